@@ -0,0 +1,41 @@
+/// One row of the top-N process table
+class ProcessStats {
+  final int pid;
+  final String name;
+  final int threads;
+
+  /// Share of one CPU, like top (can exceed 100 for multi-threaded processes)
+  final double cpuPercent;
+
+  /// Resident memory in kB
+  final int rssKb;
+
+  /// Storage I/O in bytes per second; 0 if the process is not readable
+  final double readBytesPerSec;
+  final double writeBytesPerSec;
+
+  const ProcessStats({
+    required this.pid,
+    required this.name,
+    this.threads = 1,
+    this.cpuPercent = 0.0,
+    this.rssKb = 0,
+    this.readBytesPerSec = 0.0,
+    this.writeBytesPerSec = 0.0,
+  });
+
+  double get ioBytesPerSec => readBytesPerSec + writeBytesPerSec;
+
+  String get rssString {
+    if (rssKb >= 1024 * 1024) return '${(rssKb / (1024 * 1024)).toStringAsFixed(1)} GB';
+    if (rssKb >= 1024) return '${(rssKb / 1024).toStringAsFixed(0)} MB';
+    return '$rssKb kB';
+  }
+
+  String get ioString {
+    final bytes = ioBytesPerSec;
+    if (bytes >= 1024 * 1024) return '${(bytes / (1024 * 1024)).toStringAsFixed(1)} MB/s';
+    if (bytes >= 1024) return '${(bytes / 1024).toStringAsFixed(0)} kB/s';
+    return '${bytes.toStringAsFixed(0)} B/s';
+  }
+}
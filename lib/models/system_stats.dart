@@ -1,3 +1,333 @@
+import 'dart:typed_data';
+
+/// Utilisation breakdown of a single logical CPU, in percent
+class CoreUsage {
+  final double user;
+  final double system;
+  final double idle;
+  final double iowait;
+
+  const CoreUsage({
+    this.user = 0.0,
+    this.system = 0.0,
+    this.idle = 0.0,
+    this.iowait = 0.0,
+  });
+
+  /// Share of time the core was not idle
+  double get busy => user + system + iowait;
+}
+
+/// Time spent by one native collector, from its latency histogram
+class CollectorLatency {
+  final String name;
+  final int count;
+  final Duration mean;
+  final Duration p50;
+  final Duration p99;
+  final Duration max;
+
+  const CollectorLatency({
+    required this.name,
+    this.count = 0,
+    this.mean = Duration.zero,
+    this.p50 = Duration.zero,
+    this.p99 = Duration.zero,
+    this.max = Duration.zero,
+  });
+}
+
+/// Capacity of one mounted filesystem, in MB
+class MountStats {
+  final String mountPoint;
+  final String fsType;
+  final String device;
+  final double totalMb;
+  final double usedMb;
+  final double availableMb;
+  final double usagePercent;
+
+  const MountStats({
+    required this.mountPoint,
+    this.fsType = '',
+    this.device = '',
+    this.totalMb = 0.0,
+    this.usedMb = 0.0,
+    this.availableMb = 0.0,
+    this.usagePercent = 0.0,
+  });
+}
+
+/// Throughput and latency of one block device
+class DiskIoStats {
+  final String name;
+  final double readIops;
+  final double writeIops;
+  final double readBytesPerSec;
+  final double writeBytesPerSec;
+  final double awaitMs;
+  final double utilization;
+  final int inFlight;
+  final bool isPartition;
+
+  const DiskIoStats({
+    required this.name,
+    this.readIops = 0.0,
+    this.writeIops = 0.0,
+    this.readBytesPerSec = 0.0,
+    this.writeBytesPerSec = 0.0,
+    this.awaitMs = 0.0,
+    this.utilization = 0.0,
+    this.inFlight = 0,
+    this.isPartition = false,
+  });
+}
+
+/// Traffic of one network interface, per second
+class NetworkStats {
+  final String name;
+  final double rxBytesPerSec;
+  final double txBytesPerSec;
+  final double rxPacketsPerSec;
+  final double txPacketsPerSec;
+  final double rxErrorsPerSec;
+  final double txErrorsPerSec;
+  final double rxDropsPerSec;
+  final double txDropsPerSec;
+
+  const NetworkStats({
+    required this.name,
+    this.rxBytesPerSec = 0.0,
+    this.txBytesPerSec = 0.0,
+    this.rxPacketsPerSec = 0.0,
+    this.txPacketsPerSec = 0.0,
+    this.rxErrorsPerSec = 0.0,
+    this.txErrorsPerSec = 0.0,
+    this.rxDropsPerSec = 0.0,
+    this.txDropsPerSec = 0.0,
+  });
+}
+
+/// One temperature or fan sensor
+class SensorStats {
+  final String chip;
+  final String label;
+  final int kind;
+  final int index;
+
+  /// Celsius, or RPM for fans
+  final double value;
+
+  /// Celsius; 0 if the chip reports no limit
+  final double critical;
+
+  const SensorStats({
+    required this.chip,
+    required this.label,
+    required this.kind,
+    this.index = -1,
+    this.value = 0.0,
+    this.critical = 0.0,
+  });
+}
+
+/// CPU and memory of the cgroup v2 group the dashboard runs in, against
+/// its own limits; the host's figures when it is not in one
+class ContainerStats {
+  final bool inCgroup;
+  final String path;
+
+  /// Of [cpuLimit]; negative until there are two reads to compare
+  final double cpuPercent;
+  final double cpuLimit;
+  final bool cpuLimited;
+
+  /// Share of quota periods throttled, and time throttled, since the last read
+  final double throttledPercent;
+  final double throttledMs;
+
+  /// Working set: page cache the kernel can drop is left out
+  final int memoryUsedMb;
+  final int memoryCurrentMb;
+  final int memoryLimitMb;
+  final bool memoryLimited;
+
+  const ContainerStats({
+    this.inCgroup = false,
+    this.path = '',
+    this.cpuPercent = -1.0,
+    this.cpuLimit = 0.0,
+    this.cpuLimited = false,
+    this.throttledPercent = 0.0,
+    this.throttledMs = 0.0,
+    this.memoryUsedMb = 0,
+    this.memoryCurrentMb = 0,
+    this.memoryLimitMb = 0,
+    this.memoryLimited = false,
+  });
+
+  double get memoryPercent => memoryLimitMb > 0 ? memoryUsedMb * 100.0 / memoryLimitMb : 0.0;
+}
+
+/// One group of the host's cgroup tree: a systemd service, slice or
+/// container. A group is charged for everything below it.
+class CgroupStats {
+  /// The kernel's cgroup ID; 0 stands for the root when asking for children
+  final int id;
+  final int parentId;
+  final String name;
+  final int depth;
+  final int children;
+
+  /// Share of one CPU, like top (can exceed 100)
+  final double cpuPercent;
+  final int memoryKb;
+  final double readBytesPerSec;
+  final double writeBytesPerSec;
+
+  const CgroupStats({
+    required this.id,
+    this.parentId = 0,
+    required this.name,
+    this.depth = 0,
+    this.children = 0,
+    this.cpuPercent = 0.0,
+    this.memoryKb = 0,
+    this.readBytesPerSec = 0.0,
+    this.writeBytesPerSec = 0.0,
+  });
+
+  double get ioBytesPerSec => readBytesPerSec + writeBytesPerSec;
+}
+
+/// Samples of one metric read back from the on-disk history, oldest first
+class HistoryRange {
+  /// Wall-clock milliseconds since the Unix epoch
+  final Int64List timestamps;
+  final Float64List values;
+
+  const HistoryRange({required this.timestamps, required this.values});
+
+  int get length => values.length;
+
+  bool get isEmpty => values.isEmpty;
+
+  DateTime timeAt(int index) => DateTime.fromMillisecondsSinceEpoch(timestamps[index]);
+}
+
+/// Median and tail percentiles of one metric over a window, from a native
+/// quantile sketch (each within 1% of a real sample)
+class QuantileSummary {
+  /// Samples the sketch covers; the percentiles are NaN if there are none
+  final int count;
+  final double p50;
+  final double p95;
+  final double p99;
+
+  const QuantileSummary({
+    required this.count,
+    required this.p50,
+    required this.p95,
+    required this.p99,
+  });
+
+  bool get isEmpty => count == 0;
+}
+
+/// A series reduced for drawing by the native decimation kernels
+class ChartSeries {
+  final Float64List x;
+  final Float64List y;
+
+  const ChartSeries({required this.x, required this.y});
+
+  int get length => y.length;
+}
+
+/// Pressure stall averages of one resource: the percent of wall time some
+/// (or, for full, all) non-idle tasks were waiting on it
+class ResourcePressure {
+  final int resource;
+  final double someAvg10;
+  final double someAvg60;
+  final double someAvg300;
+  final double fullAvg10;
+  final double fullAvg60;
+  final double fullAvg300;
+  final bool hasFull;
+
+  const ResourcePressure({
+    required this.resource,
+    this.someAvg10 = 0.0,
+    this.someAvg60 = 0.0,
+    this.someAvg300 = 0.0,
+    this.fullAvg10 = 0.0,
+    this.fullAvg60 = 0.0,
+    this.fullAvg300 = 0.0,
+    this.hasFull = false,
+  });
+}
+
+/// Min / max / mean / last of one burst series over a UI frame
+class BurstAggregate {
+  /// Samples taken in the frame; the figures are NaN if there were none
+  final int count;
+  final double min;
+  final double max;
+  final double mean;
+  final double last;
+
+  const BurstAggregate({
+    this.count = 0,
+    this.min = double.nan,
+    this.max = double.nan,
+    this.mean = double.nan,
+    this.last = double.nan,
+  });
+
+  bool get isEmpty => count == 0;
+}
+
+/// Everything the native burst sampler saw since the previous frame
+class BurstFrameStats {
+  final int ticks;
+  final int missed;
+  final Duration span;
+  final Duration jitterMean;
+  final Duration jitterMax;
+  final BurstAggregate cpu;
+  final BurstAggregate cpuPressure;
+
+  const BurstFrameStats({
+    required this.ticks,
+    this.missed = 0,
+    this.span = Duration.zero,
+    this.jitterMean = Duration.zero,
+    this.jitterMax = Duration.zero,
+    this.cpu = const BurstAggregate(),
+    this.cpuPressure = const BurstAggregate(),
+  });
+}
+
+/// One crossing of a pressure stall threshold
+class PressureAlert {
+  final int sequence;
+  final DateTime time;
+  final int resource;
+  final bool full;
+  final double avg10;
+  final double thresholdPercent;
+
+  const PressureAlert({
+    required this.sequence,
+    required this.time,
+    required this.resource,
+    this.full = false,
+    this.avg10 = 0.0,
+    this.thresholdPercent = 0.0,
+  });
+}
+
 class SystemStats {
   final double cpuUsage;
   final int memoryUsed;
@@ -6,6 +336,7 @@ class SystemStats {
   final double temperature;
   final double diskUsed;
   final double diskTotal;
+  final List<CoreUsage> cores;
 
   SystemStats({
     this.cpuUsage = 0.0,
@@ -15,6 +346,7 @@ class SystemStats {
     this.temperature = 0.0,
     this.diskUsed = 0.0,
     this.diskTotal = 0.0,
+    this.cores = const [],
   });
 
   String get memoryString => 
@@ -41,6 +373,7 @@ class SystemStats {
     double? temperature,
     double? diskUsed,
     double? diskTotal,
+    List<CoreUsage>? cores,
   }) {
     return SystemStats(
       cpuUsage: cpuUsage ?? this.cpuUsage,
@@ -50,6 +383,7 @@ class SystemStats {
       temperature: temperature ?? this.temperature,
       diskUsed: diskUsed ?? this.diskUsed,
       diskTotal: diskTotal ?? this.diskTotal,
+      cores: cores ?? this.cores,
     );
   }
 
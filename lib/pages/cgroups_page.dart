@@ -0,0 +1,239 @@
+// ignore_for_file: deprecated_member_use
+
+import 'package:flutter/material.dart';
+import 'package:provider/provider.dart';
+import '../models/system_stats.dart';
+import '../services/cpu_provider.dart';
+import '../services/native_structs.dart';
+import '../theme/app_theme.dart';
+
+/// The host's cgroup tree a level at a time: systemd slices, services and
+/// containers with their CPU, memory and I/O. Tapping a group lists its
+/// children; the breadcrumb goes back up.
+class CgroupsPage extends StatefulWidget {
+  const CgroupsPage({super.key});
+
+  @override
+  State<CgroupsPage> createState() => _CgroupsPageState();
+}
+
+class _CgroupsPageState extends State<CgroupsPage> {
+  late CpuProvider _provider;
+
+  @override
+  void initState() {
+    super.initState();
+    // The tree is only read while this page is open
+    WidgetsBinding.instance.addPostFrameCallback((_) {
+      if (!mounted) return;
+      _provider.watchCgroupTree();
+      if (_provider.cgroupPath.isEmpty) _provider.openCgroup(0);
+    });
+  }
+
+  @override
+  void didChangeDependencies() {
+    super.didChangeDependencies();
+    _provider = Provider.of<CpuProvider>(context, listen: false);
+  }
+
+  @override
+  void dispose() {
+    _provider.unwatchCgroupTree();
+    super.dispose();
+  }
+
+  @override
+  Widget build(BuildContext context) {
+    final provider = Provider.of<CpuProvider>(context);
+    final theme = Theme.of(context);
+    final groups = provider.cgroupChildren;
+
+    return Padding(
+      padding: const EdgeInsets.symmetric(horizontal: 16.0, vertical: 12.0),
+      child: Column(
+        crossAxisAlignment: CrossAxisAlignment.start,
+        children: [
+          // Header with sort selector
+          Row(
+            children: [
+              Icon(
+                Icons.account_tree_rounded,
+                color: AppTheme.error,
+                size: 22,
+              ),
+              const SizedBox(width: 8),
+              Expanded(
+                child: Column(
+                  crossAxisAlignment: CrossAxisAlignment.start,
+                  children: [
+                    Text(
+                      'Control Groups',
+                      style: theme.textTheme.titleLarge,
+                    ),
+                    Text(
+                      'Services, slices and containers',
+                      style: TextStyle(
+                        fontSize: 11,
+                        color: theme.textTheme.bodySmall?.color,
+                      ),
+                    ),
+                  ],
+                ),
+              ),
+              _buildSortChip(provider, 'CPU', CgroupSort.cpu),
+              const SizedBox(width: 6),
+              _buildSortChip(provider, 'Memory', CgroupSort.memory),
+              const SizedBox(width: 6),
+              _buildSortChip(provider, 'I/O', CgroupSort.io),
+            ],
+          ),
+
+          const SizedBox(height: 12),
+          _buildBreadcrumb(context, provider),
+          const SizedBox(height: 8),
+
+          Padding(
+            padding: const EdgeInsets.fromLTRB(12, 4, 12, 4),
+            child: _buildRow(context, const ['Group', 'CPU', 'Memory', 'I/O'], header: true),
+          ),
+          const Divider(height: 1),
+
+          Expanded(
+            child: !provider.hasCgroupTree || provider.cgroupPath.isEmpty
+                ? Center(
+                    child: Text(
+                      'Control groups not available',
+                      style: theme.textTheme.bodyMedium,
+                    ),
+                  )
+                : groups.isEmpty
+                    ? Center(
+                        child: Text(
+                          'No child groups',
+                          style: theme.textTheme.bodyMedium,
+                        ),
+                      )
+                    : ListView.builder(
+                        itemCount: groups.length,
+                        itemBuilder: (context, index) => _buildGroupRow(context, provider, groups, index),
+                      ),
+          ),
+        ],
+      ),
+    );
+  }
+
+  Widget _buildSortChip(CpuProvider provider, String label, int sort) {
+    return ChoiceChip(
+      label: Text(label, style: const TextStyle(fontSize: 12)),
+      selected: provider.cgroupSort == sort,
+      visualDensity: VisualDensity.compact,
+      selectedColor: AppTheme.error.withOpacity(0.2),
+      onSelected: (_) => provider.setCgroupSort(sort),
+    );
+  }
+
+  Widget _buildBreadcrumb(BuildContext context, CpuProvider provider) {
+    final path = provider.cgroupPath;
+
+    return SingleChildScrollView(
+      scrollDirection: Axis.horizontal,
+      child: Row(
+        children: [
+          for (int i = 0; i < path.length; i++) ...[
+            if (i > 0)
+              Icon(
+                Icons.chevron_right_rounded,
+                size: 16,
+                color: Theme.of(context).textTheme.bodySmall?.color,
+              ),
+            TextButton(
+              onPressed: i == path.length - 1 ? null : () => provider.openCgroup(path[i].id),
+              style: TextButton.styleFrom(visualDensity: VisualDensity.compact),
+              child: Text(path[i].name),
+            ),
+          ],
+        ],
+      ),
+    );
+  }
+
+  Widget _buildGroupRow(BuildContext context, CpuProvider provider, List<CgroupStats> groups, int index) {
+    final group = groups[index];
+
+    // Bars are relative to the busiest group listed by the chosen sort
+    double value(CgroupStats g) => switch (provider.cgroupSort) {
+          CgroupSort.memory => g.memoryKb.toDouble(),
+          CgroupSort.io => g.ioBytesPerSec,
+          _ => g.cpuPercent,
+        };
+    final top = groups.map(value).fold(0.0, (a, b) => a > b ? a : b);
+    final fraction = top > 0 ? value(group) / top : 0.0;
+
+    return InkWell(
+      onTap: group.children > 0 ? () => provider.openCgroup(group.id) : null,
+      borderRadius: BorderRadius.circular(8),
+      child: Padding(
+        padding: const EdgeInsets.symmetric(horizontal: 12, vertical: 6),
+        child: Column(
+          crossAxisAlignment: CrossAxisAlignment.stretch,
+          children: [
+            _buildRow(context, [
+              group.children > 0 ? '${group.name} (${group.children})' : group.name,
+              '${group.cpuPercent.toStringAsFixed(1)}%',
+              _formatMemory(group.memoryKb),
+              _formatRate(group.ioBytesPerSec),
+            ]),
+            const SizedBox(height: 4),
+            ClipRRect(
+              borderRadius: BorderRadius.circular(4),
+              child: LinearProgressIndicator(
+                value: fraction.clamp(0.0, 1.0),
+                minHeight: 4,
+                backgroundColor: Colors.grey.withOpacity(0.15),
+                valueColor: AlwaysStoppedAnimation(AppTheme.error.withOpacity(0.7)),
+              ),
+            ),
+          ],
+        ),
+      ),
+    );
+  }
+
+  String _formatMemory(int kb) {
+    if (kb >= 1024 * 1024) return '${(kb / (1024 * 1024)).toStringAsFixed(1)} GB';
+    if (kb >= 1024) return '${(kb / 1024).toStringAsFixed(0)} MB';
+    return '$kb kB';
+  }
+
+  String _formatRate(double bytes) {
+    if (bytes >= 1024 * 1024) return '${(bytes / (1024 * 1024)).toStringAsFixed(1)} MB/s';
+    if (bytes >= 1024) return '${(bytes / 1024).toStringAsFixed(0)} kB/s';
+    return '${bytes.toStringAsFixed(0)} B/s';
+  }
+
+  Widget _buildRow(BuildContext context, List<String> cells, {bool header = false}) {
+    final style = TextStyle(
+      fontSize: header ? 12 : 13,
+      fontWeight: header ? FontWeight.w600 : FontWeight.w500,
+      color: header
+          ? Theme.of(context).textTheme.bodyMedium?.color?.withOpacity(0.7)
+          : Theme.of(context).textTheme.bodyLarge?.color,
+    );
+
+    return Row(
+      children: [
+        Expanded(
+          flex: 4,
+          child: Text(cells[0], style: style, maxLines: 1, overflow: TextOverflow.ellipsis),
+        ),
+        for (int i = 1; i < cells.length; i++)
+          Expanded(
+            flex: 2,
+            child: Text(cells[i], style: style, textAlign: TextAlign.right, maxLines: 1),
+          ),
+      ],
+    );
+  }
+}
@@ -1,8 +1,9 @@
 // ignore_for_file: deprecated_member_use
 
-import 'dart:async';
 import 'package:flutter/material.dart';
 import 'package:provider/provider.dart';
+import 'package:real_time_monitoring_dashboard/screens/widgets/burst_card.dart';
+import 'package:real_time_monitoring_dashboard/screens/widgets/core_heatmap.dart';
 import 'package:real_time_monitoring_dashboard/screens/widgets/cpu_chart.dart';
 import '../services/cpu_provider.dart';
 import '../theme/app_theme.dart';
@@ -15,25 +16,10 @@ class CpuPage extends StatefulWidget {
 }
 
 class _CpuPageState extends State<CpuPage> {
-  Timer? _timer;
   // int _selectedTimeRange = 60; // Default 60 seconds
   
-  @override
-  void initState() {
-    super.initState();
-    // Update UI every second
-    _timer = Timer.periodic(const Duration(seconds: 1), (_) {
-      if (mounted) {
-        setState(() {});
-      }
-    });
-  }
-  
-  @override
-  void dispose() {
-    _timer?.cancel();
-    super.dispose();
-  }
+  // Rebuilt by the provider whenever a collector updates; a timer of its
+  // own would wake the UI every second even while nothing changed
 
   @override
   Widget build(BuildContext context) {
@@ -131,7 +117,9 @@ class _CpuPageState extends State<CpuPage> {
                                   child: _buildCompactMetricCard(
                                     context,
                                     title: 'Active Cores',
-                                    value: '${systemInfo.cpuCores}/${systemInfo.cpuCores}',
+                                    value: stats.cores.isEmpty
+                                        ? '${systemInfo.cpuCores}/${systemInfo.cpuCores}'
+                                        : '${stats.cores.where((core) => core.busy >= 5).length}/${stats.cores.length}',
                                     icon: Icons.grid_4x4_rounded,
                                     color: AppTheme.info,
                                     trend: 0,
@@ -146,6 +134,45 @@ class _CpuPageState extends State<CpuPage> {
                     
                     const SizedBox(height: 16),
                     
+                    // Per-core utilisation heatmap
+                    Card(
+                      margin: EdgeInsets.zero,
+                      shape: RoundedRectangleBorder(
+                        borderRadius: BorderRadius.circular(16),
+                      ),
+                      child: Padding(
+                        padding: const EdgeInsets.all(16.0),
+                        child: Column(
+                          crossAxisAlignment: CrossAxisAlignment.start,
+                          children: [
+                            Row(
+                              children: [
+                                Icon(
+                                  Icons.grid_view_rounded,
+                                  color: AppTheme.primaryLight,
+                                  size: 18
+                                ),
+                                const SizedBox(width: 8),
+                                Text(
+                                  'Per-Core Utilisation',
+                                  style: Theme.of(context).textTheme.titleMedium,
+                                ),
+                              ],
+                            ),
+                            const SizedBox(height: 16),
+                            CoreHeatmap(cores: stats.cores),
+                          ],
+                        ),
+                      ),
+                    ),
+                    
+                    const SizedBox(height: 16),
+                    
+                    // Sub-second CPU spikes from the native burst sampler
+                    const BurstCard(),
+                    
+                    const SizedBox(height: 16),
+                    
                     // Performance and Details Cards
                     Row(
                       crossAxisAlignment: CrossAxisAlignment.start,
@@ -2,6 +2,7 @@
 
 import 'package:flutter/material.dart';
 import 'package:provider/provider.dart';
+import '../models/system_stats.dart';
 import '../services/cpu_provider.dart';
 import '../theme/app_theme.dart';
 
@@ -125,6 +126,12 @@ class InfoPage extends StatelessWidget {
                       ),
                     ),
                     
+                    // Cost of the native collectors themselves
+                    if (cpuProvider.collectionCost.isNotEmpty) ...[
+                      _buildCollectionCostCard(context, cpuProvider.collectionCost),
+                      const SizedBox(height: 16),
+                    ],
+                    
                     const SizedBox(height: 16),
                     
                     // Hardware Specifications
@@ -422,6 +429,93 @@ class InfoPage extends StatelessWidget {
     );
   }
   
+  Widget _buildCollectionCostCard(BuildContext context, List<CollectorLatency> collectors) {
+    final mutedStyle = TextStyle(
+      fontSize: 12,
+      fontWeight: FontWeight.w600,
+      color: Theme.of(context).textTheme.bodyMedium?.color?.withOpacity(0.7),
+    );
+    
+    return Card(
+      margin: EdgeInsets.zero,
+      shape: RoundedRectangleBorder(
+        borderRadius: BorderRadius.circular(16),
+      ),
+      child: Padding(
+        padding: const EdgeInsets.all(16.0),
+        child: Column(
+          crossAxisAlignment: CrossAxisAlignment.start,
+          children: [
+            Row(
+              children: [
+                Icon(
+                  Icons.timer_outlined,
+                  color: AppTheme.primaryDark,
+                  size: 18,
+                ),
+                const SizedBox(width: 8),
+                Text(
+                  'Collection Cost',
+                  style: Theme.of(context).textTheme.titleMedium,
+                ),
+              ],
+            ),
+            const SizedBox(height: 16),
+            const Divider(height: 1),
+            const SizedBox(height: 16),
+            
+            Row(
+              children: [
+                SizedBox(width: 120, child: Text('Collector', style: mutedStyle)),
+                Expanded(child: Text('p50', style: mutedStyle, textAlign: TextAlign.right)),
+                Expanded(child: Text('p99', style: mutedStyle, textAlign: TextAlign.right)),
+                Expanded(child: Text('Max', style: mutedStyle, textAlign: TextAlign.right)),
+              ],
+            ),
+            for (final collector in collectors) ...[
+              const SizedBox(height: 10),
+              _buildCollectorLatencyRow(context, collector),
+            ],
+          ],
+        ),
+      ),
+    );
+  }
+  
+  Widget _buildCollectorLatencyRow(BuildContext context, CollectorLatency collector) {
+    final valueStyle = TextStyle(
+      fontSize: 13,
+      fontWeight: FontWeight.w500,
+      color: Theme.of(context).textTheme.bodyLarge?.color,
+    );
+    
+    return Row(
+      children: [
+        SizedBox(
+          width: 120,
+          child: Text(
+            collector.name,
+            style: TextStyle(
+              fontSize: 13,
+              fontWeight: FontWeight.w500,
+              color: Theme.of(context).textTheme.bodyMedium?.color?.withOpacity(0.7),
+            ),
+          ),
+        ),
+        Expanded(child: Text(_formatLatency(collector.p50, collector.count), style: valueStyle, textAlign: TextAlign.right)),
+        Expanded(child: Text(_formatLatency(collector.p99, collector.count), style: valueStyle, textAlign: TextAlign.right)),
+        Expanded(child: Text(_formatLatency(collector.max, collector.count), style: valueStyle, textAlign: TextAlign.right)),
+      ],
+    );
+  }
+  
+  String _formatLatency(Duration latency, int count) {
+    if (count == 0) return '—';
+    final micros = latency.inMicroseconds;
+    if (micros < 1000) return '$micros µs';
+    return '${(micros / 1000).toStringAsFixed(1)} ms';
+  }
+  
   Widget _buildMetricCard(
     BuildContext context, {
     required String title,
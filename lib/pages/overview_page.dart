@@ -9,7 +9,13 @@ import 'package:real_time_monitoring_dashboard/widgets/library_status_widget.dar
 import '../services/cpu_provider.dart';
 import '../theme/app_theme.dart';
 import '../screens/widgets/metric_card.dart';
+import '../screens/widgets/container_card.dart';
+import '../screens/widgets/disk_io_card.dart';
 import '../screens/widgets/disk_storage_card.dart';
+import '../screens/widgets/network_card.dart';
+import '../screens/widgets/pressure_card.dart';
+import '../screens/widgets/process_table_card.dart';
+import '../screens/widgets/sensors_card.dart';
 
 class OverviewPage extends StatelessWidget {
   const OverviewPage({super.key});
@@ -154,6 +160,42 @@ class OverviewPage extends StatelessWidget {
                   }
                 ),
                 
+                // Busiest processes, when the native library can list them
+                if (provider.hasProcessTable) ...[
+                  const SizedBox(height: 20),
+                  const ProcessTableCard(),
+                ],
+                
+                // Block device throughput, when the native library reports it
+                if (provider.hasDiskIo) ...[
+                  const SizedBox(height: 20),
+                  const DiskIoCard(),
+                ],
+                
+                // Interface traffic, when the native library reports it
+                if (provider.hasNetworkIo) ...[
+                  const SizedBox(height: 20),
+                  const NetworkCard(),
+                ],
+                
+                // Usage against the container's own limits, inside a cgroup
+                if (provider.container?.inCgroup ?? false) ...[
+                  const SizedBox(height: 20),
+                  const ContainerCard(),
+                ],
+                
+                // Stall pressure and threshold alerts, when the kernel reports PSI
+                if (provider.hasPressure) ...[
+                  const SizedBox(height: 20),
+                  const PressureCard(),
+                ],
+                
+                // Temperature and fan sensors, when the native library reads them
+                if (provider.hasSensors) ...[
+                  const SizedBox(height: 20),
+                  const SensorsCard(),
+                ],
+                
                 // Add some bottom padding
                 const SizedBox(height: 20),
               ],
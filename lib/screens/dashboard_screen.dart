@@ -5,6 +5,7 @@ import 'package:provider/provider.dart';
 import '../pages/overview_page.dart';
 import '../pages/cpu_page.dart';
 import '../pages/memory_page.dart';
+import '../pages/cgroups_page.dart';
 import '../pages/info_page.dart';
 import '../services/cpu_provider.dart';
 import '../services/theme_provider.dart';
@@ -19,19 +20,21 @@ class DashboardScreen extends StatefulWidget {
 
 class _DashboardScreenState extends State<DashboardScreen> with SingleTickerProviderStateMixin {
   late TabController _tabController;
+  late final AppLifecycleListener _lifecycleListener;
   
   // Define tab-specific colors
   final List<Color> _tabColors = [
     AppTheme.info,          // Overview tab - blue
     AppTheme.success,       // CPU tab - green
     AppTheme.warning,       // Memory tab - amber
+    AppTheme.error,         // Groups tab - red
     AppTheme.primaryDark,   // Info tab - purple
   ];
 
   @override
   void initState() {
     super.initState();
-    _tabController = TabController(length: 4, vsync: this);
+    _tabController = TabController(length: 5, vsync: this);
     
     // Listen for tab changes to update state
     _tabController.addListener(() {
@@ -40,6 +43,14 @@ class _DashboardScreenState extends State<DashboardScreen> with SingleTickerProv
       }
     });
     
+    // Sample slowly while the window is hidden or minimised
+    _lifecycleListener = AppLifecycleListener(
+      onStateChange: (state) {
+        final visible = state == AppLifecycleState.resumed || state == AppLifecycleState.inactive;
+        Provider.of<CpuProvider>(context, listen: false).setVisible(visible);
+      },
+    );
+    
     // Ensure the data is loaded when the dashboard initializes
     WidgetsBinding.instance.addPostFrameCallback((_) {
       final cpuProvider = Provider.of<CpuProvider>(context, listen: false);
@@ -53,6 +64,7 @@ class _DashboardScreenState extends State<DashboardScreen> with SingleTickerProv
 
   @override
   void dispose() {
+    _lifecycleListener.dispose();
     _tabController.dispose();
     super.dispose();
   }
@@ -104,6 +116,9 @@ class _DashboardScreenState extends State<DashboardScreen> with SingleTickerProv
                           // Memory Tab
                           MemoryPage(),
                           
+                          // Groups Tab
+                          CgroupsPage(),
+                          
                           // Info Tab
                           InfoPage(),
                         ],
@@ -244,7 +259,8 @@ class _DashboardScreenState extends State<DashboardScreen> with SingleTickerProv
           _buildNavItem(0, 'Overview', Icons.dashboard_outlined, Icons.dashboard_rounded),
           _buildNavItem(1, 'CPU', Icons.memory_outlined, Icons.memory_rounded),
           _buildNavItem(2, 'Memory', Icons.storage_outlined, Icons.storage_rounded),
-          _buildNavItem(3, 'Info', Icons.info_outline_rounded, Icons.info_rounded),
+          _buildNavItem(3, 'Groups', Icons.account_tree_outlined, Icons.account_tree_rounded),
+          _buildNavItem(4, 'Info', Icons.info_outline_rounded, Icons.info_rounded),
           const Spacer(),
           // Version number at bottom
           Padding(
@@ -0,0 +1,222 @@
+// ignore_for_file: deprecated_member_use
+
+import 'dart:collection';
+import 'dart:math';
+
+import 'package:flutter/material.dart';
+import 'package:flutter/scheduler.dart';
+import 'package:provider/provider.dart';
+import '../../models/system_stats.dart';
+import '../../services/cpu_provider.dart';
+import '../../theme/app_theme.dart';
+
+/// CPU sampled natively 100 to 1000 times a second, drawn as one bar per UI
+/// frame that spans the lowest to highest sample of that frame, so spikes
+/// far shorter than the regular one-second interval stay visible. The card
+/// takes a single aggregate per frame, whatever the rate.
+class BurstCard extends StatefulWidget {
+  const BurstCard({super.key});
+
+  @override
+  State<BurstCard> createState() => _BurstCardState();
+}
+
+class _BurstCardState extends State<BurstCard> with SingleTickerProviderStateMixin {
+  // Frames kept on screen, about four seconds at 60 fps
+  static const int _frames = 240;
+  static const List<int> _rates = [100, 250, 500, 1000];
+
+  late final Ticker _ticker;
+  late CpuProvider _provider;
+  final ListQueue<BurstFrameStats> _history = ListQueue();
+  int _rate = 1000;
+
+  @override
+  void initState() {
+    super.initState();
+    _ticker = createTicker(_onFrame);
+  }
+
+  @override
+  void didChangeDependencies() {
+    super.didChangeDependencies();
+    _provider = Provider.of<CpuProvider>(context, listen: false);
+  }
+
+  @override
+  void dispose() {
+    _ticker.dispose();
+    _provider.stopBurst();
+    super.dispose();
+  }
+
+  void _onFrame(Duration elapsed) {
+    final frame = _provider.takeBurstFrame();
+    if (frame == null) {
+      _ticker.stop();
+      setState(() {});
+      return;
+    }
+    if (frame.ticks == 0) return;
+    setState(() {
+      _history.addLast(frame);
+      while (_history.length > _frames) {
+        _history.removeFirst();
+      }
+    });
+  }
+
+  void _setRunning(bool running) {
+    if (running) {
+      if (!_provider.startBurst(_rate)) return;
+      _history.clear();
+      if (!_ticker.isActive) _ticker.start();
+    } else {
+      _ticker.stop();
+      _provider.stopBurst();
+    }
+    setState(() {});
+  }
+
+  void _setRate(int rate) {
+    setState(() => _rate = rate);
+    if (_ticker.isActive) _provider.startBurst(rate);
+  }
+
+  @override
+  Widget build(BuildContext context) {
+    final theme = Theme.of(context);
+    final available = _provider.hasBurstSampler;
+    final running = _ticker.isActive;
+
+    return Card(
+      margin: EdgeInsets.zero,
+      shape: RoundedRectangleBorder(
+        borderRadius: BorderRadius.circular(16),
+      ),
+      child: Padding(
+        padding: const EdgeInsets.all(16.0),
+        child: Column(
+          crossAxisAlignment: CrossAxisAlignment.start,
+          children: [
+            Row(
+              children: [
+                Icon(Icons.bolt_rounded, color: AppTheme.primaryLight, size: 18),
+                const SizedBox(width: 8),
+                Text('Burst Sampling', style: theme.textTheme.titleMedium),
+                const Spacer(),
+                DropdownButton<int>(
+                  value: _rate,
+                  underline: const SizedBox.shrink(),
+                  items: [
+                    for (final rate in _rates)
+                      DropdownMenuItem(value: rate, child: Text('$rate Hz')),
+                  ],
+                  onChanged: available ? (rate) => _setRate(rate!) : null,
+                ),
+                const SizedBox(width: 8),
+                Switch(
+                  value: running,
+                  onChanged: available ? _setRunning : null,
+                ),
+              ],
+            ),
+            const SizedBox(height: 4),
+            Text(
+              available ? _summary() : 'Burst sampling needs the native library on Linux',
+              style: theme.textTheme.bodySmall?.copyWith(
+                color: theme.colorScheme.onSurface.withOpacity(0.6),
+              ),
+            ),
+            const SizedBox(height: 12),
+            SizedBox(
+              height: 120,
+              child: CustomPaint(
+                size: Size.infinite,
+                painter: _BurstPainter(
+                  frames: _history.toList(growable: false),
+                  capacity: _frames,
+                  cpuColor: theme.colorScheme.primary,
+                  stallColor: AppTheme.error,
+                  gridColor: Colors.grey.withOpacity(0.2),
+                ),
+              ),
+            ),
+          ],
+        ),
+      ),
+    );
+  }
+
+  String _summary() {
+    if (_history.isEmpty) return 'Per-frame min to max of CPU usage, with CPU stall below';
+
+    double peak = 0;
+    int jitterMax = 0;
+    int jitterSum = 0;
+    int missed = 0;
+    for (final frame in _history) {
+      if (!frame.cpu.isEmpty) peak = max(peak, frame.cpu.max);
+      jitterMax = max(jitterMax, frame.jitterMax.inMicroseconds);
+      jitterSum += frame.jitterMean.inMicroseconds;
+      missed += frame.missed;
+    }
+    return 'Peak ${peak.toStringAsFixed(0)}% · jitter ${jitterSum ~/ _history.length} µs mean, '
+        '$jitterMax µs max · $missed ticks missed';
+  }
+}
+
+/// One bar per frame from the lowest to the highest CPU sample, a tick at
+/// the mean, and the highest stall percentage growing up from the bottom
+class _BurstPainter extends CustomPainter {
+  final List<BurstFrameStats> frames;
+  final int capacity;
+  final Color cpuColor;
+  final Color stallColor;
+  final Color gridColor;
+
+  _BurstPainter({
+    required this.frames,
+    required this.capacity,
+    required this.cpuColor,
+    required this.stallColor,
+    required this.gridColor,
+  });
+
+  @override
+  void paint(Canvas canvas, Size size) {
+    final grid = Paint()
+      ..color = gridColor
+      ..strokeWidth = 1;
+    for (final percent in [0.0, 50.0, 100.0]) {
+      final y = _y(percent, size);
+      canvas.drawLine(Offset(0, y), Offset(size.width, y), grid);
+    }
+
+    final width = size.width / capacity;
+    final range = Paint()..color = cpuColor.withOpacity(0.35);
+    final mean = Paint()..color = cpuColor;
+    final stall = Paint()..color = stallColor.withOpacity(0.6);
+    final start = capacity - frames.length;
+
+    for (int i = 0; i < frames.length; i++) {
+      final frame = frames[i];
+      final left = (start + i) * width;
+
+      if (!frame.cpuPressure.isEmpty && frame.cpuPressure.max > 0) {
+        canvas.drawRect(Rect.fromLTRB(left, _y(frame.cpuPressure.max, size), left + width, size.height), stall);
+      }
+      if (frame.cpu.isEmpty) continue;
+      final top = _y(frame.cpu.max, size);
+      final bottom = max(_y(frame.cpu.min, size), top + 1);
+      canvas.drawRect(Rect.fromLTRB(left, top, left + width, bottom), range);
+      final y = _y(frame.cpu.mean, size);
+      canvas.drawRect(Rect.fromLTRB(left, y - 1, left + width, y + 1), mean);
+    }
+  }
+
+  double _y(double percent, Size size) => size.height * (1 - percent.clamp(0.0, 100.0) / 100);
+
+  @override
+  bool shouldRepaint(covariant _BurstPainter oldDelegate) => true;
+}
@@ -0,0 +1,188 @@
+// ignore_for_file: deprecated_member_use
+
+import 'package:flutter/material.dart';
+import 'package:provider/provider.dart';
+import '../../models/system_stats.dart';
+import '../../services/cpu_provider.dart';
+import '../../theme/app_theme.dart';
+
+/// CPU and memory of the container the dashboard runs in, measured against
+/// the group's own quota and memory limit rather than the host's
+class ContainerCard extends StatelessWidget {
+  const ContainerCard({super.key});
+
+  @override
+  Widget build(BuildContext context) {
+    return Consumer<CpuProvider>(
+      builder: (context, provider, child) {
+        final theme = Theme.of(context);
+        final container = provider.container;
+
+        return Card(
+          elevation: 4,
+          clipBehavior: Clip.antiAlias,
+          shape: RoundedRectangleBorder(
+            borderRadius: BorderRadius.circular(16),
+            side: BorderSide(
+              color: Colors.grey.withOpacity(0.2),
+              width: 1,
+            ),
+          ),
+          child: Column(
+            crossAxisAlignment: CrossAxisAlignment.stretch,
+            children: [
+              // Header
+              Container(
+                color: AppTheme.primaryDark.withOpacity(0.08),
+                padding: const EdgeInsets.all(12),
+                child: Row(
+                  children: [
+                    Icon(
+                      Icons.inventory_2_rounded,
+                      color: AppTheme.primaryDark,
+                      size: 22,
+                    ),
+                    const SizedBox(width: 10),
+                    Text(
+                      'Container',
+                      style: theme.textTheme.titleMedium?.copyWith(
+                        fontWeight: FontWeight.bold,
+                      ),
+                    ),
+                    const SizedBox(width: 12),
+                    Expanded(
+                      child: Text(
+                        container == null || !container.inCgroup ? 'Host' : container.path,
+                        style: theme.textTheme.bodySmall,
+                        maxLines: 1,
+                        overflow: TextOverflow.ellipsis,
+                        textAlign: TextAlign.end,
+                      ),
+                    ),
+                  ],
+                ),
+              ),
+
+              if (container == null)
+                Padding(
+                  padding: const EdgeInsets.all(24),
+                  child: Center(
+                    child: Text(
+                      'Container accounting not available',
+                      style: theme.textTheme.bodyMedium,
+                    ),
+                  ),
+                )
+              else ...[
+                Padding(
+                  padding: const EdgeInsets.fromLTRB(16, 12, 16, 0),
+                  child: _buildCpu(context, container),
+                ),
+                Padding(
+                  padding: const EdgeInsets.fromLTRB(16, 12, 16, 0),
+                  child: _buildMemory(context, container),
+                ),
+                if (container.cpuLimited)
+                  Padding(
+                    padding: const EdgeInsets.fromLTRB(16, 12, 16, 0),
+                    child: _buildThrottling(context, container),
+                  ),
+              ],
+              const SizedBox(height: 16),
+            ],
+          ),
+        );
+      },
+    );
+  }
+
+  Widget _buildCpu(BuildContext context, ContainerStats container) {
+    final limit = container.cpuLimited
+        ? 'of ${container.cpuLimit.toStringAsFixed(2)} cores'
+        : 'of ${container.cpuLimit.toStringAsFixed(0)} cores, no quota';
+    final percent = container.cpuPercent < 0 ? 0.0 : container.cpuPercent;
+
+    return _buildBar(
+      context,
+      label: 'CPU',
+      detail: container.cpuPercent < 0 ? limit : '${percent.toStringAsFixed(1)}% $limit',
+      fraction: percent / 100,
+    );
+  }
+
+  Widget _buildMemory(BuildContext context, ContainerStats container) {
+    final limit = container.memoryLimited ? 'limit' : 'host';
+
+    return Tooltip(
+      message: 'Including page cache: ${container.memoryCurrentMb} MB',
+      child: _buildBar(
+        context,
+        label: 'Memory',
+        detail: '${container.memoryUsedMb} MB of ${container.memoryLimitMb} MB $limit',
+        fraction: container.memoryPercent / 100,
+      ),
+    );
+  }
+
+  Widget _buildThrottling(BuildContext context, ContainerStats container) {
+    final theme = Theme.of(context);
+    final throttled = container.throttledPercent > 0;
+
+    return Row(
+      children: [
+        Icon(
+          throttled ? Icons.speed_rounded : Icons.check_circle_outline_rounded,
+          size: 16,
+          color: throttled ? AppTheme.warning : AppTheme.success,
+        ),
+        const SizedBox(width: 8),
+        Expanded(
+          child: Text(
+            throttled
+                ? 'Throttled in ${container.throttledPercent.toStringAsFixed(0)}% of periods, '
+                    '${container.throttledMs.toStringAsFixed(0)} ms'
+                : 'Not throttled',
+            style: theme.textTheme.bodySmall,
+          ),
+        ),
+      ],
+    );
+  }
+
+  Widget _buildBar(BuildContext context, {required String label, required String detail, required double fraction}) {
+    final theme = Theme.of(context);
+    final percent = fraction * 100;
+
+    return Column(
+      crossAxisAlignment: CrossAxisAlignment.stretch,
+      children: [
+        Row(
+          children: [
+            Text(
+              label,
+              style: theme.textTheme.bodyMedium?.copyWith(fontWeight: FontWeight.w600),
+            ),
+            const Spacer(),
+            Text(detail, style: theme.textTheme.bodySmall),
+          ],
+        ),
+        const SizedBox(height: 4),
+        ClipRRect(
+          borderRadius: BorderRadius.circular(4),
+          child: LinearProgressIndicator(
+            value: fraction.clamp(0.0, 1.0),
+            minHeight: 6,
+            backgroundColor: Colors.grey.withOpacity(0.15),
+            valueColor: AlwaysStoppedAnimation(_usageColor(percent)),
+          ),
+        ),
+      ],
+    );
+  }
+
+  Color _usageColor(double percent) {
+    if (percent >= 90) return AppTheme.error;
+    if (percent >= 70) return AppTheme.warning;
+    return AppTheme.success;
+  }
+}
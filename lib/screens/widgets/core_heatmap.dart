@@ -0,0 +1,127 @@
+// ignore_for_file: deprecated_member_use
+
+import 'package:flutter/material.dart';
+import '../../models/system_stats.dart';
+import '../../theme/app_theme.dart';
+
+/// Grid of per-core utilisation cells, one per logical CPU.
+///
+/// Each cell is coloured by how busy the core is, so a single saturated core
+/// stands out even when the aggregate CPU figure looks healthy.
+class CoreHeatmap extends StatelessWidget {
+  final List<CoreUsage> cores;
+
+  const CoreHeatmap({
+    super.key,
+    required this.cores,
+  });
+
+  @override
+  Widget build(BuildContext context) {
+    final theme = Theme.of(context);
+
+    if (cores.isEmpty) {
+      return SizedBox(
+        height: 60,
+        child: Center(
+          child: Text(
+            'Per-core data not available',
+            style: theme.textTheme.bodyMedium,
+          ),
+        ),
+      );
+    }
+
+    // Smaller cells on hosts with many cores so the grid stays compact
+    final double cellSize = cores.length > 128 ? 14 : (cores.length > 32 ? 22 : 36);
+
+    return Column(
+      crossAxisAlignment: CrossAxisAlignment.start,
+      children: [
+        Wrap(
+          spacing: 4,
+          runSpacing: 4,
+          children: [
+            for (int i = 0; i < cores.length; i++)
+              _buildCell(context, i, cores[i], cellSize),
+          ],
+        ),
+        const SizedBox(height: 12),
+        _buildLegend(context),
+      ],
+    );
+  }
+
+  Widget _buildCell(BuildContext context, int index, CoreUsage core, double size) {
+    final busy = core.busy.clamp(0.0, 100.0);
+    final color = _colorForUsage(busy);
+
+    return Tooltip(
+      message: 'CPU $index: ${busy.toStringAsFixed(0)}% busy\n'
+          'user ${core.user.toStringAsFixed(1)}%  '
+          'system ${core.system.toStringAsFixed(1)}%  '
+          'iowait ${core.iowait.toStringAsFixed(1)}%',
+      child: Container(
+        width: size,
+        height: size,
+        alignment: Alignment.center,
+        decoration: BoxDecoration(
+          color: color.withOpacity(0.15 + 0.85 * busy / 100),
+          borderRadius: BorderRadius.circular(size > 20 ? 6 : 3),
+        ),
+        child: size > 30
+            ? Text(
+                '${busy.round()}',
+                style: const TextStyle(
+                  fontSize: 11,
+                  fontWeight: FontWeight.w600,
+                  color: Colors.white,
+                ),
+              )
+            : null,
+      ),
+    );
+  }
+
+  Widget _buildLegend(BuildContext context) {
+    return Row(
+      children: [
+        _buildLegendItem(context, 'Low', AppTheme.success),
+        const SizedBox(width: 16),
+        _buildLegendItem(context, 'Moderate', AppTheme.warning),
+        const SizedBox(width: 16),
+        _buildLegendItem(context, 'Saturated', AppTheme.error),
+      ],
+    );
+  }
+
+  Widget _buildLegendItem(BuildContext context, String label, Color color) {
+    return Row(
+      mainAxisSize: MainAxisSize.min,
+      children: [
+        Container(
+          width: 10,
+          height: 10,
+          decoration: BoxDecoration(
+            color: color,
+            borderRadius: BorderRadius.circular(2),
+          ),
+        ),
+        const SizedBox(width: 6),
+        Text(
+          label,
+          style: TextStyle(
+            fontSize: 12,
+            color: Theme.of(context).textTheme.bodyMedium?.color,
+          ),
+        ),
+      ],
+    );
+  }
+
+  Color _colorForUsage(double usage) {
+    if (usage < 50) return AppTheme.success;
+    if (usage < 80) return AppTheme.warning;
+    return AppTheme.error;
+  }
+}
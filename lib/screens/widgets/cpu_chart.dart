@@ -5,17 +5,27 @@ import 'package:fl_chart/fl_chart.dart';
 import 'package:provider/provider.dart';
 
 import '../../services/cpu_provider.dart';
+import '../../services/native_structs.dart';
+import 'history_window.dart';
 // import '../../theme/app_theme.dart';
 
-class CpuChartCard extends StatelessWidget {
+class CpuChartCard extends StatefulWidget {
   const CpuChartCard({
     super.key,
   });
 
+  @override
+  State<CpuChartCard> createState() => _CpuChartCardState();
+}
+
+class _CpuChartCardState extends State<CpuChartCard> {
+  HistoryWindow _window = historyWindows.first;
+
   @override
   Widget build(BuildContext context) {
     final cpuProvider = Provider.of<CpuProvider>(context);
     final stats = cpuProvider.stats;
+    final p95 = cpuProvider.quantiles(HistoryMetric.cpu, QuantileWindow.oneHour);
     
     return Container(
       decoration: BoxDecoration(
@@ -52,6 +62,11 @@ class CpuChartCard extends StatelessWidget {
                 const SizedBox(width: 10),
                 // _buildCpuIndicator(context, stats.cpuUsage),
                 const Spacer(),
+                HistoryWindowSelector(
+                  value: _window,
+                  onChanged: (window) => setState(() => _window = window),
+                ),
+                const SizedBox(width: 12),
                 OutlinedButton.icon(
                   icon: const Icon(Icons.file_download, size: 18),
                   label: const Text('Export'),
@@ -67,7 +82,7 @@ class CpuChartCard extends StatelessWidget {
             Padding(
               padding: const EdgeInsets.only(left: 30.0),
               child: Text(
-                'Monitoring last 30 seconds of CPU activity',
+                'Monitoring ${_window.label.toLowerCase()} of CPU activity',
                 style: Theme.of(context).textTheme.bodySmall?.copyWith(
                   color: Theme.of(context).colorScheme.onSurface.withOpacity(0.6)
                 ),
@@ -96,6 +111,15 @@ class CpuChartCard extends StatelessWidget {
                   '${_calculateMax(cpuProvider.cpuHistory).toStringAsFixed(1)}%',
                   color: Theme.of(context).colorScheme.error
                 ),
+                if (p95 != null && !p95.isEmpty) ...[
+                  const SizedBox(width: 12),
+                  _buildStatCard(
+                    context,
+                    'p95 · 1h',
+                    '${p95.p95.toStringAsFixed(1)}%',
+                    color: Colors.deepOrange
+                  ),
+                ],
               ],
             ),
             const SizedBox(height: 16),
@@ -183,7 +207,18 @@ class CpuChartCard extends StatelessWidget {
     final cpuProvider = Provider.of<CpuProvider>(context);
     final cpuData = cpuProvider.smoothedCpuHistory;
     
-    if (cpuData.isEmpty) {
+    return LayoutBuilder(
+      builder: (context, constraints) {
+        // Spikes matter more than shape for CPU, so keep each bucket's extremes
+        final data = historySpots(cpuProvider, HistoryMetric.cpu, cpuData, _window, constraints.maxWidth,
+            mode: DecimateMode.minMax);
+        return _buildChart(context, data);
+      },
+    );
+  }
+
+  Widget _buildChart(BuildContext context, HistorySpots data) {
+    if (data.spots.isEmpty) {
       return Center(
         child: Column(
           mainAxisAlignment: MainAxisAlignment.center,
@@ -209,11 +244,6 @@ class CpuChartCard extends StatelessWidget {
       );
     }
     
-    final spots = <FlSpot>[];
-    for (int i = 0; i < cpuData.length; i++) {
-      spots.add(FlSpot(i.toDouble(), cpuData[i]));
-    }
-    
     return Padding(
       padding: const EdgeInsets.only(right: 16, left: 6, top: 16, bottom: 16),
       child: LineChart(
@@ -223,9 +253,8 @@ class CpuChartCard extends StatelessWidget {
             touchTooltipData: LineTouchTooltipData(
               getTooltipItems: (List<LineBarSpot> touchedSpots) {
                 return touchedSpots.map((spot) {
-                  final int secondsAgo = cpuData.length - 1 - spot.x.toInt();
                   return LineTooltipItem(
-                    '${spot.y.toStringAsFixed(1)}%\n${secondsAgo == 0 ? 'now' : '$secondsAgo s ago'}',
+                    '${spot.y.toStringAsFixed(1)}%\n${HistorySpots.agoLabel(spot.x)}',
                     TextStyle(
                       color: Theme.of(context).colorScheme.primary,
                       fontWeight: FontWeight.bold,
@@ -239,7 +268,7 @@ class CpuChartCard extends StatelessWidget {
             show: true,
             drawVerticalLine: true,
             horizontalInterval: 20,
-            verticalInterval: 5,
+            verticalInterval: data.window.tick.inSeconds.toDouble(),
             getDrawingHorizontalLine: (value) {
               return FlLine(
                 color: Theme.of(context).dividerColor.withOpacity(0.15),
@@ -262,24 +291,24 @@ class CpuChartCard extends StatelessWidget {
               sideTitles: SideTitles(showTitles: false),
             ),
             bottomTitles: AxisTitles(
-              axisNameWidget: const Padding(
-                padding: EdgeInsets.only(top: 10.0),
-                child: Text('Last 30 seconds'),
+              axisNameWidget: Padding(
+                padding: const EdgeInsets.only(top: 10.0),
+                child: Text(data.window.label),
               ),
               axisNameSize: 20,
               sideTitles: SideTitles(
                 showTitles: true,
                 reservedSize: 30,
-                interval: 5,
+                interval: data.window.tick.inSeconds.toDouble(),
                 getTitlesWidget: (value, meta) {
-                  final int secondsAgo = cpuData.length - 1 - value.toInt();
-                  if (secondsAgo < 0 || value.toInt() % 5 != 0) {
+                  final label = data.axisLabel(value);
+                  if (label == null) {
                     return const SizedBox.shrink();
                   }
                   return Padding(
                     padding: const EdgeInsets.only(top: 8.0),
                     child: Text(
-                      secondsAgo == 0 ? 'now' : '-${secondsAgo}s',
+                      label,
                       style: TextStyle(
                         color: Theme.of(context).colorScheme.onSurface.withOpacity(0.6),
                         fontWeight: FontWeight.bold,
@@ -317,14 +346,14 @@ class CpuChartCard extends StatelessWidget {
             show: true,
             border: Border.all(color: Theme.of(context).dividerColor.withOpacity(0.3)),
           ),
-          minX: 0,
-          maxX: (spots.length - 1).toDouble(),
+          minX: data.minX,
+          maxX: 0,
           minY: 0,
           maxY: 100,
           lineBarsData: [
             LineChartBarData(
-              spots: spots,
-              isCurved: true,
+              spots: data.spots,
+              isCurved: data.window.live,
               curveSmoothness: 0.25,
               preventCurveOverShooting: true,
               color: Theme.of(context).colorScheme.primary,
@@ -0,0 +1,134 @@
+// ignore_for_file: deprecated_member_use
+
+import 'package:flutter/material.dart';
+import 'package:provider/provider.dart';
+import '../../models/system_stats.dart';
+import '../../services/cpu_provider.dart';
+import '../../theme/app_theme.dart';
+
+/// Per-device read/write throughput, latency and queue depth
+class DiskIoCard extends StatelessWidget {
+  const DiskIoCard({super.key});
+
+  @override
+  Widget build(BuildContext context) {
+    return Consumer<CpuProvider>(
+      builder: (context, provider, child) {
+        final theme = Theme.of(context);
+        final devices = provider.diskIo;
+
+        return Card(
+          elevation: 4,
+          clipBehavior: Clip.antiAlias,
+          shape: RoundedRectangleBorder(
+            borderRadius: BorderRadius.circular(16),
+            side: BorderSide(
+              color: Colors.grey.withOpacity(0.2),
+              width: 1,
+            ),
+          ),
+          child: Column(
+            crossAxisAlignment: CrossAxisAlignment.stretch,
+            children: [
+              // Header
+              Container(
+                color: AppTheme.primaryDark.withOpacity(0.08),
+                padding: const EdgeInsets.all(12),
+                child: Row(
+                  children: [
+                    Icon(
+                      Icons.swap_vert_rounded,
+                      color: AppTheme.primaryDark,
+                      size: 22,
+                    ),
+                    const SizedBox(width: 10),
+                    Text(
+                      'Disk I/O',
+                      style: theme.textTheme.titleMedium?.copyWith(
+                        fontWeight: FontWeight.bold,
+                      ),
+                    ),
+                  ],
+                ),
+              ),
+
+              Padding(
+                padding: const EdgeInsets.fromLTRB(16, 12, 16, 4),
+                child: _buildRow(
+                  context,
+                  const ['Device', 'Read', 'Write', 'IOPS', 'Latency', 'Busy'],
+                  header: true,
+                ),
+              ),
+              const Divider(height: 1),
+
+              if (devices.isEmpty)
+                Padding(
+                  padding: const EdgeInsets.all(24),
+                  child: Center(
+                    child: Text(
+                      'Disk I/O data not available',
+                      style: theme.textTheme.bodyMedium,
+                    ),
+                  ),
+                )
+              else
+                for (final device in devices)
+                  Padding(
+                    padding: const EdgeInsets.symmetric(horizontal: 16, vertical: 6),
+                    child: _buildDeviceRow(context, device),
+                  ),
+              const SizedBox(height: 8),
+            ],
+          ),
+        );
+      },
+    );
+  }
+
+  Widget _buildDeviceRow(BuildContext context, DiskIoStats device) {
+    return Tooltip(
+      message: '${device.name}: ${device.readIops.toStringAsFixed(0)} reads/s, '
+          '${device.writeIops.toStringAsFixed(0)} writes/s, '
+          '${device.inFlight} in flight',
+      child: _buildRow(context, [
+        device.name,
+        _formatRate(device.readBytesPerSec),
+        _formatRate(device.writeBytesPerSec),
+        (device.readIops + device.writeIops).toStringAsFixed(0),
+        '${device.awaitMs.toStringAsFixed(1)} ms',
+        '${device.utilization.toStringAsFixed(0)}%',
+      ]),
+    );
+  }
+
+  String _formatRate(double bytes) {
+    if (bytes >= 1024 * 1024) return '${(bytes / (1024 * 1024)).toStringAsFixed(1)} MB/s';
+    if (bytes >= 1024) return '${(bytes / 1024).toStringAsFixed(0)} kB/s';
+    return '${bytes.toStringAsFixed(0)} B/s';
+  }
+
+  Widget _buildRow(BuildContext context, List<String> cells, {bool header = false}) {
+    final style = TextStyle(
+      fontSize: header ? 12 : 13,
+      fontWeight: header ? FontWeight.w600 : FontWeight.w500,
+      color: header
+          ? Theme.of(context).textTheme.bodyMedium?.color?.withOpacity(0.7)
+          : Theme.of(context).textTheme.bodyLarge?.color,
+    );
+
+    return Row(
+      children: [
+        Expanded(
+          flex: 3,
+          child: Text(cells[0], style: style, maxLines: 1, overflow: TextOverflow.ellipsis),
+        ),
+        for (int i = 1; i < cells.length; i++)
+          Expanded(
+            flex: 2,
+            child: Text(cells[i], style: style, textAlign: TextAlign.right, maxLines: 1),
+          ),
+      ],
+    );
+  }
+}
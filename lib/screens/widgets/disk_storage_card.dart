@@ -2,6 +2,7 @@
 
 import 'package:flutter/material.dart';
 import 'package:provider/provider.dart';
+import '../../models/system_stats.dart';
 import '../../services/cpu_provider.dart';
 import '../../theme/app_theme.dart';
 import 'dart:math' as math;
@@ -78,7 +79,7 @@ class DiskStorageCard extends StatelessWidget {
                   // Main content area
                   Expanded(
                     child: isTall
-                        ? _buildDetailedContent(context, stats, diskUsagePercent, diskColor, isWide, constraints)
+                        ? _buildDetailedContent(context, stats, provider.mounts, diskUsagePercent, diskColor, isWide, constraints)
                         : _buildCompactContent(context, stats, diskUsagePercent, diskColor),
                   ),
                   
@@ -140,6 +141,7 @@ class DiskStorageCard extends StatelessWidget {
   Widget _buildDetailedContent(
     BuildContext context,
     dynamic stats,
+    List<MountStats> mounts,
     double diskUsagePercent,
     Color diskColor,
     bool isWide,
@@ -166,10 +168,13 @@ class DiskStorageCard extends StatelessWidget {
           
           const SizedBox(width: 12),
           
-          // Column 3: Storage categories
+          // Column 3: Every mounted filesystem, or storage categories
+          // when the native library cannot list mounts
           Expanded(
             flex: 2,
-            child: _buildStorageBreakdown(context, stats),
+            child: mounts.isNotEmpty
+                ? _buildMountList(context, mounts)
+                : _buildStorageBreakdown(context, stats),
           ),
         ],
       ),
@@ -411,6 +416,95 @@ class DiskStorageCard extends StatelessWidget {
     );
   }
   
+  // Mounted filesystems column
+  Widget _buildMountList(BuildContext context, List<MountStats> mounts) {
+    return Container(
+      decoration: BoxDecoration(
+        color: Theme.of(context).cardColor,
+        borderRadius: BorderRadius.circular(10),
+        border: Border.all(
+          color: Colors.grey.withOpacity(0.1),
+          width: 1,
+        ),
+      ),
+      padding: const EdgeInsets.all(12),
+      child: Column(
+        crossAxisAlignment: CrossAxisAlignment.start,
+        children: [
+          Text(
+            'Mounts (${mounts.length})',
+            style: TextStyle(
+              fontWeight: FontWeight.bold,
+              fontSize: 14,
+              color: Theme.of(context).textTheme.titleMedium?.color,
+            ),
+          ),
+          const Divider(height: 24),
+          
+          Expanded(
+            child: ListView.separated(
+              padding: EdgeInsets.zero,
+              itemCount: mounts.length,
+              separatorBuilder: (context, index) => const SizedBox(height: 12),
+              itemBuilder: (context, index) => _buildMountItem(context, mounts[index]),
+            ),
+          ),
+        ],
+      ),
+    );
+  }
+  
+  // One filesystem in the mounts column
+  Widget _buildMountItem(BuildContext context, MountStats mount) {
+    final color = _getDiskUsageColor(mount.usagePercent);
+    
+    return Tooltip(
+      message: '${mount.device} (${mount.fsType})\n'
+          '${_formatSize(mount.usedMb.toInt())} of ${_formatSize(mount.totalMb.toInt())} used, '
+          '${_formatSize(mount.availableMb.toInt())} available',
+      child: Column(
+        crossAxisAlignment: CrossAxisAlignment.start,
+        mainAxisSize: MainAxisSize.min,
+        children: [
+          Row(
+            children: [
+              Expanded(
+                child: Text(
+                  mount.mountPoint,
+                  style: const TextStyle(
+                    fontSize: 13,
+                    fontWeight: FontWeight.w500,
+                  ),
+                  maxLines: 1,
+                  overflow: TextOverflow.ellipsis,
+                ),
+              ),
+              const SizedBox(width: 8),
+              Text(
+                '${mount.usagePercent.toStringAsFixed(0)}%',
+                style: TextStyle(
+                  fontSize: 12,
+                  color: color,
+                  fontWeight: FontWeight.bold,
+                ),
+              ),
+            ],
+          ),
+          const SizedBox(height: 4),
+          ClipRRect(
+            borderRadius: BorderRadius.circular(2),
+            child: LinearProgressIndicator(
+              value: (mount.usagePercent / 100).clamp(0.0, 1.0),
+              backgroundColor: color.withOpacity(0.1),
+              valueColor: AlwaysStoppedAnimation<Color>(color),
+              minHeight: 4,
+            ),
+          ),
+        ],
+      ),
+    );
+  }
+  
   // Storage detail item for the second column
   Widget _buildStorageDetail(
     BuildContext context,
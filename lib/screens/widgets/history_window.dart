@@ -0,0 +1,118 @@
+import 'dart:math';
+
+import 'package:fl_chart/fl_chart.dart';
+import 'package:flutter/material.dart';
+
+import '../../services/cpu_provider.dart';
+import '../../services/native_structs.dart';
+
+/// A time span a history chart can show
+class HistoryWindow {
+  final Duration span;
+  final String label;
+  final String shortLabel;
+
+  /// Spacing of the time axis labels
+  final Duration tick;
+
+  const HistoryWindow(this.span, this.label, this.shortLabel, this.tick);
+
+  /// The live view: the smoothed recent samples, one per second
+  bool get live => identical(this, historyWindows.first);
+}
+
+const historyWindows = [
+  HistoryWindow(Duration(seconds: 30), 'Last 30 seconds', '30s', Duration(seconds: 5)),
+  HistoryWindow(Duration(minutes: 15), 'Last 15 minutes', '15m', Duration(minutes: 3)),
+  HistoryWindow(Duration(hours: 1), 'Last hour', '1h', Duration(minutes: 10)),
+  HistoryWindow(Duration(hours: 24), 'Last 24 hours', '24h', Duration(hours: 4)),
+  HistoryWindow(Duration(days: 7), 'Last 7 days', '7d', Duration(days: 1)),
+];
+
+/// Points of a history chart, x in seconds before now
+class HistorySpots {
+  final List<FlSpot> spots;
+  final double minX;
+
+  /// The window actually drawn; the live one when nothing longer is kept
+  final HistoryWindow window;
+
+  const HistorySpots(this.spots, this.minX, this.window);
+
+  /// Axis label for [value], or null between ticks
+  String? axisLabel(double value) {
+    final seconds = -value.round();
+    final tick = window.tick.inSeconds;
+    if (seconds < 0 || seconds % tick != 0) return null;
+    if (seconds == 0) return 'now';
+    if (tick < 60) return '-${seconds}s';
+    if (tick < 3600) return '-${seconds ~/ 60}m';
+    if (tick < 86400) return '-${seconds ~/ 3600}h';
+    return '-${seconds ~/ 86400}d';
+  }
+
+  /// Tooltip age of a point at [value]
+  static String agoLabel(double value) {
+    final seconds = -value.round();
+    if (seconds <= 0) return 'now';
+    if (seconds < 120) return '$seconds s ago';
+    if (seconds < 7200) return '${seconds ~/ 60} min ago';
+    if (seconds < 172800) return '${(seconds / 3600).toStringAsFixed(1)} h ago';
+    return '${(seconds / 86400).toStringAsFixed(1)} d ago';
+  }
+}
+
+/// Spots of [metric] over [window]. The live window plots [recent] as is;
+/// longer ones are decimated natively to about two points per pixel of
+/// [width], so drawing a week costs the same as drawing a minute.
+HistorySpots historySpots(CpuProvider provider, int metric, List<double> recent, HistoryWindow window, double width,
+    {int mode = DecimateMode.lttb}) {
+  if (!window.live) {
+    final series = provider.chartSeries(metric, window.span, max(2, (width * 2).round()), mode: mode);
+    if (series != null) {
+      return HistorySpots(
+        [for (var i = 0; i < series.length; i++) FlSpot(series.x[i], series.y[i])],
+        -window.span.inSeconds.toDouble(),
+        window,
+      );
+    }
+  }
+
+  final newest = recent.length - 1;
+  return HistorySpots(
+    [for (var i = 0; i < recent.length; i++) FlSpot((i - newest).toDouble(), recent[i])],
+    -max(newest, 1).toDouble(),
+    historyWindows.first,
+  );
+}
+
+/// Compact picker for a chart's [HistoryWindow]
+class HistoryWindowSelector extends StatelessWidget {
+  final HistoryWindow value;
+  final ValueChanged<HistoryWindow> onChanged;
+
+  const HistoryWindowSelector({
+    super.key,
+    required this.value,
+    required this.onChanged,
+  });
+
+  @override
+  Widget build(BuildContext context) {
+    return DropdownButtonHideUnderline(
+      child: DropdownButton<HistoryWindow>(
+        value: value,
+        isDense: true,
+        borderRadius: BorderRadius.circular(8),
+        style: Theme.of(context).textTheme.bodySmall?.copyWith(fontWeight: FontWeight.bold),
+        items: [
+          for (final window in historyWindows)
+            DropdownMenuItem(value: window, child: Text(window.shortLabel)),
+        ],
+        onChanged: (window) {
+          if (window != null) onChanged(window);
+        },
+      ),
+    );
+  }
+}
@@ -6,13 +6,22 @@ import 'package:provider/provider.dart';
 
 import '../../models/system_stats.dart';
 import '../../services/cpu_provider.dart';
+import '../../services/native_structs.dart';
 import '../../theme/app_theme.dart';
+import 'history_window.dart';
 
-class MemoryChartCard extends StatelessWidget {
+class MemoryChartCard extends StatefulWidget {
   const MemoryChartCard({
     super.key,
   });
 
+  @override
+  State<MemoryChartCard> createState() => _MemoryChartCardState();
+}
+
+class _MemoryChartCardState extends State<MemoryChartCard> {
+  HistoryWindow _window = historyWindows.first;
+
   @override
   Widget build(BuildContext context) {
     final cpuProvider = Provider.of<CpuProvider>(context);
@@ -46,6 +55,11 @@ class MemoryChartCard extends StatelessWidget {
                 const SizedBox(width: 6),
                 Text('Memory Usage', style: Theme.of(context).textTheme.titleLarge),
                 const Spacer(),
+                HistoryWindowSelector(
+                  value: _window,
+                  onChanged: (window) => setState(() => _window = window),
+                ),
+                const SizedBox(width: 8),
                 _buildMemoryIndicator(context, memoryPercentage),
               ],
             ),
@@ -137,8 +151,17 @@ class MemoryChartCard extends StatelessWidget {
     final cpuProvider = Provider.of<CpuProvider>(context);
     final memoryData = cpuProvider.smoothedMemoryHistory;
     
+    return LayoutBuilder(
+      builder: (context, constraints) {
+        final data = historySpots(cpuProvider, HistoryMetric.memory, memoryData, _window, constraints.maxWidth);
+        return _buildChart(context, data);
+      },
+    );
+  }
+
+  Widget _buildChart(BuildContext context, HistorySpots data) {
     // If no data, show loading state
-    if (memoryData.isEmpty) {
+    if (data.spots.isEmpty) {
       return Center(
         child: Column(
           mainAxisAlignment: MainAxisAlignment.center,
@@ -159,11 +182,6 @@ class MemoryChartCard extends StatelessWidget {
       );
     }
     
-    final spots = <FlSpot>[];
-    for (int i = 0; i < memoryData.length; i++) {
-      spots.add(FlSpot(i.toDouble(), memoryData[i]));
-    }
-    
     return Padding(
       padding: const EdgeInsets.only(right: 16, left: 6, top: 8, bottom: 8),
       child: LineChart(
@@ -173,9 +191,8 @@ class MemoryChartCard extends StatelessWidget {
             touchTooltipData: LineTouchTooltipData(
               getTooltipItems: (List<LineBarSpot> touchedSpots) {
                 return touchedSpots.map((spot) {
-                  final int secondsAgo = memoryData.length - 1 - spot.x.toInt();
                   return LineTooltipItem(
-                    '${spot.y.toStringAsFixed(1)}%\n${secondsAgo == 0 ? 'now' : '$secondsAgo s ago'}',
+                    '${spot.y.toStringAsFixed(1)}%\n${HistorySpots.agoLabel(spot.x)}',
                     TextStyle(
                       color: Colors.purple,
                       fontWeight: FontWeight.bold,
@@ -189,7 +206,7 @@ class MemoryChartCard extends StatelessWidget {
             show: true,
             drawVerticalLine: true,
             horizontalInterval: 20,
-            verticalInterval: 5,
+            verticalInterval: data.window.tick.inSeconds.toDouble(),
             getDrawingHorizontalLine: (value) {
               return FlLine(
                 color: Theme.of(context).dividerColor.withOpacity(0.15),
@@ -212,24 +229,24 @@ class MemoryChartCard extends StatelessWidget {
               sideTitles: SideTitles(showTitles: false),
             ),
             bottomTitles: AxisTitles(
-              axisNameWidget: const Padding(
-                padding: EdgeInsets.only(top: 8.0),
-                child: Text('Last 30 seconds', style: TextStyle(fontSize: 12)),
+              axisNameWidget: Padding(
+                padding: const EdgeInsets.only(top: 8.0),
+                child: Text(data.window.label, style: const TextStyle(fontSize: 12)),
               ),
               axisNameSize: 16,
               sideTitles: SideTitles(
                 showTitles: true,
                 reservedSize: 30,
-                interval: 5,
+                interval: data.window.tick.inSeconds.toDouble(),
                 getTitlesWidget: (value, meta) {
-                  final int secondsAgo = memoryData.length - 1 - value.toInt();
-                  if (secondsAgo < 0 || value.toInt() % 5 != 0) {
+                  final label = data.axisLabel(value);
+                  if (label == null) {
                     return const SizedBox.shrink();
                   }
                   return Padding(
                     padding: const EdgeInsets.only(top: 8.0),
                     child: Text(
-                      secondsAgo == 0 ? 'now' : '-${secondsAgo}s',
+                      label,
                       style: TextStyle(
                         color: Theme.of(context).colorScheme.onSurface.withOpacity(0.6),
                         fontWeight: FontWeight.bold,
@@ -267,14 +284,14 @@ class MemoryChartCard extends StatelessWidget {
             show: true,
             border: Border.all(color: Theme.of(context).dividerColor.withOpacity(0.3)),
           ),
-          minX: 0,
-          maxX: (spots.length - 1).toDouble(),
+          minX: data.minX,
+          maxX: 0,
           minY: 0,
           maxY: 100,
           lineBarsData: [
             LineChartBarData(
-              spots: spots,
-              isCurved: true,
+              spots: data.spots,
+              isCurved: data.window.live,
               curveSmoothness: 0.25,
               preventCurveOverShooting: true,
               color: Colors.purple,
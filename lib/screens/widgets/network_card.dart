@@ -0,0 +1,136 @@
+// ignore_for_file: deprecated_member_use
+
+import 'package:flutter/material.dart';
+import 'package:provider/provider.dart';
+import '../../models/system_stats.dart';
+import '../../services/cpu_provider.dart';
+import '../../theme/app_theme.dart';
+
+/// Receive and transmit rates of every network interface
+class NetworkCard extends StatelessWidget {
+  const NetworkCard({super.key});
+
+  @override
+  Widget build(BuildContext context) {
+    return Consumer<CpuProvider>(
+      builder: (context, provider, child) {
+        final theme = Theme.of(context);
+        final interfaces = provider.network;
+
+        return Card(
+          elevation: 4,
+          clipBehavior: Clip.antiAlias,
+          shape: RoundedRectangleBorder(
+            borderRadius: BorderRadius.circular(16),
+            side: BorderSide(
+              color: Colors.grey.withOpacity(0.2),
+              width: 1,
+            ),
+          ),
+          child: Column(
+            crossAxisAlignment: CrossAxisAlignment.stretch,
+            children: [
+              // Header
+              Container(
+                color: AppTheme.primaryDark.withOpacity(0.08),
+                padding: const EdgeInsets.all(12),
+                child: Row(
+                  children: [
+                    Icon(
+                      Icons.lan_rounded,
+                      color: AppTheme.primaryDark,
+                      size: 22,
+                    ),
+                    const SizedBox(width: 10),
+                    Text(
+                      'Network',
+                      style: theme.textTheme.titleMedium?.copyWith(
+                        fontWeight: FontWeight.bold,
+                      ),
+                    ),
+                  ],
+                ),
+              ),
+
+              Padding(
+                padding: const EdgeInsets.fromLTRB(16, 12, 16, 4),
+                child: _buildRow(
+                  context,
+                  const ['Interface', 'Receive', 'Send', 'Packets/s', 'Errors/s', 'Drops/s'],
+                  header: true,
+                ),
+              ),
+              const Divider(height: 1),
+
+              if (interfaces.isEmpty)
+                Padding(
+                  padding: const EdgeInsets.all(24),
+                  child: Center(
+                    child: Text(
+                      'Network data not available',
+                      style: theme.textTheme.bodyMedium,
+                    ),
+                  ),
+                )
+              else
+                for (final iface in interfaces)
+                  Padding(
+                    padding: const EdgeInsets.symmetric(horizontal: 16, vertical: 6),
+                    child: _buildInterfaceRow(context, iface),
+                  ),
+              const SizedBox(height: 8),
+            ],
+          ),
+        );
+      },
+    );
+  }
+
+  Widget _buildInterfaceRow(BuildContext context, NetworkStats iface) {
+    final errors = iface.rxErrorsPerSec + iface.txErrorsPerSec;
+    final drops = iface.rxDropsPerSec + iface.txDropsPerSec;
+
+    return Tooltip(
+      message: '${iface.name}: ${iface.rxPacketsPerSec.toStringAsFixed(0)} packets/s in, '
+          '${iface.txPacketsPerSec.toStringAsFixed(0)} packets/s out',
+      child: _buildRow(context, [
+        iface.name,
+        _formatRate(iface.rxBytesPerSec),
+        _formatRate(iface.txBytesPerSec),
+        (iface.rxPacketsPerSec + iface.txPacketsPerSec).toStringAsFixed(0),
+        errors.toStringAsFixed(0),
+        drops.toStringAsFixed(0),
+      ]),
+    );
+  }
+
+  String _formatRate(double bytes) {
+    if (bytes >= 1024 * 1024) return '${(bytes / (1024 * 1024)).toStringAsFixed(1)} MB/s';
+    if (bytes >= 1024) return '${(bytes / 1024).toStringAsFixed(0)} kB/s';
+    return '${bytes.toStringAsFixed(0)} B/s';
+  }
+
+  Widget _buildRow(BuildContext context, List<String> cells, {bool header = false}) {
+    final style = TextStyle(
+      fontSize: header ? 12 : 13,
+      fontWeight: header ? FontWeight.w600 : FontWeight.w500,
+      color: header
+          ? Theme.of(context).textTheme.bodyMedium?.color?.withOpacity(0.7)
+          : Theme.of(context).textTheme.bodyLarge?.color,
+    );
+
+    return Row(
+      children: [
+        Expanded(
+          flex: 3,
+          child: Text(cells[0], style: style, maxLines: 1, overflow: TextOverflow.ellipsis),
+        ),
+        for (int i = 1; i < cells.length; i++)
+          Expanded(
+            flex: 2,
+            child: Text(cells[i], style: style, textAlign: TextAlign.right, maxLines: 1),
+          ),
+      ],
+    );
+  }
+}
@@ -0,0 +1,180 @@
+// ignore_for_file: deprecated_member_use
+
+import 'package:flutter/material.dart';
+import 'package:provider/provider.dart';
+import '../../models/system_stats.dart';
+import '../../services/cpu_provider.dart';
+import '../../services/native_structs.dart';
+import '../../theme/app_theme.dart';
+
+/// Pressure stall averages of CPU, memory and I/O, and a timeline of the
+/// moments a stall threshold was crossed
+class PressureCard extends StatelessWidget {
+  const PressureCard({super.key});
+
+  // Alerts shown in the timeline; the provider keeps more
+  static const int _timelineLength = 8;
+
+  @override
+  Widget build(BuildContext context) {
+    return Consumer<CpuProvider>(
+      builder: (context, provider, child) {
+        final theme = Theme.of(context);
+        final pressure = provider.pressure;
+        final alerts = provider.pressureAlerts;
+
+        return Card(
+          elevation: 4,
+          clipBehavior: Clip.antiAlias,
+          shape: RoundedRectangleBorder(
+            borderRadius: BorderRadius.circular(16),
+            side: BorderSide(
+              color: Colors.grey.withOpacity(0.2),
+              width: 1,
+            ),
+          ),
+          child: Column(
+            crossAxisAlignment: CrossAxisAlignment.stretch,
+            children: [
+              // Header
+              Container(
+                color: AppTheme.primaryDark.withOpacity(0.08),
+                padding: const EdgeInsets.all(12),
+                child: Row(
+                  children: [
+                    Icon(
+                      Icons.hourglass_bottom_rounded,
+                      color: AppTheme.primaryDark,
+                      size: 22,
+                    ),
+                    const SizedBox(width: 10),
+                    Text(
+                      'Pressure Stalls',
+                      style: theme.textTheme.titleMedium?.copyWith(
+                        fontWeight: FontWeight.bold,
+                      ),
+                    ),
+                  ],
+                ),
+              ),
+
+              if (pressure.isEmpty)
+                Padding(
+                  padding: const EdgeInsets.all(24),
+                  child: Center(
+                    child: Text(
+                      'Pressure stall information not available',
+                      style: theme.textTheme.bodyMedium,
+                    ),
+                  ),
+                )
+              else
+                for (final resource in pressure)
+                  Padding(
+                    padding: const EdgeInsets.fromLTRB(16, 10, 16, 0),
+                    child: _buildResource(context, resource),
+                  ),
+
+              Padding(
+                padding: const EdgeInsets.fromLTRB(16, 16, 16, 4),
+                child: Text(
+                  'Recent stalls',
+                  style: theme.textTheme.titleSmall?.copyWith(fontWeight: FontWeight.w600),
+                ),
+              ),
+              const Divider(height: 1),
+              if (alerts.isEmpty)
+                Padding(
+                  padding: const EdgeInsets.all(16),
+                  child: Text(
+                    'No thresholds crossed',
+                    style: theme.textTheme.bodySmall,
+                  ),
+                )
+              else
+                for (final alert in alerts.take(_timelineLength))
+                  Padding(
+                    padding: const EdgeInsets.symmetric(horizontal: 16, vertical: 6),
+                    child: _buildAlert(context, alert),
+                  ),
+              const SizedBox(height: 8),
+            ],
+          ),
+        );
+      },
+    );
+  }
+
+  Widget _buildResource(BuildContext context, ResourcePressure resource) {
+    final theme = Theme.of(context);
+    final full = resource.hasFull ? ', full ${resource.fullAvg10.toStringAsFixed(1)}%' : '';
+
+    return Tooltip(
+      message: 'Some: ${resource.someAvg60.toStringAsFixed(1)}% over 1 min, '
+          '${resource.someAvg300.toStringAsFixed(1)}% over 5 min',
+      child: Column(
+        crossAxisAlignment: CrossAxisAlignment.stretch,
+        children: [
+          Row(
+            children: [
+              Text(
+                PressureResource.names[resource.resource],
+                style: theme.textTheme.bodyMedium?.copyWith(fontWeight: FontWeight.w600),
+              ),
+              const Spacer(),
+              Text(
+                'some ${resource.someAvg10.toStringAsFixed(1)}%$full',
+                style: theme.textTheme.bodySmall,
+              ),
+            ],
+          ),
+          const SizedBox(height: 4),
+          ClipRRect(
+            borderRadius: BorderRadius.circular(4),
+            child: LinearProgressIndicator(
+              value: (resource.someAvg10 / 100).clamp(0.0, 1.0),
+              minHeight: 6,
+              backgroundColor: Colors.grey.withOpacity(0.15),
+              valueColor: AlwaysStoppedAnimation(_stallColor(resource.someAvg10)),
+            ),
+          ),
+        ],
+      ),
+    );
+  }
+
+  Widget _buildAlert(BuildContext context, PressureAlert alert) {
+    final theme = Theme.of(context);
+    final color = alert.full ? AppTheme.error : AppTheme.warning;
+
+    return Row(
+      children: [
+        Icon(Icons.circle, size: 10, color: color),
+        const SizedBox(width: 8),
+        Text(_formatTime(alert.time), style: theme.textTheme.bodySmall),
+        const SizedBox(width: 12),
+        Expanded(
+          child: Text(
+            '${PressureResource.names[alert.resource]} ${alert.full ? 'full' : 'some'} '
+            'over ${alert.thresholdPercent.toStringAsFixed(0)}%',
+            style: theme.textTheme.bodyMedium,
+            maxLines: 1,
+            overflow: TextOverflow.ellipsis,
+          ),
+        ),
+        Text('avg10 ${alert.avg10.toStringAsFixed(1)}%', style: theme.textTheme.bodySmall),
+      ],
+    );
+  }
+
+  Color _stallColor(double percent) {
+    if (percent >= 20) return AppTheme.error;
+    if (percent >= 5) return AppTheme.warning;
+    return AppTheme.success;
+  }
+
+  String _formatTime(DateTime time) {
+    String two(int value) => value.toString().padLeft(2, '0');
+    return '${two(time.hour)}:${two(time.minute)}:${two(time.second)}';
+  }
+}
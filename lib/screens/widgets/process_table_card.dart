@@ -0,0 +1,146 @@
+// ignore_for_file: deprecated_member_use
+
+import 'package:flutter/material.dart';
+import 'package:provider/provider.dart';
+import '../../models/process_stats.dart';
+import '../../services/cpu_provider.dart';
+import '../../services/native_structs.dart';
+import '../../theme/app_theme.dart';
+
+/// Table of the busiest processes on the host, sortable by CPU, memory or I/O
+class ProcessTableCard extends StatelessWidget {
+  const ProcessTableCard({super.key});
+
+  @override
+  Widget build(BuildContext context) {
+    return Consumer<CpuProvider>(
+      builder: (context, provider, child) {
+        final theme = Theme.of(context);
+        final processes = provider.topProcesses;
+
+        return Card(
+          elevation: 4,
+          clipBehavior: Clip.antiAlias,
+          shape: RoundedRectangleBorder(
+            borderRadius: BorderRadius.circular(16),
+            side: BorderSide(
+              color: Colors.grey.withOpacity(0.2),
+              width: 1,
+            ),
+          ),
+          child: Column(
+            crossAxisAlignment: CrossAxisAlignment.stretch,
+            children: [
+              // Header with sort selector
+              Container(
+                color: AppTheme.primaryDark.withOpacity(0.08),
+                padding: const EdgeInsets.all(12),
+                child: Row(
+                  children: [
+                    Icon(
+                      Icons.list_alt_rounded,
+                      color: AppTheme.primaryDark,
+                      size: 22,
+                    ),
+                    const SizedBox(width: 10),
+                    Expanded(
+                      child: Text(
+                        'Top Processes',
+                        style: theme.textTheme.titleMedium?.copyWith(
+                          fontWeight: FontWeight.bold,
+                        ),
+                      ),
+                    ),
+                    _buildSortChip(context, provider, 'CPU', ProcessSort.cpu),
+                    const SizedBox(width: 6),
+                    _buildSortChip(context, provider, 'Memory', ProcessSort.rss),
+                    const SizedBox(width: 6),
+                    _buildSortChip(context, provider, 'I/O', ProcessSort.io),
+                  ],
+                ),
+              ),
+
+              Padding(
+                padding: const EdgeInsets.fromLTRB(16, 12, 16, 4),
+                child: _buildRow(
+                  context,
+                  const ['Process', 'PID', 'CPU', 'Memory', 'I/O'],
+                  header: true,
+                ),
+              ),
+              const Divider(height: 1),
+
+              if (processes.isEmpty)
+                Padding(
+                  padding: const EdgeInsets.all(24),
+                  child: Center(
+                    child: Text(
+                      'Process data not available',
+                      style: theme.textTheme.bodyMedium,
+                    ),
+                  ),
+                )
+              else
+                for (final process in processes)
+                  Padding(
+                    padding: const EdgeInsets.symmetric(horizontal: 16, vertical: 6),
+                    child: _buildProcessRow(context, process),
+                  ),
+              const SizedBox(height: 8),
+            ],
+          ),
+        );
+      },
+    );
+  }
+
+  Widget _buildSortChip(BuildContext context, CpuProvider provider, String label, int sort) {
+    final selected = provider.processSort == sort;
+
+    return ChoiceChip(
+      label: Text(label, style: const TextStyle(fontSize: 12)),
+      selected: selected,
+      visualDensity: VisualDensity.compact,
+      selectedColor: AppTheme.primaryDark.withOpacity(0.2),
+      onSelected: (_) => provider.setProcessSort(sort),
+    );
+  }
+
+  Widget _buildProcessRow(BuildContext context, ProcessStats process) {
+    return Tooltip(
+      message: '${process.name} (${process.pid}), ${process.threads} '
+          '${process.threads == 1 ? 'thread' : 'threads'}',
+      child: _buildRow(context, [
+        process.name,
+        '${process.pid}',
+        '${process.cpuPercent.toStringAsFixed(1)}%',
+        process.rssString,
+        process.ioString,
+      ]),
+    );
+  }
+
+  Widget _buildRow(BuildContext context, List<String> cells, {bool header = false}) {
+    final style = TextStyle(
+      fontSize: header ? 12 : 13,
+      fontWeight: header ? FontWeight.w600 : FontWeight.w500,
+      color: header
+          ? Theme.of(context).textTheme.bodyMedium?.color?.withOpacity(0.7)
+          : Theme.of(context).textTheme.bodyLarge?.color,
+    );
+
+    return Row(
+      children: [
+        Expanded(
+          flex: 3,
+          child: Text(cells[0], style: style, maxLines: 1, overflow: TextOverflow.ellipsis),
+        ),
+        for (int i = 1; i < cells.length; i++)
+          Expanded(
+            flex: 2,
+            child: Text(cells[i], style: style, textAlign: TextAlign.right, maxLines: 1),
+          ),
+      ],
+    );
+  }
+}
@@ -0,0 +1,129 @@
+// ignore_for_file: deprecated_member_use
+
+import 'package:flutter/material.dart';
+import 'package:provider/provider.dart';
+import '../../models/system_stats.dart';
+import '../../services/cpu_provider.dart';
+import '../../services/native_structs.dart';
+import '../../theme/app_theme.dart';
+
+/// Every temperature and fan sensor, grouped by kind
+class SensorsCard extends StatelessWidget {
+  const SensorsCard({super.key});
+
+  @override
+  Widget build(BuildContext context) {
+    return Consumer<CpuProvider>(
+      builder: (context, provider, child) {
+        final theme = Theme.of(context);
+        final sensors = provider.sensors;
+
+        return Card(
+          elevation: 4,
+          clipBehavior: Clip.antiAlias,
+          shape: RoundedRectangleBorder(
+            borderRadius: BorderRadius.circular(16),
+            side: BorderSide(
+              color: Colors.grey.withOpacity(0.2),
+              width: 1,
+            ),
+          ),
+          child: Column(
+            crossAxisAlignment: CrossAxisAlignment.stretch,
+            children: [
+              // Header
+              Container(
+                color: AppTheme.primaryDark.withOpacity(0.08),
+                padding: const EdgeInsets.all(12),
+                child: Row(
+                  children: [
+                    Icon(
+                      Icons.thermostat_rounded,
+                      color: AppTheme.primaryDark,
+                      size: 22,
+                    ),
+                    const SizedBox(width: 10),
+                    Text(
+                      'Sensors',
+                      style: theme.textTheme.titleMedium?.copyWith(
+                        fontWeight: FontWeight.bold,
+                      ),
+                    ),
+                  ],
+                ),
+              ),
+
+              if (sensors.isEmpty)
+                Padding(
+                  padding: const EdgeInsets.all(24),
+                  child: Center(
+                    child: Text(
+                      'No temperature or fan sensors exposed',
+                      style: theme.textTheme.bodyMedium,
+                    ),
+                  ),
+                )
+              else
+                for (final sensor in sensors)
+                  Padding(
+                    padding: const EdgeInsets.symmetric(horizontal: 16, vertical: 6),
+                    child: _buildSensor(context, sensor),
+                  ),
+              const SizedBox(height: 8),
+            ],
+          ),
+        );
+      },
+    );
+  }
+
+  Widget _buildSensor(BuildContext context, SensorStats sensor) {
+    final theme = Theme.of(context);
+    final isFan = sensor.kind == SensorKind.fan;
+    final value = isFan
+        ? '${sensor.value.toStringAsFixed(0)} RPM'
+        : '${sensor.value.toStringAsFixed(1)}°C';
+
+    return Row(
+      children: [
+        SizedBox(
+          width: 100,
+          child: Text(
+            SensorKind.names[sensor.kind.clamp(0, SensorKind.names.length - 1)],
+            style: theme.textTheme.bodySmall,
+          ),
+        ),
+        Expanded(
+          child: Text(
+            '${sensor.chip} · ${sensor.label}',
+            style: theme.textTheme.bodyMedium,
+            maxLines: 1,
+            overflow: TextOverflow.ellipsis,
+          ),
+        ),
+        if (sensor.critical > 0)
+          Padding(
+            padding: const EdgeInsets.only(right: 12),
+            child: Text(
+              'crit ${sensor.critical.toStringAsFixed(0)}°C',
+              style: theme.textTheme.bodySmall,
+            ),
+          ),
+        Text(
+          value,
+          style: theme.textTheme.bodyMedium?.copyWith(
+            fontWeight: FontWeight.w600,
+            color: isFan ? null : _temperatureColor(sensor),
+          ),
+        ),
+      ],
+    );
+  }
+
+  Color _temperatureColor(SensorStats sensor) {
+    final limit = sensor.critical > 0 ? sensor.critical : 100.0;
+    if (sensor.value >= limit - 10) return AppTheme.error;
+    if (sensor.value >= limit - 25) return AppTheme.warning;
+    return AppTheme.success;
+  }
+}
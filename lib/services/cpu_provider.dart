@@ -1,9 +1,13 @@
 import 'dart:async';
+import 'dart:collection';
 import 'dart:math';
 import 'dart:io';
+import 'dart:typed_data';
 import 'package:flutter/foundation.dart';
 import 'package:real_time_monitoring_dashboard/models/system_info.dart';
 import 'package:real_time_monitoring_dashboard/services/cpu_services.dart';
+import 'package:real_time_monitoring_dashboard/services/native_structs.dart';
+import '../models/process_stats.dart';
 import '../models/system_stats.dart';
 
 class CpuProvider extends ChangeNotifier {
@@ -19,22 +23,302 @@ class CpuProvider extends ChangeNotifier {
   );
   SystemInfo _systemInfo = SystemInfo();
   Timer? _updateTimer;
+  StreamSubscription<SystemStats>? _snapshotSubscription;
   bool _isMonitoring = false;
   bool _nativeLibraryLoaded = false;
+  bool _samplerRunning = false;
+  Duration _interval = const Duration(seconds: 1);
   
-  // Track histories
+  // Reading a collector daemon's shared segment instead of sampling here
+  bool _sharedSegment = false;
+  
+  // Every collector on its own native schedule: stable metrics back off,
+  // busy ones tighten and a hidden dashboard barely samples. The tick is
+  // then a one-shot timer armed for the next due collector.
+  bool _adaptive = false;
+  
+  // On-disk history; appended to while this process samples and holds it
+  bool _historyDatabase = false;
+  
+  // Decimated on-disk ranges with the time they were read; reread once the
+  // window has moved by a bucket
+  final Map<(int, Duration, int, int), (DateTime, ChartSeries)> _chartCache = {};
+  
+  // Track histories. When the native sampler runs, history lives in native
+  // ring buffers and these lists are only used for simulated data.
   final List<double> _cpuHistory = [];
   final List<double> _memoryHistory = [];
   final List<double> _diskHistory = [];
   final int _maxHistoryPoints = 30;
+  bool _nativeHistory = false;
+  
+  // Samples per moving average; matches HISTORY_STAT_WINDOW on the native side
+  static const int _smoothingWindow = 3;
+  
+  // Cost of the native collectors, refreshed every tick
+  List<CollectorLatency> _collectionCost = const [];
+  
+  // Top processes, refreshed every tick when the native library lists them
+  List<ProcessStats> _topProcesses = const [];
+  int _processSort = ProcessSort.cpu;
+  
+  // Every real filesystem, refreshed every tick
+  List<MountStats> _mounts = const [];
+  
+  // Block device throughput, refreshed every tick
+  List<DiskIoStats> _diskIo = const [];
+  
+  // Network interface throughput, refreshed every tick
+  List<NetworkStats> _network = const [];
+  
+  // Temperature and fan sensors, refreshed every tick
+  List<SensorStats> _sensors = const [];
+  
+  // The container's CPU and memory against its cgroup limits, refreshed
+  // every tick; null until read or when unsupported
+  ContainerStats? _container;
+  
+  // Pressure stall averages, refreshed every tick and whenever a native PSI
+  // trigger fires; alerts are the newest threshold crossings, newest first
+  List<ResourcePressure> _pressure = const [];
+  final List<PressureAlert> _pressureAlerts = [];
+  final int _maxPressureAlerts = 50;
+  int _lastPressureSequence = 0;
+  bool _pressureMonitorRunning = false;
+  
+  // The host's cgroup tree, read only while a page that shows it is open.
+  // [_cgroupPath] is the breadcrumb from the root down to the group whose
+  // children are listed; its last entry is that group.
+  int _cgroupWatchers = 0;
+  List<CgroupStats> _cgroupPath = const [];
+  List<CgroupStats> _cgroupChildren = const [];
+  int _cgroupSort = CgroupSort.cpu;
+  
+  // Native burst sampler rate, 0 when it is off. The widget that draws its
+  // frames takes them once per UI frame and redraws itself, so starting,
+  // stopping and reading it never notify.
+  int _burstRateHz = 0;
   
   SystemStats get stats => _stats;
   SystemInfo get systemInfo => _systemInfo;
   bool get isMonitoring => _isMonitoring;
-  List<double> get cpuHistory => List.unmodifiable(_cpuHistory);
-  List<double> get memoryHistory => List.unmodifiable(_memoryHistory);
-  List<double> get diskHistory => List.unmodifiable(_diskHistory);
+  List<double> get cpuHistory => _recentHistory(HistoryMetric.cpu, _cpuHistory);
+  List<double> get memoryHistory => _recentHistory(HistoryMetric.memory, _memoryHistory);
+  List<double> get diskHistory => _recentHistory(HistoryMetric.disk, _diskHistory);
   bool get nativeLibraryLoaded => _nativeLibraryLoaded;
+  List<CollectorLatency> get collectionCost => _collectionCost;
+  List<ProcessStats> get topProcesses => _topProcesses;
+  int get processSort => _processSort;
+  bool get hasProcessTable => _cpuService.hasProcessTable;
+  List<MountStats> get mounts => _mounts;
+  List<DiskIoStats> get diskIo => _diskIo;
+  bool get hasDiskIo => _cpuService.hasDiskIo;
+  List<NetworkStats> get network => _network;
+  bool get hasNetworkIo => _cpuService.hasNetworkIo;
+  List<SensorStats> get sensors => _sensors;
+  bool get hasSensors => _cpuService.hasSensors;
+  ContainerStats? get container => _container;
+  bool get hasCgroup => _cpuService.hasCgroup;
+  List<ResourcePressure> get pressure => _pressure;
+  List<PressureAlert> get pressureAlerts => UnmodifiableListView(_pressureAlerts);
+  bool get hasPressure => _cpuService.hasPressure;
+  bool get hasBurstSampler => _nativeLibraryLoaded && _cpuService.hasBurstSampler;
+  int get burstRateHz => _burstRateHz;
+  bool get hasCgroupTree => _nativeLibraryLoaded && _cpuService.hasCgroupTree;
+  List<CgroupStats> get cgroupPath => _cgroupPath;
+  List<CgroupStats> get cgroupChildren => _cgroupChildren;
+  int get cgroupSort => _cgroupSort;
+  
+  /// Keep the cgroup tree fresh until the matching [unwatchCgroupTree].
+  /// Walking thousands of groups is not free, so nothing reads the tree
+  /// while no page shows it.
+  void watchCgroupTree() {
+    if (!hasCgroupTree) return;
+    if (_cgroupWatchers++ > 0) return;
+    _refreshCgroupTree();
+    notifyListeners();
+  }
+  
+  void unwatchCgroupTree() {
+    if (_cgroupWatchers == 0) return;
+    _cgroupWatchers--;
+  }
+  
+  /// List the children of group [id]; 0 goes back to the root. A group
+  /// already on the breadcrumb cuts the breadcrumb back to it.
+  void openCgroup(int id) {
+    if (!hasCgroupTree) return;
+    final index = _cgroupPath.indexWhere((g) => g.id == id);
+    if (index >= 0) {
+      _cgroupPath = _cgroupPath.sublist(0, index + 1);
+    } else {
+      final group = _cpuService.getCgroupNode(id);
+      if (group == null) return;
+      _cgroupPath = id == 0 || _cgroupPath.isEmpty ? [group] : [..._cgroupPath, group];
+    }
+    _cgroupChildren = _cpuService.getCgroupChildren(_cgroupPath.last.id, _cgroupSort);
+    notifyListeners();
+  }
+  
+  void setCgroupSort(int sort) {
+    if (sort == _cgroupSort) return;
+    _cgroupSort = sort;
+    if (_cgroupPath.isNotEmpty) {
+      _cgroupChildren = _cpuService.getCgroupChildren(_cgroupPath.last.id, _cgroupSort);
+    }
+    notifyListeners();
+  }
+  
+  /// Re-read the tree and the listed level. A group that went away takes
+  /// the breadcrumb back to its closest surviving ancestor.
+  void _refreshCgroupTree() {
+    if (_cpuService.refreshCgroupTree() < 0) {
+      _cgroupPath = const [];
+      _cgroupChildren = const [];
+      return;
+    }
+    final path = <CgroupStats>[];
+    for (final group in _cgroupPath.isEmpty ? const [CgroupStats(id: 0, name: '/')] : _cgroupPath) {
+      final fresh = _cpuService.getCgroupNode(path.isEmpty ? 0 : group.id);
+      if (fresh == null) break;
+      path.add(fresh);
+    }
+    _cgroupPath = path;
+    _cgroupChildren = path.isEmpty ? const [] : _cpuService.getCgroupChildren(path.last.id, _cgroupSort);
+  }
+  
+  /// Sample CPU and CPU stall natively at [rateHz] (see [burstMinRateHz])
+  /// until [stopBurst]
+  bool startBurst(int rateHz) {
+    if (!hasBurstSampler) return false;
+    final rate = rateHz.clamp(burstMinRateHz, burstMaxRateHz);
+    if (!_cpuService.startBurstSampler(rate)) return false;
+    _burstRateHz = rate;
+    return true;
+  }
+  
+  void stopBurst() {
+    if (_burstRateHz == 0) return;
+    _cpuService.stopBurstSampler();
+    _burstRateHz = 0;
+  }
+  
+  /// Aggregates of the burst samples since the previous call; null when the
+  /// burst sampler is off. Call once per frame.
+  BurstFrameStats? takeBurstFrame() {
+    if (_burstRateHz == 0) return null;
+    return _cpuService.readBurstFrame();
+  }
+  
+  /// Change the process table order (see [ProcessSort]) and refresh it
+  void setProcessSort(int sort) {
+    if (sort == _processSort) return;
+    _processSort = sort;
+    _topProcesses = _cpuService.getTopProcesses(_processSort);
+    notifyListeners();
+  }
+  
+  /// Full history of a metric at a given resolution (see [HistoryTier]).
+  /// Returns a zero-copy view of native memory, or null without native history.
+  Float64List? historyTier(int metric, {int tier = HistoryTier.raw, int field = HistoryField.avg}) {
+    if (!_nativeHistory) return null;
+    return _cpuService.getHistoryView(metric, tier: tier, field: field);
+  }
+  
+  /// A window statistic (see [WindowStat]) for every raw sample of a metric,
+  /// aligned with [historyTier]. Zero-copy, or null without native history.
+  Float64List? historyStat(int metric, int stat) {
+    if (!_nativeHistory) return null;
+    return _cpuService.getHistoryStatView(metric, stat);
+  }
+  
+  /// p50/p95/p99 of a metric over a sliding window (see [QuantileWindow]),
+  /// kept natively as samples arrive. Null without native history.
+  QuantileSummary? quantiles(int metric, int window) {
+    if (!_nativeHistory) return null;
+    return _cpuService.getHistoryQuantiles(metric, window);
+  }
+  
+  /// p50/p95/p99 of a metric between [from] and [to] from the hourly sketches
+  /// in the on-disk history, at hour granularity. Null without it.
+  QuantileSummary? historyQuantiles(int metric, DateTime from, DateTime to) {
+    if (!_historyDatabase) return null;
+    final sketch = _cpuService.readHistorySketch(metric, from, to);
+    return sketch == null ? null : _cpuService.sketchQuantiles(sketch);
+  }
+  
+  /// Samples of a metric between [from] and [to] from the on-disk history,
+  /// which outlives restarts and [refreshAllData]. Null without it.
+  HistoryRange? historyRange(int metric, DateTime from, DateTime to) {
+    if (!_historyDatabase) return null;
+    return _cpuService.readHistoryRange(metric, from, to);
+  }
+  
+  /// A metric over the last [window] reduced natively to at most [maxPoints]
+  /// for drawing (see [DecimateMode]); x is seconds before now, so <= 0.
+  /// Windows the raw ring covers are read from it in place; longer ones from
+  /// the on-disk history, or else the finest rollup tier that spans them.
+  /// Null without native history.
+  ChartSeries? chartSeries(int metric, Duration window, int maxPoints, {int mode = DecimateMode.lttb}) {
+    if (!_nativeHistory || !_cpuService.hasDecimation || maxPoints < 2) return null;
+    
+    final rawSpan = _interval * HistoryTier.capacity[HistoryTier.raw];
+    if (window > rawSpan && _historyDatabase) {
+      return _decimatedRange(metric, window, maxPoints, mode);
+    }
+    
+    var tier = HistoryTier.raw;
+    var step = _interval.inMilliseconds / 1000.0;
+    if (window > rawSpan) {
+      tier = window <= Duration(seconds: 10 * HistoryTier.capacity[HistoryTier.tenSeconds])
+          ? HistoryTier.tenSeconds
+          : HistoryTier.oneMinute;
+      step = tier == HistoryTier.tenSeconds ? 10.0 : 60.0;
+    }
+    
+    final last = (window.inMilliseconds / 1000.0 / step).ceil();
+    final series = _cpuService.decimateHistory(metric, tier: tier, last: last, target: maxPoints, mode: mode);
+    final view = historyTier(metric, tier: tier);
+    if (series == null || view == null) return null;
+    
+    // x holds indices into the newest `last` points; the newest is now
+    final newest = min(last, view.length) - 1;
+    for (var i = 0; i < series.length; i++) {
+      series.x[i] = (series.x[i] - newest) * step;
+    }
+    return series;
+  }
+  
+  ChartSeries? _decimatedRange(int metric, Duration window, int maxPoints, int mode) {
+    final key = (metric, window, maxPoints, mode);
+    final now = DateTime.now();
+    final cached = _chartCache[key];
+    var series = cached?.$2;
+    if (cached == null || now.difference(cached.$1) * maxPoints > window) {
+      series = _cpuService.readHistoryRangeDecimated(metric, now.subtract(window), now, target: maxPoints, mode: mode);
+      if (series == null) return null;
+      if (_chartCache.length >= 16) _chartCache.clear();
+      _chartCache[key] = (now, series);
+    }
+    
+    final nowMs = now.millisecondsSinceEpoch;
+    return ChartSeries(
+      x: Float64List.fromList([for (final timestamp in series!.x) (timestamp - nowMs) / 1000.0]),
+      y: series.y,
+    );
+  }
+  
+  /// The newest [_maxHistoryPoints] raw samples of a metric, without copying
+  List<double> _recentHistory(int metric, List<double> fallback) {
+    final view = historyTier(metric);
+    if (view == null) return UnmodifiableListView(fallback);
+    return _newestPoints(view);
+  }
+  
+  List<double> _newestPoints(Float64List view) {
+    if (view.length <= _maxHistoryPoints) return view;
+    return Float64List.sublistView(view, view.length - _maxHistoryPoints).asUnmodifiableView();
+  }
   
   CpuProvider() {
     // Initialize the native library
@@ -123,24 +407,157 @@ class CpuProvider extends ChangeNotifier {
     if (_isMonitoring) return;
     
     _isMonitoring = true;
+    _interval = interval;
+    _adaptive = _nativeLibraryLoaded && _cpuService.hasScheduler;
+    _openHistoryDatabase();
+    
+    // A collector daemon on this host already samples everything; map its
+    // segment instead of sampling again, and sample here without one
+    if (_nativeLibraryLoaded && _cpuService.hasSharedSegment && _cpuService.attachSharedSegment()) {
+      _sharedSegment = true;
+      _nativeHistory = _cpuService.hasHistory;
+    } else {
+      _startInProcessSampler();
+    }
+    
+    // Stalls shorter than the tick interval wake the dashboard through PSI
+    // triggers instead of waiting for the next poll
+    if (_nativeLibraryLoaded && _cpuService.hasPressureMonitor) {
+      _startPressureMonitor();
+    }
+    
     _updateStats(); // Update immediately
     
-    // Set up periodic updates
+    // With push delivery the sampler thread drives every tick, so there is
+    // no timer and a slow tick cannot queue another behind it. On an
+    // adaptive schedule pushes carry the snapshot metrics and the timer
+    // only wakes for the collectors read here.
     _updateTimer?.cancel();
-    _updateTimer = Timer.periodic(interval, (_) => _updateStats());
+    _updateTimer = null;
+    if (_samplerRunning && _cpuService.hasSnapshotPush) {
+      _snapshotSubscription = _cpuService.snapshotStream().listen(
+        (snapshot) => _updateStats(pushed: snapshot, due: _adaptive ? 0 : null),
+        onError: (Object e) => debugPrint('Snapshot stream failed: $e'),
+      );
+    }
+    if (_adaptive) {
+      _scheduleTick();
+    } else if (_snapshotSubscription == null) {
+      _updateTimer = Timer.periodic(interval, (_) => _updateStats());
+    }
     notifyListeners();
   }
   
+  /// Arm the tick for the next due collector. Pushed snapshots already
+  /// cover the sampler's collectors; without them the tick reads those too.
+  /// A tick lands a few milliseconds after the due time so that the sampler
+  /// thread has published by then.
+  void _scheduleTick() {
+    _updateTimer?.cancel();
+    _updateTimer = null;
+    final mask = _snapshotSubscription != null
+        ? ScheduleCollector.uiMask
+        : ScheduleCollector.uiMask | ScheduleCollector.snapshotMask;
+    // Everything paused while hidden; setVisible() arms it again
+    final next = _cpuService.scheduleNext(mask);
+    if (next == null) return;
+    _updateTimer = Timer(next + const Duration(milliseconds: 5), () {
+      _updateStats(due: _cpuService.scheduleDue(ScheduleCollector.uiMask));
+      _scheduleTick();
+    });
+  }
+  
+  /// Whether the dashboard can be seen; hidden or minimised it samples
+  /// slowly and skips what only the screen shows
+  void setVisible(bool visible) {
+    if (!_adaptive) return;
+    _cpuService.setScheduleVisible(visible);
+    if (_isMonitoring) _scheduleTick();
+  }
+  
   /// Stop monitoring system statistics
   void stopMonitoring() {
     _updateTimer?.cancel();
+    _adaptive = false;
     _updateTimer = null;
+    _snapshotSubscription?.cancel();
+    _snapshotSubscription = null;
+    if (_samplerRunning) {
+      _cpuService.stopSampler();
+      _samplerRunning = false;
+    }
+    if (_sharedSegment) {
+      _leaveSharedSegment();
+    }
+    if (_pressureMonitorRunning) {
+      _cpuService.stopPressureMonitor();
+      _pressureMonitorRunning = false;
+    }
     _isMonitoring = false;
     notifyListeners();
   }
   
-  /// Update all system statistics from the native code
-  Future<void> _updateStats() async {
+  /// Let the native sampler thread collect off the UI isolate; ticks then
+  /// only copy its latest snapshot
+  void _startInProcessSampler() {
+    if (_nativeLibraryLoaded && _cpuService.hasSampler) {
+      _cpuService.setSamplerAdaptive(_adaptive);
+      _samplerRunning = _cpuService.startSampler(_interval);
+      _nativeHistory = _samplerRunning && _cpuService.hasHistory;
+    }
+  }
+  
+  /// Open the on-disk history once. Opening it for writing seeds the
+  /// history rings with the last hour, so this runs before the sampler.
+  void _openHistoryDatabase() {
+    if (_historyDatabase || !_nativeLibraryLoaded || !_cpuService.hasHistoryDatabase) return;
+    _historyDatabase = _cpuService.openHistoryDatabase();
+  }
+  
+  /// Unmap the daemon's segment; history reads local rings again
+  void _leaveSharedSegment() {
+    _cpuService.detachSharedSegment();
+    _sharedSegment = false;
+    _nativeHistory = false;
+  }
+  
+  /// Arm the default stall thresholds and start the native trigger thread.
+  /// Windows are 2 s so that unprivileged processes may register them.
+  void _startPressureMonitor() {
+    const window = Duration(seconds: 2);
+    _cpuService.clearPressureTriggers();
+    _cpuService.addPressureTrigger(PressureResource.cpu,
+        stall: const Duration(milliseconds: 400), window: window);
+    _cpuService.addPressureTrigger(PressureResource.memory,
+        stall: const Duration(milliseconds: 200), window: window);
+    _cpuService.addPressureTrigger(PressureResource.memory,
+        full: true, stall: const Duration(milliseconds: 100), window: window);
+    _cpuService.addPressureTrigger(PressureResource.io,
+        stall: const Duration(milliseconds: 400), window: window);
+    _cpuService.addPressureTrigger(PressureResource.io,
+        full: true, stall: const Duration(milliseconds: 200), window: window);
+    _pressureMonitorRunning = _cpuService.startPressureMonitor(_onPressure);
+  }
+  
+  /// A PSI threshold was crossed: record the new events and redraw now
+  void _onPressure(int resource) {
+    final alerts = _cpuService.readPressureEvents(_lastPressureSequence);
+    if (alerts.isEmpty) return;
+    
+    _lastPressureSequence = alerts.last.sequence;
+    _pressureAlerts.insertAll(0, alerts.reversed);
+    if (_pressureAlerts.length > _maxPressureAlerts) {
+      _pressureAlerts.removeRange(_maxPressureAlerts, _pressureAlerts.length);
+    }
+    _pressure = _cpuService.getPressure();
+    notifyListeners();
+  }
+  
+  /// Update all system statistics from the native code. A [pushed]
+  /// snapshot from the sampler thread is used as is. [due] limits the
+  /// collectors read here to those bits of [ScheduleCollector.uiMask];
+  /// null reads every one.
+  Future<void> _updateStats({SystemStats? pushed, int? due}) async {
     try {
       double cpuUsage;
       Map<String, int> memoryInfo;
@@ -148,8 +565,41 @@ class CpuProvider extends ChangeNotifier {
       double diskTotal;
       double diskUsage;
       double temperature;
+      List<CoreUsage> cores = const [];
       
-      if (_nativeLibraryLoaded) {
+      SystemStats? snapshot = pushed;
+      if (snapshot == null && _sharedSegment) {
+        snapshot = _cpuService.readSharedSnapshot();
+        // The daemon stopped publishing: collect in this process from now on
+        if (snapshot == null) {
+          _leaveSharedSegment();
+          // Reopen to take over writing the on-disk history from the daemon
+          if (_historyDatabase) {
+            _cpuService.closeHistoryDatabase();
+            _historyDatabase = _cpuService.openHistoryDatabase();
+          }
+          _startInProcessSampler();
+          return;
+        }
+      }
+      if (snapshot == null && _samplerRunning) {
+        snapshot = _cpuService.readLatestSnapshot();
+        // The sampler has not published its first sample yet
+        if (snapshot == null) return;
+      } else if (snapshot == null && _nativeLibraryLoaded) {
+        snapshot = await _cpuService.getSystemSnapshot();
+      }
+      
+      if (snapshot != null) {
+        // One native sample for every metric
+        cpuUsage = snapshot.cpuUsage;
+        memoryInfo = {'used': snapshot.memoryUsed, 'total': snapshot.memoryTotal};
+        diskUsed = snapshot.diskUsed;
+        diskTotal = snapshot.diskTotal;
+        diskUsage = snapshot.diskUsage;
+        temperature = snapshot.temperature;
+        cores = snapshot.cores;
+      } else if (_nativeLibraryLoaded) {
         // Get system stats using native code
         cpuUsage = await _cpuService.getCpuUsage();
         memoryInfo = await _cpuService.getMemoryInfo();
@@ -190,12 +640,20 @@ class CpuProvider extends ChangeNotifier {
         temperature: temperature,
         diskUsed: diskUsed,
         diskTotal: diskTotal,
+        cores: cores,
       );
       
-      // Update histories
-      _updateCpuHistory(cpuUsage);
-      _updateMemoryHistory(memTotal > 0 ? (memUsed / memTotal) * 100 : 0.0);
-      _updateDiskHistory(diskUsage);
+      // Update histories; the native sampler records its own
+      if (!_nativeHistory) {
+        _updateCpuHistory(cpuUsage);
+        _updateMemoryHistory(memTotal > 0 ? (memUsed / memTotal) * 100 : 0.0);
+        _updateDiskHistory(diskUsage);
+      }
+      
+      if (_nativeLibraryLoaded) {
+        _collectDue(due ?? ScheduleCollector.uiMask);
+        _collectionCost = _cpuService.getCollectorLatency();
+      }
       
       notifyListeners();
     } catch (e) {
@@ -203,6 +661,59 @@ class CpuProvider extends ChangeNotifier {
     }
   }
   
+  /// Read the dashboard's own collectors in [due] and, on an adaptive
+  /// schedule, report one figure for each so its interval can adapt
+  void _collectDue(int due) {
+    bool isDue(int collector) => (due & ScheduleCollector.bit(collector)) != 0;
+    
+    if (isDue(ScheduleCollector.processes)) {
+      _topProcesses = _cpuService.getTopProcesses(_processSort);
+      _report(ScheduleCollector.processes, _topProcesses.map((p) => p.cpuPercent));
+    }
+    if (isDue(ScheduleCollector.mounts)) {
+      _mounts = _cpuService.getMountUsage();
+      _report(ScheduleCollector.mounts, _mounts.map((m) => m.usagePercent));
+    }
+    if (isDue(ScheduleCollector.diskIo)) {
+      _diskIo = _cpuService.getDiskIo();
+      _report(ScheduleCollector.diskIo, [
+        _diskIo.where((d) => !d.isPartition).fold(0.0, (sum, d) => sum + d.readBytesPerSec + d.writeBytesPerSec) /
+            (1024 * 1024),
+      ]);
+    }
+    if (isDue(ScheduleCollector.network)) {
+      _network = _cpuService.getNetworkIo();
+      _report(ScheduleCollector.network, [
+        _network.fold(0.0, (sum, n) => sum + n.rxBytesPerSec + n.txBytesPerSec) / (1024 * 1024),
+      ]);
+    }
+    if (isDue(ScheduleCollector.sensors)) {
+      _sensors = _cpuService.getSensors();
+      _report(ScheduleCollector.sensors,
+          _sensors.where((s) => s.kind != SensorKind.fan).map((s) => s.value));
+    }
+    if (isDue(ScheduleCollector.container) && _cpuService.hasCgroup) {
+      _container = _cpuService.getCgroupUsage() ?? _container;
+      final cpu = _container?.cpuPercent ?? -1.0;
+      if (cpu >= 0) _report(ScheduleCollector.container, [cpu]);
+    }
+    if (isDue(ScheduleCollector.cgroups) && _cgroupWatchers > 0) {
+      _refreshCgroupTree();
+      _report(ScheduleCollector.cgroups, _cgroupChildren.map((g) => g.cpuPercent));
+    }
+    if (isDue(ScheduleCollector.pressure)) {
+      _pressure = _cpuService.getPressure();
+      _report(ScheduleCollector.pressure, _pressure.map((p) => p.someAvg10));
+    }
+  }
+  
+  /// Report the highest of [values] (throughput in MB/s, the rest in their
+  /// own units); nothing when there are none
+  void _report(int collector, Iterable<double> values) {
+    if (!_adaptive || values.isEmpty) return;
+    _cpuService.scheduleReport(collector, values.reduce(max));
+  }
+  
   /// Refresh system information
   Future<void> refreshSystemInfo() async {
     await _fetchSystemInfo();
@@ -233,48 +744,25 @@ class CpuProvider extends ChangeNotifier {
   }
   
   /// Get smoothed CPU history using moving average
-  List<double> get smoothedCpuHistory {
-    if (_cpuHistory.isEmpty) return [];
-    
-    final smoothedData = <double>[];
-    const windowSize = 3; // Smaller window size for more responsive visualization
-    
-    for (int i = 0; i < _cpuHistory.length; i++) {
-      double sum = 0;
-      int count = 0;
-      
-      // Calculate moving average for this point
-      for (int j = max(0, i - windowSize + 1); j <= i; j++) {
-        sum += _cpuHistory[j];
-        count++;
-      }
-      
-      smoothedData.add(sum / count);
-    }
-    
-    return smoothedData;
-  }
+  List<double> get smoothedCpuHistory => _smoothedHistory(HistoryMetric.cpu, cpuHistory);
   
   /// Get smoothed memory history using moving average
-  List<double> get smoothedMemoryHistory {
-    if (_memoryHistory.isEmpty) return [];
-    
-    final smoothedData = <double>[];
-    const windowSize = 3; // Same window size as CPU for consistency
+  List<double> get smoothedMemoryHistory => _smoothedHistory(HistoryMetric.memory, memoryHistory);
+  
+  /// Moving averages of the newest [_maxHistoryPoints] samples. The native
+  /// side keeps them per sample, so this is a view; otherwise one
+  /// running-sum pass over the recent samples in [fallback].
+  List<double> _smoothedHistory(int metric, List<double> fallback) {
+    final view = historyStat(metric, WindowStat.mean);
+    if (view != null) return _newestPoints(view);
     
-    for (int i = 0; i < _memoryHistory.length; i++) {
-      double sum = 0;
-      int count = 0;
-      
-      // Calculate moving average for this point
-      for (int j = max(0, i - windowSize + 1); j <= i; j++) {
-        sum += _memoryHistory[j];
-        count++;
-      }
-      
-      smoothedData.add(sum / count);
+    final smoothedData = Float64List(fallback.length);
+    double sum = 0;
+    for (int i = 0; i < fallback.length; i++) {
+      sum += fallback[i];
+      if (i >= _smoothingWindow) sum -= fallback[i - _smoothingWindow];
+      smoothedData[i] = sum / min(i + 1, _smoothingWindow);
     }
-    
     return smoothedData;
   }
   
@@ -287,10 +775,15 @@ class CpuProvider extends ChangeNotifier {
       stopMonitoring();
     }
     
-    // Clear existing history data for a fresh start
+    // Clear existing history data for a fresh start; the on-disk history
+    // is kept
     _cpuHistory.clear();
     _memoryHistory.clear();
     _diskHistory.clear();
+    _cpuService.clearHistory();
+    _cpuService.resetCollectorLatency();
+    _cpuService.invalidateStaticValues();
+    _chartCache.clear();
     
     // Reload all data
     await _updateStats();
@@ -307,6 +800,22 @@ class CpuProvider extends ChangeNotifier {
   @override
   void dispose() {
     _updateTimer?.cancel();
+    _snapshotSubscription?.cancel();
+    if (_samplerRunning) {
+      _cpuService.stopSampler();
+    }
+    if (_sharedSegment) {
+      _cpuService.detachSharedSegment();
+    }
+    if (_historyDatabase) {
+      _cpuService.closeHistoryDatabase();
+    }
+    if (_pressureMonitorRunning) {
+      _cpuService.stopPressureMonitor();
+    }
+    if (_burstRateHz > 0) {
+      _cpuService.stopBurstSampler();
+    }
     super.dispose();
   }
 }
\ No newline at end of file
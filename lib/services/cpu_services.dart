@@ -1,8 +1,16 @@
+import 'dart:async';
+import 'dart:convert';
 import 'dart:ffi';
 import 'dart:io';
+import 'dart:isolate';
+import 'dart:math';
+import 'dart:typed_data';
 import 'package:flutter/foundation.dart';
 import 'package:path/path.dart' as path;
 import 'package:ffi/ffi.dart'; // For Utf8 and other FFI utilities
+import '../models/process_stats.dart';
+import '../models/system_stats.dart';
+import 'native_structs.dart';
 
 /// A service to interact with native code for CPU and system monitoring
 class CpuService {
@@ -24,6 +32,128 @@ class CpuService {
   static Pointer<NativeFunction<Pointer<Char> Function()>>? _getKernelVersionPtr;
   static Pointer<NativeFunction<Int Function()>>? _getCpuCoreCountPtr;
   
+  // Batched snapshot, filled into one struct that is allocated once and
+  // reused for every tick
+  static int Function(Pointer<SystemSnapshot>)? _getSystemSnapshot;
+  static Pointer<SystemSnapshot>? _snapshot;
+  
+  // Snapshots posted by the sampler thread to a native port; only usable
+  // when the library was built against the Dart SDK's dart_api_dl.c
+  static int Function(int, double, int)? _setSnapshotPort;
+  static bool _dartApiReady = false;
+  
+  // Background native sampler
+  static int Function(int)? _startSampler;
+  static void Function()? _stopSampler;
+  static void Function(int)? _setSamplerInterval;
+  static int Function(Pointer<SystemSnapshot>)? _readLatestSnapshot;
+  
+  // Snapshots and history published by a collector daemon on this host,
+  // read from its shared memory segment
+  static int Function(Pointer<Char>)? _attachSharedSegment;
+  static int Function(Pointer<SystemSnapshot>)? _readSharedSnapshot;
+  static void Function()? _detachSharedSegment;
+  
+  // Native history rings, read through zero-copy views
+  static Pointer<Double> Function(int, int, int, Pointer<Int32>)? _getHistoryView;
+  static void Function()? _clearHistory;
+  static Pointer<Int32>? _historyLength;
+  static Pointer<Double> Function(int, int, Pointer<Int32>)? _getHistoryStatView;
+  
+  // Chart decimation, written into reusable native output buffers
+  static int Function(int, Pointer<Double>, Pointer<Double>, int, int, Pointer<Double>, Pointer<Double>)? _decimateSeries;
+  static int Function(int, int, int, int, int, int, Pointer<Double>, Pointer<Double>)? _decimateHistory;
+  static Pointer<Double>? _decimatedX;
+  static Pointer<Double>? _decimatedY;
+  static int _decimatedCapacity = 0;
+  
+  // Quantile sketches: sliding windows over the rings, hourly ones on disk,
+  // and encoded sketches passed through one shared buffer
+  static int Function(int, int, Pointer<Double>, int, Pointer<Double>)? _getHistoryQuantiles;
+  static int Function(int, int, Pointer<Uint8>, int)? _getHistorySketch;
+  static int Function(int, int, int, Pointer<Uint8>, int)? _readHistorySketch;
+  static int Function(Pointer<Uint8>, int, Pointer<Double>, int, Pointer<Double>)? _sketchQuantiles;
+  static int Function(Pointer<Uint8>, int, Pointer<Uint8>, int, Pointer<Uint8>, int)? _mergeQuantileSketches;
+  static Pointer<Uint8>? _sketchBuffer;
+  static Pointer<Uint8>? _sketchInput;
+  static Pointer<Double>? _quantileLevels;
+  static Pointer<Double>? _quantileValues;
+  
+  // Compressed history on disk, queried by time range
+  static int Function(Pointer<Char>)? _openHistoryDatabase;
+  static void Function()? _closeHistoryDatabase;
+  static int Function(int, int, int)? _getHistoryRangeCount;
+  static int Function(int, int, int, Pointer<Int64>, Pointer<Double>, int)? _readHistoryRange;
+  
+  // Per-collector latency histograms
+  static int Function(int, Pointer<LatencyStats>)? _getCollectorLatency;
+  static void Function(int)? _resetCollectorLatency;
+  static Pointer<LatencyStats>? _latencyStats;
+  
+  // Top-N process table, filled into a fixed array of rows
+  static const int maxProcessRows = 50;
+  static int Function(int, Pointer<ProcessUsage>, int)? _getTopProcesses;
+  static Pointer<ProcessUsage>? _processRows;
+  
+  // Mounted filesystems
+  static const int maxMountRows = 64;
+  static int Function(Pointer<MountUsage>, int)? _getMountUsage;
+  static Pointer<MountUsage>? _mountRows;
+  
+  // Block device throughput
+  static const int maxDiskIoRows = 64;
+  static int Function(Pointer<DiskIo>, int, int)? _getDiskIo;
+  static Pointer<DiskIo>? _diskIoRows;
+  
+  // Network interface throughput
+  static const int maxNetworkRows = 256;
+  static int Function(Pointer<NetIo>, int)? _getNetworkIo;
+  static Pointer<NetIo>? _networkRows;
+  
+  // Temperature and fan sensors
+  static const int maxSensorRows = 64;
+  static int Function(Pointer<SensorReading>, int)? _getSensors;
+  static Pointer<SensorReading>? _sensorRows;
+  
+  // High-frequency burst sampling, drained once per UI frame
+  static int Function(int)? _startBurstSampler;
+  static void Function()? _stopBurstSampler;
+  static int Function(Pointer<BurstFrame>)? _readBurstFrame;
+  static Pointer<BurstFrame>? _burstFrame;
+  
+  // Adaptive per-collector schedule and the sampler mode that follows it
+  static void Function(int)? _setSamplerAdaptive;
+  static void Function(int)? _setScheduleVisible;
+  static int Function(int)? _scheduleDue;
+  static int Function(int)? _scheduleNextMs;
+  static void Function(int, double)? _scheduleReport;
+  static void Function()? _invalidateStaticValues;
+  
+  // Container CPU and memory from the cgroup v2 group, or the host's
+  static int Function(Pointer<CgroupUsage>)? _getCgroupUsage;
+  static Pointer<Char> Function()? _getCgroupPath;
+  static Pointer<CgroupUsage>? _cgroupUsage;
+  
+  // Every cgroup on the host as a tree, read a level at a time
+  static const int maxCgroupRows = 50;
+  static int Function()? _refreshCgroupTree;
+  static int Function(int, int, Pointer<CgroupNode>, int)? _getCgroupChildren;
+  static int Function(int, Pointer<CgroupNode>)? _getCgroupNode;
+  static Pointer<CgroupNode>? _cgroupRows;
+  
+  // Pressure stall information, and the native thread that waits on PSI
+  // triggers and calls back into Dart when one fires
+  static const int maxPressureEvents = 64;
+  static int Function(int, Pointer<PressureStats>)? _getPressure;
+  static int Function(int, int, int, int)? _addPressureTrigger;
+  static void Function()? _clearPressureTriggers;
+  static int Function(Pointer<NativeFunction<Void Function(Int32)>>)? _startPressureMonitor;
+  static void Function()? _stopPressureMonitor;
+  static int Function(Pointer<PressureEvent>, int, int)? _readPressureEvents;
+  static Pointer<PressureStats>? _pressureStats;
+  static Pointer<PressureEvent>? _pressureEvents;
+  static NativeCallable<Void Function(Int32)>? _pressureCallback;
+  
   /// Initialize the native library
   static void initialize() {
     if (_dylib != null) return;
@@ -145,7 +275,993 @@ class CpuService {
     } catch (e) {
       debugPrint('Error initializing function pointers: $e');
       _dylib = null; // Reset library reference
+      return;
+    }
+    
+    // Optional entry points that older builds of the library may not export
+    final snapshotPtr = _lookupOptional<NativeFunction<Int Function(Pointer<SystemSnapshot>)>>('getSystemSnapshot');
+    if (snapshotPtr != null) {
+      _getSystemSnapshot = snapshotPtr.asFunction<int Function(Pointer<SystemSnapshot>)>();
+      _snapshot = calloc<SystemSnapshot>();
+    }
+    
+    final startSamplerPtr = _lookupOptional<NativeFunction<Int Function(Int)>>('startSampler');
+    final stopSamplerPtr = _lookupOptional<NativeFunction<Void Function()>>('stopSampler');
+    final setIntervalPtr = _lookupOptional<NativeFunction<Void Function(Int)>>('setSamplerInterval');
+    final readLatestPtr = _lookupOptional<NativeFunction<Int Function(Pointer<SystemSnapshot>)>>('readLatestSnapshot');
+    if (startSamplerPtr != null && stopSamplerPtr != null && setIntervalPtr != null &&
+        readLatestPtr != null && _snapshot != null) {
+      _startSampler = startSamplerPtr.asFunction<int Function(int)>();
+      _stopSampler = stopSamplerPtr.asFunction<void Function()>();
+      _setSamplerInterval = setIntervalPtr.asFunction<void Function(int)>();
+      _readLatestSnapshot = readLatestPtr.asFunction<int Function(Pointer<SystemSnapshot>)>();
+    }
+    
+    final attachSegmentPtr = _lookupOptional<NativeFunction<Int Function(Pointer<Char>)>>('attachSharedSegment');
+    final readSharedPtr = _lookupOptional<NativeFunction<Int Function(Pointer<SystemSnapshot>)>>('readSharedSnapshot');
+    final detachSegmentPtr = _lookupOptional<NativeFunction<Void Function()>>('detachSharedSegment');
+    if (attachSegmentPtr != null && readSharedPtr != null && detachSegmentPtr != null && _snapshot != null) {
+      _attachSharedSegment = attachSegmentPtr.asFunction<int Function(Pointer<Char>)>();
+      _readSharedSnapshot = readSharedPtr.asFunction<int Function(Pointer<SystemSnapshot>)>();
+      _detachSharedSegment = detachSegmentPtr.asFunction<void Function()>();
+    }
+    
+    final initDartApiPtr = _lookupOptional<NativeFunction<IntPtr Function(Pointer<Void>)>>('initDartApi');
+    final setSnapshotPortPtr = _lookupOptional<NativeFunction<Int Function(Int64, Double, Int)>>('setSnapshotPort');
+    if (initDartApiPtr != null && setSnapshotPortPtr != null) {
+      final initDartApi = initDartApiPtr.asFunction<int Function(Pointer<Void>)>();
+      _dartApiReady = initDartApi(NativeApi.initializeApiDLData) == 0;
+      _setSnapshotPort = setSnapshotPortPtr.asFunction<int Function(int, double, int)>();
+    }
+    
+    final historyViewPtr = _lookupOptional<NativeFunction<Pointer<Double> Function(Int, Int, Int, Pointer<Int32>)>>('getHistoryView');
+    final clearHistoryPtr = _lookupOptional<NativeFunction<Void Function()>>('clearHistory');
+    if (historyViewPtr != null && clearHistoryPtr != null) {
+      _getHistoryView = historyViewPtr.asFunction<Pointer<Double> Function(int, int, int, Pointer<Int32>)>();
+      _clearHistory = clearHistoryPtr.asFunction<void Function()>();
+      _historyLength = calloc<Int32>();
+    }
+    
+    final historyStatViewPtr = _lookupOptional<NativeFunction<Pointer<Double> Function(Int, Int, Pointer<Int32>)>>('getHistoryStatView');
+    if (historyStatViewPtr != null && _historyLength != null) {
+      _getHistoryStatView = historyStatViewPtr.asFunction<Pointer<Double> Function(int, int, Pointer<Int32>)>();
+    }
+    
+    final decimateSeriesPtr = _lookupOptional<NativeFunction<Int32 Function(Int, Pointer<Double>, Pointer<Double>, Int32, Int32, Pointer<Double>, Pointer<Double>)>>('decimateSeries');
+    final decimateHistoryPtr = _lookupOptional<NativeFunction<Int32 Function(Int, Int, Int, Int32, Int, Int32, Pointer<Double>, Pointer<Double>)>>('decimateHistory');
+    if (decimateSeriesPtr != null && decimateHistoryPtr != null) {
+      _decimateSeries = decimateSeriesPtr.asFunction<int Function(int, Pointer<Double>, Pointer<Double>, int, int, Pointer<Double>, Pointer<Double>)>(isLeaf: true);
+      _decimateHistory = decimateHistoryPtr.asFunction<int Function(int, int, int, int, int, int, Pointer<Double>, Pointer<Double>)>(isLeaf: true);
+    }
+    
+    final historyQuantilesPtr = _lookupOptional<NativeFunction<Int64 Function(Int, Int, Pointer<Double>, Int32, Pointer<Double>)>>('getHistoryQuantiles');
+    final historySketchPtr = _lookupOptional<NativeFunction<Int32 Function(Int, Int, Pointer<Uint8>, Int32)>>('getHistorySketch');
+    final sketchQuantilesPtr = _lookupOptional<NativeFunction<Int64 Function(Pointer<Uint8>, Int32, Pointer<Double>, Int32, Pointer<Double>)>>('sketchQuantiles');
+    final mergeSketchesPtr = _lookupOptional<NativeFunction<Int32 Function(Pointer<Uint8>, Int32, Pointer<Uint8>, Int32, Pointer<Uint8>, Int32)>>('mergeQuantileSketches');
+    if (historyQuantilesPtr != null && historySketchPtr != null && sketchQuantilesPtr != null && mergeSketchesPtr != null) {
+      _getHistoryQuantiles = historyQuantilesPtr.asFunction<int Function(int, int, Pointer<Double>, int, Pointer<Double>)>();
+      _getHistorySketch = historySketchPtr.asFunction<int Function(int, int, Pointer<Uint8>, int)>();
+      _sketchQuantiles = sketchQuantilesPtr.asFunction<int Function(Pointer<Uint8>, int, Pointer<Double>, int, Pointer<Double>)>(isLeaf: true);
+      _mergeQuantileSketches = mergeSketchesPtr.asFunction<int Function(Pointer<Uint8>, int, Pointer<Uint8>, int, Pointer<Uint8>, int)>(isLeaf: true);
+      _sketchBuffer = calloc<Uint8>(quantileSketchMaxBytes);
+      _sketchInput = calloc<Uint8>(2 * quantileSketchMaxBytes);
+      _quantileLevels = calloc<Double>(3);
+      _quantileLevels![0] = 0.5;
+      _quantileLevels![1] = 0.95;
+      _quantileLevels![2] = 0.99;
+      _quantileValues = calloc<Double>(3);
+    }
+    final readSketchPtr = _lookupOptional<NativeFunction<Int32 Function(Int, Int64, Int64, Pointer<Uint8>, Int32)>>('readHistorySketch');
+    if (readSketchPtr != null && _sketchBuffer != null) {
+      _readHistorySketch = readSketchPtr.asFunction<int Function(int, int, int, Pointer<Uint8>, int)>();
+    }
+    
+    final openHistoryDatabasePtr = _lookupOptional<NativeFunction<Int Function(Pointer<Char>)>>('openHistoryDatabase');
+    final closeHistoryDatabasePtr = _lookupOptional<NativeFunction<Void Function()>>('closeHistoryDatabase');
+    final rangeCountPtr = _lookupOptional<NativeFunction<Int64 Function(Int, Int64, Int64)>>('getHistoryRangeCount');
+    final readRangePtr = _lookupOptional<NativeFunction<Int64 Function(Int, Int64, Int64, Pointer<Int64>, Pointer<Double>, Int64)>>('readHistoryRange');
+    if (openHistoryDatabasePtr != null && closeHistoryDatabasePtr != null && rangeCountPtr != null && readRangePtr != null) {
+      _openHistoryDatabase = openHistoryDatabasePtr.asFunction<int Function(Pointer<Char>)>();
+      _closeHistoryDatabase = closeHistoryDatabasePtr.asFunction<void Function()>();
+      _getHistoryRangeCount = rangeCountPtr.asFunction<int Function(int, int, int)>();
+      _readHistoryRange = readRangePtr.asFunction<int Function(int, int, int, Pointer<Int64>, Pointer<Double>, int)>();
+    }
+    
+    final latencyPtr = _lookupOptional<NativeFunction<Int Function(Int, Pointer<LatencyStats>)>>('getCollectorLatency');
+    final resetLatencyPtr = _lookupOptional<NativeFunction<Void Function(Int)>>('resetCollectorLatency');
+    if (latencyPtr != null && resetLatencyPtr != null) {
+      _getCollectorLatency = latencyPtr.asFunction<int Function(int, Pointer<LatencyStats>)>();
+      _resetCollectorLatency = resetLatencyPtr.asFunction<void Function(int)>();
+      _latencyStats = calloc<LatencyStats>();
+    }
+    
+    final topProcessesPtr = _lookupOptional<NativeFunction<Int Function(Int, Pointer<ProcessUsage>, Int)>>('getTopProcesses');
+    if (topProcessesPtr != null) {
+      _getTopProcesses = topProcessesPtr.asFunction<int Function(int, Pointer<ProcessUsage>, int)>();
+      _processRows = calloc<ProcessUsage>(maxProcessRows);
+    }
+    
+    final mountUsagePtr = _lookupOptional<NativeFunction<Int Function(Pointer<MountUsage>, Int)>>('getMountUsage');
+    if (mountUsagePtr != null) {
+      _getMountUsage = mountUsagePtr.asFunction<int Function(Pointer<MountUsage>, int)>();
+      _mountRows = calloc<MountUsage>(maxMountRows);
+    }
+    
+    final diskIoPtr = _lookupOptional<NativeFunction<Int Function(Pointer<DiskIo>, Int, Int)>>('getDiskIo');
+    if (diskIoPtr != null) {
+      _getDiskIo = diskIoPtr.asFunction<int Function(Pointer<DiskIo>, int, int)>();
+      _diskIoRows = calloc<DiskIo>(maxDiskIoRows);
+    }
+    
+    final networkIoPtr = _lookupOptional<NativeFunction<Int Function(Pointer<NetIo>, Int)>>('getNetworkIo');
+    if (networkIoPtr != null) {
+      _getNetworkIo = networkIoPtr.asFunction<int Function(Pointer<NetIo>, int)>();
+      _networkRows = calloc<NetIo>(maxNetworkRows);
+    }
+    
+    final sensorsPtr = _lookupOptional<NativeFunction<Int Function(Pointer<SensorReading>, Int)>>('getSensors');
+    if (sensorsPtr != null) {
+      _getSensors = sensorsPtr.asFunction<int Function(Pointer<SensorReading>, int)>();
+      _sensorRows = calloc<SensorReading>(maxSensorRows);
+    }
+    
+    final startBurstPtr = _lookupOptional<NativeFunction<Int Function(Int)>>('startBurstSampler');
+    final stopBurstPtr = _lookupOptional<NativeFunction<Void Function()>>('stopBurstSampler');
+    final readBurstPtr = _lookupOptional<NativeFunction<Int Function(Pointer<BurstFrame>)>>('readBurstFrame');
+    if (startBurstPtr != null && stopBurstPtr != null && readBurstPtr != null) {
+      _startBurstSampler = startBurstPtr.asFunction<int Function(int)>();
+      _stopBurstSampler = stopBurstPtr.asFunction<void Function()>();
+      _readBurstFrame = readBurstPtr.asFunction<int Function(Pointer<BurstFrame>)>();
+      _burstFrame = calloc<BurstFrame>();
+    }
+    
+    final samplerAdaptivePtr = _lookupOptional<NativeFunction<Void Function(Int)>>('setSamplerAdaptive');
+    final scheduleVisiblePtr = _lookupOptional<NativeFunction<Void Function(Int)>>('setScheduleVisible');
+    final scheduleDuePtr = _lookupOptional<NativeFunction<Uint32 Function(Uint32)>>('scheduleDue');
+    final scheduleNextPtr = _lookupOptional<NativeFunction<Int64 Function(Uint32)>>('scheduleNextMs');
+    final scheduleReportPtr = _lookupOptional<NativeFunction<Void Function(Int, Double)>>('scheduleReport');
+    final invalidateStaticPtr = _lookupOptional<NativeFunction<Void Function()>>('invalidateStaticValues');
+    if (samplerAdaptivePtr != null && scheduleVisiblePtr != null && scheduleDuePtr != null &&
+        scheduleNextPtr != null && scheduleReportPtr != null && invalidateStaticPtr != null) {
+      _setSamplerAdaptive = samplerAdaptivePtr.asFunction<void Function(int)>();
+      _setScheduleVisible = scheduleVisiblePtr.asFunction<void Function(int)>();
+      _scheduleDue = scheduleDuePtr.asFunction<int Function(int)>();
+      _scheduleNextMs = scheduleNextPtr.asFunction<int Function(int)>();
+      _scheduleReport = scheduleReportPtr.asFunction<void Function(int, double)>();
+      _invalidateStaticValues = invalidateStaticPtr.asFunction<void Function()>();
+    }
+    
+    final cgroupUsagePtr = _lookupOptional<NativeFunction<Int Function(Pointer<CgroupUsage>)>>('getCgroupUsage');
+    final cgroupPathPtr = _lookupOptional<NativeFunction<Pointer<Char> Function()>>('getCgroupPath');
+    if (cgroupUsagePtr != null && cgroupPathPtr != null) {
+      _getCgroupUsage = cgroupUsagePtr.asFunction<int Function(Pointer<CgroupUsage>)>();
+      _getCgroupPath = cgroupPathPtr.asFunction<Pointer<Char> Function()>();
+      _cgroupUsage = calloc<CgroupUsage>();
+    }
+    
+    final refreshTreePtr = _lookupOptional<NativeFunction<Int Function()>>('refreshCgroupTree');
+    final cgroupChildrenPtr = _lookupOptional<NativeFunction<Int Function(Uint64, Int, Pointer<CgroupNode>, Int)>>('getCgroupChildren');
+    final cgroupNodePtr = _lookupOptional<NativeFunction<Int Function(Uint64, Pointer<CgroupNode>)>>('getCgroupNode');
+    if (refreshTreePtr != null && cgroupChildrenPtr != null && cgroupNodePtr != null) {
+      _refreshCgroupTree = refreshTreePtr.asFunction<int Function()>();
+      _getCgroupChildren = cgroupChildrenPtr.asFunction<int Function(int, int, Pointer<CgroupNode>, int)>();
+      _getCgroupNode = cgroupNodePtr.asFunction<int Function(int, Pointer<CgroupNode>)>();
+      _cgroupRows = calloc<CgroupNode>(maxCgroupRows);
+    }
+    
+    final pressurePtr = _lookupOptional<NativeFunction<Int Function(Int, Pointer<PressureStats>)>>('getPressure');
+    if (pressurePtr != null) {
+      _getPressure = pressurePtr.asFunction<int Function(int, Pointer<PressureStats>)>();
+      _pressureStats = calloc<PressureStats>();
+    }
+    
+    final addTriggerPtr = _lookupOptional<NativeFunction<Int Function(Int, Int, Int, Int)>>('addPressureTrigger');
+    final clearTriggersPtr = _lookupOptional<NativeFunction<Void Function()>>('clearPressureTriggers');
+    final startMonitorPtr = _lookupOptional<NativeFunction<Int Function(Pointer<NativeFunction<Void Function(Int32)>>)>>('startPressureMonitor');
+    final stopMonitorPtr = _lookupOptional<NativeFunction<Void Function()>>('stopPressureMonitor');
+    final readEventsPtr = _lookupOptional<NativeFunction<Int Function(Pointer<PressureEvent>, Int, Uint64)>>('readPressureEvents');
+    if (addTriggerPtr != null && clearTriggersPtr != null && startMonitorPtr != null &&
+        stopMonitorPtr != null && readEventsPtr != null) {
+      _addPressureTrigger = addTriggerPtr.asFunction<int Function(int, int, int, int)>();
+      _clearPressureTriggers = clearTriggersPtr.asFunction<void Function()>();
+      _startPressureMonitor = startMonitorPtr.asFunction<int Function(Pointer<NativeFunction<Void Function(Int32)>>)>();
+      _stopPressureMonitor = stopMonitorPtr.asFunction<void Function()>();
+      _readPressureEvents = readEventsPtr.asFunction<int Function(Pointer<PressureEvent>, int, int)>();
+      _pressureEvents = calloc<PressureEvent>(maxPressureEvents);
+    }
+  }
+  
+  /// Look up a symbol that may be missing from the loaded library
+  static Pointer<T>? _lookupOptional<T extends NativeType>(String symbol) {
+    if (_dylib == null || !_dylib!.providesSymbol(symbol)) {
+      debugPrint('Native library does not export $symbol');
+      return null;
+    }
+    return _dylib!.lookup<T>(symbol);
+  }
+  
+  /// Whether the native library supports batched snapshots
+  bool get hasSystemSnapshot => _getSystemSnapshot != null;
+  
+  /// Get every per-tick metric from one native sample in a single FFI call.
+  /// Returns null if the library does not support snapshots or sampling failed.
+  Future<SystemStats?> getSystemSnapshot() async {
+    if (_getSystemSnapshot == null || _snapshot == null) return null;
+    
+    try {
+      final snapshot = _snapshot!.ref;
+      snapshot.version = systemSnapshotVersion;
+      snapshot.size = sizeOf<SystemSnapshot>();
+      if (_getSystemSnapshot!(_snapshot!) != 0) return null;
+      return _statsFromSnapshot(snapshot);
+    } catch (e) {
+      debugPrint('Error getting system snapshot: $e');
+    }
+    return null;
+  }
+  
+  /// Whether the native library can sample on its own background thread
+  bool get hasSampler => _startSampler != null;
+  
+  /// Start the native sampler thread. Returns false if unsupported or it failed to start.
+  bool startSampler(Duration interval) {
+    if (_startSampler == null) return false;
+    return _startSampler!(interval.inMilliseconds) == 0;
+  }
+  
+  /// Stop the native sampler thread
+  void stopSampler() {
+    _stopSampler?.call();
+  }
+  
+  /// Change the native sampling interval
+  void setSamplerInterval(Duration interval) {
+    _setSamplerInterval?.call(interval.inMilliseconds);
+  }
+  
+  /// Read the sample most recently published by the sampler thread. This is
+  /// a memory copy on the native side and performs no system calls.
+  /// Returns null until the first sample has been published.
+  SystemStats? readLatestSnapshot() {
+    if (_readLatestSnapshot == null || _snapshot == null) return null;
+    
+    final snapshot = _snapshot!.ref;
+    snapshot.version = systemSnapshotVersion;
+    snapshot.size = sizeOf<SystemSnapshot>();
+    if (_readLatestSnapshot!(_snapshot!) != 0) return null;
+    return _statsFromSnapshot(snapshot);
+  }
+  
+  /// Whether the native library can read a collector daemon's segment
+  bool get hasSharedSegment => _attachSharedSegment != null;
+  
+  /// Map the segment of a collector daemon running on this host. History
+  /// views then read the daemon's rings. Returns false if no daemon is
+  /// publishing, or it was built with a different layout.
+  bool attachSharedSegment() {
+    if (_attachSharedSegment == null) return false;
+    return _attachSharedSegment!(nullptr) == 0;
+  }
+  
+  /// Copy the daemon's latest snapshot. Returns null once the daemon stops
+  /// publishing; detach and sample in-process then.
+  SystemStats? readSharedSnapshot() {
+    if (_readSharedSnapshot == null || _snapshot == null) return null;
+    
+    final snapshot = _snapshot!.ref;
+    snapshot.version = systemSnapshotVersion;
+    snapshot.size = sizeOf<SystemSnapshot>();
+    if (_readSharedSnapshot!(_snapshot!) != 0) return null;
+    return _statsFromSnapshot(snapshot);
+  }
+  
+  /// Unmap the daemon's segment; history views read local rings again
+  void detachSharedSegment() {
+    _detachSharedSegment?.call();
+  }
+  
+  /// Whether the sampler thread can push snapshots to this isolate
+  bool get hasSnapshotPush => _dartApiReady && _setSnapshotPort != null;
+  
+  /// Snapshots posted by the native sampler thread as it publishes them,
+  /// decoded from one typed-data message each. With a [changeThreshold] (in
+  /// percentage points or degrees) quiet samples are skipped until a metric
+  /// moves that far or [maxSilence] passes. The native side posts to one
+  /// port at a time, so listen to one stream only. Start the sampler first.
+  Stream<SystemStats> snapshotStream({double changeThreshold = 0, Duration maxSilence = Duration.zero}) {
+    if (!hasSnapshotPush) return const Stream.empty();
+    
+    ReceivePort? port;
+    late final StreamController<SystemStats> controller;
+    controller = StreamController<SystemStats>(
+      onListen: () {
+        port = ReceivePort('cpu_monitor snapshots');
+        port!.listen((message) {
+          final stats = message is Float64List ? _statsFromMessage(message) : null;
+          if (stats != null) controller.add(stats);
+        });
+        if (_setSnapshotPort!(port!.sendPort.nativePort, changeThreshold, maxSilence.inMilliseconds) != 0) {
+          controller.addError(StateError('Native snapshot port unavailable'));
+          port!.close();
+          controller.close();
+        }
+      },
+      onCancel: () {
+        _setSnapshotPort!(0, 0, 0);
+        port?.close();
+      },
+    );
+    return controller.stream;
+  }
+  
+  /// Whether the native library keeps metric history (fed by the sampler)
+  bool get hasHistory => _getHistoryView != null;
+  
+  /// Zero-copy view of one native history tier, oldest point first.
+  ///
+  /// The view aliases native memory and the window advances as samples
+  /// arrive, so fetch a fresh view for every read instead of keeping one.
+  Float64List? getHistoryView(int metric, {int tier = HistoryTier.raw, int field = HistoryField.avg}) {
+    if (_getHistoryView == null || _historyLength == null) return null;
+    
+    final data = _getHistoryView!(metric, tier, field, _historyLength!);
+    if (data == nullptr) return null;
+    return data.asTypedList(_historyLength!.value).asUnmodifiableView();
+  }
+  
+  /// Zero-copy view of a window statistic (see [WindowStat]) of the raw
+  /// tier, one point per raw sample, kept up to date by the native side as
+  /// samples arrive. Same lifetime rules as [getHistoryView].
+  Float64List? getHistoryStatView(int metric, int stat) {
+    if (_getHistoryStatView == null || _historyLength == null) return null;
+    
+    final data = _getHistoryStatView!(metric, stat, _historyLength!);
+    if (data == nullptr) return null;
+    return data.asTypedList(_historyLength!.value).asUnmodifiableView();
+  }
+  
+  /// Drop all native history
+  void clearHistory() {
+    _clearHistory?.call();
+  }
+  
+  /// Whether the native library can downsample series for charts
+  bool get hasDecimation => _decimateSeries != null && _decimateHistory != null;
+  
+  /// Grow the shared output buffers to hold [target] decimated points
+  static void _reserveDecimated(int target) {
+    if (target <= _decimatedCapacity) return;
+    if (_decimatedX != null) calloc.free(_decimatedX!);
+    if (_decimatedY != null) calloc.free(_decimatedY!);
+    _decimatedX = calloc<Double>(target);
+    _decimatedY = calloc<Double>(target);
+    _decimatedCapacity = target;
+  }
+  
+  /// The newest [last] points of a history tier (all of them if 0), reduced
+  /// in place to at most [target] points (see [DecimateMode]). x values are
+  /// indices into those points. Returns null without native decimation.
+  ChartSeries? decimateHistory(int metric, {int tier = HistoryTier.raw, int field = HistoryField.avg, int last = 0, required int target, int mode = DecimateMode.lttb}) {
+    if (_decimateHistory == null || target < 2) return null;
+    
+    _reserveDecimated(target);
+    final count = _decimateHistory!(metric, tier, field, last, mode, target, _decimatedX!, _decimatedY!);
+    if (count < 0) return null;
+    return ChartSeries(
+      x: Float64List.fromList(_decimatedX!.asTypedList(count)),
+      y: Float64List.fromList(_decimatedY!.asTypedList(count)),
+    );
+  }
+  
+  /// Like [readHistoryRange], but reduced to at most [target] points before
+  /// anything is copied into Dart. x values are wall-clock milliseconds.
+  ChartSeries? readHistoryRangeDecimated(int metric, DateTime from, DateTime to, {required int target, int mode = DecimateMode.lttb}) {
+    if (_getHistoryRangeCount == null || _readHistoryRange == null || _decimateSeries == null || target < 2) return null;
+    
+    final fromMs = from.millisecondsSinceEpoch;
+    final toMs = to.millisecondsSinceEpoch;
+    final count = _getHistoryRangeCount!(metric, fromMs, toMs);
+    if (count < 0) return null;
+    if (count == 0) return ChartSeries(x: Float64List(0), y: Float64List(0));
+    
+    final timestamps = calloc<Int64>(count);
+    final values = calloc<Double>(count);
+    try {
+      final read = _readHistoryRange!(metric, fromMs, toMs, timestamps, values, count);
+      if (read < 0) return null;
+      
+      _reserveDecimated(target);
+      final kept = _decimateSeries!(mode, nullptr, values, read, target, _decimatedX!, _decimatedY!);
+      if (kept < 0) return null;
+      
+      // Without x the kernel returns sample indices; map them to timestamps
+      final times = timestamps.asTypedList(read);
+      final indices = _decimatedX!.asTypedList(kept);
+      return ChartSeries(
+        x: Float64List.fromList([for (final index in indices) times[index.toInt()].toDouble()]),
+        y: Float64List.fromList(_decimatedY!.asTypedList(kept)),
+      );
+    } finally {
+      calloc.free(timestamps);
+      calloc.free(values);
+    }
+  }
+  
+  /// Whether the native library can keep history on disk
+  bool get hasHistoryDatabase => _openHistoryDatabase != null;
+  
+  /// Open the on-disk history in the per-user data directory. Samples are
+  /// appended while this process samples and holds the store; otherwise it
+  /// is a read-only view of the process that does. The last hour is loaded
+  /// into the history rings, so open it before starting the sampler.
+  bool openHistoryDatabase() {
+    if (_openHistoryDatabase == null) return false;
+    return _openHistoryDatabase!(nullptr) == 0;
+  }
+  
+  /// Flush and close the on-disk history
+  void closeHistoryDatabase() {
+    _closeHistoryDatabase?.call();
+  }
+  
+  /// Samples of one metric (see [HistoryMetric]) recorded between [from]
+  /// and [to], inclusive. Only the blocks covering the range are decoded.
+  /// Returns null if the history is not open.
+  HistoryRange? readHistoryRange(int metric, DateTime from, DateTime to) {
+    if (_getHistoryRangeCount == null || _readHistoryRange == null) return null;
+    
+    final fromMs = from.millisecondsSinceEpoch;
+    final toMs = to.millisecondsSinceEpoch;
+    final count = _getHistoryRangeCount!(metric, fromMs, toMs);
+    if (count < 0) return null;
+    if (count == 0) return HistoryRange(timestamps: Int64List(0), values: Float64List(0));
+    
+    final timestamps = calloc<Int64>(count);
+    final values = calloc<Double>(count);
+    try {
+      final read = _readHistoryRange!(metric, fromMs, toMs, timestamps, values, count);
+      if (read < 0) return null;
+      return HistoryRange(
+        timestamps: Int64List.fromList(timestamps.asTypedList(read)),
+        values: Float64List.fromList(values.asTypedList(read)),
+      );
+    } finally {
+      calloc.free(timestamps);
+      calloc.free(values);
+    }
+  }
+  
+  /// Whether the native library keeps quantile sketches of its history
+  bool get hasQuantiles => _getHistoryQuantiles != null;
+  
+  QuantileSummary? _summary(int count) {
+    if (count < 0) return null;
+    return QuantileSummary(
+      count: count,
+      p50: _quantileValues![0],
+      p95: _quantileValues![1],
+      p99: _quantileValues![2],
+    );
+  }
+  
+  Uint8List? _copySketch(int length) {
+    if (length < 0) return null;
+    return Uint8List.fromList(_sketchBuffer!.asTypedList(length));
+  }
+  
+  /// p50/p95/p99 of a metric over a sliding window (see [QuantileWindow])
+  /// of the in-memory history. Null without native quantiles.
+  QuantileSummary? getHistoryQuantiles(int metric, int window) {
+    if (_getHistoryQuantiles == null) return null;
+    return _summary(_getHistoryQuantiles!(metric, window, _quantileLevels!, 3, _quantileValues!));
+  }
+  
+  /// A sliding window's sketch, encoded so it can be stored or merged with
+  /// sketches from elsewhere (see [mergeSketches])
+  Uint8List? historySketch(int metric, int window) {
+    if (_getHistorySketch == null) return null;
+    return _copySketch(_getHistorySketch!(metric, window, _sketchBuffer!, quantileSketchMaxBytes));
+  }
+  
+  /// Merged sketch of every on-disk hour of a metric overlapping [from] to
+  /// [to], read without touching the samples. Null if the history is not
+  /// open.
+  Uint8List? readHistorySketch(int metric, DateTime from, DateTime to) {
+    if (_readHistorySketch == null) return null;
+    return _copySketch(_readHistorySketch!(
+        metric, from.millisecondsSinceEpoch, to.millisecondsSinceEpoch, _sketchBuffer!, quantileSketchMaxBytes));
+  }
+  
+  /// p50/p95/p99 of an encoded sketch, or null if it is not one
+  QuantileSummary? sketchQuantiles(Uint8List sketch) {
+    if (_sketchQuantiles == null || sketch.length > quantileSketchMaxBytes) return null;
+    _sketchInput!.asTypedList(sketch.length).setAll(0, sketch);
+    return _summary(_sketchQuantiles!(_sketchInput!, sketch.length, _quantileLevels!, 3, _quantileValues!));
+  }
+  
+  /// Sketch of the samples of both [a] and [b], or null if either is not one
+  Uint8List? mergeSketches(Uint8List a, Uint8List b) {
+    if (_mergeQuantileSketches == null || a.length > quantileSketchMaxBytes || b.length > quantileSketchMaxBytes) {
+      return null;
+    }
+    final second = _sketchInput! + quantileSketchMaxBytes;
+    _sketchInput!.asTypedList(a.length).setAll(0, a);
+    second.asTypedList(b.length).setAll(0, b);
+    return _copySketch(_mergeQuantileSketches!(
+        _sketchInput!, a.length, second, b.length, _sketchBuffer!, quantileSketchMaxBytes));
+  }
+  
+  /// Whether the native library measures its own collection cost
+  bool get hasCollectorLatency => _getCollectorLatency != null;
+  
+  /// Latency of every native collector (see [LatencyCollector]), or an
+  /// empty list if the library does not record it
+  List<CollectorLatency> getCollectorLatency() {
+    if (_getCollectorLatency == null || _latencyStats == null) return const [];
+    
+    final stats = _latencyStats!.ref;
+    final result = <CollectorLatency>[];
+    for (int i = 0; i < LatencyCollector.names.length; i++) {
+      if (_getCollectorLatency!(i, _latencyStats!) != 0) continue;
+      result.add(CollectorLatency(
+        name: LatencyCollector.names[i],
+        count: stats.count,
+        mean: Duration(microseconds: stats.meanNs ~/ 1000),
+        p50: Duration(microseconds: stats.p50Ns ~/ 1000),
+        p99: Duration(microseconds: stats.p99Ns ~/ 1000),
+        max: Duration(microseconds: stats.maxNs ~/ 1000),
+      ));
     }
+    return result;
+  }
+  
+  /// Clear the native latency histograms
+  void resetCollectorLatency() {
+    _resetCollectorLatency?.call(-1);
+  }
+  
+  /// Whether the native library can list processes
+  bool get hasProcessTable => _getTopProcesses != null;
+  
+  /// The busiest [count] processes by [sort] (see [ProcessSort]), busiest
+  /// first. Returns an empty list if unsupported or the scan failed.
+  List<ProcessStats> getTopProcesses(int sort, {int count = 10}) {
+    if (_getTopProcesses == null || _processRows == null) return const [];
+    
+    final written = _getTopProcesses!(sort, _processRows!, min(count, maxProcessRows));
+    if (written <= 0) return const [];
+    
+    return List<ProcessStats>.generate(written, (i) {
+      final row = _processRows![i];
+      return ProcessStats(
+        pid: row.pid,
+        name: _arrayString(row.name, processNameLength),
+        threads: row.threads,
+        cpuPercent: row.cpuPercent,
+        rssKb: row.rssKb,
+        readBytesPerSec: row.readBytesPerSec,
+        writeBytesPerSec: row.writeBytesPerSec,
+      );
+    }, growable: false);
+  }
+  
+  /// Whether the native library can list mounted filesystems
+  bool get hasMountUsage => _getMountUsage != null;
+  
+  /// Capacity of every real filesystem, ordered by mount point. Returns an
+  /// empty list if unsupported or the mount table could not be read.
+  List<MountStats> getMountUsage() {
+    if (_getMountUsage == null || _mountRows == null) return const [];
+    
+    final written = _getMountUsage!(_mountRows!, maxMountRows);
+    if (written <= 0) return const [];
+    
+    return List<MountStats>.generate(written, (i) {
+      final row = _mountRows![i];
+      return MountStats(
+        mountPoint: _arrayString(row.mountPoint, mountPathLength),
+        fsType: _arrayString(row.fsType, mountFsTypeLength),
+        device: _arrayString(row.device, mountDeviceLength),
+        totalMb: row.totalMb,
+        usedMb: row.usedMb,
+        availableMb: row.availableMb,
+        usagePercent: row.usagePercent,
+      );
+    }, growable: false);
+  }
+  
+  /// Whether the native library reports block device throughput
+  bool get hasDiskIo => _getDiskIo != null;
+  
+  /// I/O rates of each block device since the previous call. Partitions are
+  /// left out unless [includePartitions], as their disk already counts them.
+  /// Returns an empty list on the first call, which only sets the baseline.
+  List<DiskIoStats> getDiskIo({bool includePartitions = false}) {
+    if (_getDiskIo == null || _diskIoRows == null) return const [];
+    
+    final written = _getDiskIo!(_diskIoRows!, maxDiskIoRows, includePartitions ? 0 : 1);
+    if (written <= 0) return const [];
+    
+    return List<DiskIoStats>.generate(written, (i) {
+      final row = _diskIoRows![i];
+      return DiskIoStats(
+        name: _arrayString(row.name, diskIoNameLength),
+        readIops: row.readIops,
+        writeIops: row.writeIops,
+        readBytesPerSec: row.readBytesPerSec,
+        writeBytesPerSec: row.writeBytesPerSec,
+        awaitMs: row.awaitMs,
+        utilization: row.utilization,
+        inFlight: row.inFlight,
+        isPartition: row.isPartition != 0,
+      );
+    }, growable: false);
+  }
+  
+  /// Whether the native library reports network interface throughput
+  bool get hasNetworkIo => _getNetworkIo != null;
+  
+  /// Traffic of each network interface since the previous call. Returns an
+  /// empty list on the first call, which only sets the baseline.
+  List<NetworkStats> getNetworkIo() {
+    if (_getNetworkIo == null || _networkRows == null) return const [];
+    
+    final written = _getNetworkIo!(_networkRows!, maxNetworkRows);
+    if (written <= 0) return const [];
+    
+    return List<NetworkStats>.generate(written, (i) {
+      final row = _networkRows![i];
+      return NetworkStats(
+        name: _arrayString(row.name, netIoNameLength),
+        rxBytesPerSec: row.rxBytesPerSec,
+        txBytesPerSec: row.txBytesPerSec,
+        rxPacketsPerSec: row.rxPacketsPerSec,
+        txPacketsPerSec: row.txPacketsPerSec,
+        rxErrorsPerSec: row.rxErrorsPerSec,
+        txErrorsPerSec: row.txErrorsPerSec,
+        rxDropsPerSec: row.rxDropsPerSec,
+        txDropsPerSec: row.txDropsPerSec,
+      );
+    }, growable: false);
+  }
+  
+  /// Whether the native library reads hardware sensors
+  bool get hasSensors => _getSensors != null;
+  
+  /// Every temperature and fan sensor, CPU package and cores first. Returns
+  /// an empty list if unsupported or none are exposed (most VMs).
+  List<SensorStats> getSensors() {
+    if (_getSensors == null || _sensorRows == null) return const [];
+    
+    final written = _getSensors!(_sensorRows!, maxSensorRows);
+    if (written <= 0) return const [];
+    
+    return List<SensorStats>.generate(written, (i) {
+      final row = _sensorRows![i];
+      return SensorStats(
+        chip: _arrayString(row.chip, sensorNameLength),
+        label: _arrayString(row.label, sensorNameLength),
+        kind: row.kind,
+        index: row.index,
+        value: row.value,
+        critical: row.critical,
+      );
+    }, growable: false);
+  }
+  
+  /// Whether the native library has the high-frequency burst sampler
+  bool get hasBurstSampler => _startBurstSampler != null;
+  
+  /// Sample CPU and CPU stall [rateHz] times a second (100 to 1000) on a
+  /// native timer thread; a running sampler switches to the new rate
+  bool startBurstSampler(int rateHz) {
+    if (_startBurstSampler == null) return false;
+    return _startBurstSampler!(rateHz) == 0;
+  }
+  
+  void stopBurstSampler() {
+    _stopBurstSampler?.call();
+  }
+  
+  /// Aggregates of every burst sample since the previous call, meant to be
+  /// taken once per UI frame. Null if the sampler is not running.
+  BurstFrameStats? readBurstFrame() {
+    if (_readBurstFrame == null || _burstFrame == null) return null;
+    if (_readBurstFrame!(_burstFrame!) < 0) return null;
+    
+    final frame = _burstFrame!.ref;
+    BurstAggregate aggregate(int series) {
+      final stats = frame.series[series];
+      return BurstAggregate(
+        count: stats.count,
+        min: stats.min,
+        max: stats.max,
+        mean: stats.mean,
+        last: stats.last,
+      );
+    }
+    
+    return BurstFrameStats(
+      ticks: frame.ticks,
+      missed: frame.missed,
+      span: Duration(microseconds: (frame.endNs - frame.startNs) ~/ 1000),
+      jitterMean: Duration(microseconds: frame.jitterMeanNs ~/ 1000),
+      jitterMax: Duration(microseconds: frame.jitterMaxNs ~/ 1000),
+      cpu: aggregate(BurstSeries.cpu),
+      cpuPressure: aggregate(BurstSeries.cpuPressure),
+    );
+  }
+  
+  /// Whether the native library schedules each collector adaptively
+  bool get hasScheduler => _scheduleDue != null;
+  
+  /// Let the schedule decide when the sampler thread takes each snapshot
+  /// metric, instead of taking all of them every interval
+  void setSamplerAdaptive(bool enabled) {
+    _setSamplerAdaptive?.call(enabled ? 1 : 0);
+  }
+  
+  /// Hidden dashboards sample slowly or not at all; showing it again makes
+  /// every collector due
+  void setScheduleVisible(bool visible) {
+    _setScheduleVisible?.call(visible ? 1 : 0);
+  }
+  
+  /// Take the collectors in [mask] (bits of [ScheduleCollector]) that are
+  /// due now; they are returned as a mask. Without the scheduler every one
+  /// is always due.
+  int scheduleDue(int mask) {
+    if (_scheduleDue == null) return mask;
+    return _scheduleDue!(mask);
+  }
+  
+  /// Time until the first collector in [mask] is due, or null if every one
+  /// of them is paused
+  Duration? scheduleNext(int mask) {
+    if (_scheduleNextMs == null) return null;
+    final ms = _scheduleNextMs!(mask);
+    return ms < 0 ? null : Duration(milliseconds: ms);
+  }
+  
+  /// Report the value a collector just read so its interval can adapt
+  void scheduleReport(int collector, double value) {
+    _scheduleReport?.call(collector, value);
+  }
+  
+  /// Drop the cached core count and totals so the next reads refresh them
+  void invalidateStaticValues() {
+    _invalidateStaticValues?.call();
+  }
+  
+  /// Whether the native library reads cgroup accounting (Linux only)
+  bool get hasCgroup => _getCgroupUsage != null;
+  
+  /// CPU and memory of the container against its own quota and memory
+  /// limit, or the host's figures outside a cgroup v2 group. Returns null
+  /// if unsupported or nothing could be read.
+  ContainerStats? getCgroupUsage() {
+    if (_getCgroupUsage == null || _cgroupUsage == null) return null;
+    
+    try {
+      if (_getCgroupUsage!(_cgroupUsage!) != 0) return null;
+      final usage = _cgroupUsage!.ref;
+      return ContainerStats(
+        inCgroup: usage.inCgroup != 0,
+        path: _getCgroupPath!().cast<Utf8>().toDartString(),
+        cpuPercent: usage.cpuPercent,
+        cpuLimit: usage.cpuLimit,
+        cpuLimited: (usage.limits & cgroupLimitCpu) != 0,
+        throttledPercent: usage.throttledPercent,
+        throttledMs: usage.throttledMs,
+        memoryUsedMb: usage.memoryUsedMb,
+        memoryCurrentMb: usage.memoryCurrentMb,
+        memoryLimitMb: usage.memoryLimitMb,
+        memoryLimited: (usage.limits & cgroupLimitMemory) != 0,
+      );
+    } catch (e) {
+      debugPrint('Error getting cgroup usage: $e');
+    }
+    return null;
+  }
+  
+  /// Whether the native library can list the host's cgroup tree (Linux only)
+  bool get hasCgroupTree => _refreshCgroupTree != null;
+  
+  /// Re-read the tree, walking it again if groups came or went. Returns the
+  /// number of groups, or -1 without a cgroup2 mount.
+  int refreshCgroupTree() {
+    if (_refreshCgroupTree == null) return -1;
+    return _refreshCgroupTree!();
+  }
+  
+  /// The busiest children of group [parentId] by [sort] (a [CgroupSort]),
+  /// busiest first; [parentId] 0 is the root. The level asked for is read
+  /// on every refresh after this. Returns an empty list for an unknown group.
+  List<CgroupStats> getCgroupChildren(int parentId, int sort, {int count = maxCgroupRows}) {
+    if (_getCgroupChildren == null || _cgroupRows == null) return const [];
+    
+    final written = _getCgroupChildren!(parentId, sort, _cgroupRows!, min(count, maxCgroupRows));
+    if (written <= 0) return const [];
+    
+    return List<CgroupStats>.generate(written, (i) => _cgroupStats(_cgroupRows![i]), growable: false);
+  }
+  
+  /// Figures of one group, 0 for the root; null if it is not in the tree
+  CgroupStats? getCgroupNode(int id) {
+    if (_getCgroupNode == null || _cgroupRows == null) return null;
+    if (_getCgroupNode!(id, _cgroupRows!) != 0) return null;
+    return _cgroupStats(_cgroupRows!.ref);
+  }
+  
+  CgroupStats _cgroupStats(CgroupNode node) {
+    return CgroupStats(
+      id: node.id,
+      parentId: node.parentId,
+      name: _arrayString(node.name, cgroupNameLength),
+      depth: node.depth,
+      children: node.children,
+      cpuPercent: node.cpuPercent,
+      memoryKb: node.memoryKb,
+      readBytesPerSec: node.readBytesPerSec,
+      writeBytesPerSec: node.writeBytesPerSec,
+    );
+  }
+  
+  /// Whether the native library reads pressure stall information
+  bool get hasPressure => _getPressure != null;
+  
+  /// Current stall averages of CPU, memory and I/O. Resources the kernel
+  /// does not report (no CONFIG_PSI, or PSI disabled) are left out.
+  List<ResourcePressure> getPressure() {
+    if (_getPressure == null || _pressureStats == null) return const [];
+    
+    final pressure = <ResourcePressure>[];
+    for (int resource = PressureResource.cpu; resource <= PressureResource.io; resource++) {
+      if (_getPressure!(resource, _pressureStats!) != 0) continue;
+      final stats = _pressureStats!.ref;
+      pressure.add(ResourcePressure(
+        resource: resource,
+        someAvg10: stats.someAvg10,
+        someAvg60: stats.someAvg60,
+        someAvg300: stats.someAvg300,
+        fullAvg10: stats.fullAvg10,
+        fullAvg60: stats.fullAvg60,
+        fullAvg300: stats.fullAvg300,
+        hasFull: stats.hasFull != 0,
+      ));
+    }
+    return pressure;
+  }
+  
+  /// Whether the native library can wait on PSI triggers
+  bool get hasPressureMonitor => _startPressureMonitor != null;
+  
+  /// Add a trigger that fires when tasks stall on [resource] for [stall]
+  /// within any [window] (500 ms to 10 s). Unprivileged processes need a
+  /// window that is a multiple of 2 s for the kernel to accept it; otherwise
+  /// the native side checks the stall total once per window instead.
+  bool addPressureTrigger(int resource, {bool full = false, required Duration stall, required Duration window}) {
+    if (_addPressureTrigger == null) return false;
+    return _addPressureTrigger!(resource, full ? 1 : 0, stall.inMicroseconds, window.inMicroseconds) == 0;
+  }
+  
+  /// Remove every pressure trigger
+  void clearPressureTriggers() {
+    _clearPressureTriggers?.call();
+  }
+  
+  /// Start the native trigger thread. [onPressure] runs on this isolate with
+  /// the resource whose threshold was crossed; the thread sleeps in poll()
+  /// between events. Returns false if unsupported or it failed to start.
+  bool startPressureMonitor(void Function(int resource) onPressure) {
+    if (_startPressureMonitor == null) return false;
+    if (_pressureCallback != null) return true;
+    
+    final callback = NativeCallable<Void Function(Int32)>.listener(onPressure);
+    if (_startPressureMonitor!(callback.nativeFunction) != 0) {
+      callback.close();
+      return false;
+    }
+    _pressureCallback = callback;
+    return true;
+  }
+  
+  /// Stop the trigger thread, then release the callback it was calling
+  void stopPressureMonitor() {
+    _stopPressureMonitor?.call();
+    _pressureCallback?.close();
+    _pressureCallback = null;
+  }
+  
+  /// Threshold crossings newer than [afterSequence], oldest first
+  List<PressureAlert> readPressureEvents(int afterSequence) {
+    if (_readPressureEvents == null || _pressureEvents == null) return const [];
+    
+    final written = _readPressureEvents!(_pressureEvents!, maxPressureEvents, afterSequence);
+    if (written <= 0) return const [];
+    
+    return List<PressureAlert>.generate(written, (i) {
+      final event = _pressureEvents![i];
+      return PressureAlert(
+        sequence: event.sequence,
+        time: DateTime.fromMillisecondsSinceEpoch(event.timestampMs),
+        resource: event.resource,
+        full: event.full != 0,
+        avg10: event.avg10,
+        thresholdPercent: event.thresholdPercent,
+      );
+    }, growable: false);
+  }
+  
+  /// Decode a NUL-terminated UTF-8 string held in a fixed-size struct array
+  static String _arrayString(Array<Uint8> chars, int length) {
+    final bytes = <int>[];
+    for (int i = 0; i < length && chars[i] != 0; i++) {
+      bytes.add(chars[i]);
+    }
+    return utf8.decode(bytes, allowMalformed: true);
+  }
+  
+  /// Decode a snapshot message posted by the sampler thread
+  static SystemStats? _statsFromMessage(Float64List message) {
+    if (message.length < SnapshotMessageField.headerFields ||
+        message[SnapshotMessageField.version] != snapshotMessageVersion) {
+      return null;
+    }
+    
+    final diskTotal = max(message[SnapshotMessageField.diskTotal], 0.0);
+    final diskUsed = max(message[SnapshotMessageField.diskUsed], 0.0);
+    final coreCount = min(message[SnapshotMessageField.coreCount].toInt(),
+        (message.length - SnapshotMessageField.headerFields) ~/ coreUsageFields);
+    final cores = List<CoreUsage>.generate(coreCount, (i) {
+      final base = SnapshotMessageField.headerFields + i * coreUsageFields;
+      return CoreUsage(
+        user: message[base],
+        system: message[base + 1],
+        idle: message[base + 2],
+        iowait: message[base + 3],
+      );
+    }, growable: false);
+    
+    return SystemStats(
+      cpuUsage: max(message[SnapshotMessageField.cpuUsage], 0.0),
+      memoryUsed: max(message[SnapshotMessageField.memoryUsed].toInt(), 0),
+      memoryTotal: max(message[SnapshotMessageField.memoryTotal].toInt(), 0),
+      diskUsage: diskTotal > 0 ? (diskUsed / diskTotal * 100) : 0.0,
+      temperature: max(message[SnapshotMessageField.temperature], 0.0),
+      diskUsed: diskUsed,
+      diskTotal: diskTotal,
+      cores: cores,
+    );
+  }
+  
+  /// Convert a filled native snapshot into dashboard stats
+  static SystemStats _statsFromSnapshot(SystemSnapshot snapshot) {
+    final diskTotal = snapshot.diskTotal > 0 ? snapshot.diskTotal : 0.0;
+    final diskUsed = snapshot.diskUsed > 0 ? snapshot.diskUsed : 0.0;
+    
+    final coreCount = snapshot.version >= 2 ? min(snapshot.coreCount, snapshotMaxCores) : 0;
+    final perCore = snapshot.perCore;
+    final cores = List<CoreUsage>.generate(coreCount, (i) {
+      final base = i * coreUsageFields;
+      return CoreUsage(
+        user: perCore[base],
+        system: perCore[base + 1],
+        idle: perCore[base + 2],
+        iowait: perCore[base + 3],
+      );
+    }, growable: false);
+    
+    return SystemStats(
+      cpuUsage: snapshot.cpuUsage >= 0 ? snapshot.cpuUsage : 0.0,
+      memoryUsed: snapshot.memoryUsed >= 0 ? snapshot.memoryUsed : 0,
+      memoryTotal: snapshot.memoryTotal >= 0 ? snapshot.memoryTotal : 0,
+      diskUsage: diskTotal > 0 ? (diskUsed / diskTotal * 100) : 0.0,
+      temperature: snapshot.temperature >= 0 ? snapshot.temperature : 0.0,
+      diskUsed: diskUsed,
+      diskTotal: diskTotal,
+      cores: cores,
+    );
   }
   
   /// Get the current CPU usage percentage (0-100)
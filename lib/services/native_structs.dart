@@ -0,0 +1,571 @@
+import 'dart:ffi';
+
+/// Dart mirrors of the structs exported by the native library.
+///
+/// Field order and types must match the C definitions exactly; the native
+/// side only ever appends fields, guarded by a layout version.
+
+/// Layout version of `struct system_snapshot` this build was written against
+const int systemSnapshotVersion = 2;
+
+/// Cores carried inline in a snapshot (`SYSTEM_SNAPSHOT_MAX_CORES`)
+const int snapshotMaxCores = 512;
+
+/// Shares reported per core: user, system, idle, iowait (`CORE_USAGE_FIELDS`)
+const int coreUsageFields = 4;
+
+/// Layout version of the snapshot messages posted by the native sampler
+/// (`DART_PORT_MESSAGE_VERSION`)
+const int snapshotMessageVersion = 1;
+
+/// Mirror of `enum dart_port_field` in native/common/dart_port.h: leading
+/// fields of a posted Float64List, followed by [coreUsageFields] per core
+abstract final class SnapshotMessageField {
+  static const int version = 0;
+  static const int timestampMs = 1;
+  static const int cpuUsage = 2;
+  static const int memoryUsed = 3;
+  static const int memoryTotal = 4;
+  static const int diskUsage = 5;
+  static const int diskUsed = 6;
+  static const int diskTotal = 7;
+  static const int temperature = 8;
+  static const int coreCount = 9;
+  static const int headerFields = 10;
+}
+
+/// Mirror of `struct system_snapshot` in native/common/system_snapshot.h
+final class SystemSnapshot extends Struct {
+  @Uint32()
+  external int version;
+
+  @Uint32()
+  external int size;
+
+  /// Monotonic clock at the time of the sample, in nanoseconds
+  @Uint64()
+  external int timestampNs;
+
+  @Double()
+  external double cpuUsage;
+
+  /// Used memory in MB
+  @Int64()
+  external int memoryUsed;
+
+  /// Total memory in MB
+  @Int64()
+  external int memoryTotal;
+
+  @Double()
+  external double diskUsage;
+
+  /// Used disk space in MB
+  @Double()
+  external double diskUsed;
+
+  /// Total disk space in MB
+  @Double()
+  external double diskTotal;
+
+  /// Temperature in Celsius, negative if unavailable
+  @Double()
+  external double temperature;
+
+  // Version 2
+
+  /// Logical CPUs present in [perCore]
+  @Int32()
+  external int coreCount;
+
+  @Int32()
+  external int reserved;
+
+  /// user/system/idle/iowait percentages, [coreUsageFields] per core
+  @Array(snapshotMaxCores * coreUsageFields)
+  external Array<Double> perCore;
+}
+
+/// Path and name limits of `struct mount_usage` (`MOUNT_*_LEN`)
+const int mountPathLength = 128;
+const int mountFsTypeLength = 16;
+const int mountDeviceLength = 64;
+
+/// Mirror of `struct mount_usage` in native/common/mount_usage.h
+final class MountUsage extends Struct {
+  @Double()
+  external double totalMb;
+
+  @Double()
+  external double usedMb;
+
+  /// Free space usable by unprivileged users
+  @Double()
+  external double availableMb;
+
+  @Double()
+  external double usagePercent;
+
+  @Array(mountPathLength)
+  external Array<Uint8> mountPoint;
+
+  @Array(mountFsTypeLength)
+  external Array<Uint8> fsType;
+
+  @Array(mountDeviceLength)
+  external Array<Uint8> device;
+}
+
+/// Device name limit of `struct disk_io` (`DISK_IO_NAME_LEN`)
+const int diskIoNameLength = 32;
+
+/// Mirror of `struct disk_io` in native/common/disk_io.h
+final class DiskIo extends Struct {
+  @Double()
+  external double readIops;
+
+  @Double()
+  external double writeIops;
+
+  @Double()
+  external double readBytesPerSec;
+
+  @Double()
+  external double writeBytesPerSec;
+
+  /// Average time per completed request, queueing included
+  @Double()
+  external double awaitMs;
+
+  /// Percent of wall time with requests in flight
+  @Double()
+  external double utilization;
+
+  @Int32()
+  external int inFlight;
+
+  @Int32()
+  external int isPartition;
+
+  @Array(diskIoNameLength)
+  external Array<Uint8> name;
+}
+
+/// Interface name limit of `struct net_io` (`NET_IO_NAME_LEN`)
+const int netIoNameLength = 16;
+
+/// Mirror of `struct net_io` in native/common/net_io.h
+final class NetIo extends Struct {
+  @Double()
+  external double rxBytesPerSec;
+
+  @Double()
+  external double txBytesPerSec;
+
+  @Double()
+  external double rxPacketsPerSec;
+
+  @Double()
+  external double txPacketsPerSec;
+
+  @Double()
+  external double rxErrorsPerSec;
+
+  @Double()
+  external double txErrorsPerSec;
+
+  @Double()
+  external double rxDropsPerSec;
+
+  @Double()
+  external double txDropsPerSec;
+
+  @Array(netIoNameLength)
+  external Array<Uint8> name;
+}
+
+/// Mirror of `struct pressure_stats` in native/common/pressure.h
+final class PressureStats extends Struct {
+  @Double()
+  external double someAvg10;
+
+  @Double()
+  external double someAvg60;
+
+  @Double()
+  external double someAvg300;
+
+  @Double()
+  external double fullAvg10;
+
+  @Double()
+  external double fullAvg60;
+
+  @Double()
+  external double fullAvg300;
+
+  @Uint64()
+  external int someTotalUs;
+
+  @Uint64()
+  external int fullTotalUs;
+
+  @Int32()
+  external int hasFull;
+
+  @Int32()
+  external int reserved;
+}
+
+/// Mirror of `struct pressure_event` in native/common/pressure.h
+final class PressureEvent extends Struct {
+  @Uint64()
+  external int sequence;
+
+  @Int64()
+  external int timestampMs;
+
+  @Int32()
+  external int resource;
+
+  @Int32()
+  external int full;
+
+  @Double()
+  external double avg10;
+
+  @Double()
+  external double thresholdPercent;
+}
+
+/// Mirror of `enum pressure_resource`
+abstract final class PressureResource {
+  static const int cpu = 0;
+  static const int memory = 1;
+  static const int io = 2;
+
+  static const List<String> names = ['CPU', 'Memory', 'I/O'];
+}
+
+/// Mirror of `struct cgroup_usage` in native/common/cgroup.h
+final class CgroupUsage extends Struct {
+  /// Of [cpuLimit], since the previous read; -1 on the first
+  @Double()
+  external double cpuPercent;
+
+  /// Cores the group may use
+  @Double()
+  external double cpuLimit;
+
+  @Double()
+  external double throttledPercent;
+
+  @Double()
+  external double throttledMs;
+
+  /// memory.current less inactive file cache
+  @Int64()
+  external int memoryUsedMb;
+
+  @Int64()
+  external int memoryCurrentMb;
+
+  @Int64()
+  external int memoryLimitMb;
+
+  @Int32()
+  external int inCgroup;
+
+  @Int32()
+  external int limits;
+}
+
+/// `CGROUP_LIMIT_*` bits of [CgroupUsage.limits]
+const int cgroupLimitCpu = 0x1;
+const int cgroupLimitMemory = 0x2;
+
+/// Group name limit of `struct cgroup_node` (`CGROUP_NAME_LEN`)
+const int cgroupNameLength = 64;
+
+/// Mirror of `struct cgroup_node` in native/common/cgroup_tree.h
+final class CgroupNode extends Struct {
+  @Uint64()
+  external int id;
+
+  /// 0 for the root
+  @Uint64()
+  external int parentId;
+
+  /// Share of one CPU, like top (can exceed 100)
+  @Double()
+  external double cpuPercent;
+
+  @Double()
+  external double readBytesPerSec;
+
+  @Double()
+  external double writeBytesPerSec;
+
+  @Int64()
+  external int memoryKb;
+
+  @Int32()
+  external int depth;
+
+  @Int32()
+  external int children;
+
+  @Array(cgroupNameLength)
+  external Array<Uint8> name;
+}
+
+/// Mirror of `enum cgroup_sort`
+abstract final class CgroupSort {
+  static const int cpu = 0;
+  static const int memory = 1;
+  static const int io = 2;
+}
+
+/// Mirror of `enum burst_series` in native/common/burst.h
+abstract final class BurstSeries {
+  static const int cpu = 0;
+  static const int cpuPressure = 1;
+  static const int count = 2;
+}
+
+/// `BURST_MIN_RATE_HZ` and `BURST_MAX_RATE_HZ`
+const int burstMinRateHz = 100;
+const int burstMaxRateHz = 1000;
+
+/// Mirror of `struct burst_stats` in native/common/burst.h
+final class BurstStats extends Struct {
+  @Double()
+  external double min;
+
+  @Double()
+  external double max;
+
+  @Double()
+  external double mean;
+
+  @Double()
+  external double last;
+
+  @Uint32()
+  external int count;
+
+  @Uint32()
+  external int reserved;
+}
+
+/// Mirror of `struct burst_frame` in native/common/burst.h
+final class BurstFrame extends Struct {
+  @Uint64()
+  external int startNs;
+
+  @Uint64()
+  external int endNs;
+
+  @Uint32()
+  external int ticks;
+
+  @Uint32()
+  external int missed;
+
+  @Uint64()
+  external int jitterMeanNs;
+
+  @Uint64()
+  external int jitterMaxNs;
+
+  @Array(2)
+  external Array<BurstStats> series;
+}
+
+/// Chip and label limit of `struct sensor_reading` (`SENSOR_NAME_LEN`)
+const int sensorNameLength = 32;
+
+/// Mirror of `struct sensor_reading` in native/common/sensors.h
+final class SensorReading extends Struct {
+  /// Celsius, or RPM for fans
+  @Double()
+  external double value;
+
+  /// Celsius; 0 if the chip reports no limit
+  @Double()
+  external double critical;
+
+  @Int32()
+  external int kind;
+
+  /// Core or fan number, -1 if none
+  @Int32()
+  external int index;
+
+  @Array(sensorNameLength)
+  external Array<Uint8> chip;
+
+  @Array(sensorNameLength)
+  external Array<Uint8> label;
+}
+
+/// Mirror of `enum sensor_kind`
+abstract final class SensorKind {
+  static const int cpuPackage = 0;
+  static const int cpuCore = 1;
+  static const int nvme = 2;
+  static const int gpu = 3;
+  static const int fan = 4;
+  static const int other = 5;
+
+  static const List<String> names = ['CPU package', 'CPU core', 'NVMe', 'GPU', 'Fan', 'Other'];
+}
+
+/// Process names are the kernel's comm (`PROCESS_NAME_LEN`)
+const int processNameLength = 16;
+
+/// Mirror of `struct process_usage` in native/common/process_top.h
+final class ProcessUsage extends Struct {
+  @Int32()
+  external int pid;
+
+  @Int32()
+  external int threads;
+
+  /// Share of one CPU, like top (can exceed 100)
+  @Double()
+  external double cpuPercent;
+
+  @Int64()
+  external int rssKb;
+
+  @Double()
+  external double readBytesPerSec;
+
+  @Double()
+  external double writeBytesPerSec;
+
+  /// NUL-terminated process name
+  @Array(processNameLength)
+  external Array<Uint8> name;
+}
+
+/// Mirror of `enum process_sort`
+abstract final class ProcessSort {
+  static const int cpu = 0;
+  static const int rss = 1;
+  static const int io = 2;
+}
+
+/// Mirror of `struct latency_stats` in native/common/latency.h
+final class LatencyStats extends Struct {
+  @Uint64()
+  external int count;
+
+  @Uint64()
+  external int meanNs;
+
+  @Uint64()
+  external int p50Ns;
+
+  @Uint64()
+  external int p99Ns;
+
+  @Uint64()
+  external int maxNs;
+}
+
+/// Mirror of `enum latency_collector`
+abstract final class LatencyCollector {
+  static const int cpu = 0;
+  static const int memory = 1;
+  static const int disk = 2;
+  static const int temperature = 3;
+  static const int snapshot = 4;
+  static const int processes = 5;
+  static const int network = 6;
+  static const int cgroups = 7;
+  static const int mounts = 8;
+  static const int diskIo = 9;
+
+  static const List<String> names = [
+    'CPU', 'Memory', 'Disk', 'Temperature', 'Snapshot', 'Processes', 'Network', 'Cgroups', 'Mounts', 'Disk I/O',
+  ];
+}
+
+/// Mirror of `enum history_metric` in native/common/history.h
+abstract final class HistoryMetric {
+  static const int cpu = 0;
+  static const int memory = 1;
+  static const int disk = 2;
+  static const int temperature = 3;
+}
+
+/// Mirror of `enum history_tier`: raw samples, 10 s and 1 min rollups
+abstract final class HistoryTier {
+  static const int raw = 0;
+  static const int tenSeconds = 1;
+  static const int oneMinute = 2;
+  
+  /// Points each tier holds (HISTORY_*_CAPACITY)
+  static const List<int> capacity = [900, 2160, 1440];
+}
+
+/// Mirror of `enum history_field`; the raw tier only has [avg]
+abstract final class HistoryField {
+  static const int avg = 0;
+  static const int min = 1;
+  static const int max = 2;
+}
+
+/// Mirror of `enum window_stat` in native/common/window_stats.h
+abstract final class WindowStat {
+  static const int mean = 0;
+  static const int ewma = 1;
+  static const int min = 2;
+  static const int max = 3;
+  static const int stddev = 4;
+}
+
+/// Mirror of `enum quantile_window_span` in native/common/quantile.h
+abstract final class QuantileWindow {
+  static const int fiveMinutes = 0;
+  static const int oneHour = 1;
+  static const int day = 2;
+}
+
+/// QUANTILE_SKETCH_MAX_BYTES: room for any encoded sketch
+const int quantileSketchMaxBytes = 8192;
+
+/// Mirror of `enum schedule_collector` in native/common/schedule.h
+abstract final class ScheduleCollector {
+  static const int cpu = 0;
+  static const int memory = 1;
+  static const int disk = 2;
+  static const int temperature = 3;
+  static const int processes = 4;
+  static const int mounts = 5;
+  static const int diskIo = 6;
+  static const int network = 7;
+  static const int sensors = 8;
+  static const int pressure = 9;
+  static const int container = 10;
+  static const int cgroups = 11;
+
+  static int bit(int collector) => 1 << collector;
+
+  /// The collectors the native sampler takes (SCHEDULE_SNAPSHOT_MASK)
+  static const int snapshotMask = 0x00f;
+
+  /// The ones the dashboard reads itself on its tick
+  static const int uiMask = 0xff0;
+}
+
+/// Mirror of `enum decimate_mode` in native/common/decimate.h
+abstract final class DecimateMode {
+  /// One point per bucket, following the shape of the line
+  static const int lttb = 0;
+
+  /// Lowest and highest point per bucket, keeping every spike
+  static const int minMax = 1;
+}
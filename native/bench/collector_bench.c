@@ -0,0 +1,433 @@
+// Micro-benchmarks for every exported collector and the batched snapshot.
+//
+// For each function this measures per-call latency, the CPU cost of calling
+// it at 10/100/1000 Hz, heap allocations per call (malloc is interposed below)
+// and system calls per call (counted by tracing a forked child with ptrace).
+// Results are written as JSON so runs can be diffed between commits.
+//
+//   collector_bench [--iterations N] [--duration-ms MS] [--output FILE]
+
+#define _GNU_SOURCE
+#include <errno.h>
+#include <signal.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/ptrace.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <sys/utsname.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "cpu_monitor.h"
+
+#define DEFAULT_ITERATIONS 10000
+#define DEFAULT_DURATION_MS 1000
+#define SYSCALL_ITERATIONS 100
+
+static const int rates_hz[] = {10, 100, 1000};
+#define RATE_COUNT (int)(sizeof(rates_hz) / sizeof(rates_hz[0]))
+
+// AddressSanitizer replaces the allocator, so frees of its blocks cannot
+// go to glibc; sanitized builds skip the interposition and report -1
+#if defined(__SANITIZE_ADDRESS__)
+#define BENCH_COUNT_ALLOCATIONS 0
+#elif defined(__has_feature)
+#if __has_feature(address_sanitizer)
+#define BENCH_COUNT_ALLOCATIONS 0
+#endif
+#endif
+#ifndef BENCH_COUNT_ALLOCATIONS
+#define BENCH_COUNT_ALLOCATIONS 1
+#endif
+
+// Allocation counting. Only calls made on the benchmark thread while
+// `counting` is set are recorded, so the sampler thread and stdio do not
+// skew the figures.
+#if BENCH_COUNT_ALLOCATIONS
+extern void* __libc_malloc(size_t size);
+extern void* __libc_calloc(size_t count, size_t size);
+extern void* __libc_realloc(void* ptr, size_t size);
+extern void __libc_free(void* ptr);
+
+static __thread int counting = 0;
+static __thread unsigned long long allocations = 0;
+
+void* malloc(size_t size) {
+    if (counting) allocations++;
+    return __libc_malloc(size);
+}
+
+void* calloc(size_t count, size_t size) {
+    if (counting) allocations++;
+    return __libc_calloc(count, size);
+}
+
+void* realloc(void* ptr, size_t size) {
+    if (counting) allocations++;
+    return __libc_realloc(ptr, size);
+}
+
+void free(void* ptr) {
+    __libc_free(ptr);
+}
+#endif
+
+// Sink for results so the calls are not optimised away
+static volatile double sink;
+
+static double per_core[CORE_USAGE_MAX_CORES * CORE_USAGE_FIELDS];
+static struct system_snapshot snapshot;
+static struct process_usage processes[20];
+static struct mount_usage mount_rows[64];
+static struct disk_io disk_rows[64];
+static struct net_io net_rows[512];
+
+static void call_cpu_usage(void) { sink = getCpuUsage(); }
+static void call_per_core_usage(void) { sink = getPerCoreUsage(per_core, CORE_USAGE_MAX_CORES * CORE_USAGE_FIELDS); }
+static void call_memory_used(void) { sink = getMemoryUsed(); }
+static void call_memory_total(void) { sink = getMemoryTotal(); }
+static void call_disk_usage(void) { sink = getDiskUsage(); }
+static void call_disk_used(void) { sink = getDiskUsed(); }
+static void call_disk_total(void) { sink = getDiskTotal(); }
+static void call_temperature(void) { sink = getTemperature(); }
+static void call_cpu_model(void) { sink = getCpuModel()[0]; }
+static void call_os_version(void) { sink = getOsVersion()[0]; }
+static void call_hostname(void) { sink = getHostname()[0]; }
+static void call_kernel_version(void) { sink = getKernelVersion()[0]; }
+static void call_core_count(void) { sink = getCpuCoreCount(); }
+
+static void call_mount_usage(void) {
+    sink = getMountUsage(mount_rows, sizeof(mount_rows) / sizeof(mount_rows[0]));
+}
+
+static void call_disk_io(void) {
+    sink = getDiskIo(disk_rows, sizeof(disk_rows) / sizeof(disk_rows[0]), 1);
+}
+
+static void call_network_io(void) {
+    sink = getNetworkIo(net_rows, sizeof(net_rows) / sizeof(net_rows[0]));
+}
+
+static void call_top_processes(void) {
+    sink = getTopProcesses(PROCESS_SORT_CPU, processes, sizeof(processes) / sizeof(processes[0]));
+}
+
+static void call_cgroup_tree(void) {
+    sink = refreshCgroupTree();
+}
+
+static void call_system_snapshot(void) {
+    snapshot.version = SYSTEM_SNAPSHOT_VERSION;
+    snapshot.size = sizeof(snapshot);
+    sink = getSystemSnapshot(&snapshot);
+}
+
+static void call_read_latest_snapshot(void) {
+    snapshot.version = SYSTEM_SNAPSHOT_VERSION;
+    snapshot.size = sizeof(snapshot);
+    sink = readLatestSnapshot(&snapshot);
+}
+
+struct benchmark {
+    const char* name;
+    void (*call)(void);
+};
+
+static const struct benchmark benchmarks[] = {
+    {"getCpuUsage", call_cpu_usage},
+    {"getPerCoreUsage", call_per_core_usage},
+    {"getMemoryUsed", call_memory_used},
+    {"getMemoryTotal", call_memory_total},
+    {"getDiskUsage", call_disk_usage},
+    {"getDiskUsed", call_disk_used},
+    {"getDiskTotal", call_disk_total},
+    {"getTemperature", call_temperature},
+    {"getMountUsage", call_mount_usage},
+    {"getDiskIo", call_disk_io},
+    {"getNetworkIo", call_network_io},
+    {"getSystemSnapshot", call_system_snapshot},
+    {"readLatestSnapshot", call_read_latest_snapshot},
+    {"getTopProcesses", call_top_processes},
+    {"refreshCgroupTree", call_cgroup_tree},
+    {"getCpuModel", call_cpu_model},
+    {"getOsVersion", call_os_version},
+    {"getHostname", call_hostname},
+    {"getKernelVersion", call_kernel_version},
+    {"getCpuCoreCount", call_core_count},
+};
+#define BENCHMARK_COUNT (int)(sizeof(benchmarks) / sizeof(benchmarks[0]))
+
+struct latency_summary {
+    uint64_t min, mean, p50, p99, max;
+};
+
+struct rate_result {
+    int target_hz;
+    double achieved_hz;
+    double cpu_percent;
+    int missed;
+};
+
+static int compare_u64(const void* a, const void* b) {
+    uint64_t x = *(const uint64_t*)a, y = *(const uint64_t*)b;
+    return (x > y) - (x < y);
+}
+
+static uint64_t thread_cpu_ns(void) {
+    struct rusage usage;
+    getrusage(RUSAGE_THREAD, &usage);
+    return ((uint64_t)usage.ru_utime.tv_sec + (uint64_t)usage.ru_stime.tv_sec) * 1000000000ull +
+           ((uint64_t)usage.ru_utime.tv_usec + (uint64_t)usage.ru_stime.tv_usec) * 1000ull;
+}
+
+// Time `iterations` back-to-back calls and summarise them
+static void measure_latency(const struct benchmark* bench, int iterations, uint64_t* samples,
+                            struct latency_summary* summary) {
+    uint64_t sum = 0;
+
+    for (int i = 0; i < iterations; i++) {
+        uint64_t start = latency_now_ns();
+        bench->call();
+        samples[i] = latency_now_ns() - start;
+        sum += samples[i];
+    }
+
+    qsort(samples, (size_t)iterations, sizeof(uint64_t), compare_u64);
+    summary->min = samples[0];
+    summary->mean = sum / (uint64_t)iterations;
+    summary->p50 = samples[(iterations - 1) / 2];
+    summary->p99 = samples[(int)((iterations - 1) * 0.99)];
+    summary->max = samples[iterations - 1];
+}
+
+// Call at a fixed rate for `duration_ms` and report the CPU it costs
+static void measure_rate(const struct benchmark* bench, int hz, int duration_ms,
+                         struct rate_result* result) {
+    uint64_t period = 1000000000ull / (uint64_t)hz;
+    uint64_t start = latency_now_ns();
+    uint64_t end = start + (uint64_t)duration_ms * 1000000ull;
+    uint64_t cpu_start = thread_cpu_ns();
+    uint64_t deadline = start;
+    int calls = 0;
+
+    result->target_hz = hz;
+    result->missed = 0;
+
+    while (deadline < end) {
+        bench->call();
+        calls++;
+
+        deadline += period;
+        uint64_t now = latency_now_ns();
+        if (now > deadline) {
+            // Overran the slot; skip the ticks we can no longer make
+            result->missed += (int)((now - deadline) / period) + 1;
+            deadline += ((now - deadline) / period + 1) * period;
+            continue;
+        }
+
+        struct timespec wake = {
+            .tv_sec = (time_t)(deadline / 1000000000ull),
+            .tv_nsec = (long)(deadline % 1000000000ull),
+        };
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &wake, NULL) == EINTR) {
+        }
+    }
+
+    uint64_t elapsed = latency_now_ns() - start;
+    result->achieved_hz = (double)calls * 1e9 / (double)elapsed;
+    result->cpu_percent = (double)(thread_cpu_ns() - cpu_start) * 100.0 / (double)elapsed;
+}
+
+// Heap allocations made by `iterations` calls, after a warm-up call; -1
+// when allocations are not counted
+static double measure_allocations(const struct benchmark* bench, int iterations) {
+#if BENCH_COUNT_ALLOCATIONS
+    bench->call();
+
+    allocations = 0;
+    counting = 1;
+    for (int i = 0; i < iterations; i++) {
+        bench->call();
+    }
+    counting = 0;
+    return (double)allocations / (double)iterations;
+#else
+    (void)bench;
+    (void)iterations;
+    return -1.0;
+#endif
+}
+
+// Count the system calls made by `iterations` calls in a traced child.
+// getppid() brackets the measured loop; no collector calls it. Returns -1 if
+// the child cannot be traced (e.g. ptrace is blocked in a container).
+static double measure_syscalls(const struct benchmark* bench, int iterations) {
+    pid_t child = fork();
+    if (child < 0) return -1.0;
+
+    if (child == 0) {
+        if (ptrace(PTRACE_TRACEME, 0, NULL, NULL) != 0) _exit(2);
+        raise(SIGSTOP);
+
+        bench->call();
+        syscall(SYS_getppid);
+        for (int i = 0; i < iterations; i++) {
+            bench->call();
+        }
+        syscall(SYS_getppid);
+        _exit(0);
+    }
+
+    int status;
+    if (waitpid(child, &status, 0) != child || !WIFSTOPPED(status)) {
+        waitpid(child, &status, 0);
+        return -1.0;
+    }
+    ptrace(PTRACE_SETOPTIONS, child, NULL, (void*)(long)(PTRACE_O_TRACESYSGOOD | PTRACE_O_EXITKILL));
+
+    // 0 = before the first marker, 1 = measuring, 2 = done
+    int phase = 0;
+    long count = 0;
+    int signal = 0;
+
+    for (;;) {
+        if (ptrace(PTRACE_SYSCALL, child, NULL, (void*)(long)signal) != 0) break;
+        if (waitpid(child, &status, 0) != child || WIFEXITED(status) || WIFSIGNALED(status)) break;
+
+        signal = 0;
+        if (WSTOPSIG(status) != (SIGTRAP | 0x80)) {
+            // Forward real signals to the child
+            signal = WSTOPSIG(status);
+            continue;
+        }
+
+        struct __ptrace_syscall_info info;
+        if (ptrace(PTRACE_GET_SYSCALL_INFO, child, (void*)sizeof(info), &info) <= 0 ||
+            info.op != PTRACE_SYSCALL_INFO_ENTRY) {
+            continue;
+        }
+
+        if (info.entry.nr == SYS_getppid) {
+            phase++;
+        } else if (phase == 1) {
+            count++;
+        }
+    }
+
+    if (!WIFEXITED(status) && !WIFSIGNALED(status)) {
+        kill(child, SIGKILL);
+        waitpid(child, &status, 0);
+    }
+    return phase >= 2 ? (double)count / (double)iterations : -1.0;
+}
+
+static void write_latency(FILE* out, const struct latency_summary* s) {
+    fprintf(out, "{\"min\": %llu, \"mean\": %llu, \"p50\": %llu, \"p99\": %llu, \"max\": %llu}",
+            (unsigned long long)s->min, (unsigned long long)s->mean, (unsigned long long)s->p50,
+            (unsigned long long)s->p99, (unsigned long long)s->max);
+}
+
+static void usage(const char* program) {
+    fprintf(stderr, "usage: %s [--iterations N] [--duration-ms MS] [--output FILE]\n", program);
+}
+
+int main(int argc, char** argv) {
+    int iterations = DEFAULT_ITERATIONS;
+    int duration_ms = DEFAULT_DURATION_MS;
+    const char* output = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--iterations") == 0 && i + 1 < argc) {
+            iterations = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--duration-ms") == 0 && i + 1 < argc) {
+            duration_ms = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--output") == 0 && i + 1 < argc) {
+            output = argv[++i];
+        } else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if (iterations <= 0 || duration_ms <= 0) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    FILE* out = output ? fopen(output, "w") : stdout;
+    if (out == NULL) {
+        fprintf(stderr, "Cannot open %s\n", output);
+        return 1;
+    }
+
+    uint64_t* samples = malloc((size_t)iterations * sizeof(uint64_t));
+    if (samples == NULL) return 1;
+
+    init_cpu_monitoring();
+
+    // readLatestSnapshot only has data once the sampler has published;
+    // syscall counts come from a forked child, where the sampler thread does
+    // not exist, so they reflect the read path alone
+    startSampler(1000);
+    struct timespec settle = {0, 50 * 1000000L};
+    while (readLatestSnapshot(&(struct system_snapshot){.version = SYSTEM_SNAPSHOT_VERSION,
+                                                        .size = sizeof(struct system_snapshot)}) != 0) {
+        nanosleep(&settle, NULL);
+    }
+
+    struct utsname host;
+    uname(&host);
+
+    fprintf(out, "{\n");
+    fprintf(out, "  \"schema\": 1,\n");
+    fprintf(out, "  \"kernel\": \"%s\",\n", host.release);
+    fprintf(out, "  \"machine\": \"%s\",\n", host.machine);
+    fprintf(out, "  \"cpus\": %ld,\n", sysconf(_SC_NPROCESSORS_ONLN));
+    fprintf(out, "  \"iterations\": %d,\n", iterations);
+    fprintf(out, "  \"duration_ms\": %d,\n", duration_ms);
+    fprintf(out, "  \"benchmarks\": [\n");
+
+    for (int b = 0; b < BENCHMARK_COUNT; b++) {
+        const struct benchmark* bench = &benchmarks[b];
+        struct latency_summary latency;
+        struct rate_result rates[RATE_COUNT];
+
+        double allocs = measure_allocations(bench, iterations);
+        measure_latency(bench, iterations, samples, &latency);
+        for (int r = 0; r < RATE_COUNT; r++) {
+            measure_rate(bench, rates_hz[r], duration_ms, &rates[r]);
+        }
+        fflush(out);
+        double syscalls = measure_syscalls(bench, SYSCALL_ITERATIONS);
+
+        fprintf(out, "    {\n");
+        fprintf(out, "      \"name\": \"%s\",\n", bench->name);
+        fprintf(out, "      \"latency_ns\": ");
+        write_latency(out, &latency);
+        fprintf(out, ",\n");
+        fprintf(out, "      \"allocations_per_call\": %.3f,\n", allocs);
+        fprintf(out, "      \"syscalls_per_call\": %.3f,\n", syscalls);
+        fprintf(out, "      \"rates\": [");
+        for (int r = 0; r < RATE_COUNT; r++) {
+            fprintf(out, "%s{\"target_hz\": %d, \"achieved_hz\": %.1f, \"cpu_percent\": %.3f, \"missed\": %d}",
+                    r ? ", " : "", rates[r].target_hz, rates[r].achieved_hz, rates[r].cpu_percent,
+                    rates[r].missed);
+        }
+        fprintf(out, "]\n");
+        fprintf(out, "    }%s\n", b + 1 < BENCHMARK_COUNT ? "," : "");
+    }
+
+    fprintf(out, "  ]\n");
+    fprintf(out, "}\n");
+
+    stopSampler();
+    // Releases every collector's cached state so leak checkers see a clean exit
+    cleanup_cpu_monitoring();
+    free(samples);
+    if (out != stdout) fclose(out);
+    return 0;
+}
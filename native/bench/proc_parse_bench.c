@@ -0,0 +1,274 @@
+// Times the /proc parser against a naive sscanf() parser on captured /proc
+// samples (bench/proc_samples) and prints JSON.
+//
+//   proc_parse_bench [--iterations N] [--samples DIR] [--output FILE]
+
+#define _GNU_SOURCE
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "proc_parse.h"
+
+#define DEFAULT_ITERATIONS 20000
+#define MAX_LINES 4096
+
+struct sample {
+    const char* name;
+    void (*parse_fast)(const char* buffer, const char* end);
+    void (*parse_sscanf)(char** lines, int count);
+    char* buffer;
+    size_t length;
+    char* lines[MAX_LINES];           // NUL-terminated copies for sscanf
+    int line_count;
+};
+
+// Sink for results so the parsing is not optimised away
+static volatile uint64_t sink;
+
+static uint64_t now_ns(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000ull + (uint64_t)now.tv_nsec;
+}
+
+static void fast_stat(const char* buffer, const char* end) {
+    uint64_t fields[PROC_CPU_FIELD_COUNT];
+    for (const char* line = buffer; line < end && line[0] == 'c'; line = proc_next_line(line, end)) {
+        const char* cursor = proc_skip_fields(line, end, 1);
+        proc_parse_fields(&cursor, end, &proc_stat_cpu_fields, fields);
+        sink += fields[PROC_CPU_USER];
+    }
+}
+
+static void sscanf_stat(char** lines, int count) {
+    unsigned long long f[8];
+    for (int i = 0; i < count && lines[i][0] == 'c'; i++) {
+        sscanf(lines[i], "%*s %llu %llu %llu %llu %llu %llu %llu %llu", &f[0], &f[1], &f[2], &f[3], &f[4], &f[5],
+               &f[6], &f[7]);
+        sink += f[0];
+    }
+}
+
+static const struct proc_key meminfo_keys[] = {
+    PROC_KEY("MemTotal"), PROC_KEY("MemFree"), PROC_KEY("MemAvailable"), PROC_KEY("Cached"),
+    PROC_KEY("SwapTotal"), PROC_KEY("SwapFree"),
+};
+#define MEMINFO_KEYS (int)(sizeof(meminfo_keys) / sizeof(meminfo_keys[0]))
+
+static void fast_meminfo(const char* buffer, const char* end) {
+    uint64_t values[MEMINFO_KEYS];
+    proc_parse_keyed(buffer, end, meminfo_keys, MEMINFO_KEYS, values);
+    sink += values[0];
+}
+
+static void sscanf_meminfo(char** lines, int count) {
+    int found = 0;
+    for (int i = 0; i < count && found < MEMINFO_KEYS; i++) {
+        char key[64];
+        unsigned long long value;
+        if (sscanf(lines[i], "%63[^:]: %llu", key, &value) != 2) continue;
+        for (int k = 0; k < MEMINFO_KEYS; k++) {
+            if (strcmp(key, meminfo_keys[k].name) == 0) {
+                sink += value;
+                found++;
+            }
+        }
+    }
+}
+
+static void fast_diskstats(const char* buffer, const char* end) {
+    uint64_t fields[PROC_DISK_FIELD_COUNT];
+    for (const char* line = buffer; line < end; line = proc_next_line(line, end)) {
+        const char* cursor = proc_skip_fields(line, end, 3);
+        proc_parse_fields(&cursor, end, &proc_diskstats_fields, fields);
+        sink += fields[PROC_DISK_READS];
+    }
+}
+
+static void sscanf_diskstats(char** lines, int count) {
+    unsigned long long f[8];
+    for (int i = 0; i < count; i++) {
+        sscanf(lines[i], "%*u %*u %*s %llu %*u %llu %llu %llu %*u %llu %llu %llu %llu", &f[0], &f[1], &f[2], &f[3],
+               &f[4], &f[5], &f[6], &f[7]);
+        sink += f[0];
+    }
+}
+
+static void fast_pid_stat(const char* buffer, const char* end) {
+    uint64_t fields[PROC_PID_FIELD_COUNT];
+    for (const char* line = buffer; line < end;) {
+        const char* next = proc_next_line(line, end);
+        const char* close_paren = memrchr(line, ')', (size_t)(next - line));
+        if (close_paren != NULL) {
+            const char* cursor = close_paren + 1;
+            proc_parse_fields(&cursor, end, &proc_pid_stat_fields, fields);
+            sink += fields[PROC_PID_UTIME];
+        }
+        line = next;
+    }
+}
+
+static void sscanf_pid_stat(char** lines, int count) {
+    unsigned long long f[5];
+    for (int i = 0; i < count; i++) {
+        char* close_paren = strrchr(lines[i], ')');
+        if (close_paren == NULL) continue;
+        sscanf(close_paren + 1,
+               " %*c %*d %*d %*d %*d %*d %*u %*u %*u %*u %*u %llu %llu %*d %*d %*d %*d %llu %*d %llu %*u %llu",
+               &f[0], &f[1], &f[2], &f[3], &f[4]);
+        sink += f[0];
+    }
+}
+
+static void fast_net_dev(const char* buffer, const char* end) {
+    uint64_t fields[PROC_NET_FIELD_COUNT];
+    const char* line = proc_next_line(proc_next_line(buffer, end), end);
+    for (; line < end; line = proc_next_line(line, end)) {
+        const char* colon = memchr(line, ':', (size_t)(end - line));
+        if (colon == NULL) break;
+        const char* cursor = colon + 1;
+        proc_parse_fields(&cursor, end, &proc_net_dev_fields, fields);
+        sink += fields[PROC_NET_RX_BYTES];
+    }
+}
+
+static void sscanf_net_dev(char** lines, int count) {
+    unsigned long long f[8];
+    for (int i = 2; i < count; i++) {
+        char* colon = strchr(lines[i], ':');
+        if (colon == NULL) break;
+        sscanf(colon + 1, "%llu %llu %llu %llu %*u %*u %*u %*u %llu %llu %llu %llu", &f[0], &f[1], &f[2], &f[3],
+               &f[4], &f[5], &f[6], &f[7]);
+        sink += f[0];
+    }
+}
+
+static struct sample samples[] = {
+    {.name = "stat", .parse_fast = fast_stat, .parse_sscanf = sscanf_stat},
+    {.name = "meminfo", .parse_fast = fast_meminfo, .parse_sscanf = sscanf_meminfo},
+    {.name = "diskstats", .parse_fast = fast_diskstats, .parse_sscanf = sscanf_diskstats},
+    {.name = "pid_stat", .parse_fast = fast_pid_stat, .parse_sscanf = sscanf_pid_stat},
+    {.name = "net_dev", .parse_fast = fast_net_dev, .parse_sscanf = sscanf_net_dev},
+};
+#define SAMPLE_COUNT (int)(sizeof(samples) / sizeof(samples[0]))
+
+static int load_sample(struct sample* sample, const char* dir) {
+    char path[512];
+    snprintf(path, sizeof(path), "%s/%s", dir, sample->name);
+
+    FILE* file = fopen(path, "r");
+    if (file == NULL) {
+        fprintf(stderr, "Cannot open %s\n", path);
+        return -1;
+    }
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    rewind(file);
+    sample->buffer = malloc((size_t)size + 1);
+    if (sample->buffer == NULL) {
+        fclose(file);
+        return -1;
+    }
+    sample->length = fread(sample->buffer, 1, (size_t)size, file);
+    sample->buffer[sample->length] = '\0';
+    fclose(file);
+
+    const char* end = sample->buffer + sample->length;
+    sample->line_count = 0;
+    for (const char* line = sample->buffer; line < end && sample->line_count < MAX_LINES;) {
+        const char* next = proc_next_line(line, end);
+        sample->lines[sample->line_count++] = strndup(line, (size_t)(next - line));
+        line = next;
+    }
+    return 0;
+}
+
+// Mean time per parse of the whole sample, best of five batches
+static double time_fast(const struct sample* sample, int iterations) {
+    const char* end = sample->buffer + sample->length;
+    double best = 0;
+
+    for (int batch = 0; batch < 5; batch++) {
+        uint64_t start = now_ns();
+        for (int i = 0; i < iterations; i++) sample->parse_fast(sample->buffer, end);
+        double mean = (double)(now_ns() - start) / iterations;
+        if (batch == 0 || mean < best) best = mean;
+    }
+    return best;
+}
+
+static double time_sscanf(const struct sample* sample, int iterations) {
+    double best = 0;
+
+    for (int batch = 0; batch < 5; batch++) {
+        uint64_t start = now_ns();
+        for (int i = 0; i < iterations; i++) sample->parse_sscanf((char**)sample->lines, sample->line_count);
+        double mean = (double)(now_ns() - start) / iterations;
+        if (batch == 0 || mean < best) best = mean;
+    }
+    return best;
+}
+
+static void usage(const char* program) {
+    fprintf(stderr, "usage: %s [--iterations N] [--samples DIR] [--output FILE]\n", program);
+}
+
+int main(int argc, char** argv) {
+    int iterations = DEFAULT_ITERATIONS;
+    const char* dir = PROC_SAMPLES_DIR;
+    const char* output = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--iterations") == 0 && i + 1 < argc) {
+            iterations = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--samples") == 0 && i + 1 < argc) {
+            dir = argv[++i];
+        } else if (strcmp(argv[i], "--output") == 0 && i + 1 < argc) {
+            output = argv[++i];
+        } else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if (iterations <= 0) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    for (int s = 0; s < SAMPLE_COUNT; s++) {
+        if (load_sample(&samples[s], dir) != 0) return 1;
+    }
+
+    FILE* out = output ? fopen(output, "w") : stdout;
+    if (out == NULL) {
+        fprintf(stderr, "Cannot open %s\n", output);
+        return 1;
+    }
+
+    fprintf(out, "{\n");
+    fprintf(out, "  \"schema\": 1,\n");
+    fprintf(out, "  \"iterations\": %d,\n", iterations);
+    fprintf(out, "  \"samples\": [\n");
+    for (int s = 0; s < SAMPLE_COUNT; s++) {
+        const struct sample* sample = &samples[s];
+        double fast = time_fast(sample, iterations);
+        double reference = time_sscanf(sample, iterations);
+
+        fprintf(out, "    {\"name\": \"%s\", \"bytes\": %zu, \"lines\": %d, \"proc_parse_ns\": %.1f, "
+                     "\"sscanf_ns\": %.1f, \"speedup\": %.2f}%s\n",
+                sample->name, sample->length, sample->line_count, fast, reference, reference / fast,
+                s + 1 < SAMPLE_COUNT ? "," : "");
+    }
+    fprintf(out, "  ]\n");
+    fprintf(out, "}\n");
+
+    for (int s = 0; s < SAMPLE_COUNT; s++) {
+        for (int i = 0; i < samples[s].line_count; i++) free(samples[s].lines[i]);
+        free(samples[s].buffer);
+    }
+    if (out != stdout) fclose(out);
+    return 0;
+}
@@ -4,32 +4,100 @@
 set -e
 
 # Create build directory
-mkdir -p ../build/libs
+mkdir -p ../build/libs ../build/bin
 
 # Detect OS
 OS=$(uname -s)
 
+# Pushing snapshots to Dart (common/dart_port.h) needs dart_api_dl.c from the
+# Dart SDK. Set DART_SDK_INCLUDE, or it is looked up next to flutter or dart.
+if [ -z "$DART_SDK_INCLUDE" ]; then
+    for tool in flutter dart; do
+        if command -v "$tool" > /dev/null; then
+            bin_dir=$(dirname "$(readlink -f "$(command -v "$tool")")")
+            for candidate in "$bin_dir/cache/dart-sdk/include" "$bin_dir/../include"; do
+                if [ -f "$candidate/dart_api_dl.c" ]; then
+                    DART_SDK_INCLUDE=$candidate
+                    break 2
+                fi
+            done
+        fi
+    done
+fi
+DART_PORT_FLAGS=()
+if [ -n "$DART_SDK_INCLUDE" ] && [ -f "$DART_SDK_INCLUDE/dart_api_dl.c" ]; then
+    echo "Dart native ports enabled: $DART_SDK_INCLUDE"
+    DART_PORT_FLAGS=(-DCPU_MONITOR_DART_PORTS -I"$DART_SDK_INCLUDE" "$DART_SDK_INCLUDE/dart_api_dl.c")
+fi
+
 if [ "$OS" = "Darwin" ]; then
     echo "Building for macOS..."
     
     # Build macOS dynamic library
-    clang -shared -fPIC \
+    clang -shared -fPIC -O3 \
         -o ../build/libs/libcpu_monitor.dylib \
         -framework IOKit \
         -framework CoreFoundation \
-        macos/cpu_monitor.c
+        macos/cpu_monitor.c \
+        common/core_usage.c \
+        common/dart_port.c \
+        common/decimate.c \
+        common/history.c \
+        common/history_db.c \
+        common/latency.c \
+        common/quantile.c \
+        common/sampler.c \
+        common/schedule.c \
+        common/shared_segment.c \
+        common/window_stats.c \
+        "${DART_PORT_FLAGS[@]}"
     
     echo "macOS library built successfully: $(pwd)/../build/libs/libcpu_monitor.dylib"
     
+    # Headless collector for shared-memory publishing
+    clang -O3 -Imacos \
+        -o ../build/bin/cpu_monitor_daemon \
+        daemon/cpu_monitor_daemon.c \
+        -L../build/libs -lcpu_monitor -Wl,-rpath,@loader_path/../libs
+    
 elif [ "$OS" = "Linux" ]; then
     echo "Building for Linux..."
     
     # Build Linux shared library
-    gcc -shared -fPIC \
+    gcc -shared -fPIC -O3 -Wall -pthread \
         -o ../build/libs/libcpu_monitor.so \
-        linux/cpu_monitor.c
+        linux/burst.c \
+        linux/cgroup.c \
+        linux/cgroup_tree.c \
+        linux/cpu_monitor.c \
+        linux/diskstats.c \
+        linux/mounts.c \
+        linux/netdev.c \
+        linux/pressure.c \
+        linux/proc_parse.c \
+        linux/process_top.c \
+        linux/sensors.c \
+        common/core_usage.c \
+        common/dart_port.c \
+        common/decimate.c \
+        common/history.c \
+        common/history_db.c \
+        common/latency.c \
+        common/quantile.c \
+        common/sampler.c \
+        common/schedule.c \
+        common/shared_segment.c \
+        common/window_stats.c \
+        "${DART_PORT_FLAGS[@]}" \
+        -lm -lrt
     
     echo "Linux library built successfully: $(pwd)/../build/libs/libcpu_monitor.so"
+    
+    # Headless collector for shared-memory publishing
+    gcc -O3 -Wall -pthread -Ilinux \
+        -o ../build/bin/cpu_monitor_daemon \
+        daemon/cpu_monitor_daemon.c \
+        -L../build/libs -lcpu_monitor -Wl,-rpath,'$ORIGIN/../libs'
 else
     echo "Unsupported operating system: $OS"
     exit 1
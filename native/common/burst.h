@@ -0,0 +1,77 @@
+#ifndef BURST_H
+#define BURST_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// High-frequency burst sampling (Linux). A dedicated thread wakes on a
+// CLOCK_MONOTONIC timerfd 100 to 1000 times a second, reads the CPU
+// counters and the CPU pressure stall total, and folds each sample into the
+// current frame's min / max / mean / last. The UI takes one frame per paint
+// with readBurstFrame(), which returns everything since its previous call
+// and starts a new frame, so a 1000 Hz burst costs Dart the same as 1 Hz
+// while still showing 50 ms spikes.
+//
+// /proc/stat counts in 10 ms ticks, so CPU usage gets a new sample only
+// once some tick has been accounted since the last one; ticks that find
+// the counters unchanged are not reported as idle. The stall total is in
+// microseconds and gives a sample on every tick.
+
+#define BURST_MIN_RATE_HZ 100
+#define BURST_MAX_RATE_HZ 1000
+
+enum burst_series {
+    BURST_CPU = 0,               // Busy percent of all CPUs
+    BURST_CPU_PRESSURE = 1,      // Percent of the interval some task stalled on CPU
+    BURST_SERIES_COUNT
+};
+
+struct burst_stats {
+    double min;
+    double max;
+    double mean;
+    double last;
+    uint32_t count;              // Samples folded in; the figures are NaN if 0
+    uint32_t reserved;
+};
+
+struct burst_frame {
+    uint64_t start_ns;           // Monotonic time of the first tick folded in
+    uint64_t end_ns;             // ... and of the last one
+    uint32_t ticks;              // Timer expirations handled
+    uint32_t missed;             // Expirations that passed while the thread was late
+    uint64_t jitter_mean_ns;     // Delay from each expiration to the wakeup
+    uint64_t jitter_max_ns;
+    struct burst_stats series[BURST_SERIES_COUNT];
+};
+
+// Start sampling at `rate_hz`, clamped to BURST_MIN_RATE_HZ ..
+// BURST_MAX_RATE_HZ; a running sampler is restarted at the new rate.
+// Returns 0 on success, -1 on error.
+int startBurstSampler(int rate_hz);
+
+// Stop the burst thread and wait for it to exit (at most one tick)
+void stopBurstSampler();
+
+// Current rate, or 0 when stopped
+int getBurstRate();
+
+// Move the samples since the previous call into `frame` and start a new
+// one. Returns the number of ticks in the frame, or -1 if the sampler is
+// not running, its timer failed, or `frame` is NULL. After a failure,
+// startBurstSampler() restarts it even at the same rate.
+int readBurstFrame(struct burst_frame* frame);
+
+// Read CPU counters and the stall total from these files instead of
+// /proc/stat and /proc/pressure/cpu; used by tests. NULL restores the
+// default. Takes effect at the next start.
+void burst_set_sources(const char* stat_path, const char* pressure_path);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // BURST_H
@@ -0,0 +1,64 @@
+#ifndef CGROUP_H
+#define CGROUP_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Container-level CPU and memory accounting from the cgroup v2 group this
+// process runs in. The group is found once, from /proc/self/cgroup and the
+// cgroup2 mount in /proc/self/mountinfo; its accounting files, and the
+// limit files of every ancestor, then stay open so a read is one pread()
+// per file. Limits are the tightest along the path up to the mount, since
+// a parent's limit caps its children.
+//
+// Outside a cgroup (cgroup v1 only, the root group, or no cgroup2 mount)
+// the same figures describe the whole host.
+
+#define CGROUP_PATH_LEN 512
+
+// Which limits apply; the others are the host's
+#define CGROUP_LIMIT_CPU 0x1          // cpu.max quota or a narrower cpuset
+#define CGROUP_LIMIT_MEMORY 0x2       // memory.max
+
+struct cgroup_usage {
+    double cpu_percent;           // Of cpu_limit, since the previous call; -1 on the first
+    double cpu_limit;             // Cores the group may use
+    double throttled_percent;     // Quota periods throttled, since the previous call
+    double throttled_ms;          // Time throttled, since the previous call
+    int64_t memory_used_mb;       // memory.current less inactive file cache
+    int64_t memory_current_mb;    // memory.current, page cache included
+    int64_t memory_limit_mb;      // Tightest memory.max, or the host's memory
+    int32_t in_cgroup;            // 0: host figures
+    int32_t limits;               // CGROUP_LIMIT_* bits
+};
+
+// Read the group's usage. Returns 0 on success, -1 if `out` is NULL or
+// nothing could be read.
+int getCgroupUsage(struct cgroup_usage* out);
+
+// The group's path below the cgroup2 mount ("/system.slice/app.service"),
+// or "" outside a cgroup
+const char* getCgroupPath();
+
+// Read the process's cgroup and the mount table from other files, and
+// /proc/stat and /proc/meminfo for the host fallback; used by tests. NULL
+// restores a default. Drops the detected group.
+void cgroup_set_sources(const char* proc_cgroup_path, const char* mountinfo_path, const char* stat_path,
+                        const char* meminfo_path);
+
+// Mount point of the cgroup2 hierarchy, from the mount table set by
+// cgroup_set_sources(). Returns 0, or -1 without one.
+int cgroup_mount_point(char* out, size_t capacity);
+
+// Close every descriptor and forget the group
+void cgroup_cleanup();
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CGROUP_H
@@ -0,0 +1,67 @@
+#ifndef CGROUP_TREE_H
+#define CGROUP_TREE_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// CPU, memory and I/O of every cgroup on the host (systemd services,
+// slices, containers), as a tree under the cgroup2 mount. The collector
+// keeps each group's directory open and reads its files relative to it;
+// the hierarchy is walked again only when inotify reports a group created,
+// removed or renamed. Rates are since the previous refresh that read the
+// group. cgroup v2 charges a group with everything below it, so the
+// children of a group add up to at most the group itself.
+
+// Group names are cut to CGROUP_NAME_LEN - 1 bytes
+#define CGROUP_NAME_LEN 64
+
+enum cgroup_sort {
+    CGROUP_SORT_CPU = 0,
+    CGROUP_SORT_MEMORY = 1,
+    CGROUP_SORT_IO = 2,
+    CGROUP_SORT_COUNT
+};
+
+struct cgroup_node {
+    uint64_t id;                  // Inode of the group's directory, the kernel's cgroup ID
+    uint64_t parent_id;           // 0 for the root
+    double cpu_percent;           // Share of one CPU, like top (can exceed 100)
+    double read_bytes_per_sec;    // io.stat, every device
+    double write_bytes_per_sec;
+    int64_t memory_kb;            // memory.current; 0 where it is not charged (the root)
+    int32_t depth;                // 0 for the root
+    int32_t children;
+    char name[CGROUP_NAME_LEN];   // Last path component, "/" for the root
+};
+
+// Re-read every group, walking the hierarchy first if groups came or went.
+// On hosts with thousands of groups the reads are spread over several
+// calls, but the children last asked for with getCgroupChildren() are read
+// on every call. Returns the number of groups, or -1 without a cgroup2
+// mount. Not thread-safe; call from one thread.
+int refreshCgroupTree();
+
+// Write the `capacity` busiest children of group `parent_id` by `sort`
+// into `out`, busiest first; `parent_id` 0 is the root. Returns the number
+// written, or -1 for an unknown group or a bad argument.
+int getCgroupChildren(uint64_t parent_id, int sort, struct cgroup_node* out, int capacity);
+
+// Figures of one group, 0 for the root. Returns 0, or -1 if the group is
+// not in the tree.
+int getCgroupNode(uint64_t id, struct cgroup_node* out);
+
+// Walk the tree under `path` instead of the cgroup2 mount; used by tests.
+// NULL restores the mount. Drops the tree.
+void cgroup_tree_set_root(const char* path);
+
+// Close every descriptor and inotify watch and drop the tree
+void cgroup_tree_cleanup();
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CGROUP_TREE_H
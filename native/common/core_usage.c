@@ -0,0 +1,47 @@
+#include "core_usage.h"
+
+// Cores handled per block; keeps the temporaries in L1
+#define CORE_BLOCK 64
+
+int core_usage_compute(const struct core_counters* current,
+                       const struct core_counters* previous,
+                       double* out, int capacity) {
+    double user[CORE_BLOCK], system[CORE_BLOCK], idle[CORE_BLOCK], iowait[CORE_BLOCK];
+    int count = current->count;
+
+    if (capacity < 0) return 0;
+    if (count > capacity / CORE_USAGE_FIELDS) count = capacity / CORE_USAGE_FIELDS;
+
+    for (int base = 0; base < count; base += CORE_BLOCK) {
+        int n = count - base < CORE_BLOCK ? count - base : CORE_BLOCK;
+
+        // Deltas stay 64-bit: a baseline of zero makes them ticks since
+        // boot, which pass 2^31 after about 248 days at USER_HZ=100
+        for (int i = 0; i < n; i++) {
+            int64_t du = (int64_t)(current->user[base + i] - previous->user[base + i]);
+            int64_t ds = (int64_t)(current->system[base + i] - previous->system[base + i]);
+            int64_t di = (int64_t)(current->idle[base + i] - previous->idle[base + i]);
+            int64_t dw = (int64_t)(current->iowait[base + i] - previous->iowait[base + i]);
+            int64_t dt = (int64_t)(current->steal[base + i] - previous->steal[base + i]);
+            int64_t total = du + ds + di + dw + dt;
+            // Branch-free guard for cores that saw no ticks at all; their
+            // shares then all come out as 0
+            total += (total == 0);
+            double scale = 100.0 / (double)total;
+            user[i] = (double)du * scale;
+            system[i] = (double)ds * scale;
+            idle[i] = (double)di * scale;
+            iowait[i] = (double)dw * scale;
+        }
+
+        double* dst = out + (long)base * CORE_USAGE_FIELDS;
+        for (int i = 0; i < n; i++) {
+            dst[i * CORE_USAGE_FIELDS + 0] = user[i];
+            dst[i * CORE_USAGE_FIELDS + 1] = system[i];
+            dst[i * CORE_USAGE_FIELDS + 2] = idle[i];
+            dst[i * CORE_USAGE_FIELDS + 3] = iowait[i];
+        }
+    }
+
+    return count;
+}
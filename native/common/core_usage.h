@@ -0,0 +1,44 @@
+#ifndef CORE_USAGE_H
+#define CORE_USAGE_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Largest number of logical CPUs tracked per host
+#define CORE_USAGE_MAX_CORES 1024
+
+// Shares reported per core, in this order: user, system, idle, iowait
+#define CORE_USAGE_FIELDS 4
+
+// Cumulative per-core tick counters in structure-of-arrays layout, one
+// contiguous array per CPU state, so the per-tick delta math runs as
+// straight-line loops the compiler can vectorise.
+struct core_counters {
+    int count;
+    uint64_t user[CORE_USAGE_MAX_CORES];     // user + nice
+    uint64_t system[CORE_USAGE_MAX_CORES];   // system + irq + softirq
+    uint64_t idle[CORE_USAGE_MAX_CORES];
+    uint64_t iowait[CORE_USAGE_MAX_CORES];
+    uint64_t steal[CORE_USAGE_MAX_CORES];    // Counted in the total, not reported
+};
+
+// Compute user/system/idle/iowait percentages for every core between two
+// counter sets and write them interleaved (CORE_USAGE_FIELDS per core) into
+// `out`. Writes at most `capacity` doubles; returns the number of cores written.
+int core_usage_compute(const struct core_counters* current,
+                       const struct core_counters* previous,
+                       double* out, int capacity);
+
+// Get per-core usage shares for every logical CPU since the previous call.
+// `capacity` is the number of doubles in `out`; returns the number of cores
+// written (CORE_USAGE_FIELDS doubles each) or -1 on error.
+int getPerCoreUsage(double* out, int capacity);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CORE_USAGE_H
@@ -0,0 +1,118 @@
+#include <pthread.h>
+#include <stdatomic.h>
+#include <string.h>
+
+#include "dart_port.h"
+
+#ifdef CPU_MONITOR_DART_PORTS
+#include "dart_api_dl.h"
+#endif
+
+// Posting state, guarded by port_lock. snapshot_port is also read without
+// the lock so that an unsubscribed sampler pays one atomic load per sample.
+static pthread_mutex_t port_lock = PTHREAD_MUTEX_INITIALIZER;
+static _Atomic int64_t snapshot_port = 0;
+static int api_ready = 0;
+static double change_threshold = 0.0;
+static uint64_t max_silence_ns = 0;
+
+// The last posted sample, to measure change against
+static int has_posted = 0;
+static uint64_t posted_ns = 0;
+static double posted_values[4];
+
+// Message under construction; Dart_PostCObject copies it
+static double message[DART_PORT_HEADER_FIELDS + SYSTEM_SNAPSHOT_MAX_CORES * CORE_USAGE_FIELDS];
+
+intptr_t initDartApi(void* data) {
+#ifdef CPU_MONITOR_DART_PORTS
+    pthread_mutex_lock(&port_lock);
+    if (!api_ready && Dart_InitializeApiDL(data) == 0) api_ready = 1;
+    intptr_t result = api_ready ? 0 : -1;
+    pthread_mutex_unlock(&port_lock);
+    return result;
+#else
+    (void)data;
+    return -1;
+#endif
+}
+
+int setSnapshotPort(int64_t port, double threshold, int max_silence_ms) {
+    pthread_mutex_lock(&port_lock);
+    if (!api_ready) {
+        pthread_mutex_unlock(&port_lock);
+        return -1;
+    }
+    change_threshold = threshold > 0 ? threshold : 0.0;
+    max_silence_ns = max_silence_ms > 0 ? (uint64_t)max_silence_ms * 1000000ull : 0;
+    has_posted = 0;
+    atomic_store(&snapshot_port, port);
+    pthread_mutex_unlock(&port_lock);
+    return 0;
+}
+
+// CPU, memory and disk percentages and temperature: the values the change
+// threshold applies to
+static void watched_values(const struct system_snapshot* sample, double values[4]) {
+    values[0] = sample->cpu_usage;
+    values[1] = sample->memory_total > 0 ? (double)sample->memory_used / (double)sample->memory_total * 100.0 : 0.0;
+    values[2] = sample->disk_usage;
+    values[3] = sample->temperature;
+}
+
+// Called with port_lock held
+static int should_post(const struct system_snapshot* sample, const double values[4]) {
+    if (!has_posted || change_threshold == 0.0) return 1;
+    if (max_silence_ns != 0 && sample->timestamp_ns - posted_ns >= max_silence_ns) return 1;
+    for (int i = 0; i < 4; i++) {
+        double delta = values[i] - posted_values[i];
+        if (delta >= change_threshold || -delta >= change_threshold) return 1;
+    }
+    return 0;
+}
+
+void dart_port_publish(const struct system_snapshot* sample) {
+    if (atomic_load_explicit(&snapshot_port, memory_order_relaxed) == 0) return;
+
+    pthread_mutex_lock(&port_lock);
+    int64_t port = atomic_load(&snapshot_port);
+    double values[4];
+    watched_values(sample, values);
+    if (port == 0 || !api_ready || !should_post(sample, values)) {
+        pthread_mutex_unlock(&port_lock);
+        return;
+    }
+
+    int cores = sample->core_count;
+    if (cores < 0) cores = 0;
+    if (cores > SYSTEM_SNAPSHOT_MAX_CORES) cores = SYSTEM_SNAPSHOT_MAX_CORES;
+
+    message[DART_PORT_VERSION] = DART_PORT_MESSAGE_VERSION;
+    message[DART_PORT_TIMESTAMP_MS] = (double)(sample->timestamp_ns / 1000000ull);
+    message[DART_PORT_CPU_USAGE] = sample->cpu_usage;
+    message[DART_PORT_MEMORY_USED] = (double)sample->memory_used;
+    message[DART_PORT_MEMORY_TOTAL] = (double)sample->memory_total;
+    message[DART_PORT_DISK_USAGE] = sample->disk_usage;
+    message[DART_PORT_DISK_USED] = sample->disk_used;
+    message[DART_PORT_DISK_TOTAL] = sample->disk_total;
+    message[DART_PORT_TEMPERATURE] = sample->temperature;
+    message[DART_PORT_CORE_COUNT] = cores;
+    memcpy(&message[DART_PORT_HEADER_FIELDS], sample->per_core, sizeof(double) * (size_t)cores * CORE_USAGE_FIELDS);
+
+#ifdef CPU_MONITOR_DART_PORTS
+    Dart_CObject object;
+    object.type = Dart_CObject_kTypedData;
+    object.value.as_typed_data.type = Dart_TypedData_kFloat64;
+    object.value.as_typed_data.length = DART_PORT_HEADER_FIELDS + (intptr_t)cores * CORE_USAGE_FIELDS;
+    object.value.as_typed_data.values = (const uint8_t*)message;
+    if (!Dart_PostCObject_DL(port, &object)) {
+        // The isolate closed its port without unsubscribing
+        atomic_store(&snapshot_port, 0);
+    }
+#endif
+
+    has_posted = 1;
+    posted_ns = sample->timestamp_ns;
+    for (int i = 0; i < 4; i++) posted_values[i] = values[i];
+    pthread_mutex_unlock(&port_lock);
+}
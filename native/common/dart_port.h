@@ -0,0 +1,57 @@
+#ifndef DART_PORT_H
+#define DART_PORT_H
+
+#include <stdint.h>
+
+#include "system_snapshot.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Push delivery of sampler snapshots to a Dart isolate. Dart passes
+// NativeApi.initializeApiDLData to initDartApi() and a ReceivePort's
+// sendPort.nativePort to setSnapshotPort(); from then on the sampler thread
+// posts each sample it publishes as one Float64List message, laid out as
+// below, instead of Dart polling readLatestSnapshot().
+//
+// Posting needs the Dart SDK's include/dart_api_dl.c compiled in with
+// CPU_MONITOR_DART_PORTS defined. Other builds still export these functions
+// but initDartApi() fails, and Dart keeps polling.
+
+#define DART_PORT_MESSAGE_VERSION 1
+
+// Leading fields of a message; core_count * CORE_USAGE_FIELDS per-core
+// percentages follow
+enum dart_port_field {
+    DART_PORT_VERSION,
+    DART_PORT_TIMESTAMP_MS,      // Monotonic clock
+    DART_PORT_CPU_USAGE,
+    DART_PORT_MEMORY_USED,       // MB
+    DART_PORT_MEMORY_TOTAL,      // MB
+    DART_PORT_DISK_USAGE,
+    DART_PORT_DISK_USED,         // MB
+    DART_PORT_DISK_TOTAL,        // MB
+    DART_PORT_TEMPERATURE,       // -1 if unavailable
+    DART_PORT_CORE_COUNT,
+    DART_PORT_HEADER_FIELDS
+};
+
+// Initialise the Dart API function table. Returns 0 on success, -1 if the
+// library was built without Dart port support or the SDK versions differ.
+intptr_t initDartApi(void* data);
+
+// Post samples to `port` when the CPU, memory or disk percentage or the
+// temperature moved by at least `change_threshold` since the last message,
+// or `max_silence_ms` passed without one. A threshold of 0 posts every
+// sample. Port 0 stops posting. Returns 0, or -1 before initDartApi().
+int setSnapshotPort(int64_t port, double change_threshold, int max_silence_ms);
+
+// Called by the sampler thread with every sample it publishes
+void dart_port_publish(const struct system_snapshot* sample);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DART_PORT_H
@@ -0,0 +1,252 @@
+#include <math.h>
+#include <stddef.h>
+
+#include "decimate.h"
+#include "history.h"
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+
+static inline __m128d select_pd(__m128d mask, __m128d when_set, __m128d otherwise) {
+    return _mm_or_pd(_mm_and_pd(mask, when_set), _mm_andnot_pd(mask, otherwise));
+}
+#endif
+
+static inline double x_at(const double* x, int32_t i) {
+    return x != NULL ? x[i] : (double)i;
+}
+
+// Indices of the lowest and highest sample in [start, end), earliest on
+// ties; -1 if every sample is NaN
+static void bucket_extremes(const double* y, int32_t start, int32_t end, int32_t* lowest, int32_t* highest) {
+    double min = INFINITY, max = -INFINITY;
+    int32_t min_index = -1, max_index = -1;
+    int32_t i = start;
+
+#ifdef __SSE2__
+    if (end - start >= 4) {
+        __m128d min_values = _mm_set1_pd(INFINITY);
+        __m128d max_values = _mm_set1_pd(-INFINITY);
+        __m128d min_indices = _mm_set1_pd(-1.0);
+        __m128d max_indices = _mm_set1_pd(-1.0);
+        __m128d indices = _mm_set_pd((double)(i + 1), (double)i);
+        const __m128d step = _mm_set1_pd(2.0);
+
+        // Each lane keeps its first extreme; compares with NaN are false
+        for (; i + 2 <= end; i += 2) {
+            __m128d values = _mm_loadu_pd(y + i);
+            __m128d lower = _mm_cmplt_pd(values, min_values);
+            __m128d higher = _mm_cmpgt_pd(values, max_values);
+            min_values = select_pd(lower, values, min_values);
+            min_indices = select_pd(lower, indices, min_indices);
+            max_values = select_pd(higher, values, max_values);
+            max_indices = select_pd(higher, indices, max_indices);
+            indices = _mm_add_pd(indices, step);
+        }
+
+        double lane_min[2], lane_max[2], lane_min_index[2], lane_max_index[2];
+        _mm_storeu_pd(lane_min, min_values);
+        _mm_storeu_pd(lane_max, max_values);
+        _mm_storeu_pd(lane_min_index, min_indices);
+        _mm_storeu_pd(lane_max_index, max_indices);
+        for (int lane = 0; lane < 2; lane++) {
+            int32_t index = (int32_t)lane_min_index[lane];
+            if (index >= 0 && (lane_min[lane] < min || (lane_min[lane] == min && index < min_index))) {
+                min = lane_min[lane];
+                min_index = index;
+            }
+            index = (int32_t)lane_max_index[lane];
+            if (index >= 0 && (lane_max[lane] > max || (lane_max[lane] == max && index < max_index))) {
+                max = lane_max[lane];
+                max_index = index;
+            }
+        }
+    }
+#endif
+    for (; i < end; i++) {
+        if (y[i] < min) {
+            min = y[i];
+            min_index = i;
+        }
+        if (y[i] > max) {
+            max = y[i];
+            max_index = i;
+        }
+    }
+
+    // Only infinities: one side never moved off its starting bound
+    if (min_index < 0) min_index = max_index;
+    if (max_index < 0) max_index = min_index;
+    *lowest = min_index;
+    *highest = max_index;
+}
+
+// Mean x and y of [start, end)
+static void bucket_average(const double* x, const double* y, int32_t start, int32_t end, double* mean_x,
+                           double* mean_y) {
+    double sum_x = 0.0, sum_y = 0.0;
+    int32_t i = start;
+
+#ifdef __SSE2__
+    __m128d sums_x = _mm_setzero_pd();
+    __m128d sums_y = _mm_setzero_pd();
+    for (; i + 2 <= end; i += 2) {
+        sums_y = _mm_add_pd(sums_y, _mm_loadu_pd(y + i));
+        if (x != NULL) sums_x = _mm_add_pd(sums_x, _mm_loadu_pd(x + i));
+    }
+    double lanes[2];
+    _mm_storeu_pd(lanes, sums_y);
+    sum_y = lanes[0] + lanes[1];
+    _mm_storeu_pd(lanes, sums_x);
+    sum_x = lanes[0] + lanes[1];
+#endif
+    for (; i < end; i++) {
+        sum_y += y[i];
+        if (x != NULL) sum_x += x[i];
+    }
+
+    double count = (double)(end - start);
+    *mean_x = x != NULL ? sum_x / count : (double)(start + end - 1) / 2.0;
+    *mean_y = sum_y / count;
+}
+
+// Sample of [start, end) forming the largest triangle with (ax, ay) and
+// (cx, cy). The doubled area |dx * y + dy * x + k| is linear in the
+// sample, so a bucket is one multiply-add pass.
+static int32_t largest_triangle(const double* x, const double* y, int32_t start, int32_t end, double ax, double ay,
+                                double cx, double cy) {
+    double dx = ax - cx;
+    double dy = cy - ay;
+    double k = -dx * ay - dy * ax;
+    double best = -1.0;
+    int32_t best_index = start;
+    int32_t i = start;
+
+#ifdef __SSE2__
+    if (end - start >= 4) {
+        const __m128d sign = _mm_set1_pd(-0.0);
+        const __m128d vdx = _mm_set1_pd(dx);
+        const __m128d vdy = _mm_set1_pd(dy);
+        const __m128d vk = _mm_set1_pd(k);
+        const __m128d step = _mm_set1_pd(2.0);
+        __m128d indices = _mm_set_pd((double)(i + 1), (double)i);
+        __m128d best_areas = _mm_set1_pd(-1.0);
+        __m128d best_indices = _mm_set1_pd((double)start);
+
+        for (; i + 2 <= end; i += 2) {
+            __m128d xs = x != NULL ? _mm_loadu_pd(x + i) : indices;
+            __m128d area = _mm_add_pd(_mm_add_pd(_mm_mul_pd(vdx, _mm_loadu_pd(y + i)), _mm_mul_pd(vdy, xs)), vk);
+            area = _mm_andnot_pd(sign, area);
+            __m128d larger = _mm_cmpgt_pd(area, best_areas);
+            best_areas = select_pd(larger, area, best_areas);
+            best_indices = select_pd(larger, indices, best_indices);
+            indices = _mm_add_pd(indices, step);
+        }
+
+        double lane_area[2], lane_index[2];
+        _mm_storeu_pd(lane_area, best_areas);
+        _mm_storeu_pd(lane_index, best_indices);
+        for (int lane = 0; lane < 2; lane++) {
+            int32_t index = (int32_t)lane_index[lane];
+            if (lane_area[lane] > best || (lane_area[lane] == best && index < best_index)) {
+                best = lane_area[lane];
+                best_index = index;
+            }
+        }
+    }
+#endif
+    for (; i < end; i++) {
+        double area = fabs(dx * y[i] + dy * x_at(x, i) + k);
+        if (area > best) {
+            best = area;
+            best_index = i;
+        }
+    }
+    return best_index;
+}
+
+static int32_t lttb(const double* x, const double* y, int32_t length, int32_t target, double* out_x,
+                    double* out_y) {
+    int32_t written = 0;
+    int32_t kept = 0;
+
+    out_x[written] = x_at(x, 0);
+    out_y[written++] = y[0];
+
+    if (target > 2) {
+        // The first and last points are kept; the rest is split evenly
+        double every = (double)(length - 2) / (double)(target - 2);
+        for (int32_t bucket = 0; bucket < target - 2; bucket++) {
+            int32_t start = (int32_t)(bucket * every) + 1;
+            int32_t end = (int32_t)((bucket + 1) * every) + 1;
+            int32_t next_end = (int32_t)((bucket + 2) * every) + 1;
+            if (end > length - 1) end = length - 1;
+            if (next_end > length) next_end = length;
+            if (start >= end) continue;
+
+            double cx, cy;
+            bucket_average(x, y, end, next_end, &cx, &cy);
+            kept = largest_triangle(x, y, start, end, x_at(x, kept), y[kept], cx, cy);
+            out_x[written] = x_at(x, kept);
+            out_y[written++] = y[kept];
+        }
+    }
+
+    out_x[written] = x_at(x, length - 1);
+    out_y[written++] = y[length - 1];
+    return written;
+}
+
+static int32_t min_max(const double* x, const double* y, int32_t length, int32_t target, double* out_x,
+                       double* out_y) {
+    int32_t buckets = target / 2;
+    int32_t written = 0;
+
+    for (int32_t bucket = 0; bucket < buckets; bucket++) {
+        int32_t start = (int32_t)((int64_t)bucket * length / buckets);
+        int32_t end = (int32_t)((int64_t)(bucket + 1) * length / buckets);
+        int32_t lowest, highest;
+
+        bucket_extremes(y, start, end, &lowest, &highest);
+        if (lowest < 0) continue;
+
+        int32_t first = lowest < highest ? lowest : highest;
+        int32_t second = lowest < highest ? highest : lowest;
+        out_x[written] = x_at(x, first);
+        out_y[written++] = y[first];
+        if (second != first) {
+            out_x[written] = x_at(x, second);
+            out_y[written++] = y[second];
+        }
+    }
+    return written;
+}
+
+int32_t decimateSeries(int mode, const double* x, const double* y, int32_t length, int32_t target,
+                       double* out_x, double* out_y) {
+    if (y == NULL || out_x == NULL || out_y == NULL || length < 0 || target < 2) return -1;
+    if (mode != DECIMATE_LTTB && mode != DECIMATE_MIN_MAX) return -1;
+
+    if (length <= target) {
+        for (int32_t i = 0; i < length; i++) {
+            out_x[i] = x_at(x, i);
+            out_y[i] = y[i];
+        }
+        return length;
+    }
+    if (mode == DECIMATE_LTTB) return lttb(x, y, length, target, out_x, out_y);
+    return min_max(x, y, length, target, out_x, out_y);
+}
+
+int32_t decimateHistory(int metric, int tier, int field, int32_t last, int mode, int32_t target,
+                        double* out_x, double* out_y) {
+    int32_t length = 0;
+    const double* view = getHistoryView(metric, tier, field, &length);
+    if (view == NULL) return -1;
+
+    if (last > 0 && last < length) {
+        view += length - last;
+        length = last;
+    }
+    return decimateSeries(mode, NULL, view, length, target, out_x, out_y);
+}
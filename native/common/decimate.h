@@ -0,0 +1,49 @@
+#ifndef DECIMATE_H
+#define DECIMATE_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Downsampling for charts: reduce a series to about two points per pixel
+// so drawing cost follows the chart width, not the history depth, while
+// peaks stay visible.
+//
+// Both modes split the series into equal-count buckets and keep real
+// samples, never averages:
+//  - DECIMATE_LTTB (Largest-Triangle-Three-Buckets) keeps the point of each
+//    bucket that forms the largest triangle with the point kept before it
+//    and the average of the next bucket, plus the first and last points.
+//    One point per bucket; follows the shape of the line.
+//  - DECIMATE_MIN_MAX keeps the lowest and highest point of each bucket in
+//    time order. Two points per bucket; keeps every spike exactly.
+//
+// Bucket scans use SSE2 where available. NaN samples are never picked as
+// extremes.
+
+enum decimate_mode {
+    DECIMATE_LTTB = 0,
+    DECIMATE_MIN_MAX = 1,
+};
+
+// Reduce `length` points to at most `target` into out_x/out_y (`target`
+// slots each). `x` may be NULL for evenly spaced samples, in which case
+// out_x receives sample indices. A series that already fits is copied.
+// Returns the number of points written, or -1 for invalid arguments
+// (including `target` below 2).
+int32_t decimateSeries(int mode, const double* x, const double* y, int32_t length, int32_t target,
+                       double* out_x, double* out_y);
+
+// decimateSeries() over the newest `last` points of a history ring (all of
+// them if `last` is 0 or more than it holds), without copying the ring.
+// out_x receives indices into those points.
+int32_t decimateHistory(int metric, int tier, int field, int32_t last, int mode, int32_t target,
+                        double* out_x, double* out_y);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DECIMATE_H
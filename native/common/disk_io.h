@@ -0,0 +1,39 @@
+#ifndef DISK_IO_H
+#define DISK_IO_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Per-device block I/O rates, computed from /proc/diskstats deltas between
+// consecutive calls. The first call, and the first after a device is added or
+// removed, only sets the baseline and returns no rows.
+
+#define DISK_IO_NAME_LEN 32
+
+struct disk_io {
+    double read_iops;
+    double write_iops;
+    double read_bytes_per_sec;
+    double write_bytes_per_sec;
+    double await_ms;              // Average time per completed request, queueing included
+    double utilization;           // Percent of wall time with requests in flight
+    int32_t in_flight;            // Requests currently queued or being serviced
+    int32_t is_partition;
+    char name[DISK_IO_NAME_LEN];
+};
+
+// Point the collector at other diskstats and /sys/class/block locations;
+// used by tests. Drops the device table and baselines.
+void disk_io_set_sources(const char* diskstats_path, const char* sys_block_path);
+
+// Close the diskstats descriptor and drop the device table
+void disk_io_cleanup();
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DISK_IO_H
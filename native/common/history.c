@@ -0,0 +1,327 @@
+#include <math.h>
+#include <stdatomic.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "history.h"
+#include "quantile.h"
+#include "window_stats.h"
+
+#define NS_PER_SECOND 1000000000ull
+
+// Each ring stores capacity + 1 slots, twice. The extra slot is the one the
+// writer overwrites next, so it is never part of a published window and a
+// reader holding a view never sees a value change under it mid-sample.
+#define SLOTS(capacity) ((capacity) + 1)
+
+// Running rollup for the bucket currently being filled
+struct rollup {
+    uint64_t bucket;
+    uint64_t count;
+    double sum;
+    double min;
+    double max;
+};
+
+// Running window statistics of one metric's raw samples, advanced in O(1)
+// per sample. The sample leaving the window and the deque entries are read
+// back from the raw ring, which always holds more than a window.
+struct window_state {
+    uint64_t first;          // Oldest sample a window may reach back to
+    double sum;
+    double mean;             // Welford mean and squared deviations
+    double m2;
+    double ewma;
+    uint64_t min_head, min_tail;
+    uint64_t max_head, max_tail;
+    uint64_t min_queue[SLOTS(HISTORY_RAW_CAPACITY)];
+    uint64_t max_queue[SLOTS(HISTORY_RAW_CAPACITY)];
+};
+
+// Every ring and rollup. Plain data with no pointers, so a store can live
+// in memory shared between processes; all-zero bytes are an empty history.
+struct history_store {
+    double raw[HISTORY_METRIC_COUNT][2 * SLOTS(HISTORY_RAW_CAPACITY)];
+    double tier_10s[HISTORY_METRIC_COUNT][HISTORY_FIELD_COUNT][2 * SLOTS(HISTORY_10S_CAPACITY)];
+    double tier_1min[HISTORY_METRIC_COUNT][HISTORY_FIELD_COUNT][2 * SLOTS(HISTORY_1MIN_CAPACITY)];
+
+    // Window statistics of each raw point, in the raw ring's slots
+    double stats[HISTORY_METRIC_COUNT][WINDOW_STAT_COUNT][2 * SLOTS(HISTORY_RAW_CAPACITY)];
+
+    // Points ever written per ring; the only value shared with readers
+    _Atomic uint64_t written[HISTORY_METRIC_COUNT][HISTORY_TIER_COUNT];
+
+    struct rollup rollup_10s[HISTORY_METRIC_COUNT];
+    struct rollup rollup_1min[HISTORY_METRIC_COUNT];
+
+    struct window_state window_state[HISTORY_METRIC_COUNT];
+    uint32_t stat_window;    // 0 for HISTORY_STAT_WINDOW
+
+    struct quantile_window quantiles[HISTORY_METRIC_COUNT][QUANTILE_WINDOW_COUNT];
+};
+
+static struct history_store local_store;
+static struct history_store* store = &local_store;
+static int store_writable = 1;
+
+static const int tier_capacity[HISTORY_TIER_COUNT] = {
+    HISTORY_RAW_CAPACITY,
+    HISTORY_10S_CAPACITY,
+    HISTORY_1MIN_CAPACITY,
+};
+
+static double* ring_storage(int metric, int tier, int field) {
+    switch (tier) {
+        case HISTORY_TIER_RAW:
+            return field == HISTORY_FIELD_AVG ? store->raw[metric] : NULL;
+        case HISTORY_TIER_10S:
+            return store->tier_10s[metric][field];
+        case HISTORY_TIER_1MIN:
+            return store->tier_1min[metric][field];
+    }
+    return NULL;
+}
+
+static uint64_t stat_window() {
+    return store->stat_window != 0 ? store->stat_window : HISTORY_STAT_WINDOW;
+}
+
+// Push raw sample `index` onto a monotonic deque, drop entries older than
+// `oldest`, and return the window's extreme
+static double deque_push(uint64_t* queue, uint64_t* head, uint64_t* tail, const double* raw, uint64_t index,
+                         uint64_t oldest, int maximum) {
+    const uint64_t slots = SLOTS(HISTORY_RAW_CAPACITY);
+    double value = raw[index % slots];
+
+    while (*tail > *head) {
+        double back = raw[queue[(*tail - 1) % slots] % slots];
+        if (maximum ? back > value : back < value) break;
+        (*tail)--;
+    }
+    queue[(*tail)++ % slots] = index;
+    while (queue[*head % slots] < oldest) (*head)++;
+    return raw[queue[*head % slots] % slots];
+}
+
+// Advance the window statistics by raw sample `index`, already stored,
+// and store them in its slots
+static void window_step(int metric, uint64_t index) {
+    struct window_state* state = &store->window_state[metric];
+    const double* raw = store->raw[metric];
+    const uint64_t slots = SLOTS(HISTORY_RAW_CAPACITY);
+    uint64_t window = stat_window();
+    uint64_t held = index - state->first;
+    uint64_t oldest = held >= window ? index - window + 1 : state->first;
+    double count = (double)(index - oldest + 1);
+    double value = raw[index % slots];
+
+    if (held >= window) {
+        double leaving = raw[(index - window) % slots];
+        double previous = state->mean;
+        state->sum += value - leaving;
+        state->mean += (value - leaving) / count;
+        state->m2 += (value - leaving) * (value - state->mean + leaving - previous);
+    } else {
+        double delta = value - state->mean;
+        state->sum += value;
+        state->mean += delta / count;
+        state->m2 += delta * (value - state->mean);
+    }
+    double alpha = 2.0 / ((double)window + 1.0);
+    state->ewma = held == 0 ? value : state->ewma + alpha * (value - state->ewma);
+
+    double values[WINDOW_STAT_COUNT];
+    values[WINDOW_STAT_MEAN] = state->sum / count;
+    values[WINDOW_STAT_EWMA] = state->ewma;
+    values[WINDOW_STAT_MIN] = deque_push(state->min_queue, &state->min_head, &state->min_tail, raw, index, oldest, 0);
+    values[WINDOW_STAT_MAX] = deque_push(state->max_queue, &state->max_head, &state->max_tail, raw, index, oldest, 1);
+    values[WINDOW_STAT_STDDEV] = sqrt(fmax(state->m2, 0.0) / count);
+
+    int pos = (int)(index % slots);
+    for (int stat = 0; stat < WINDOW_STAT_COUNT; stat++) {
+        store->stats[metric][stat][pos] = values[stat];
+        store->stats[metric][stat][pos + slots] = values[stat];
+    }
+}
+
+// Store one point (avg/min/max) into a ring and publish it
+static void ring_append(int metric, int tier, double avg, double min, double max) {
+    uint64_t count = atomic_load_explicit(&store->written[metric][tier], memory_order_relaxed);
+    int slots = SLOTS(tier_capacity[tier]);
+    int pos = (int)(count % (uint64_t)slots);
+
+    if (tier == HISTORY_TIER_RAW) {
+        double* data = store->raw[metric];
+        data[pos] = avg;
+        data[pos + slots] = avg;
+        window_step(metric, count);
+    } else {
+        double values[HISTORY_FIELD_COUNT] = {avg, min, max};
+        for (int field = 0; field < HISTORY_FIELD_COUNT; field++) {
+            double* data = ring_storage(metric, tier, field);
+            data[pos] = values[field];
+            data[pos + slots] = values[field];
+        }
+    }
+
+    atomic_store_explicit(&store->written[metric][tier], count + 1, memory_order_release);
+}
+
+static void rollup_merge(struct rollup* into, uint64_t bucket, const struct rollup* from) {
+    if (into->count == 0) {
+        into->bucket = bucket;
+        into->min = from->min;
+        into->max = from->max;
+    } else {
+        if (from->min < into->min) into->min = from->min;
+        if (from->max > into->max) into->max = from->max;
+    }
+    into->sum += from->sum;
+    into->count += from->count;
+}
+
+void history_push(int metric, uint64_t timestamp_ns, double value) {
+    if (metric < 0 || metric >= HISTORY_METRIC_COUNT || !store_writable) return;
+
+    ring_append(metric, HISTORY_TIER_RAW, value, value, value);
+    for (int span = 0; span < QUANTILE_WINDOW_COUNT; span++) {
+        quantile_window_push(&store->quantiles[metric][span], span, timestamp_ns, value);
+    }
+
+    uint64_t seconds = timestamp_ns / NS_PER_SECOND;
+    uint64_t bucket_10s = seconds / 10;
+    struct rollup* tens = &store->rollup_10s[metric];
+    struct rollup* minutes = &store->rollup_1min[metric];
+
+    // A sample in a new 10 s bucket closes the previous one, which in turn
+    // feeds the running 1 min bucket
+    if (tens->count > 0 && tens->bucket != bucket_10s) {
+        uint64_t bucket_1min = tens->bucket * 10 / 60;
+
+        ring_append(metric, HISTORY_TIER_10S, tens->sum / (double)tens->count, tens->min, tens->max);
+
+        if (minutes->count > 0 && minutes->bucket != bucket_1min) {
+            ring_append(metric, HISTORY_TIER_1MIN, minutes->sum / (double)minutes->count,
+                        minutes->min, minutes->max);
+            memset(minutes, 0, sizeof(*minutes));
+        }
+        rollup_merge(minutes, bucket_1min, tens);
+        memset(tens, 0, sizeof(*tens));
+    }
+
+    struct rollup sample = {bucket_10s, 1, value, value, value};
+    rollup_merge(tens, bucket_10s, &sample);
+}
+
+const double* getHistoryView(int metric, int tier, int field, int32_t* length) {
+    if (metric < 0 || metric >= HISTORY_METRIC_COUNT || tier < 0 || tier >= HISTORY_TIER_COUNT ||
+        field < 0 || field >= HISTORY_FIELD_COUNT || length == NULL) {
+        return NULL;
+    }
+
+    double* data = ring_storage(metric, tier, field);
+    if (data == NULL) {
+        // The raw tier only has one field; min and max equal the value
+        data = ring_storage(metric, tier, HISTORY_FIELD_AVG);
+    }
+
+    uint64_t count = atomic_load_explicit(&store->written[metric][tier], memory_order_acquire);
+    uint64_t capacity = (uint64_t)tier_capacity[tier];
+    uint64_t visible = count < capacity ? count : capacity;
+    uint64_t start = (count - visible) % (uint64_t)SLOTS(tier_capacity[tier]);
+
+    *length = (int32_t)visible;
+    return data + start;
+}
+
+const double* getHistoryStatView(int metric, int stat, int32_t* length) {
+    if (metric < 0 || metric >= HISTORY_METRIC_COUNT || stat < 0 || stat >= WINDOW_STAT_COUNT || length == NULL) {
+        return NULL;
+    }
+
+    const double* raw = getHistoryView(metric, HISTORY_TIER_RAW, HISTORY_FIELD_AVG, length);
+    return store->stats[metric][stat] + (raw - store->raw[metric]);
+}
+
+int setHistoryStatWindow(int32_t window) {
+    if (window < 1 || window > HISTORY_RAW_CAPACITY || !store_writable) return -1;
+
+    store->stat_window = (uint32_t)window;
+    for (int metric = 0; metric < HISTORY_METRIC_COUNT; metric++) {
+        uint64_t count = atomic_load_explicit(&store->written[metric][HISTORY_TIER_RAW], memory_order_relaxed);
+        uint64_t held = count < HISTORY_RAW_CAPACITY ? count : HISTORY_RAW_CAPACITY;
+
+        // Replay what the ring still holds; earlier samples are gone, so
+        // the oldest windows are cut short
+        memset(&store->window_state[metric], 0, sizeof(store->window_state[metric]));
+        store->window_state[metric].first = count - held;
+        for (uint64_t index = count - held; index < count; index++) {
+            window_step(metric, index);
+        }
+    }
+    return 0;
+}
+
+int32_t getHistoryStatWindow() {
+    return (int32_t)stat_window();
+}
+
+int64_t getHistoryQuantiles(int metric, int span, const double* quantiles, int32_t count, double* out) {
+    struct quantile_sketch sketch;
+
+    if (metric < 0 || metric >= HISTORY_METRIC_COUNT || span < 0 || span >= QUANTILE_WINDOW_COUNT ||
+        quantiles == NULL || out == NULL || count < 0) {
+        return -1;
+    }
+    if (quantile_window_read(&store->quantiles[metric][span], &sketch) != 0) return -1;
+
+    for (int32_t i = 0; i < count; i++) {
+        out[i] = quantile_sketch_query(&sketch, quantiles[i]);
+    }
+    return (int64_t)sketch.count;
+}
+
+int32_t getHistorySketch(int metric, int span, uint8_t* buffer, int32_t capacity) {
+    struct quantile_sketch sketch;
+
+    if (metric < 0 || metric >= HISTORY_METRIC_COUNT || span < 0 || span >= QUANTILE_WINDOW_COUNT) return -1;
+    if (quantile_window_read(&store->quantiles[metric][span], &sketch) != 0) return -1;
+    return quantile_sketch_encode(&sketch, buffer, capacity);
+}
+
+int getHistoryLength(int metric, int tier) {
+    if (metric < 0 || metric >= HISTORY_METRIC_COUNT || tier < 0 || tier >= HISTORY_TIER_COUNT) {
+        return 0;
+    }
+
+    uint64_t count = atomic_load_explicit(&store->written[metric][tier], memory_order_acquire);
+    return count < (uint64_t)tier_capacity[tier] ? (int)count : tier_capacity[tier];
+}
+
+void clearHistory() {
+    if (!store_writable) return;
+
+    for (int metric = 0; metric < HISTORY_METRIC_COUNT; metric++) {
+        for (int tier = 0; tier < HISTORY_TIER_COUNT; tier++) {
+            atomic_store_explicit(&store->written[metric][tier], 0, memory_order_release);
+        }
+    }
+    memset(store->rollup_10s, 0, sizeof(store->rollup_10s));
+    memset(store->rollup_1min, 0, sizeof(store->rollup_1min));
+    memset(store->window_state, 0, sizeof(store->window_state));
+    memset(store->quantiles, 0, sizeof(store->quantiles));
+}
+
+size_t history_store_size() {
+    return sizeof(struct history_store);
+}
+
+void history_use_store(void* memory, int writable) {
+    if (memory == NULL) {
+        store = &local_store;
+        store_writable = 1;
+    } else {
+        store = memory;
+        store_writable = writable;
+    }
+}
@@ -0,0 +1,110 @@
+#ifndef HISTORY_H
+#define HISTORY_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "quantile.h"
+#include "window_stats.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Fixed-capacity, multi-resolution metric history owned by the native side.
+//
+// Every metric keeps three tiers: raw samples, 10 s rollups and 1 min
+// rollups (avg/min/max). Rollups are updated incrementally as samples arrive.
+// Each ring is stored mirrored (every slot written twice, `capacity` apart),
+// so the live window is always one contiguous array that Dart can wrap as a
+// zero-copy Float64List.
+//
+// Each raw sample also gets trailing-window statistics (enum window_stat in
+// window_stats.h), updated in O(1) as it arrives and kept in rings aligned
+// with the raw one, so charts read smoothed series without recomputing them.
+// Quantile sketches over sliding 5 min, 1 h and 24 h windows (quantile.h)
+// are fed the same way.
+
+enum history_metric {
+    HISTORY_CPU = 0,
+    HISTORY_MEMORY = 1,
+    HISTORY_DISK = 2,
+    HISTORY_TEMPERATURE = 3,
+    HISTORY_METRIC_COUNT
+};
+
+enum history_tier {
+    HISTORY_TIER_RAW = 0,     // One point per sample (1 s by default), 15 min
+    HISTORY_TIER_10S = 1,     // 10 s buckets, 6 h
+    HISTORY_TIER_1MIN = 2,    // 1 min buckets, 24 h
+    HISTORY_TIER_COUNT
+};
+
+enum history_field {
+    HISTORY_FIELD_AVG = 0,    // Raw tier: the sample value itself
+    HISTORY_FIELD_MIN = 1,
+    HISTORY_FIELD_MAX = 2,
+    HISTORY_FIELD_COUNT
+};
+
+#define HISTORY_RAW_CAPACITY 900
+#define HISTORY_10S_CAPACITY 2160
+#define HISTORY_1MIN_CAPACITY 1440
+
+// Raw samples per window of the cached statistics unless changed
+#define HISTORY_STAT_WINDOW 3
+
+// Record one sample. Must be called from a single writer thread.
+void history_push(int metric, uint64_t timestamp_ns, double value);
+
+// Return a pointer to the oldest point of a tier/field and store the number
+// of contiguous points in `length`. The pointer stays valid until the store
+// is switched with history_use_store(); the window advances as samples arrive, so callers should
+// re-fetch it on every read. Returns NULL for invalid arguments.
+const double* getHistoryView(int metric, int tier, int field, int32_t* length);
+
+// Like getHistoryView() for the raw tier, but for one window statistic
+// (enum window_stat): point i summarises the window ending at raw point i.
+// Returns NULL for invalid arguments.
+const double* getHistoryStatView(int metric, int stat, int32_t* length);
+
+// Window of the cached statistics in raw samples, 1..HISTORY_RAW_CAPACITY.
+// The statistics of the samples already held are recomputed, so this must
+// not race with history_push(). Returns 0, or -1 for an invalid window or a
+// read-only store.
+int setHistoryStatWindow(int32_t window);
+int32_t getHistoryStatWindow();
+
+// Quantiles of a metric over a sliding window (enum quantile_window_span):
+// out[i] is the value at quantiles[i] (0..1), within
+// QUANTILE_RELATIVE_ACCURACY of a real sample. Returns the number of
+// samples in the window (the values are NaN if there are none), or -1 for
+// invalid arguments.
+int64_t getHistoryQuantiles(int metric, int span, const double* quantiles, int32_t count, double* out);
+
+// Encode a window's sketch for storage or merging elsewhere (see
+// mergeQuantileSketches()). Returns the bytes written, or -1 for invalid
+// arguments or too small a buffer (QUANTILE_SKETCH_MAX_BYTES always fits).
+int32_t getHistorySketch(int metric, int span, uint8_t* buffer, int32_t capacity);
+
+// Number of points currently held in a tier
+int getHistoryLength(int metric, int tier);
+
+// Drop all history. Must not race with history_push().
+void clearHistory();
+
+// Bytes needed to hold a history store, for callers that place one in
+// shared memory (see shared_segment.h)
+size_t history_store_size();
+
+// Keep history in `memory` (history_store_size() bytes, zeroed or written
+// by this same build) instead of the built-in store; NULL switches back.
+// A store that is not `writable` ignores history_push() and clearHistory().
+// Must not race with history_push() or with readers holding a view.
+void history_use_store(void* memory, int writable);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HISTORY_H
@@ -0,0 +1,810 @@
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "history.h"
+#include "history_db.h"
+#include "latency.h"
+#include "quantile.h"
+
+#define FILE_MAGIC 0x53544d43u     // "CMTS"
+#define FILE_VERSION 1
+#define BLOCK_MAGIC 0x4b4c4243u    // "CBLK"
+#define SKETCH_RECORD_MAGIC 0x52534b43u   // "CKSR"
+
+// Worst-case bits for one point: a 32-bit delta-of-delta, then a value
+// that opens a new leading/trailing-zero window
+#define MAX_POINT_BITS (4 + 32 + 2 + 5 + 6 + 64)
+
+// Block slots mapped past the end of a file, so growing it only remaps
+// every few hundred blocks
+#define MAP_RESERVE_BLOCKS 256
+
+// The first block-sized slot of every column file
+struct file_header {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t block_size;
+    uint32_t metric;
+};
+
+struct block_header {
+    uint32_t magic;
+    uint32_t count;       // Points in the block
+    int64_t first_ms;
+    int64_t last_ms;
+    uint32_t bits;        // Payload bits in use
+    uint32_t checksum;    // FNV-1a of the header (with checksum 0) and payload
+};
+
+#define PAYLOAD_BYTES (HISTORY_DB_BLOCK_SIZE - sizeof(struct block_header))
+
+struct block {
+    struct block_header header;
+    uint8_t payload[PAYLOAD_BYTES];
+};
+
+// Encoder state after the last point of a block; the decoder rebuilds it
+// so a writer can resume a partly filled block
+struct codec {
+    uint32_t count;
+    uint32_t bits;
+    int64_t last_ms;
+    int64_t last_delta;
+    uint64_t last_value;
+    int leading;          // Current XOR window, -1 before the first one
+    int trailing;
+};
+
+struct bit_reader {
+    const uint8_t* payload;
+    uint32_t next_byte;
+    uint32_t position;    // Bits consumed
+    int available;        // Bits buffered, most significant first
+    uint64_t buffer;
+};
+
+struct column {
+    int fd;
+    const uint8_t* map;   // Read-only mapping of the file from offset 0
+    size_t map_size;
+    int64_t newest_ms;    // Latest timestamp stored, sealed or not
+
+    // Sparse index: one entry per block in the file (the writer's open
+    // block is not included)
+    size_t blocks;
+    size_t index_capacity;
+    int64_t* first_ms;
+    int64_t* last_ms;
+    uint32_t* counts;
+
+    // Writer only: the open block, stored in slot `blocks`
+    struct block tail;
+    struct codec tail_codec;
+    int unflushed;
+
+    // Hourly quantile sketches, one record appended to `<name>.sketch` as
+    // each hour ends; the writer builds the current one in `hour`
+    int sketch_fd;
+    int64_t hour_ms;
+    struct quantile_sketch hour;
+};
+
+// Header of each record in a sketch file; the encoded sketch follows
+struct sketch_record {
+    uint32_t magic;
+    uint32_t length;
+    int64_t hour_ms;
+};
+
+static const char* const column_names[HISTORY_METRIC_COUNT] = {"cpu", "memory", "disk", "temperature"};
+
+// Guards everything below. The sampler appends under the write lock;
+// queries share the read lock, except on a read-only view where they also
+// extend the index.
+static pthread_rwlock_t db_lock = PTHREAD_RWLOCK_INITIALIZER;
+static struct column columns[HISTORY_METRIC_COUNT];
+static int db_open = 0;
+static int db_writable = 0;
+static int lock_fd = -1;
+static int write_error_reported = 0;
+
+static void put_bits(uint8_t* payload, uint32_t* position, uint64_t value, int count) {
+    while (count > 0) {
+        int free_bits = 8 - (int)(*position & 7);
+        int take = count < free_bits ? count : free_bits;
+        uint8_t chunk = (uint8_t)((value >> (count - take)) & ((1u << take) - 1));
+
+        payload[*position >> 3] |= (uint8_t)(chunk << (free_bits - take));
+        *position += (uint32_t)take;
+        count -= take;
+    }
+}
+
+// Read up to 56 bits, refilling the buffer a byte at a time
+static uint64_t read_short(struct bit_reader* reader, int count) {
+    while (reader->available <= 56) {
+        uint64_t byte = reader->next_byte < PAYLOAD_BYTES ? reader->payload[reader->next_byte] : 0;
+        reader->buffer |= byte << (56 - reader->available);
+        reader->next_byte++;
+        reader->available += 8;
+    }
+    uint64_t value = reader->buffer >> (64 - count);
+    reader->buffer <<= count;
+    reader->available -= count;
+    reader->position += (uint32_t)count;
+    return value;
+}
+
+static uint64_t read_bits(struct bit_reader* reader, int count) {
+    if (count > 32) {
+        uint64_t high = read_short(reader, count - 32);
+        return high << 32 | read_short(reader, 32);
+    }
+    return read_short(reader, count);
+}
+
+static uint32_t block_checksum(const struct block* block) {
+    struct block_header header = block->header;
+    uint32_t hash = 2166136261u;
+
+    header.checksum = 0;
+    const uint8_t* bytes = (const uint8_t*)&header;
+    for (size_t i = 0; i < sizeof(header); i++) {
+        hash = (hash ^ bytes[i]) * 16777619u;
+    }
+    size_t used = (block->header.bits + 7) / 8;
+    for (size_t i = 0; i < used && i < PAYLOAD_BYTES; i++) {
+        hash = (hash ^ block->payload[i]) * 16777619u;
+    }
+    return hash;
+}
+
+static int block_valid(const struct block* block) {
+    const struct block_header* header = &block->header;
+    return header->magic == BLOCK_MAGIC && header->count > 0 && header->bits <= PAYLOAD_BYTES * 8 &&
+           header->first_ms <= header->last_ms && header->checksum == block_checksum(block);
+}
+
+static void codec_reset(struct codec* codec) {
+    memset(codec, 0, sizeof(*codec));
+    codec->leading = -1;
+}
+
+// Append one point to a block. Returns -1 if it does not fit, leaving the
+// block unchanged.
+static int encode_point(struct block* block, struct codec* codec, int64_t timestamp_ms, double value) {
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+
+    if (codec->count == 0) {
+        put_bits(block->payload, &codec->bits, bits, 64);
+        block->header.magic = BLOCK_MAGIC;
+        block->header.first_ms = timestamp_ms;
+    } else {
+        int64_t delta = timestamp_ms - codec->last_ms;
+        int64_t dod = delta - codec->last_delta;
+        if (dod < INT32_MIN || dod > INT32_MAX || codec->bits + MAX_POINT_BITS > PAYLOAD_BYTES * 8) {
+            return -1;
+        }
+
+        // Timestamps: steady intervals cost a single bit
+        if (dod == 0) {
+            put_bits(block->payload, &codec->bits, 0, 1);
+        } else if (dod >= -63 && dod <= 64) {
+            put_bits(block->payload, &codec->bits, 2, 2);
+            put_bits(block->payload, &codec->bits, (uint64_t)(dod + 63), 7);
+        } else if (dod >= -255 && dod <= 256) {
+            put_bits(block->payload, &codec->bits, 6, 3);
+            put_bits(block->payload, &codec->bits, (uint64_t)(dod + 255), 9);
+        } else if (dod >= -2047 && dod <= 2048) {
+            put_bits(block->payload, &codec->bits, 14, 4);
+            put_bits(block->payload, &codec->bits, (uint64_t)(dod + 2047), 12);
+        } else {
+            put_bits(block->payload, &codec->bits, 15, 4);
+            put_bits(block->payload, &codec->bits, (uint32_t)(int32_t)dod, 32);
+        }
+
+        // Values: only the bits that differ from the previous one, inside
+        // the previous window of leading/trailing zeros when they fit
+        uint64_t xor = bits ^ codec->last_value;
+        if (xor == 0) {
+            put_bits(block->payload, &codec->bits, 0, 1);
+        } else {
+            int leading = __builtin_clzll(xor);
+            int trailing = __builtin_ctzll(xor);
+            if (leading > 31) leading = 31;
+
+            if (codec->leading >= 0 && leading >= codec->leading && trailing >= codec->trailing) {
+                put_bits(block->payload, &codec->bits, 2, 2);
+                put_bits(block->payload, &codec->bits, xor >> codec->trailing,
+                         64 - codec->leading - codec->trailing);
+            } else {
+                int meaningful = 64 - leading - trailing;
+                put_bits(block->payload, &codec->bits, 3, 2);
+                put_bits(block->payload, &codec->bits, (uint64_t)leading, 5);
+                put_bits(block->payload, &codec->bits, (uint64_t)(meaningful - 1), 6);
+                put_bits(block->payload, &codec->bits, xor >> trailing, meaningful);
+                codec->leading = leading;
+                codec->trailing = trailing;
+            }
+        }
+        codec->last_delta = delta;
+    }
+
+    codec->count++;
+    codec->last_ms = timestamp_ms;
+    codec->last_value = bits;
+    block->header.count = codec->count;
+    block->header.last_ms = timestamp_ms;
+    block->header.bits = codec->bits;
+    return 0;
+}
+
+// Decode the points of a block with from_ms <= timestamp <= to_ms, up to
+// `capacity` of them; with `values` NULL they are only counted. A non-NULL
+// `state` decodes the whole block and receives the encoder state after it.
+static int64_t decode_block(const struct block* block, int64_t from_ms, int64_t to_ms, int64_t* timestamps,
+                            double* values, int64_t capacity, struct codec* state) {
+    struct bit_reader reader = {block->payload, 0, 0, 0, 0};
+    struct codec codec;
+    int64_t found = 0;
+
+    codec_reset(&codec);
+    int64_t timestamp = block->header.first_ms;
+    uint64_t bits = read_bits(&reader, 64);
+
+    for (uint32_t i = 0;; i++) {
+        if (timestamp > to_ms && state == NULL) break;
+        if (timestamp >= from_ms && timestamp <= to_ms) {
+            if (found == capacity) break;
+            if (values != NULL) {
+                if (timestamps != NULL) timestamps[found] = timestamp;
+                memcpy(&values[found], &bits, sizeof(bits));
+            }
+            found++;
+        }
+        if (i + 1 == block->header.count) break;
+
+        int64_t dod;
+        if (read_short(&reader, 1) == 0) {
+            dod = 0;
+        } else if (read_short(&reader, 1) == 0) {
+            dod = (int64_t)read_short(&reader, 7) - 63;
+        } else if (read_short(&reader, 1) == 0) {
+            dod = (int64_t)read_short(&reader, 9) - 255;
+        } else if (read_short(&reader, 1) == 0) {
+            dod = (int64_t)read_short(&reader, 12) - 2047;
+        } else {
+            dod = (int32_t)(uint32_t)read_short(&reader, 32);
+        }
+        codec.last_delta += dod;
+        timestamp += codec.last_delta;
+
+        if (read_short(&reader, 1) != 0) {
+            if (read_short(&reader, 1) != 0) {
+                codec.leading = (int)read_short(&reader, 5);
+                int meaningful = (int)read_short(&reader, 6) + 1;
+                codec.trailing = 64 - codec.leading - meaningful;
+            }
+            if (codec.leading < 0 || codec.trailing < 0) break;
+            bits ^= read_bits(&reader, 64 - codec.leading - codec.trailing) << codec.trailing;
+        }
+    }
+
+    if (state != NULL) {
+        codec.count = block->header.count;
+        codec.bits = reader.position;
+        codec.last_ms = timestamp;
+        codec.last_value = bits;
+        *state = codec;
+    }
+    return found;
+}
+
+// Map the file header and `blocks` slots, plus room to grow
+static int map_column(struct column* column, size_t blocks) {
+    size_t needed = (blocks + 1) * HISTORY_DB_BLOCK_SIZE;
+    if (column->map != NULL && needed <= column->map_size) return 0;
+
+    size_t size = needed + MAP_RESERVE_BLOCKS * HISTORY_DB_BLOCK_SIZE;
+    void* mapping = mmap(NULL, size, PROT_READ, MAP_SHARED, column->fd, 0);
+    if (mapping == MAP_FAILED) return -1;
+
+    if (column->map != NULL) munmap((void*)column->map, column->map_size);
+    column->map = mapping;
+    column->map_size = size;
+    return 0;
+}
+
+// Blocks the mapping can serve; fewer than indexed only if a remap failed
+static size_t mapped_blocks(const struct column* column) {
+    size_t covered = column->map_size / HISTORY_DB_BLOCK_SIZE;
+    covered = covered > 0 ? covered - 1 : 0;
+    return column->blocks < covered ? column->blocks : covered;
+}
+
+static const struct block* block_at(const struct column* column, size_t index) {
+    return (const struct block*)(column->map + (index + 1) * HISTORY_DB_BLOCK_SIZE);
+}
+
+static int index_set(struct column* column, size_t index, const struct block_header* header) {
+    if (index >= column->index_capacity) {
+        size_t capacity = column->index_capacity ? column->index_capacity * 2 : 64;
+        int64_t* first_ms = realloc(column->first_ms, capacity * sizeof(*first_ms));
+        if (first_ms != NULL) column->first_ms = first_ms;
+        int64_t* last_ms = realloc(column->last_ms, capacity * sizeof(*last_ms));
+        if (last_ms != NULL) column->last_ms = last_ms;
+        uint32_t* counts = realloc(column->counts, capacity * sizeof(*counts));
+        if (counts != NULL) column->counts = counts;
+        if (first_ms == NULL || last_ms == NULL || counts == NULL) return -1;
+        column->index_capacity = capacity;
+    }
+    column->first_ms[index] = header->first_ms;
+    column->last_ms[index] = header->last_ms;
+    column->counts[index] = header->count;
+    return 0;
+}
+
+// Index the valid blocks from `start` on, stopping at the first slot that
+// is empty or torn. Slots are validated from a copy, since a writer in
+// another process may be rewriting its open block.
+static void scan_blocks(struct column* column, size_t start, size_t slots) {
+    struct block copy;
+    size_t index = start;
+
+    for (; index < slots; index++) {
+        memcpy(&copy, block_at(column, index), sizeof(copy));
+        if (!block_valid(&copy) || (index > 0 && copy.header.first_ms <= column->last_ms[index - 1])) break;
+        if (index_set(column, index, &copy.header) != 0) break;
+    }
+    column->blocks = index;
+    column->newest_ms = index > 0 ? column->last_ms[index - 1] : INT64_MIN;
+}
+
+static void report_write_error(const char* what) {
+    if (write_error_reported) return;
+    write_error_reported = 1;
+    fprintf(stderr, "Error writing history %s: %s\n", what, strerror(errno));
+}
+
+static void flush_tail(struct column* column) {
+    if (column->tail_codec.count == 0) return;
+
+    column->tail.header.checksum = block_checksum(&column->tail);
+    off_t offset = (off_t)((column->blocks + 1) * HISTORY_DB_BLOCK_SIZE);
+    if (pwrite(column->fd, &column->tail, sizeof(column->tail), offset) != (ssize_t)sizeof(column->tail)) {
+        report_write_error("block");
+    }
+    column->unflushed = 0;
+}
+
+// Write out the open block, add it to the index and start the next one
+static void seal_tail(struct column* column) {
+    flush_tail(column);
+    if (index_set(column, column->blocks, &column->tail.header) == 0) {
+        column->blocks++;
+        map_column(column, column->blocks);
+    }
+    memset(&column->tail, 0, sizeof(column->tail));
+    codec_reset(&column->tail_codec);
+}
+
+static int open_file(struct column* column, const char* directory, int metric, int writable) {
+    char path[PATH_MAX];
+    snprintf(path, sizeof(path), "%s/%s.col", directory, column_names[metric]);
+
+    column->fd = open(path, writable ? O_RDWR | O_CREAT : O_RDONLY, 0644);
+    if (column->fd < 0) {
+        // A read-only view waits for the writer to create the file
+        return !writable && errno == ENOENT ? 0 : -1;
+    }
+
+    struct file_header header;
+    struct stat info;
+    if (fstat(column->fd, &info) != 0) return -1;
+    if (info.st_size == 0 && writable) {
+        static const uint8_t empty[HISTORY_DB_BLOCK_SIZE];
+        header = (struct file_header){FILE_MAGIC, FILE_VERSION, HISTORY_DB_BLOCK_SIZE, (uint32_t)metric};
+        if (pwrite(column->fd, empty, sizeof(empty), 0) != (ssize_t)sizeof(empty) ||
+            pwrite(column->fd, &header, sizeof(header), 0) != (ssize_t)sizeof(header)) {
+            return -1;
+        }
+    } else if (pread(column->fd, &header, sizeof(header), 0) != (ssize_t)sizeof(header) ||
+               header.magic != FILE_MAGIC || header.version != FILE_VERSION ||
+               header.block_size != HISTORY_DB_BLOCK_SIZE || header.metric != (uint32_t)metric) {
+        // Header not written yet by a writer that just created the file
+        if (!writable && info.st_size < HISTORY_DB_BLOCK_SIZE) {
+            close(column->fd);
+            column->fd = -1;
+            return 0;
+        }
+        fprintf(stderr, "History file %s has an unknown format\n", path);
+        return -1;
+    }
+    return 0;
+}
+
+// Merge the sketches of the hours overlapping from_ms..to_ms into `merged`
+// (if not NULL). Returns the end of the last whole record, where a writer
+// appends the next one.
+static off_t scan_sketches(int fd, int64_t from_ms, int64_t to_ms, struct quantile_sketch* merged) {
+    struct sketch_record record;
+    uint8_t encoded[QUANTILE_SKETCH_MAX_BYTES];
+    struct quantile_sketch sketch;
+    off_t offset = 0;
+
+    while (pread(fd, &record, sizeof(record), offset) == (ssize_t)sizeof(record) &&
+           record.magic == SKETCH_RECORD_MAGIC && record.length <= sizeof(encoded)) {
+        if (pread(fd, encoded, record.length, offset + (off_t)sizeof(record)) != (ssize_t)record.length ||
+            quantile_sketch_decode(&sketch, encoded, (int32_t)record.length) != 0) {
+            break;
+        }
+        if (merged != NULL && record.hour_ms <= to_ms && record.hour_ms + HISTORY_DB_SKETCH_MS > from_ms) {
+            quantile_sketch_merge(merged, &sketch);
+        }
+        offset += (off_t)(sizeof(record) + record.length);
+    }
+    return offset;
+}
+
+static int open_sketch_file(struct column* column, const char* directory, int metric, int writable) {
+    char path[PATH_MAX + 16];
+    snprintf(path, sizeof(path), "%s/%s.sketch", directory, column_names[metric]);
+
+    column->sketch_fd = open(path, writable ? O_RDWR | O_CREAT | O_APPEND : O_RDONLY, 0644);
+    if (column->sketch_fd < 0) return !writable && errno == ENOENT ? 0 : -1;
+
+    // Drop a record torn by a crash mid-write, so new ones stay reachable
+    if (writable && ftruncate(column->sketch_fd, scan_sketches(column->sketch_fd, 0, 0, NULL)) != 0) return -1;
+    return 0;
+}
+
+// Append the writer's current hour to the sketch file and start over
+static void write_hour(struct column* column) {
+    uint8_t record[sizeof(struct sketch_record) + QUANTILE_SKETCH_MAX_BYTES];
+
+    if (column->hour.count > 0 && column->sketch_fd >= 0) {
+        int32_t length = quantile_sketch_encode(&column->hour, record + sizeof(struct sketch_record),
+                                                QUANTILE_SKETCH_MAX_BYTES);
+        struct sketch_record header = {SKETCH_RECORD_MAGIC, (uint32_t)length, column->hour_ms};
+        memcpy(record, &header, sizeof(header));
+        size_t size = sizeof(header) + (size_t)length;
+        if (length < 0 || write(column->sketch_fd, record, size) != (ssize_t)size) {
+            report_write_error("sketch");
+        }
+    }
+    quantile_sketch_clear(&column->hour);
+}
+
+// Bring a read-only view's index up to date with the file
+static void refresh_column(struct column* column, const char* directory, int metric) {
+    if (column->sketch_fd < 0) open_sketch_file(column, directory, metric, 0);
+    if (column->fd < 0 && (open_file(column, directory, metric, 0) != 0 || column->fd < 0)) return;
+
+    struct stat info;
+    if (fstat(column->fd, &info) != 0) return;
+    size_t slots = (size_t)info.st_size / HISTORY_DB_BLOCK_SIZE;
+    slots = slots > 0 ? slots - 1 : 0;
+    if (map_column(column, slots) != 0) return;
+
+    // The last block may have grown since it was indexed
+    scan_blocks(column, column->blocks > 0 ? column->blocks - 1 : 0, slots);
+}
+
+static int open_column(struct column* column, const char* directory, int metric, int writable) {
+    column->fd = -1;
+    column->sketch_fd = -1;
+    column->newest_ms = INT64_MIN;
+    column->hour_ms = INT64_MIN;
+    codec_reset(&column->tail_codec);
+    quantile_sketch_clear(&column->hour);
+
+    if (open_file(column, directory, metric, writable) != 0) return -1;
+    if (writable && open_sketch_file(column, directory, metric, 1) != 0) return -1;
+    if (!writable) {
+        refresh_column(column, directory, metric);
+        return 0;
+    }
+
+    struct stat info;
+    if (fstat(column->fd, &info) != 0) return -1;
+    size_t slots = (size_t)info.st_size / HISTORY_DB_BLOCK_SIZE - 1;
+    if (map_column(column, slots) != 0) return -1;
+    scan_blocks(column, 0, slots);
+
+    // Drop a block torn by a crash mid-write, and anything after it
+    if ((off_t)((column->blocks + 1) * HISTORY_DB_BLOCK_SIZE) != info.st_size &&
+        ftruncate(column->fd, (off_t)((column->blocks + 1) * HISTORY_DB_BLOCK_SIZE)) != 0) {
+        return -1;
+    }
+
+    // Keep filling the last block if it has room
+    if (column->blocks > 0) {
+        const struct block* last = block_at(column, column->blocks - 1);
+        struct codec state;
+        if (last->header.bits + MAX_POINT_BITS <= PAYLOAD_BYTES * 8) {
+            decode_block(last, INT64_MIN, INT64_MAX, NULL, NULL, INT64_MAX, &state);
+            if (state.bits == last->header.bits && state.last_ms == last->header.last_ms) {
+                memcpy(&column->tail, last, sizeof(column->tail));
+                column->tail_codec = state;
+                column->blocks--;
+            }
+        }
+    }
+    return 0;
+}
+
+static void close_column(struct column* column) {
+    if (db_writable && column->fd >= 0) flush_tail(column);
+    if (db_writable) write_hour(column);
+    if (column->map != NULL) munmap((void*)column->map, column->map_size);
+    if (column->fd >= 0) close(column->fd);
+    if (column->sketch_fd >= 0) close(column->sketch_fd);
+    free(column->first_ms);
+    free(column->last_ms);
+    free(column->counts);
+    memset(column, 0, sizeof(*column));
+    column->fd = -1;
+    column->sketch_fd = -1;
+}
+
+// First indexed block that ends at or after `from_ms`
+static size_t first_block_from(const struct column* column, size_t blocks, int64_t from_ms) {
+    size_t low = 0, high = blocks;
+    while (low < high) {
+        size_t mid = low + (high - low) / 2;
+        if (column->last_ms[mid] < from_ms) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+// Range query without locking; see readHistoryRange(). A read-only view
+// decodes its last block from a validated copy, since the writer may be
+// rewriting it.
+static int64_t read_range(const struct column* column, int64_t from_ms, int64_t to_ms, int64_t* timestamps,
+                          double* values, int64_t capacity) {
+    struct block copy;
+    size_t blocks = mapped_blocks(column);
+    int64_t found = 0;
+
+    for (size_t i = first_block_from(column, blocks, from_ms); i < blocks && found < capacity; i++) {
+        if (column->first_ms[i] > to_ms) return found;
+
+        const struct block* block = block_at(column, i);
+        if (!db_writable && i + 1 == blocks) {
+            memcpy(&copy, block, sizeof(copy));
+            if (!block_valid(&copy)) break;
+            block = &copy;
+        }
+        if (values == NULL && column->first_ms[i] >= from_ms && column->last_ms[i] <= to_ms) {
+            found += column->counts[i];
+            continue;
+        }
+        found += decode_block(block, from_ms, to_ms, timestamps != NULL ? timestamps + found : NULL,
+                              values != NULL ? values + found : NULL, capacity - found, NULL);
+    }
+
+    const struct block* tail = &column->tail;
+    if (db_writable && column->tail_codec.count > 0 && found < capacity && tail->header.first_ms <= to_ms &&
+        tail->header.last_ms >= from_ms) {
+        found += decode_block(tail, from_ms, to_ms, timestamps != NULL ? timestamps + found : NULL,
+                              values != NULL ? values + found : NULL, capacity - found, NULL);
+    }
+    return found;
+}
+
+// Seed the in-memory rings with recent samples, mapping their wall-clock
+// times onto the monotonic clock the sampler stamps them with
+static void preload_history() {
+    int64_t now_ms = history_db_now_ms();
+    uint64_t now_ns = latency_now_ns();
+
+    for (int metric = 0; metric < HISTORY_METRIC_COUNT; metric++) {
+        const struct column* column = &columns[metric];
+        int64_t from_ms = now_ms - HISTORY_DB_PRELOAD_MS;
+        int64_t count = read_range(column, from_ms, now_ms, NULL, NULL, INT64_MAX);
+        if (count <= 0) continue;
+
+        int64_t* timestamps = malloc((size_t)count * sizeof(*timestamps));
+        double* values = malloc((size_t)count * sizeof(*values));
+        if (timestamps != NULL && values != NULL) {
+            count = read_range(column, from_ms, now_ms, timestamps, values, count);
+            for (int64_t i = 0; i < count; i++) {
+                uint64_t age_ns = (uint64_t)(now_ms - timestamps[i]) * 1000000ull;
+                if (age_ns < now_ns) history_push(metric, now_ns - age_ns, values[i]);
+            }
+        }
+        free(timestamps);
+        free(values);
+    }
+}
+
+// Per-user data directory: ~/Library/Application Support on macOS,
+// $XDG_DATA_HOME or ~/.local/share elsewhere
+static int default_directory(char* path, size_t size) {
+    const char* home = getenv("HOME");
+#ifdef __APPLE__
+    if (home == NULL || home[0] == '\0') return -1;
+    snprintf(path, size, "%s/Library/Application Support/cpu_monitor/history", home);
+#else
+    const char* data = getenv("XDG_DATA_HOME");
+    if (data != NULL && data[0] == '/') {
+        snprintf(path, size, "%s/cpu_monitor/history", data);
+    } else if (home != NULL && home[0] != '\0') {
+        snprintf(path, size, "%s/.local/share/cpu_monitor/history", home);
+    } else {
+        return -1;
+    }
+#endif
+    return 0;
+}
+
+static int make_directories(char* path) {
+    for (char* slash = strchr(path + 1, '/'); slash != NULL; slash = strchr(slash + 1, '/')) {
+        *slash = '\0';
+        int result = mkdir(path, 0755);
+        *slash = '/';
+        if (result != 0 && errno != EEXIST) return -1;
+    }
+    return mkdir(path, 0755) != 0 && errno != EEXIST ? -1 : 0;
+}
+
+static void close_locked() {
+    if (!db_open) return;
+
+    for (int metric = 0; metric < HISTORY_METRIC_COUNT; metric++) {
+        close_column(&columns[metric]);
+    }
+    if (lock_fd >= 0) close(lock_fd);
+    lock_fd = -1;
+    db_open = 0;
+    db_writable = 0;
+}
+
+static char db_directory[PATH_MAX];
+
+int openHistoryDatabase(const char* directory) {
+    char path[PATH_MAX];
+
+    if (directory != NULL) {
+        snprintf(path, sizeof(path), "%s", directory);
+    } else if (default_directory(path, sizeof(path)) != 0) {
+        fprintf(stderr, "No home directory for the history database\n");
+        return -1;
+    }
+    if (make_directories(path) != 0) {
+        fprintf(stderr, "Error creating history directory %s: %s\n", path, strerror(errno));
+        return -1;
+    }
+
+    pthread_rwlock_wrlock(&db_lock);
+    close_locked();
+
+    // Whoever holds the lock file writes; everyone else reads
+    char lock_path[PATH_MAX + 16];
+    snprintf(lock_path, sizeof(lock_path), "%s/writer.lock", path);
+    lock_fd = open(lock_path, O_RDWR | O_CREAT, 0644);
+    db_writable = lock_fd >= 0 && flock(lock_fd, LOCK_EX | LOCK_NB) == 0;
+    write_error_reported = 0;
+    snprintf(db_directory, sizeof(db_directory), "%s", path);
+
+    for (int metric = 0; metric < HISTORY_METRIC_COUNT; metric++) {
+        if (open_column(&columns[metric], path, metric, db_writable) != 0) {
+            fprintf(stderr, "Error opening history column %s in %s\n", column_names[metric], path);
+            for (int opened = 0; opened <= metric; opened++) {
+                close_column(&columns[opened]);
+            }
+            if (lock_fd >= 0) close(lock_fd);
+            lock_fd = -1;
+            db_writable = 0;
+            pthread_rwlock_unlock(&db_lock);
+            return -1;
+        }
+    }
+    db_open = 1;
+    if (db_writable) preload_history();
+
+    pthread_rwlock_unlock(&db_lock);
+    return 0;
+}
+
+void closeHistoryDatabase() {
+    pthread_rwlock_wrlock(&db_lock);
+    close_locked();
+    pthread_rwlock_unlock(&db_lock);
+}
+
+int getHistoryDatabaseMode() {
+    pthread_rwlock_rdlock(&db_lock);
+    int mode = db_open ? db_writable : -1;
+    pthread_rwlock_unlock(&db_lock);
+    return mode;
+}
+
+// Lock the store for a query. Returns 0 with nothing locked if no store is
+// open.
+static int begin_query(int metric) {
+    pthread_rwlock_rdlock(&db_lock);
+    if (db_open && db_writable) return 1;
+    pthread_rwlock_unlock(&db_lock);
+
+    pthread_rwlock_wrlock(&db_lock);
+    if (!db_open) {
+        pthread_rwlock_unlock(&db_lock);
+        return 0;
+    }
+    if (!db_writable) refresh_column(&columns[metric], db_directory, metric);
+    return 1;
+}
+
+int64_t getHistoryRangeCount(int metric, int64_t from_ms, int64_t to_ms) {
+    if (metric < 0 || metric >= HISTORY_METRIC_COUNT) return -1;
+    if (!begin_query(metric)) return -1;
+
+    int64_t count = read_range(&columns[metric], from_ms, to_ms, NULL, NULL, INT64_MAX);
+    pthread_rwlock_unlock(&db_lock);
+    return count;
+}
+
+int64_t readHistoryRange(int metric, int64_t from_ms, int64_t to_ms, int64_t* timestamps_ms,
+                         double* values, int64_t capacity) {
+    if (metric < 0 || metric >= HISTORY_METRIC_COUNT || values == NULL || capacity < 0) return -1;
+    if (!begin_query(metric)) return -1;
+
+    int64_t count = read_range(&columns[metric], from_ms, to_ms, timestamps_ms, values, capacity);
+    pthread_rwlock_unlock(&db_lock);
+    return count;
+}
+
+void history_db_append(int metric, int64_t timestamp_ms, double value) {
+    if (metric < 0 || metric >= HISTORY_METRIC_COUNT) return;
+
+    pthread_rwlock_wrlock(&db_lock);
+    struct column* column = &columns[metric];
+    if (db_open && db_writable && column->fd >= 0 && timestamp_ms > column->newest_ms) {
+        if (encode_point(&column->tail, &column->tail_codec, timestamp_ms, value) != 0) {
+            seal_tail(column);
+            encode_point(&column->tail, &column->tail_codec, timestamp_ms, value);
+        }
+        column->newest_ms = timestamp_ms;
+        if (++column->unflushed >= HISTORY_DB_FLUSH_POINTS) flush_tail(column);
+
+        int64_t hour_ms = timestamp_ms - timestamp_ms % HISTORY_DB_SKETCH_MS;
+        if (hour_ms != column->hour_ms) {
+            write_hour(column);
+            column->hour_ms = hour_ms;
+        }
+        quantile_sketch_add(&column->hour, value);
+    }
+    pthread_rwlock_unlock(&db_lock);
+}
+
+int32_t readHistorySketch(int metric, int64_t from_ms, int64_t to_ms, uint8_t* buffer, int32_t capacity) {
+    struct quantile_sketch merged;
+
+    if (metric < 0 || metric >= HISTORY_METRIC_COUNT || buffer == NULL) return -1;
+    if (!begin_query(metric)) return -1;
+
+    const struct column* column = &columns[metric];
+    quantile_sketch_clear(&merged);
+    if (column->sketch_fd >= 0) scan_sketches(column->sketch_fd, from_ms, to_ms, &merged);
+    if (db_writable && column->hour_ms <= to_ms && column->hour_ms + HISTORY_DB_SKETCH_MS > from_ms) {
+        quantile_sketch_merge(&merged, &column->hour);
+    }
+    pthread_rwlock_unlock(&db_lock);
+
+    return quantile_sketch_encode(&merged, buffer, capacity);
+}
@@ -0,0 +1,93 @@
+#ifndef HISTORY_DB_H
+#define HISTORY_DB_H
+
+#include <stdint.h>
+#include <time.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Persistent history on disk, one append-only column file per metric
+// (enum history_metric), fed by the sampler alongside the in-memory rings.
+//
+// Columns are split into fixed-size blocks compressed Gorilla-style:
+// timestamps as delta-of-deltas, values XORed with the previous one. A
+// steady 1 s series costs a few bits a point; a noisy one such as CPU usage
+// still stores under its 16 raw bytes. A sparse index of each block's
+// first/last timestamp finds a time range without decoding anything outside
+// it, and sealed blocks are read straight from a read-only mapping of the
+// file.
+//
+// One process writes a directory at a time (it holds `writer.lock`); any
+// other process opening it gets a read-only view that picks up new blocks
+// as the writer flushes them. The open block is flushed every
+// HISTORY_DB_FLUSH_POINTS samples, so a writer that crashes loses at most
+// that many.
+//
+// Timestamps are wall-clock milliseconds since the Unix epoch. Samples not
+// newer than the last one stored (the clock stepped back) are dropped.
+//
+// Each metric also gets a quantile sketch (quantile.h) per hour in
+// `<name>.sketch`, written when the hour ends or the writer closes, so
+// percentiles over days or weeks merge a few sketches instead of decoding
+// every sample.
+
+#define HISTORY_DB_BLOCK_SIZE 4096
+#define HISTORY_DB_FLUSH_POINTS 60
+
+// Span of each persisted quantile sketch
+#define HISTORY_DB_SKETCH_MS (60 * 60 * 1000)
+
+// History the in-memory rings are seeded with when opening for writing
+#define HISTORY_DB_PRELOAD_MS (60 * 60 * 1000)
+
+// Wall-clock timestamp for history_db_append()
+static inline int64_t history_db_now_ms(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_REALTIME, &now);
+    return (int64_t)now.tv_sec * 1000 + now.tv_nsec / 1000000;
+}
+
+// Open or create the store in `directory` (a per-user default under the
+// platform data directory if NULL), creating missing directories. The
+// writer also seeds the in-memory history rings with the last
+// HISTORY_DB_PRELOAD_MS of samples, so call it before startSampler().
+// Returns 0 on success, -1 on error.
+int openHistoryDatabase(const char* directory);
+
+// Flush the open blocks and close the store
+void closeHistoryDatabase();
+
+// Whether this process holds the store for writing. Returns 1 for the
+// writer, 0 for a read-only view, -1 if no store is open.
+int getHistoryDatabaseMode();
+
+// Number of samples of `metric` with from_ms <= timestamp <= to_ms. Only the
+// blocks at either end of the range are decoded. Returns -1 if no store is
+// open or for an unknown metric.
+int64_t getHistoryRangeCount(int metric, int64_t from_ms, int64_t to_ms);
+
+// Copy the samples of `metric` with from_ms <= timestamp <= to_ms, oldest
+// first, stopping after `capacity`. `timestamps_ms` may be NULL. Returns the
+// number of samples copied, or -1 if no store is open or the arguments are
+// invalid.
+int64_t readHistoryRange(int metric, int64_t from_ms, int64_t to_ms, int64_t* timestamps_ms,
+                         double* values, int64_t capacity);
+
+// Encode the merged quantile sketch of every hour of `metric` that overlaps
+// from_ms..to_ms, so hours are counted whole. The writer includes its
+// current hour; a read-only view only sees hours already written out.
+// Returns the bytes written, or -1 if no store is open, for invalid
+// arguments or too small a buffer (QUANTILE_SKETCH_MAX_BYTES always fits).
+int32_t readHistorySketch(int metric, int64_t from_ms, int64_t to_ms, uint8_t* buffer, int32_t capacity);
+
+// Append one sample; called by the sampler thread. Does nothing unless this
+// process holds the store for writing.
+void history_db_append(int metric, int64_t timestamp_ms, double value);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HISTORY_DB_H
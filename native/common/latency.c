@@ -0,0 +1,117 @@
+#include <stdatomic.h>
+#include <stddef.h>
+
+#include "latency.h"
+
+#define LATENCY_SUB_BUCKET_BITS 4
+#define LATENCY_SUB_BUCKETS (1 << LATENCY_SUB_BUCKET_BITS)
+// Powers of two tracked above the linear range (values up to 2^40 ns)
+#define LATENCY_MAGNITUDES 37
+#define LATENCY_BUCKETS ((LATENCY_MAGNITUDES + 1) * LATENCY_SUB_BUCKETS)
+
+struct latency_histogram {
+    _Atomic uint64_t buckets[LATENCY_BUCKETS];
+    _Atomic uint64_t count;
+    _Atomic uint64_t sum_ns;
+    _Atomic uint64_t max_ns;
+};
+
+static struct latency_histogram histograms[LATENCY_COLLECTOR_COUNT];
+
+// Values below LATENCY_SUB_BUCKETS map one-to-one; above that, the bucket is
+// the power of two plus the next LATENCY_SUB_BUCKET_BITS bits of the value
+static int bucket_index(uint64_t value) {
+    if (value < LATENCY_SUB_BUCKETS) return (int)value;
+
+    int magnitude = 63 - __builtin_clzll(value);
+    int shift = magnitude - LATENCY_SUB_BUCKET_BITS;
+    if (shift >= LATENCY_MAGNITUDES) return LATENCY_BUCKETS - 1;
+
+    int sub = (int)((value >> shift) & (LATENCY_SUB_BUCKETS - 1));
+    return (shift + 1) * LATENCY_SUB_BUCKETS + sub;
+}
+
+// Highest value that maps to a bucket, reported for percentiles
+static uint64_t bucket_upper_bound(int index) {
+    if (index < LATENCY_SUB_BUCKETS) return (uint64_t)index;
+
+    int shift = index / LATENCY_SUB_BUCKETS - 1;
+    uint64_t sub = (uint64_t)(index % LATENCY_SUB_BUCKETS);
+    return (((uint64_t)LATENCY_SUB_BUCKETS + sub + 1) << shift) - 1;
+}
+
+void latency_record(int collector, uint64_t start_ns) {
+    if (collector < 0 || collector >= LATENCY_COLLECTOR_COUNT) return;
+
+    struct latency_histogram* histogram = &histograms[collector];
+    uint64_t elapsed = latency_now_ns() - start_ns;
+
+    atomic_fetch_add_explicit(&histogram->buckets[bucket_index(elapsed)], 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&histogram->count, 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&histogram->sum_ns, elapsed, memory_order_relaxed);
+
+    uint64_t max = atomic_load_explicit(&histogram->max_ns, memory_order_relaxed);
+    while (elapsed > max &&
+           !atomic_compare_exchange_weak_explicit(&histogram->max_ns, &max, elapsed,
+                                                  memory_order_relaxed, memory_order_relaxed)) {
+    }
+}
+
+int getCollectorLatency(int collector, struct latency_stats* stats) {
+    if (collector < 0 || collector >= LATENCY_COLLECTOR_COUNT || stats == NULL) return -1;
+
+    struct latency_histogram* histogram = &histograms[collector];
+    uint64_t total = 0;
+
+    // Sum the buckets rather than trusting `count`, so percentiles stay
+    // consistent with the bucket snapshot even while writers are active
+    uint64_t counts[LATENCY_BUCKETS];
+    for (int i = 0; i < LATENCY_BUCKETS; i++) {
+        counts[i] = atomic_load_explicit(&histogram->buckets[i], memory_order_relaxed);
+        total += counts[i];
+    }
+
+    stats->count = total;
+    stats->max_ns = atomic_load_explicit(&histogram->max_ns, memory_order_relaxed);
+    stats->p50_ns = 0;
+    stats->p99_ns = 0;
+    stats->mean_ns = 0;
+    if (total == 0) return 0;
+
+    uint64_t recorded = atomic_load_explicit(&histogram->count, memory_order_relaxed);
+    if (recorded > 0) {
+        stats->mean_ns = atomic_load_explicit(&histogram->sum_ns, memory_order_relaxed) / recorded;
+    }
+
+    uint64_t p50_rank = (total * 50 + 99) / 100;
+    uint64_t p99_rank = (total * 99 + 99) / 100;
+    uint64_t seen = 0;
+    for (int i = 0; i < LATENCY_BUCKETS; i++) {
+        if (counts[i] == 0) continue;
+        seen += counts[i];
+        if (stats->p50_ns == 0 && seen >= p50_rank) stats->p50_ns = bucket_upper_bound(i);
+        if (seen >= p99_rank) {
+            stats->p99_ns = bucket_upper_bound(i);
+            break;
+        }
+    }
+
+    // Bucket bounds can overshoot the largest value actually seen
+    if (stats->p50_ns > stats->max_ns) stats->p50_ns = stats->max_ns;
+    if (stats->p99_ns > stats->max_ns) stats->p99_ns = stats->max_ns;
+    return 0;
+}
+
+void resetCollectorLatency(int collector) {
+    for (int c = 0; c < LATENCY_COLLECTOR_COUNT; c++) {
+        if (collector != -1 && collector != c) continue;
+
+        struct latency_histogram* histogram = &histograms[c];
+        for (int i = 0; i < LATENCY_BUCKETS; i++) {
+            atomic_store_explicit(&histogram->buckets[i], 0, memory_order_relaxed);
+        }
+        atomic_store_explicit(&histogram->count, 0, memory_order_relaxed);
+        atomic_store_explicit(&histogram->sum_ns, 0, memory_order_relaxed);
+        atomic_store_explicit(&histogram->max_ns, 0, memory_order_relaxed);
+    }
+}
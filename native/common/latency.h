@@ -0,0 +1,61 @@
+#ifndef LATENCY_H
+#define LATENCY_H
+
+#include <stdint.h>
+#include <time.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Always-on latency histograms, one per collector. Recording is a couple of
+// relaxed atomic increments, so it is safe from any thread and never blocks.
+//
+// Buckets are HDR-style log-linear: each power of two is split into
+// LATENCY_SUB_BUCKETS linear sub-buckets, which bounds the relative error of
+// any reported percentile to about 6% from 1 ns up to ~18 minutes.
+
+enum latency_collector {
+    LATENCY_CPU = 0,
+    LATENCY_MEMORY = 1,
+    LATENCY_DISK = 2,
+    LATENCY_TEMPERATURE = 3,
+    LATENCY_SNAPSHOT = 4,
+    LATENCY_PROCESSES = 5,
+    LATENCY_NETWORK = 6,
+    LATENCY_CGROUPS = 7,
+    LATENCY_MOUNTS = 8,
+    LATENCY_DISK_IO = 9,
+    LATENCY_COLLECTOR_COUNT
+};
+
+struct latency_stats {
+    uint64_t count;
+    uint64_t mean_ns;
+    uint64_t p50_ns;
+    uint64_t p99_ns;
+    uint64_t max_ns;
+};
+
+// Monotonic timestamp for latency_record()
+static inline uint64_t latency_now_ns(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000ull + (uint64_t)now.tv_nsec;
+}
+
+// Record the time elapsed since `start_ns` against a collector
+void latency_record(int collector, uint64_t start_ns);
+
+// Get count, mean, p50, p99 and max for a collector. Returns 0 on success,
+// -1 for an unknown collector or a NULL `stats`.
+int getCollectorLatency(int collector, struct latency_stats* stats);
+
+// Clear one collector's histogram, or all of them when `collector` is -1
+void resetCollectorLatency(int collector);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LATENCY_H
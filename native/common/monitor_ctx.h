@@ -0,0 +1,42 @@
+#ifndef MONITOR_CTX_H
+#define MONITOR_CTX_H
+
+#include "schedule.h"
+#include "system_snapshot.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Independent sampling contexts. CPU figures are deltas against the previous
+// sample, so every consumer that samples on its own schedule (the sampler
+// thread, an exporter, a second window) needs its own baseline; sharing the
+// process-wide one behind getCpuUsage() and getSystemSnapshot() would hand
+// each of them the interval since someone else's call.
+//
+// A context owns its baselines, read buffers and open sources. One context
+// must not be sampled from two threads at once, but different contexts may
+// be sampled concurrently without contending on a lock.
+struct monitor_ctx;
+
+// Create a context. Its first sample reports CPU usage since boot, like the
+// first getCpuUsage() call. Returns NULL on error.
+struct monitor_ctx* monitor_create();
+
+// Fill `snapshot` from one sample, as getSystemSnapshot() does for the
+// process-wide context. Returns 0 on success, -1 on error.
+int monitor_sample(struct monitor_ctx* ctx, struct system_snapshot* snapshot);
+
+// Like monitor_sample(), but only refresh the metrics whose collectors are
+// in `mask` (SCHEDULE_BIT() of SCHEDULE_CPU, _MEMORY, _DISK and
+// _TEMPERATURE); the other fields of `snapshot` are left as they are.
+int monitor_sample_mask(struct monitor_ctx* ctx, struct system_snapshot* snapshot, uint32_t mask);
+
+// Close the context's sources and free it; NULL is ignored
+void monitor_destroy(struct monitor_ctx* ctx);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // MONITOR_CTX_H
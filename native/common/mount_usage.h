@@ -0,0 +1,40 @@
+#ifndef MOUNT_USAGE_H
+#define MOUNT_USAGE_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Capacity of every real (block-backed or network) filesystem on the host.
+// The mount list is cached and only rebuilt when the mount table changes;
+// each call costs one statfs() per cached mount.
+
+#define MOUNT_PATH_LEN 128
+#define MOUNT_FSTYPE_LEN 16
+#define MOUNT_DEVICE_LEN 64
+
+struct mount_usage {
+    double total_mb;
+    double used_mb;
+    double available_mb;          // Free space usable by unprivileged users
+    double usage_percent;         // used / (used + available), like df
+    char mount_point[MOUNT_PATH_LEN];
+    char fs_type[MOUNT_FSTYPE_LEN];
+    char device[MOUNT_DEVICE_LEN];
+};
+
+// Write up to `capacity` mounts into `out`, ordered by mount point. Returns
+// the number written, or -1 on error.
+int getMountUsage(struct mount_usage* out, int capacity);
+
+// Release the cached mount list and close mountinfo (Linux only; the other
+// platforms keep no state)
+void mount_usage_cleanup();
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // MOUNT_USAGE_H
@@ -0,0 +1,40 @@
+#ifndef NET_IO_H
+#define NET_IO_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Per-interface network rates, computed from counter deltas between
+// consecutive calls. The first call, and the first after an interface is
+// added or removed, only sets the baseline and returns no rows.
+
+#define NET_IO_NAME_LEN 16
+
+struct net_io {
+    double rx_bytes_per_sec;
+    double tx_bytes_per_sec;
+    double rx_packets_per_sec;
+    double tx_packets_per_sec;
+    double rx_errors_per_sec;
+    double tx_errors_per_sec;
+    double rx_drops_per_sec;
+    double tx_drops_per_sec;
+    char name[NET_IO_NAME_LEN];
+};
+
+// Point the collector at other /proc/net/dev and /sys/class/net locations;
+// used by tests. A NULL proc path forces the sysfs fallback. Drops the
+// interface table and baselines.
+void net_io_set_sources(const char* proc_net_dev_path, const char* sys_net_path);
+
+// Close the open descriptors and drop the interface table
+void net_io_cleanup();
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // NET_IO_H
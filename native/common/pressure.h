@@ -0,0 +1,92 @@
+#ifndef PRESSURE_H
+#define PRESSURE_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Pressure stall information (PSI) from /proc/pressure. getPressure() reads
+// the kernel's running averages on demand. The pressure monitor instead
+// registers PSI triggers and sleeps in poll() on a background thread until
+// one fires, so a healthy system costs nothing between events. Kernels or
+// sandboxes that refuse triggers fall back to comparing the stall total once
+// per trigger window.
+
+enum pressure_resource {
+    PRESSURE_CPU = 0,
+    PRESSURE_MEMORY = 1,
+    PRESSURE_IO = 2,
+    PRESSURE_RESOURCE_COUNT = 3
+};
+
+// Trigger windows the kernel accepts, in microseconds
+#define PRESSURE_MIN_WINDOW_US 500000
+#define PRESSURE_MAX_WINDOW_US 10000000
+
+#define PRESSURE_MAX_TRIGGERS 16
+#define PRESSURE_EVENT_CAPACITY 128
+
+// Percent of wall time some / all non-idle tasks were stalled
+struct pressure_stats {
+    double some_avg10;
+    double some_avg60;
+    double some_avg300;
+    double full_avg10;
+    double full_avg60;
+    double full_avg300;
+    uint64_t some_total_us;
+    uint64_t full_total_us;
+    int32_t has_full;             // CPU "full" needs Linux 5.13
+    int32_t reserved;
+};
+
+struct pressure_event {
+    uint64_t sequence;            // Starts at 1, increases by one per event
+    int64_t timestamp_ms;         // Wall clock
+    int32_t resource;             // enum pressure_resource
+    int32_t full;                 // Trigger was on the "full" line
+    double avg10;                 // avg10 of that line when it fired
+    double threshold_percent;     // Trigger stall as a percent of its window
+};
+
+// Called on the monitor thread after each event is recorded
+typedef void (*pressure_callback)(int32_t resource);
+
+// Current averages of one resource. Returns 0 on success, -1 if PSI is
+// unavailable or the arguments are invalid.
+int getPressure(int resource, struct pressure_stats* out);
+
+// Fire when tasks stall for `stall_us` within any `window_us`. Triggers
+// added while the monitor runs are armed immediately. Returns 0, or -1 for
+// invalid arguments or when PRESSURE_MAX_TRIGGERS are set.
+int addPressureTrigger(int resource, int full, int stall_us, int window_us);
+
+// Remove every trigger
+void clearPressureTriggers();
+
+// Start the monitor thread; `callback` may be NULL. Returns 0 on success
+// (including when already running), -1 on error.
+int startPressureMonitor(pressure_callback callback);
+
+// Stop the monitor thread and wait for it to exit
+void stopPressureMonitor();
+
+// Copy events newer than `after_sequence`, oldest first. Returns the number
+// written, or -1 on invalid arguments.
+int readPressureEvents(struct pressure_event* out, int capacity, uint64_t after_sequence);
+
+// Read pressure files from `dir` instead of /proc/pressure, and always use
+// the polling fallback since plain files cannot raise PSI events; used by
+// tests. NULL restores the default.
+void pressure_set_sources(const char* dir);
+
+// Stop the monitor, drop triggers and events, and close descriptors
+void pressure_cleanup();
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PRESSURE_H
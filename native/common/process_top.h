@@ -0,0 +1,45 @@
+#ifndef PROCESS_TOP_H
+#define PROCESS_TOP_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Top-N process table. The collector keeps per-PID state across calls, so
+// CPU and I/O figures are rates since the previous call that saw the process.
+
+// Process names are the kernel's comm, at most 15 characters
+#define PROCESS_NAME_LEN 16
+
+enum process_sort {
+    PROCESS_SORT_CPU = 0,
+    PROCESS_SORT_RSS = 1,
+    PROCESS_SORT_IO = 2,
+    PROCESS_SORT_COUNT
+};
+
+struct process_usage {
+    int32_t pid;
+    int32_t threads;
+    double cpu_percent;           // Share of one CPU, like top (can exceed 100)
+    int64_t rss_kb;
+    double read_bytes_per_sec;    // Storage I/O; 0 if the process is not readable
+    double write_bytes_per_sec;
+    char name[PROCESS_NAME_LEN];
+};
+
+// Refresh the process table and write the `capacity` busiest processes by
+// `sort` into `out`, busiest first. Returns the number written, or -1 on
+// error. Not thread-safe; call from one thread.
+int getTopProcesses(int sort, struct process_usage* out, int capacity);
+
+// Close cached descriptors and drop all per-PID state
+void process_top_cleanup();
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PROCESS_TOP_H
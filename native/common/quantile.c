@@ -0,0 +1,280 @@
+#include <math.h>
+#include <string.h>
+
+#include "quantile.h"
+
+#define SKETCH_MAGIC 0x544b5351u   // "QSKT"
+#define SKETCH_VERSION 1
+#define SKETCH_HEADER_BYTES 24
+
+#define NS_PER_SECOND 1000000000ull
+
+// Reads that keep meeting an update in progress give up after this many
+// attempts
+#define READ_ATTEMPTS 1000
+
+static const uint64_t span_seconds[QUANTILE_WINDOW_COUNT] = {5 * 60, 60 * 60, 24 * 60 * 60};
+
+static double gamma_value() {
+    return (1.0 + QUANTILE_RELATIVE_ACCURACY) / (1.0 - QUANTILE_RELATIVE_ACCURACY);
+}
+
+// Bucket of a sample, or -1 for the zero bucket
+static int32_t bucket_of(double value) {
+    if (!(value >= QUANTILE_MIN_VALUE)) return -1;
+    double index = floor(log(value / QUANTILE_MIN_VALUE) / log(gamma_value()));
+    return index < QUANTILE_BUCKETS - 1 ? (int32_t)index : QUANTILE_BUCKETS - 1;
+}
+
+// Within the relative accuracy of every value in the bucket
+static double bucket_value(int32_t bucket) {
+    return QUANTILE_MIN_VALUE * pow(gamma_value(), bucket) * (1.0 + QUANTILE_RELATIVE_ACCURACY);
+}
+
+void quantile_sketch_clear(struct quantile_sketch* sketch) {
+    memset(sketch, 0, sizeof(*sketch));
+    sketch->lowest = QUANTILE_BUCKETS;
+    sketch->highest = -1;
+}
+
+static void sketch_add_count(struct quantile_sketch* sketch, int32_t bucket, uint64_t count) {
+    if (count == 0) return;
+    sketch->count += count;
+    if (bucket < 0) {
+        sketch->zero_count += count;
+        return;
+    }
+    sketch->buckets[bucket] += count;
+    if (bucket < sketch->lowest) sketch->lowest = bucket;
+    if (bucket > sketch->highest) sketch->highest = bucket;
+}
+
+void quantile_sketch_add(struct quantile_sketch* sketch, double value) {
+    if (isnan(value)) return;
+    sketch_add_count(sketch, bucket_of(value), 1);
+}
+
+void quantile_sketch_merge(struct quantile_sketch* into, const struct quantile_sketch* from) {
+    sketch_add_count(into, -1, from->zero_count);
+    for (int32_t bucket = from->lowest; bucket <= from->highest; bucket++) {
+        sketch_add_count(into, bucket, from->buckets[bucket]);
+    }
+}
+
+double quantile_sketch_query(const struct quantile_sketch* sketch, double q) {
+    if (sketch->count == 0 || !(q >= 0.0 && q <= 1.0)) return NAN;
+
+    // Lower rank, as in the DDSketch paper
+    uint64_t rank = (uint64_t)(q * (double)(sketch->count - 1));
+    uint64_t seen = sketch->zero_count;
+    if (rank < seen) return 0.0;
+    for (int32_t bucket = sketch->lowest; bucket <= sketch->highest; bucket++) {
+        seen += sketch->buckets[bucket];
+        if (rank < seen) return bucket_value(bucket);
+    }
+    return bucket_value(sketch->highest);
+}
+
+static int put_varint(uint8_t* buffer, int32_t capacity, int32_t* position, uint64_t value) {
+    do {
+        if (*position >= capacity) return -1;
+        uint8_t byte = value & 0x7f;
+        value >>= 7;
+        buffer[(*position)++] = byte | (value != 0 ? 0x80 : 0);
+    } while (value != 0);
+    return 0;
+}
+
+static int get_varint(const uint8_t* buffer, int32_t length, int32_t* position, uint64_t* value) {
+    *value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        if (*position >= length) return -1;
+        uint8_t byte = buffer[(*position)++];
+        *value |= (uint64_t)(byte & 0x7f) << shift;
+        if ((byte & 0x80) == 0) return 0;
+    }
+    return -1;
+}
+
+static void put_u32(uint8_t* out, uint32_t value) {
+    for (int i = 0; i < 4; i++) out[i] = (uint8_t)(value >> (8 * i));
+}
+
+static uint32_t get_u32(const uint8_t* in) {
+    return (uint32_t)in[0] | (uint32_t)in[1] << 8 | (uint32_t)in[2] << 16 | (uint32_t)in[3] << 24;
+}
+
+static void put_f64(uint8_t* out, double value) {
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    put_u32(out, (uint32_t)bits);
+    put_u32(out + 4, (uint32_t)(bits >> 32));
+}
+
+static double get_f64(const uint8_t* in) {
+    uint64_t bits = (uint64_t)get_u32(in) | (uint64_t)get_u32(in + 4) << 32;
+    double value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+// Header (magic, version, bucket count, accuracy, minimum value), then
+// varints: zero count, number of buckets from the lowest non-empty one,
+// the lowest bucket, and each count
+int32_t quantile_sketch_encode(const struct quantile_sketch* sketch, uint8_t* buffer, int32_t capacity) {
+    if (buffer == NULL || capacity < SKETCH_HEADER_BYTES) return -1;
+
+    put_u32(buffer, SKETCH_MAGIC);
+    put_u32(buffer + 4, SKETCH_VERSION | (uint32_t)QUANTILE_BUCKETS << 16);
+    put_f64(buffer + 8, QUANTILE_RELATIVE_ACCURACY);
+    put_f64(buffer + 16, QUANTILE_MIN_VALUE);
+
+    int32_t position = SKETCH_HEADER_BYTES;
+    int32_t used = sketch->highest >= sketch->lowest ? sketch->highest - sketch->lowest + 1 : 0;
+    if (put_varint(buffer, capacity, &position, sketch->zero_count) != 0 ||
+        put_varint(buffer, capacity, &position, (uint64_t)used) != 0 ||
+        put_varint(buffer, capacity, &position, used > 0 ? (uint64_t)sketch->lowest : 0) != 0) {
+        return -1;
+    }
+    for (int32_t i = 0; i < used; i++) {
+        if (put_varint(buffer, capacity, &position, sketch->buckets[sketch->lowest + i]) != 0) return -1;
+    }
+    return position;
+}
+
+int quantile_sketch_decode(struct quantile_sketch* sketch, const uint8_t* buffer, int32_t length) {
+    if (buffer == NULL || length < SKETCH_HEADER_BYTES || get_u32(buffer) != SKETCH_MAGIC ||
+        get_u32(buffer + 4) != (SKETCH_VERSION | (uint32_t)QUANTILE_BUCKETS << 16) ||
+        get_f64(buffer + 8) != QUANTILE_RELATIVE_ACCURACY || get_f64(buffer + 16) != QUANTILE_MIN_VALUE) {
+        return -1;
+    }
+
+    int32_t position = SKETCH_HEADER_BYTES;
+    uint64_t zero_count, used, lowest;
+    if (get_varint(buffer, length, &position, &zero_count) != 0 ||
+        get_varint(buffer, length, &position, &used) != 0 ||
+        get_varint(buffer, length, &position, &lowest) != 0 || lowest + used > QUANTILE_BUCKETS) {
+        return -1;
+    }
+
+    quantile_sketch_clear(sketch);
+    sketch_add_count(sketch, -1, zero_count);
+    for (uint64_t i = 0; i < used; i++) {
+        uint64_t count;
+        if (get_varint(buffer, length, &position, &count) != 0) return -1;
+        sketch_add_count(sketch, (int32_t)(lowest + i), count);
+    }
+    return 0;
+}
+
+static void slice_clear(struct quantile_slice* slice) {
+    if (slice->end > slice->lowest) {
+        memset(&slice->buckets[slice->lowest], 0, sizeof(slice->buckets[0]) * (size_t)(slice->end - slice->lowest));
+    }
+    slice->zero_count = 0;
+    slice->lowest = 0;
+    slice->end = 0;
+}
+
+// Take an expiring slice out of the totals and empty it
+static void window_expire(struct quantile_window* window, struct quantile_slice* slice) {
+    atomic_store_explicit(&window->zero_count,
+                          atomic_load_explicit(&window->zero_count, memory_order_relaxed) - slice->zero_count,
+                          memory_order_relaxed);
+    for (int32_t bucket = slice->lowest; bucket < slice->end; bucket++) {
+        uint32_t count = slice->buckets[bucket];
+        if (count == 0) continue;
+        atomic_store_explicit(&window->buckets[bucket],
+                              atomic_load_explicit(&window->buckets[bucket], memory_order_relaxed) - count,
+                              memory_order_relaxed);
+    }
+    slice_clear(slice);
+}
+
+void quantile_window_push(struct quantile_window* window, int span, uint64_t timestamp_ns, double value) {
+    if (span < 0 || span >= QUANTILE_WINDOW_COUNT || isnan(value)) return;
+
+    uint64_t slice_ns = span_seconds[span] * NS_PER_SECOND / QUANTILE_SLICES;
+    uint64_t number = timestamp_ns / slice_ns;
+    uint32_t sequence = atomic_load_explicit(&window->sequence, memory_order_relaxed);
+
+    // Too old for any slice still held
+    if (window->newest != 0 && number + QUANTILE_SLICES < window->newest) return;
+
+    atomic_store_explicit(&window->sequence, sequence + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+
+    // Expire the slices this one moves past; after a long gap, all of them
+    if (window->newest == 0) {
+        window->newest = number + 1;
+    } else if (number + 1 > window->newest) {
+        uint64_t steps = number + 1 - window->newest;
+        if (steps > QUANTILE_SLICES) steps = QUANTILE_SLICES;
+        for (uint64_t step = 0; step < steps; step++) {
+            window_expire(window, &window->slices[(number - step) % QUANTILE_SLICES]);
+        }
+        window->newest = number + 1;
+    }
+
+    struct quantile_slice* slice = &window->slices[number % QUANTILE_SLICES];
+    int32_t bucket = bucket_of(value);
+    if (bucket < 0) {
+        slice->zero_count++;
+        atomic_store_explicit(&window->zero_count, atomic_load_explicit(&window->zero_count, memory_order_relaxed) + 1,
+                              memory_order_relaxed);
+    } else {
+        if (slice->end == 0) {
+            slice->lowest = bucket;
+            slice->end = bucket + 1;
+        } else if (bucket < slice->lowest) {
+            slice->lowest = bucket;
+        } else if (bucket >= slice->end) {
+            slice->end = bucket + 1;
+        }
+        slice->buckets[bucket]++;
+        atomic_store_explicit(&window->buckets[bucket],
+                              atomic_load_explicit(&window->buckets[bucket], memory_order_relaxed) + 1,
+                              memory_order_relaxed);
+    }
+    atomic_store_explicit(&window->sequence, sequence + 2, memory_order_release);
+}
+
+int quantile_window_read(struct quantile_window* window, struct quantile_sketch* sketch) {
+    for (int attempt = 0; attempt < READ_ATTEMPTS; attempt++) {
+        uint32_t before = atomic_load_explicit(&window->sequence, memory_order_acquire);
+        if (before & 1) continue;
+
+        quantile_sketch_clear(sketch);
+        sketch_add_count(sketch, -1, atomic_load_explicit(&window->zero_count, memory_order_relaxed));
+        for (int32_t bucket = 0; bucket < QUANTILE_BUCKETS; bucket++) {
+            sketch_add_count(sketch, bucket, atomic_load_explicit(&window->buckets[bucket], memory_order_relaxed));
+        }
+
+        atomic_thread_fence(memory_order_acquire);
+        if (atomic_load_explicit(&window->sequence, memory_order_relaxed) == before) return 0;
+    }
+    return -1;
+}
+
+int64_t sketchQuantiles(const uint8_t* sketch, int32_t length, const double* quantiles, int32_t count,
+                        double* out) {
+    struct quantile_sketch decoded;
+
+    if (quantiles == NULL || out == NULL || count < 0) return -1;
+    if (quantile_sketch_decode(&decoded, sketch, length) != 0) return -1;
+    for (int32_t i = 0; i < count; i++) {
+        out[i] = quantile_sketch_query(&decoded, quantiles[i]);
+    }
+    return (int64_t)decoded.count;
+}
+
+int32_t mergeQuantileSketches(const uint8_t* a, int32_t a_length, const uint8_t* b, int32_t b_length,
+                              uint8_t* out, int32_t capacity) {
+    struct quantile_sketch merged, other;
+
+    if (quantile_sketch_decode(&merged, a, a_length) != 0 || quantile_sketch_decode(&other, b, b_length) != 0) {
+        return -1;
+    }
+    quantile_sketch_merge(&merged, &other);
+    return quantile_sketch_encode(&merged, out, capacity);
+}
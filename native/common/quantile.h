@@ -0,0 +1,105 @@
+#ifndef QUANTILE_H
+#define QUANTILE_H
+
+#include <stdatomic.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Mergeable quantile sketches (DDSketch): samples are counted in buckets
+// whose bounds grow geometrically by gamma = (1 + a) / (1 - a), so any
+// quantile comes back within relative accuracy a of a real sample, in fixed
+// memory and O(1) per sample. Two sketches merge by adding bucket counts,
+// which makes a window the sum of its slices and lets sketches from other
+// hours or hosts combine without their raw samples.
+//
+// Samples below QUANTILE_MIN_VALUE (idle CPU, say) share one zero bucket
+// and read back as 0; samples past the last bucket read back as its value.
+// NaN samples are ignored.
+
+#define QUANTILE_RELATIVE_ACCURACY 0.01
+#define QUANTILE_MIN_VALUE 0.01
+#define QUANTILE_BUCKETS 768       // Up to about 40000
+#define QUANTILE_SKETCH_MAX_BYTES 8192
+
+// Sliding windows kept per history metric; each is QUANTILE_SLICES slices
+// that expire whole, so a window covers its length give or take a slice
+enum quantile_window_span {
+    QUANTILE_WINDOW_5MIN = 0,
+    QUANTILE_WINDOW_1H = 1,
+    QUANTILE_WINDOW_24H = 2,
+    QUANTILE_WINDOW_COUNT
+};
+
+#define QUANTILE_SLICES 12
+
+struct quantile_sketch {
+    uint64_t count;
+    uint64_t zero_count;
+    int32_t lowest;            // Range of non-empty buckets; lowest > highest if none
+    int32_t highest;
+    uint64_t buckets[QUANTILE_BUCKETS];
+};
+
+// One sliding window. Plain data, valid when zeroed, so it can live in the
+// shared history store: one writer updates it and readers copy the totals
+// under `sequence` (odd while an update is in progress).
+struct quantile_slice {
+    uint32_t zero_count;
+    int32_t lowest;            // Non-empty buckets lie in [lowest, end); end is 0 if none
+    int32_t end;
+    uint32_t buckets[QUANTILE_BUCKETS];
+};
+
+struct quantile_window {
+    _Atomic uint32_t sequence;
+    uint64_t newest;           // Newest slice number + 1; 0 if empty
+    struct quantile_slice slices[QUANTILE_SLICES];
+    _Atomic uint64_t zero_count;
+    _Atomic uint32_t buckets[QUANTILE_BUCKETS];
+};
+
+void quantile_sketch_clear(struct quantile_sketch* sketch);
+void quantile_sketch_add(struct quantile_sketch* sketch, double value);
+void quantile_sketch_merge(struct quantile_sketch* into, const struct quantile_sketch* from);
+
+// Value at quantile q (0..1), or NaN if the sketch is empty or q is out of
+// range
+double quantile_sketch_query(const struct quantile_sketch* sketch, double q);
+
+// Compact little-endian encoding of a sketch, at most
+// QUANTILE_SKETCH_MAX_BYTES. Returns the bytes written, or -1 if
+// `capacity` is too small.
+int32_t quantile_sketch_encode(const struct quantile_sketch* sketch, uint8_t* buffer, int32_t capacity);
+
+// Returns 0, or -1 for a truncated encoding or one made with other bucket
+// parameters
+int quantile_sketch_decode(struct quantile_sketch* sketch, const uint8_t* buffer, int32_t length);
+
+// Add a sample taken at `timestamp_ns` (monotonic) to a window of the given
+// span (enum quantile_window_span), which must not change. Slices
+// that fell out of the window are subtracted from the totals first, so the
+// cost is amortised over the samples of a slice. Single writer only.
+void quantile_window_push(struct quantile_window* window, int span, uint64_t timestamp_ns, double value);
+
+// Copy a window's totals. Returns 0, or -1 if the writer kept it busy for
+// too long (or died mid-update in another process).
+int quantile_window_read(struct quantile_window* window, struct quantile_sketch* sketch);
+
+// Quantiles of an encoded sketch: out[i] is the value at quantiles[i].
+// Returns the number of samples in the sketch, or -1 for invalid arguments.
+int64_t sketchQuantiles(const uint8_t* sketch, int32_t length, const double* quantiles, int32_t count,
+                        double* out);
+
+// Merge two encoded sketches into `out`. Returns the bytes written, or -1
+// for invalid input or too small a `capacity`.
+int32_t mergeQuantileSketches(const uint8_t* a, int32_t a_length, const uint8_t* b, int32_t b_length,
+                              uint8_t* out, int32_t capacity);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // QUANTILE_H
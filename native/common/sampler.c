@@ -0,0 +1,341 @@
+#include <math.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "dart_port.h"
+#include "history.h"
+#include "history_db.h"
+#include "latency.h"
+#include "monitor_ctx.h"
+#include "sampler.h"
+#include "seqlock.h"
+#include "shared_segment.h"
+
+// Bounds for the sampling interval (1 ms .. 1 hour)
+#define SAMPLER_MIN_INTERVAL_MS 1
+#define SAMPLER_MAX_INTERVAL_MS 3600000
+
+// Latest-value slot shared with readers
+static _Atomic uint32_t slot_sequence = 0;
+static _Atomic uint64_t slot_words[SEQLOCK_WORDS(struct system_snapshot)];
+
+// Sampler thread state, guarded by control_lock
+static pthread_mutex_t control_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t control_cond;
+static pthread_once_t control_once = PTHREAD_ONCE_INIT;
+static pthread_t sampler_thread;
+static int sampler_running = 0;
+static int sampler_stop_requested = 0;
+static int sampler_interval_ms = 1000;
+static int sampler_adaptive = 0;
+
+// Raw history pacing for adaptive mode, touched only by the sampler thread.
+// The raw ring has no timestamps and assumes one point per sampler
+// interval, so each metric is resampled onto that grid: samples taken
+// inside one step are averaged into its point, and steps the collector
+// slept through repeat the previous point.
+struct history_pace {
+    int has_point;
+    int32_t step_ms;
+    uint64_t step_end_ns;
+    double sum;
+    uint32_t count;
+    double point;
+};
+static struct history_pace paces[HISTORY_METRIC_COUNT];
+
+static void init_control_cond() {
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+#ifndef __APPLE__
+    // Sleep on the monotonic clock so wall-clock changes do not stall sampling
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+#endif
+    pthread_cond_init(&control_cond, &attr);
+    pthread_condattr_destroy(&attr);
+}
+
+static int clamp_interval(int interval_ms) {
+    if (interval_ms < SAMPLER_MIN_INTERVAL_MS) return SAMPLER_MIN_INTERVAL_MS;
+    if (interval_ms > SAMPLER_MAX_INTERVAL_MS) return SAMPLER_MAX_INTERVAL_MS;
+    return interval_ms;
+}
+
+// Wait up to interval_ms or until woken by stop/set-interval. Called with
+// control_lock held.
+static void wait_interval(int interval_ms) {
+#ifdef __APPLE__
+    struct timespec relative;
+    relative.tv_sec = interval_ms / 1000;
+    relative.tv_nsec = (long)(interval_ms % 1000) * 1000000L;
+    pthread_cond_timedwait_relative_np(&control_cond, &control_lock, &relative);
+#else
+    struct timespec deadline;
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+    deadline.tv_sec += interval_ms / 1000;
+    deadline.tv_nsec += (long)(interval_ms % 1000) * 1000000L;
+    if (deadline.tv_nsec >= 1000000000L) {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000L;
+    }
+    pthread_cond_timedwait(&control_cond, &control_lock, &deadline);
+#endif
+}
+
+// Wait until the monotonic `deadline_ns`, or without a deadline if it is
+// negative, or until woken. Called with control_lock held.
+static void wait_until(int64_t deadline_ns) {
+    if (deadline_ns < 0) {
+        pthread_cond_wait(&control_cond, &control_lock);
+        return;
+    }
+#ifdef __APPLE__
+    uint64_t now_ns = latency_now_ns();
+    uint64_t delay_ns = (uint64_t)deadline_ns > now_ns ? (uint64_t)deadline_ns - now_ns : 0;
+    struct timespec relative;
+    relative.tv_sec = (time_t)(delay_ns / 1000000000ull);
+    relative.tv_nsec = (long)(delay_ns % 1000000000ull);
+    pthread_cond_timedwait_relative_np(&control_cond, &control_lock, &relative);
+#else
+    struct timespec deadline;
+    deadline.tv_sec = (time_t)((uint64_t)deadline_ns / 1000000000ull);
+    deadline.tv_nsec = (long)((uint64_t)deadline_ns % 1000000000ull);
+    pthread_cond_timedwait(&control_cond, &control_lock, &deadline);
+#endif
+}
+
+// Wake the sampler to recompute its deadline after the schedule changed
+static void wake_sampler(void) {
+    pthread_once(&control_once, init_control_cond);
+    pthread_mutex_lock(&control_lock);
+    pthread_cond_signal(&control_cond);
+    pthread_mutex_unlock(&control_lock);
+}
+
+// Feed one metric to the in-memory rings and the on-disk store
+static void record(int metric, uint64_t timestamp_ns, int64_t wall_ms, double value) {
+    history_push(metric, timestamp_ns, value);
+    history_db_append(metric, wall_ms, value);
+}
+
+// Like record(), through the metric's pacing. The on-disk store is
+// timestamped, so it gets the real sample as it is.
+static void record_paced(int metric, uint64_t timestamp_ns, int64_t wall_ms, double value, int32_t step_ms) {
+    struct history_pace* pace = &paces[metric];
+    uint64_t step_ns = (uint64_t)step_ms * 1000000ull;
+
+    history_db_append(metric, wall_ms, value);
+    if (!pace->has_point || pace->step_ms != step_ms) {
+        history_push(metric, timestamp_ns, value);
+        pace->has_point = 1;
+        pace->step_ms = step_ms;
+        pace->step_end_ns = timestamp_ns + step_ns;
+        pace->sum = 0;
+        pace->count = 0;
+        pace->point = value;
+        return;
+    }
+
+    // A quarter step of slack keeps a sample that wakes slightly early on
+    // the step it was meant for
+    if (timestamp_ns + step_ns / 4 < pace->step_end_ns) {
+        pace->sum += value;
+        pace->count++;
+        return;
+    }
+
+    uint64_t skipped = (timestamp_ns + step_ns / 4 - pace->step_end_ns) / step_ns;
+    if (skipped > 0 && pace->count > 0) {
+        // The open step closes with the samples it already has
+        pace->point = pace->sum / pace->count;
+        history_push(metric, pace->step_end_ns, pace->point);
+        pace->step_end_ns += step_ns;
+        pace->sum = 0;
+        pace->count = 0;
+        skipped--;
+    }
+    if (skipped >= HISTORY_RAW_CAPACITY) {
+        // Longer than the ring holds: start the grid again from this sample
+        skipped = HISTORY_RAW_CAPACITY;
+        pace->step_end_ns = timestamp_ns - skipped * step_ns;
+    }
+    for (uint64_t i = 0; i < skipped; i++) {
+        history_push(metric, pace->step_end_ns, pace->point);
+        pace->step_end_ns += step_ns;
+    }
+
+    pace->point = (pace->sum + value) / (pace->count + 1);
+    history_push(metric, timestamp_ns, pace->point);
+    pace->step_end_ns += step_ns;
+    pace->sum = 0;
+    pace->count = 0;
+}
+
+// The history metric of each snapshot collector (the two enums share
+// their first four values), or NAN when the sample has no value for it
+static double history_value(const struct system_snapshot* sample, int metric) {
+    switch (metric) {
+        case HISTORY_CPU:
+            return sample->cpu_usage >= 0 ? sample->cpu_usage : NAN;
+        case HISTORY_MEMORY:
+            return sample->memory_total > 0 && sample->memory_used >= 0
+                       ? (double)sample->memory_used / (double)sample->memory_total * 100.0
+                       : NAN;
+        case HISTORY_DISK:
+            return sample->disk_usage >= 0 ? sample->disk_usage : NAN;
+        case HISTORY_TEMPERATURE:
+            return sample->temperature >= 0 ? sample->temperature : NAN;
+        default:
+            return NAN;
+    }
+}
+
+// Feed the native history from a completed sample. In adaptive mode only
+// the metrics in `mask` were sampled; they are paced onto the raw grid and
+// reported to the schedule.
+static void record_history(const struct system_snapshot* sample, uint32_t mask, int adaptive, int32_t step_ms) {
+    uint64_t timestamp = sample->timestamp_ns;
+    int64_t wall_ms = history_db_now_ms();
+
+    for (int metric = 0; metric < HISTORY_METRIC_COUNT; metric++) {
+        if (!(mask & SCHEDULE_BIT(metric))) continue;
+        double value = history_value(sample, metric);
+        if (isnan(value)) continue;
+        if (adaptive) {
+            record_paced(metric, timestamp, wall_ms, value, step_ms);
+            schedule_report_at(metric, value, timestamp);
+        } else {
+            record(metric, timestamp, wall_ms, value);
+        }
+    }
+}
+
+static void* sampler_main(void* arg) {
+    struct system_snapshot sample;
+    (void)arg;
+
+    // A context of its own, so direct getCpuUsage()/getSystemSnapshot()
+    // callers do not shorten the interval the sampler's deltas cover
+    struct monitor_ctx* ctx = monitor_create();
+
+    // Kept across iterations: an adaptive sample only refreshes the
+    // collectors that are due and publishes the rest as they were
+    memset(&sample, 0, sizeof(sample));
+    sample.version = SYSTEM_SNAPSHOT_VERSION;
+    sample.size = sizeof(sample);
+    int has_sample = 0;
+    int was_adaptive = 0;
+
+    pthread_mutex_lock(&control_lock);
+    while (!sampler_stop_requested) {
+        int adaptive = sampler_adaptive;
+        int32_t step_ms = sampler_interval_ms;
+        pthread_mutex_unlock(&control_lock);
+
+        // Fixed sampling fed the raw rings directly in the meantime
+        if (adaptive && !was_adaptive) memset(paces, 0, sizeof(paces));
+        was_adaptive = adaptive;
+
+        // Collect outside the lock so stop/set-interval never wait on I/O.
+        // The first sample fills every field whatever is due.
+        uint32_t mask = SCHEDULE_SNAPSHOT_MASK;
+        if (adaptive) {
+            uint32_t due = schedule_due_at(SCHEDULE_SNAPSHOT_MASK, latency_now_ns());
+            mask = has_sample ? due : SCHEDULE_SNAPSHOT_MASK;
+        }
+        if (mask != 0) {
+            int result = ctx != NULL ? monitor_sample_mask(ctx, &sample, mask) : getSystemSnapshot(&sample);
+            if (result == 0) {
+                has_sample = 1;
+                seqlock_write(&slot_sequence, slot_words, &sample, sizeof(sample));
+                record_history(&sample, mask, adaptive, step_ms);
+                dart_port_publish(&sample);
+                shared_segment_publish(&sample);
+            }
+        }
+
+        pthread_mutex_lock(&control_lock);
+        if (!sampler_stop_requested) {
+            if (sampler_adaptive) {
+                wait_until(schedule_next_ns(SCHEDULE_SNAPSHOT_MASK, latency_now_ns()));
+            } else {
+                wait_interval(sampler_interval_ms);
+            }
+        }
+    }
+    pthread_mutex_unlock(&control_lock);
+
+    monitor_destroy(ctx);
+    return NULL;
+}
+
+int startSampler(int interval_ms) {
+    int result = 0;
+
+    pthread_once(&control_once, init_control_cond);
+    pthread_mutex_lock(&control_lock);
+    sampler_interval_ms = clamp_interval(interval_ms);
+    if (!sampler_running) {
+        sampler_stop_requested = 0;
+        if (pthread_create(&sampler_thread, NULL, sampler_main, NULL) == 0) {
+            sampler_running = 1;
+        } else {
+            fprintf(stderr, "Error starting sampler thread\n");
+            result = -1;
+        }
+    } else {
+        pthread_cond_signal(&control_cond);
+    }
+    pthread_mutex_unlock(&control_lock);
+    return result;
+}
+
+void stopSampler() {
+    pthread_once(&control_once, init_control_cond);
+    pthread_mutex_lock(&control_lock);
+    if (!sampler_running) {
+        pthread_mutex_unlock(&control_lock);
+        return;
+    }
+    sampler_stop_requested = 1;
+    pthread_cond_signal(&control_cond);
+    pthread_mutex_unlock(&control_lock);
+
+    pthread_join(sampler_thread, NULL);
+
+    pthread_mutex_lock(&control_lock);
+    sampler_running = 0;
+    pthread_mutex_unlock(&control_lock);
+}
+
+void setSamplerInterval(int interval_ms) {
+    pthread_once(&control_once, init_control_cond);
+    pthread_mutex_lock(&control_lock);
+    sampler_interval_ms = clamp_interval(interval_ms);
+    pthread_cond_signal(&control_cond);
+    pthread_mutex_unlock(&control_lock);
+}
+
+void setSamplerAdaptive(int enabled) {
+    pthread_once(&control_once, init_control_cond);
+    // Registered before taking control_lock: the listener takes it too
+    schedule_set_listener(enabled ? wake_sampler : NULL);
+    pthread_mutex_lock(&control_lock);
+    sampler_adaptive = enabled != 0;
+    pthread_cond_signal(&control_cond);
+    pthread_mutex_unlock(&control_lock);
+}
+
+int readLatestSnapshot(struct system_snapshot* snapshot) {
+    struct system_snapshot latest;
+
+    if (snapshot == NULL || snapshot->size < SYSTEM_SNAPSHOT_MIN_SIZE) {
+        return -1;
+    }
+    if (seqlock_read(&slot_sequence, slot_words, &latest, sizeof(latest)) != 0) {
+        return -1;
+    }
+    return system_snapshot_copy_out(snapshot, &latest);
+}
@@ -0,0 +1,39 @@
+#ifndef SAMPLER_H
+#define SAMPLER_H
+
+#include "system_snapshot.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Background sampler. A native thread samples its own monitor_ctx every
+// interval and publishes the result into a seqlock-protected slot, so
+// readLatestSnapshot() is a plain memory copy with no syscalls.
+
+// Start sampling every `interval_ms` milliseconds. Returns 0 on success
+// (including when already running), -1 on error.
+int startSampler(int interval_ms);
+
+// Stop the sampler thread and wait for it to exit
+void stopSampler();
+
+// Change the sampling interval; takes effect immediately
+void setSamplerInterval(int interval_ms);
+
+// Let the schedule (schedule.h) decide when each snapshot collector is
+// sampled instead of sampling all of them every interval. The interval
+// still spaces the raw history: collectors sampled less often repeat their
+// last value there, and ones sampled more often are averaged per interval.
+// Off by default.
+void setSamplerAdaptive(int enabled);
+
+// Copy the most recently published snapshot. Returns 0 on success, -1 if no
+// sample has been published yet or `snapshot` is invalid.
+int readLatestSnapshot(struct system_snapshot* snapshot);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SAMPLER_H
@@ -0,0 +1,284 @@
+#include <math.h>
+#include <pthread.h>
+#include <stddef.h>
+
+#include "latency.h"
+#include "schedule.h"
+
+#define NS_PER_MS 1000000ull
+
+// Intervals in ms, then the change per value (percentage points, Celsius
+// or MB/s) that counts as stable and the one that tightens the interval.
+// Collectors only the UI shows pause while it is hidden; the snapshot ones
+// feed the history and slow down instead.
+static const struct schedule_policy default_policies[SCHEDULE_COLLECTOR_COUNT] = {
+    [SCHEDULE_CPU] = {1000, 250, 4000, 5000, 1.0, 10.0},
+    [SCHEDULE_MEMORY] = {1000, 500, 8000, 10000, 0.1, 2.0},
+    [SCHEDULE_DISK] = {5000, 1000, 60000, 60000, 0.01, 0.5},
+    [SCHEDULE_TEMPERATURE] = {2000, 1000, 10000, 30000, 0.5, 4.0},
+    [SCHEDULE_PROCESSES] = {2000, 1000, 10000, 0, 1.0, 20.0},     // Busiest process's CPU
+    [SCHEDULE_MOUNTS] = {10000, 5000, 60000, 0, 0.01, 0.5},       // Fullest filesystem
+    [SCHEDULE_DISK_IO] = {1000, 500, 8000, 0, 0.1, 20.0},         // Total throughput
+    [SCHEDULE_NETWORK] = {1000, 500, 8000, 0, 0.05, 10.0},        // Total throughput
+    [SCHEDULE_SENSORS] = {2000, 1000, 10000, 0, 0.5, 4.0},        // Hottest sensor
+    [SCHEDULE_PRESSURE] = {2000, 1000, 10000, 0, 0.1, 5.0},       // Highest some avg10
+    [SCHEDULE_CONTAINER] = {1000, 500, 8000, 0, 1.0, 10.0},       // cgroup CPU
+    [SCHEDULE_CGROUPS] = {2000, 1000, 10000, 0, 1.0, 20.0},       // Busiest group's CPU
+};
+
+// Hotplug and resizes are rare, and the next read after the TTL sees them
+static const int32_t default_static_ttl_ms[SCHEDULE_STATIC_COUNT] = {
+    [SCHEDULE_STATIC_CORE_COUNT] = 60000,
+    [SCHEDULE_STATIC_MEMORY_TOTAL] = 60000,
+    [SCHEDULE_STATIC_DISK_TOTAL] = 30000,
+};
+
+struct collector_state {
+    struct schedule_policy policy;
+    int32_t current_ms;          // Interval while visible
+    uint64_t next_due_ns;        // 0: due now
+    int has_value;
+    int stable_run;
+    double last_value;
+};
+
+struct static_value {
+    int has_value;
+    double value;
+    uint64_t stored_ns;
+};
+
+// Everything below is guarded by schedule_lock
+static pthread_mutex_t schedule_lock = PTHREAD_MUTEX_INITIALIZER;
+static int initialized = 0;
+static int visible = 1;
+static struct collector_state collectors[SCHEDULE_COLLECTOR_COUNT];
+static struct static_value statics[SCHEDULE_STATIC_COUNT];
+static int32_t static_ttl_ms[SCHEDULE_STATIC_COUNT];
+static void (*schedule_listener)(void) = NULL;
+
+static void reset_locked(void) {
+    for (int i = 0; i < SCHEDULE_COLLECTOR_COUNT; i++) {
+        struct collector_state* state = &collectors[i];
+        state->policy = default_policies[i];
+        state->current_ms = state->policy.interval_ms;
+        state->next_due_ns = 0;
+        state->has_value = 0;
+        state->stable_run = 0;
+    }
+    for (int i = 0; i < SCHEDULE_STATIC_COUNT; i++) {
+        statics[i].has_value = 0;
+        static_ttl_ms[i] = default_static_ttl_ms[i];
+    }
+    visible = 1;
+    initialized = 1;
+}
+
+static void lock(void) {
+    pthread_mutex_lock(&schedule_lock);
+    if (!initialized) reset_locked();
+}
+
+// Tell a sleeping sampler to recompute its deadline, outside the lock
+static void unlock_and_notify(void) {
+    void (*listener)(void) = schedule_listener;
+    pthread_mutex_unlock(&schedule_lock);
+    if (listener != NULL) listener();
+}
+
+static int32_t effective_ms(const struct collector_state* state) {
+    return visible ? state->current_ms : state->policy.hidden_interval_ms;
+}
+
+static int valid_collector(int collector) {
+    return collector >= 0 && collector < SCHEDULE_COLLECTOR_COUNT;
+}
+
+int setSchedulePolicy(int collector, const struct schedule_policy* policy) {
+    if (!valid_collector(collector) || policy == NULL) return -1;
+    if (policy->min_interval_ms <= 0 || policy->min_interval_ms > policy->interval_ms ||
+        policy->interval_ms > policy->max_interval_ms || policy->hidden_interval_ms < 0 ||
+        !(policy->stable_change >= 0) || !(policy->active_change > policy->stable_change)) {
+        return -1;
+    }
+
+    lock();
+    struct collector_state* state = &collectors[collector];
+    state->policy = *policy;
+    state->current_ms = policy->interval_ms;
+    state->stable_run = 0;
+    unlock_and_notify();
+    return 0;
+}
+
+int getSchedulePolicy(int collector, struct schedule_policy* policy) {
+    if (!valid_collector(collector) || policy == NULL) return -1;
+
+    lock();
+    *policy = collectors[collector].policy;
+    pthread_mutex_unlock(&schedule_lock);
+    return 0;
+}
+
+int32_t getScheduleInterval(int collector) {
+    if (!valid_collector(collector)) return -1;
+
+    lock();
+    int32_t interval = effective_ms(&collectors[collector]);
+    pthread_mutex_unlock(&schedule_lock);
+    return interval;
+}
+
+void setScheduleVisible(int now_visible) {
+    lock();
+    now_visible = now_visible != 0;
+    if (now_visible == visible) {
+        pthread_mutex_unlock(&schedule_lock);
+        return;
+    }
+    visible = now_visible;
+    // Coming back refreshes everything at once rather than when the long
+    // hidden intervals run out
+    if (visible) {
+        for (int i = 0; i < SCHEDULE_COLLECTOR_COUNT; i++) collectors[i].next_due_ns = 0;
+    }
+    unlock_and_notify();
+}
+
+uint32_t schedule_due_at(uint32_t mask, uint64_t now_ns) {
+    uint32_t due = 0;
+
+    lock();
+    for (int i = 0; i < SCHEDULE_COLLECTOR_COUNT; i++) {
+        struct collector_state* state = &collectors[i];
+        int32_t interval_ms = effective_ms(state);
+        if (!(mask & SCHEDULE_BIT(i)) || interval_ms == 0) continue;
+
+        uint64_t slack_ns = (uint64_t)(interval_ms / 4 < SCHEDULE_MAX_SLACK_MS ? interval_ms / 4 : SCHEDULE_MAX_SLACK_MS) *
+                            NS_PER_MS;
+        if (state->next_due_ns <= now_ns + slack_ns) {
+            due |= SCHEDULE_BIT(i);
+            // From now rather than from the due time, so collectors taken
+            // together stay together
+            state->next_due_ns = now_ns + (uint64_t)interval_ms * NS_PER_MS;
+        }
+    }
+    pthread_mutex_unlock(&schedule_lock);
+    return due;
+}
+
+int64_t schedule_next_ns(uint32_t mask, uint64_t now_ns) {
+    int64_t next = -1;
+
+    lock();
+    for (int i = 0; i < SCHEDULE_COLLECTOR_COUNT; i++) {
+        const struct collector_state* state = &collectors[i];
+        if (!(mask & SCHEDULE_BIT(i)) || effective_ms(state) == 0) continue;
+        uint64_t due = state->next_due_ns > now_ns ? state->next_due_ns : now_ns;
+        if (next < 0 || due < (uint64_t)next) next = (int64_t)due;
+    }
+    pthread_mutex_unlock(&schedule_lock);
+    return next;
+}
+
+void schedule_report_at(int collector, double value, uint64_t now_ns) {
+    if (!valid_collector(collector) || isnan(value)) return;
+
+    lock();
+    struct collector_state* state = &collectors[collector];
+    const struct schedule_policy* policy = &state->policy;
+    if (state->has_value) {
+        double change = fabs(value - state->last_value);
+        if (change >= policy->active_change) {
+            state->stable_run = 0;
+            state->current_ms = state->current_ms / 2 > policy->min_interval_ms ? state->current_ms / 2
+                                                                                 : policy->min_interval_ms;
+            // Do not sit out the rest of a long backed-off interval
+            uint64_t sooner = now_ns + (uint64_t)state->current_ms * NS_PER_MS;
+            if (visible && state->next_due_ns > sooner) state->next_due_ns = sooner;
+        } else if (change <= policy->stable_change) {
+            if (++state->stable_run >= SCHEDULE_STABLE_RUN) {
+                state->stable_run = 0;
+                state->current_ms = state->current_ms * 2 < policy->max_interval_ms ? state->current_ms * 2
+                                                                                    : policy->max_interval_ms;
+            }
+        } else {
+            state->stable_run = 0;
+            if (state->current_ms > policy->interval_ms) {
+                state->current_ms = state->current_ms / 2 > policy->interval_ms ? state->current_ms / 2
+                                                                                : policy->interval_ms;
+            } else if (state->current_ms < policy->interval_ms) {
+                state->current_ms = state->current_ms * 2 < policy->interval_ms ? state->current_ms * 2
+                                                                                : policy->interval_ms;
+            }
+        }
+    }
+    state->has_value = 1;
+    state->last_value = value;
+    pthread_mutex_unlock(&schedule_lock);
+}
+
+uint32_t scheduleDue(uint32_t mask) {
+    return schedule_due_at(mask, latency_now_ns());
+}
+
+int64_t scheduleNextMs(uint32_t mask) {
+    uint64_t now_ns = latency_now_ns();
+    int64_t next = schedule_next_ns(mask, now_ns);
+    if (next < 0) return -1;
+    return (int64_t)(((uint64_t)next - now_ns + NS_PER_MS - 1) / NS_PER_MS);
+}
+
+void scheduleReport(int collector, double value) {
+    schedule_report_at(collector, value, latency_now_ns());
+}
+
+void resetSchedule() {
+    pthread_mutex_lock(&schedule_lock);
+    reset_locked();
+    unlock_and_notify();
+}
+
+int setStaticValueTtl(int value, int32_t ttl_ms) {
+    if (value < 0 || value >= SCHEDULE_STATIC_COUNT || ttl_ms < 0) return -1;
+
+    lock();
+    static_ttl_ms[value] = ttl_ms;
+    pthread_mutex_unlock(&schedule_lock);
+    return 0;
+}
+
+void invalidateStaticValues() {
+    lock();
+    for (int i = 0; i < SCHEDULE_STATIC_COUNT; i++) statics[i].has_value = 0;
+    pthread_mutex_unlock(&schedule_lock);
+}
+
+int schedule_static_get(int value, double* out) {
+    if (value < 0 || value >= SCHEDULE_STATIC_COUNT || out == NULL) return 0;
+
+    uint64_t now_ns = latency_now_ns();
+    lock();
+    const struct static_value* cached = &statics[value];
+    int fresh = cached->has_value && now_ns - cached->stored_ns < (uint64_t)static_ttl_ms[value] * NS_PER_MS;
+    if (fresh) *out = cached->value;
+    pthread_mutex_unlock(&schedule_lock);
+    return fresh;
+}
+
+void schedule_static_put(int value, double cached) {
+    if (value < 0 || value >= SCHEDULE_STATIC_COUNT) return;
+
+    uint64_t now_ns = latency_now_ns();
+    lock();
+    statics[value].has_value = 1;
+    statics[value].value = cached;
+    statics[value].stored_ns = now_ns;
+    pthread_mutex_unlock(&schedule_lock);
+}
+
+void schedule_set_listener(void (*listener)(void)) {
+    lock();
+    schedule_listener = listener;
+    pthread_mutex_unlock(&schedule_lock);
+}
@@ -0,0 +1,122 @@
+#ifndef SCHEDULE_H
+#define SCHEDULE_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Adaptive per-collector sampling schedule. Each collector has a policy: a
+// normal interval, the range it may move in, and an interval for while the
+// dashboard is hidden (0 pauses it). Reporting each new value moves the
+// interval: a metric that stays put backs off towards the slowest interval,
+// one that jumps tightens towards the fastest, and anything in between
+// drifts back to normal.
+//
+// The sampler thread takes the snapshot collectors and the UI takes the
+// rest, both from the same clock. Taking collects every collector due
+// within a quarter of its interval (at most SCHEDULE_MAX_SLACK_MS early), so
+// collectors with similar intervals fall into step and share one wakeup.
+
+enum schedule_collector {
+    SCHEDULE_CPU = 0,
+    SCHEDULE_MEMORY = 1,
+    SCHEDULE_DISK = 2,
+    SCHEDULE_TEMPERATURE = 3,
+    SCHEDULE_PROCESSES = 4,
+    SCHEDULE_MOUNTS = 5,
+    SCHEDULE_DISK_IO = 6,
+    SCHEDULE_NETWORK = 7,
+    SCHEDULE_SENSORS = 8,
+    SCHEDULE_PRESSURE = 9,
+    SCHEDULE_CONTAINER = 10,
+    SCHEDULE_CGROUPS = 11,
+    SCHEDULE_COLLECTOR_COUNT
+};
+
+#define SCHEDULE_BIT(collector) (1u << (collector))
+#define SCHEDULE_ALL ((1u << SCHEDULE_COLLECTOR_COUNT) - 1)
+
+// Collectors that fill struct system_snapshot
+#define SCHEDULE_SNAPSHOT_MASK                                                                     \
+    (SCHEDULE_BIT(SCHEDULE_CPU) | SCHEDULE_BIT(SCHEDULE_MEMORY) | SCHEDULE_BIT(SCHEDULE_DISK) | \
+     SCHEDULE_BIT(SCHEDULE_TEMPERATURE))
+
+#define SCHEDULE_MAX_SLACK_MS 500
+
+// Consecutive stable values before an interval backs off
+#define SCHEDULE_STABLE_RUN 3
+
+struct schedule_policy {
+    int32_t interval_ms;         // While the metric moves normally
+    int32_t min_interval_ms;     // While it changes quickly
+    int32_t max_interval_ms;     // After it has stayed put
+    int32_t hidden_interval_ms;  // While hidden or minimised; 0 pauses it
+    double stable_change;        // Change per value, in the metric's units, that counts as stable
+    double active_change;        // ... and that tightens the interval
+};
+
+// Values that rarely change, cached for a time to live by the functions
+// that read them (getCpuCoreCount() and the totals)
+enum schedule_static {
+    SCHEDULE_STATIC_CORE_COUNT = 0,
+    SCHEDULE_STATIC_MEMORY_TOTAL = 1,
+    SCHEDULE_STATIC_DISK_TOTAL = 2,
+    SCHEDULE_STATIC_COUNT
+};
+
+// Replace a collector's policy; it takes effect from its next value.
+// Returns 0, or -1 for an unknown collector or inconsistent intervals.
+int setSchedulePolicy(int collector, const struct schedule_policy* policy);
+
+// Returns 0, or -1 for an unknown collector or a NULL `policy`
+int getSchedulePolicy(int collector, struct schedule_policy* policy);
+
+// Interval the collector is on now, in ms; 0 while paused, -1 if unknown
+int32_t getScheduleInterval(int collector);
+
+// Whether the dashboard can be seen. Hidden collectors move to their
+// hidden interval at once; showing the dashboard makes everything due.
+void setScheduleVisible(int visible);
+
+// Take the collectors in `mask` that are due now: they are returned as a
+// bit mask and next due one interval from now
+uint32_t scheduleDue(uint32_t mask);
+
+// Milliseconds until the first collector in `mask` is due (0 if one is
+// overdue), or -1 if every one of them is paused
+int64_t scheduleNextMs(uint32_t mask);
+
+// Report the value a collector just read, to adapt its interval. NaN is
+// ignored.
+void scheduleReport(int collector, double value);
+
+// Normal intervals, default policies, and everything due now
+void resetSchedule();
+
+// Set how long a static value stays cached; 0 disables the cache.
+// Returns 0, or -1 for an unknown value or a negative TTL.
+int setStaticValueTtl(int value, int32_t ttl_ms);
+
+// Drop every cached static value
+void invalidateStaticValues();
+
+// Clock-explicit forms of the above, for the sampler thread and tests
+uint32_t schedule_due_at(uint32_t mask, uint64_t now_ns);
+int64_t schedule_next_ns(uint32_t mask, uint64_t now_ns);
+void schedule_report_at(int collector, double value, uint64_t now_ns);
+
+// Cached static value, if one younger than its TTL exists
+int schedule_static_get(int value, double* out);
+void schedule_static_put(int value, double cached);
+
+// Called (on the caller's thread) after anything that can move a due time
+// earlier, so a thread sleeping until the next due time can recompute it
+void schedule_set_listener(void (*listener)(void));
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SCHEDULE_H
@@ -0,0 +1,58 @@
+#ifndef SENSORS_H
+#define SENSORS_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Hardware temperature and fan sensors. The hwmon and thermal zone trees
+// are walked once, on first use or rescanSensors(); every input found keeps
+// an open descriptor, so a read is one pread() per sensor.
+
+#define SENSOR_NAME_LEN 32
+#define SENSOR_MAX_COUNT 256
+
+enum sensor_kind {
+    SENSOR_CPU_PACKAGE = 0,       // Whole-package or die temperature
+    SENSOR_CPU_CORE = 1,
+    SENSOR_NVME = 2,
+    SENSOR_GPU = 3,
+    SENSOR_FAN = 4,               // Value is RPM
+    SENSOR_OTHER = 5              // Board, chipset, ACPI and other temperatures
+};
+
+struct sensor_reading {
+    double value;                 // Celsius, or RPM for fans
+    double critical;              // Celsius; 0 if the chip reports no limit
+    int32_t kind;                 // enum sensor_kind
+    int32_t index;                // Core or fan number, -1 if none
+    char chip[SENSOR_NAME_LEN];   // hwmon name or thermal zone type
+    char label[SENSOR_NAME_LEN];  // Input label, or the input file's stem
+};
+
+// Read every sensor, ordered by kind, chip and index. Inputs that fail to
+// read are skipped. Returns the number of rows written, or -1 on error.
+int getSensors(struct sensor_reading* out, int capacity);
+
+// Walk the sysfs trees again, e.g. after a device was hot-plugged. Returns
+// the number of sensors found.
+int rescanSensors();
+
+// Hottest CPU package sensor, else the hottest core, else the first ACPI
+// thermal zone (acpitz); -1 without any. Used by getTemperature().
+double sensors_cpu_temperature();
+
+// Point the collector at other /sys/class/hwmon and /sys/class/thermal
+// locations; used by tests. Drops the sensor table.
+void sensors_set_sources(const char* hwmon_path, const char* thermal_path);
+
+// Close every sensor descriptor and drop the table
+void sensors_cleanup();
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SENSORS_H
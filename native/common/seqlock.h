@@ -0,0 +1,98 @@
+#ifndef SEQLOCK_H
+#define SEQLOCK_H
+
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Single-writer sequence lock over a fixed-size payload of 64-bit words.
+//
+// The writer bumps the sequence to an odd value, stores the payload and bumps
+// it back to even. Readers never block the writer and never take a lock: they
+// copy the payload and retry only if the sequence changed underneath them.
+// The payload words are atomics so the concurrent copy is not a data race.
+
+#define SEQLOCK_WORDS(type) ((sizeof(type) + sizeof(uint64_t) - 1) / sizeof(uint64_t))
+
+// Publish `size` bytes from `src`. Must only be called from one thread.
+static inline void seqlock_write(_Atomic uint32_t* sequence, _Atomic uint64_t* words,
+                                 const void* src, size_t size) {
+    const unsigned char* bytes = (const unsigned char*)src;
+    size_t count = (size + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+    uint32_t seq = atomic_load_explicit(sequence, memory_order_relaxed);
+
+    atomic_store_explicit(sequence, seq + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+
+    for (size_t i = 0; i < count; i++) {
+        uint64_t word = 0;
+        size_t offset = i * sizeof(uint64_t);
+        memcpy(&word, bytes + offset, size - offset < sizeof(word) ? size - offset : sizeof(word));
+        atomic_store_explicit(&words[i], word, memory_order_relaxed);
+    }
+
+    atomic_store_explicit(sequence, seq + 2, memory_order_release);
+}
+
+// Copy the latest consistent payload into `dst`. Returns 0 on success or -1
+// if nothing has been published yet.
+static inline int seqlock_read(_Atomic uint32_t* sequence, _Atomic uint64_t* words,
+                               void* dst, size_t size) {
+    unsigned char* bytes = (unsigned char*)dst;
+    size_t count = (size + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+    for (;;) {
+        uint32_t before = atomic_load_explicit(sequence, memory_order_acquire);
+        if (before == 0) return -1;
+        if (before & 1) continue;
+
+        for (size_t i = 0; i < count; i++) {
+            uint64_t word = atomic_load_explicit(&words[i], memory_order_relaxed);
+            size_t offset = i * sizeof(uint64_t);
+            memcpy(bytes + offset, &word, size - offset < sizeof(word) ? size - offset : sizeof(word));
+        }
+
+        atomic_thread_fence(memory_order_acquire);
+        if (atomic_load_explicit(sequence, memory_order_relaxed) == before) {
+            return 0;
+        }
+    }
+}
+
+// Like seqlock_read(), but give up after `attempts` torn copies. For a
+// writer in another process, which may die halfway through a write and
+// leave the sequence odd for good.
+static inline int seqlock_try_read(_Atomic uint32_t* sequence, _Atomic uint64_t* words,
+                                   void* dst, size_t size, int attempts) {
+    unsigned char* bytes = (unsigned char*)dst;
+    size_t count = (size + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+    for (int attempt = 0; attempt < attempts; attempt++) {
+        uint32_t before = atomic_load_explicit(sequence, memory_order_acquire);
+        if (before == 0) return -1;
+        if (before & 1) continue;
+
+        for (size_t i = 0; i < count; i++) {
+            uint64_t word = atomic_load_explicit(&words[i], memory_order_relaxed);
+            size_t offset = i * sizeof(uint64_t);
+            memcpy(bytes + offset, &word, size - offset < sizeof(word) ? size - offset : sizeof(word));
+        }
+
+        atomic_thread_fence(memory_order_acquire);
+        if (atomic_load_explicit(sequence, memory_order_relaxed) == before) {
+            return 0;
+        }
+    }
+    return -1;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SEQLOCK_H
@@ -0,0 +1,186 @@
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "history.h"
+#include "latency.h"
+#include "seqlock.h"
+#include "shared_segment.h"
+
+// Torn snapshot copies a viewer tolerates before giving up on a collector
+// that died mid-write
+#define READ_ATTEMPTS 1000
+
+#define ALIGN(value) (((value) + 63) & ~(uint64_t)63)
+
+// Collector state; only changed while the sampler thread is stopped
+static struct shared_segment_header* writer = NULL;
+static size_t writer_size = 0;
+static char writer_name[64];
+
+// Viewer state
+static struct shared_segment_header* viewer = NULL;
+static size_t viewer_size = 0;
+
+static uint64_t snapshot_bytes() {
+    return SEQLOCK_WORDS(struct system_snapshot) * sizeof(uint64_t);
+}
+
+static _Atomic uint64_t* snapshot_words(struct shared_segment_header* header) {
+    return (_Atomic uint64_t*)((char*)header + header->snapshot_offset);
+}
+
+// Whether a snapshot arrived within SHARED_SEGMENT_STALE_INTERVALS intervals
+static int is_live(struct shared_segment_header* header) {
+    uint64_t published = atomic_load_explicit(&header->published_ns, memory_order_acquire);
+    if (published == 0) return 0;
+
+    uint64_t stale_ns = (uint64_t)header->interval_ms * SHARED_SEGMENT_STALE_INTERVALS * 1000000ull;
+    return latency_now_ns() - published <= stale_ns;
+}
+
+// Whether a mapped segment was written by a collector with this layout
+static int is_compatible(struct shared_segment_header* header, size_t size) {
+    if (atomic_load_explicit(&header->magic, memory_order_acquire) != SHARED_SEGMENT_MAGIC) return 0;
+    return header->version == SHARED_SEGMENT_VERSION &&
+           header->snapshot_size == sizeof(struct system_snapshot) &&
+           header->history_size == history_store_size() &&
+           header->snapshot_offset + snapshot_bytes() <= header->history_offset &&
+           header->history_offset + header->history_size <= size;
+}
+
+// Map an existing segment read-only. Returns NULL if there is none.
+static struct shared_segment_header* map_existing(const char* name, size_t* size) {
+    int fd = shm_open(name, O_RDONLY, 0);
+    if (fd < 0) return NULL;
+
+    struct stat info;
+    void* mapping = MAP_FAILED;
+    if (fstat(fd, &info) == 0 && (size_t)info.st_size >= sizeof(struct shared_segment_header)) {
+        mapping = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    }
+    close(fd);
+    if (mapping == MAP_FAILED) return NULL;
+
+    *size = (size_t)info.st_size;
+    return mapping;
+}
+
+int shared_segment_create(const char* name, int interval_ms) {
+    if (name == NULL) name = SHARED_SEGMENT_NAME;
+    if (writer != NULL || interval_ms <= 0 || strlen(name) >= sizeof(writer_name)) return -1;
+
+    // Replace a segment left behind by a collector that is gone
+    size_t existing_size;
+    struct shared_segment_header* existing = map_existing(name, &existing_size);
+    if (existing != NULL) {
+        int live = is_compatible(existing, existing_size) && is_live(existing);
+        munmap(existing, existing_size);
+        if (live) {
+            fprintf(stderr, "Another collector is publishing to %s\n", name);
+            return -1;
+        }
+        shm_unlink(name);
+    }
+
+    uint64_t snapshot_offset = ALIGN(sizeof(struct shared_segment_header));
+    uint64_t history_offset = ALIGN(snapshot_offset + snapshot_bytes());
+    size_t size = (size_t)(history_offset + history_store_size());
+
+    int fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0644);
+    if (fd < 0) {
+        fprintf(stderr, "Error creating shared segment %s: %s\n", name, strerror(errno));
+        return -1;
+    }
+    // Viewers run as other users; do not let the umask lock them out
+    fchmod(fd, 0644);
+
+    // Extending the object zero-fills it: no snapshot and an empty history
+    void* mapping = MAP_FAILED;
+    if (ftruncate(fd, (off_t)size) == 0) {
+        mapping = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        fprintf(stderr, "Error mapping shared segment %s: %s\n", name, strerror(errno));
+        shm_unlink(name);
+        return -1;
+    }
+
+    struct shared_segment_header* header = mapping;
+    header->version = SHARED_SEGMENT_VERSION;
+    header->snapshot_size = sizeof(struct system_snapshot);
+    header->interval_ms = (uint32_t)interval_ms;
+    header->history_size = history_store_size();
+    header->snapshot_offset = snapshot_offset;
+    header->history_offset = history_offset;
+    header->writer_pid = (int64_t)getpid();
+    atomic_store_explicit(&header->magic, SHARED_SEGMENT_MAGIC, memory_order_release);
+
+    history_use_store((char*)mapping + history_offset, 1);
+    writer = header;
+    writer_size = size;
+    snprintf(writer_name, sizeof(writer_name), "%s", name);
+    return 0;
+}
+
+void shared_segment_publish(const struct system_snapshot* sample) {
+    if (writer == NULL) return;
+
+    seqlock_write(&writer->snapshot_sequence, snapshot_words(writer), sample, sizeof(*sample));
+    atomic_store_explicit(&writer->published_ns, latency_now_ns(), memory_order_release);
+}
+
+void shared_segment_destroy() {
+    if (writer == NULL) return;
+
+    history_use_store(NULL, 1);
+    munmap(writer, writer_size);
+    shm_unlink(writer_name);
+    writer = NULL;
+    writer_size = 0;
+}
+
+int attachSharedSegment(const char* name) {
+    if (name == NULL) name = SHARED_SEGMENT_NAME;
+    detachSharedSegment();
+
+    size_t size;
+    struct shared_segment_header* header = map_existing(name, &size);
+    if (header == NULL) return -1;
+
+    if (!is_compatible(header, size) || !is_live(header)) {
+        munmap(header, size);
+        return -1;
+    }
+
+    history_use_store((char*)header + header->history_offset, 0);
+    viewer = header;
+    viewer_size = size;
+    return 0;
+}
+
+int readSharedSnapshot(struct system_snapshot* snapshot) {
+    struct system_snapshot latest;
+
+    if (viewer == NULL || snapshot == NULL || snapshot->size < SYSTEM_SNAPSHOT_MIN_SIZE) return -1;
+    if (!is_live(viewer)) return -1;
+    if (seqlock_try_read(&viewer->snapshot_sequence, snapshot_words(viewer), &latest, sizeof(latest),
+                         READ_ATTEMPTS) != 0) {
+        return -1;
+    }
+    return system_snapshot_copy_out(snapshot, &latest);
+}
+
+void detachSharedSegment() {
+    if (viewer == NULL) return;
+
+    history_use_store(NULL, 1);
+    munmap(viewer, viewer_size);
+    viewer = NULL;
+    viewer_size = 0;
+}
@@ -0,0 +1,78 @@
+#ifndef SHARED_SEGMENT_H
+#define SHARED_SEGMENT_H
+
+#include <stdatomic.h>
+#include <stdint.h>
+
+#include "system_snapshot.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Snapshots and history published by one collector process for any number
+// of viewers on the same host. cpu_monitor_daemon samples once per interval
+// into a POSIX shared memory object (/dev/shm/cpu_monitor on Linux);
+// dashboards map it read-only, copy snapshots out through its seqlock and
+// read history views straight from the mapping, so another viewer adds no
+// collection work.
+//
+// The segment is a struct shared_segment_header followed by the snapshot
+// slot and the history store at the offsets the header records. Viewers
+// check the magic, layout version and sizes when attaching, so a viewer
+// from another build samples in-process instead of misreading the segment.
+
+#define SHARED_SEGMENT_NAME "/cpu_monitor"
+#define SHARED_SEGMENT_MAGIC 0x4e4f4d43u   // "CMON"
+#define SHARED_SEGMENT_VERSION 3
+
+// Viewers treat the collector as gone after this many intervals without a
+// snapshot
+#define SHARED_SEGMENT_STALE_INTERVALS 5
+
+struct shared_segment_header {
+    _Atomic uint32_t magic;              // Stored last, once the rest is valid
+    uint32_t version;
+    uint32_t snapshot_size;              // sizeof(struct system_snapshot)
+    uint32_t interval_ms;
+    uint64_t history_size;               // history_store_size()
+    uint64_t snapshot_offset;
+    uint64_t history_offset;
+    int64_t writer_pid;
+    _Atomic uint64_t published_ns;       // Monotonic clock of the latest snapshot
+    _Atomic uint32_t snapshot_sequence;  // Seqlock over the snapshot slot
+    uint32_t reserved;
+};
+
+// Collector side. Create the segment `name` (SHARED_SEGMENT_NAME if NULL)
+// and move history into it. Fails if a live collector already publishes
+// there; a stale segment left by a crashed one is replaced. Returns 0 on
+// success, -1 on error.
+int shared_segment_create(const char* name, int interval_ms);
+
+// Called by the sampler thread with every sample it publishes; does nothing
+// unless this process created a segment
+void shared_segment_publish(const struct system_snapshot* sample);
+
+// Move history back to process memory, unmap and remove the segment
+void shared_segment_destroy();
+
+// Viewer side, called from one thread. Map the segment `name`
+// (SHARED_SEGMENT_NAME if NULL) read-only and read history from it. Returns
+// 0 on success, or -1 if there is no segment, it comes from another build,
+// or its collector has stopped publishing.
+int attachSharedSegment(const char* name);
+
+// Copy the collector's latest snapshot. Returns 0 on success, or -1 if not
+// attached or the collector has stopped publishing, in which case the
+// caller should detach and sample in-process.
+int readSharedSnapshot(struct system_snapshot* snapshot);
+
+// Unmap the segment and read history from process memory again
+void detachSharedSegment();
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SHARED_SEGMENT_H
@@ -0,0 +1,67 @@
+#ifndef SYSTEM_SNAPSHOT_H
+#define SYSTEM_SNAPSHOT_H
+
+#include <stdint.h>
+#include <string.h>
+
+#include "core_usage.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Layout version of struct system_snapshot. Fields are only ever appended,
+// so a caller built against an older version still gets a valid prefix.
+#define SYSTEM_SNAPSHOT_VERSION 2
+
+// Cores carried inline in a snapshot; larger hosts use getPerCoreUsage()
+#define SYSTEM_SNAPSHOT_MAX_CORES 512
+
+// One coherent sample of every per-tick metric, filled in a single FFI call.
+// The caller sets `version` and `size` to what it was built against; the
+// library writes at most `size` bytes and reports its own version back.
+struct system_snapshot {
+    uint32_t version;
+    uint32_t size;
+    uint64_t timestamp_ns;   // Monotonic clock at the time of the sample
+
+    double cpu_usage;        // Percentage (0-100)
+    int64_t memory_used;     // MB
+    int64_t memory_total;    // MB
+    double disk_usage;       // Percentage (0-100) of the root filesystem
+    double disk_used;        // MB
+    double disk_total;       // MB
+    double temperature;      // Celsius, -1 if unavailable
+
+    // Version 2
+    int32_t core_count;      // Logical CPUs present in per_core
+    int32_t reserved;
+    double per_core[SYSTEM_SNAPSHOT_MAX_CORES * CORE_USAGE_FIELDS]; // user/system/idle/iowait % per core
+};
+
+// Smallest snapshot a caller may pass (the version 1 layout)
+#define SYSTEM_SNAPSHOT_MIN_SIZE 72
+
+// Fill `snapshot` from one sample. Returns 0 on success, -1 on error.
+int getSystemSnapshot(struct system_snapshot* snapshot);
+
+// Copy a complete sample into a caller-provided snapshot, honouring the
+// caller's declared size. Shared by the platform backends.
+static inline int system_snapshot_copy_out(struct system_snapshot* dst,
+                                           const struct system_snapshot* src) {
+    if (dst == NULL || dst->size < SYSTEM_SNAPSHOT_MIN_SIZE) {
+        return -1;
+    }
+
+    uint32_t size = dst->size < sizeof(*src) ? dst->size : (uint32_t)sizeof(*src);
+    memcpy(dst, src, size);
+    dst->version = SYSTEM_SNAPSHOT_VERSION;
+    dst->size = size;
+    return 0;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SYSTEM_SNAPSHOT_H
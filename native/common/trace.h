@@ -0,0 +1,18 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdio.h>
+
+// Compile-time trace points for debugging the collectors. Build with
+// -DCPU_MONITOR_TRACE_ENABLED to print them; otherwise they compile to
+// nothing (the arguments are still type-checked).
+#ifdef CPU_MONITOR_TRACE_ENABLED
+#define CPU_MONITOR_TRACE(...) fprintf(stderr, __VA_ARGS__)
+#else
+#define CPU_MONITOR_TRACE(...)                 \
+    do {                                       \
+        if (0) fprintf(stderr, __VA_ARGS__);   \
+    } while (0)
+#endif
+
+#endif // TRACE_H
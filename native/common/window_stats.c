@@ -0,0 +1,115 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "window_stats.h"
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+// Prefix sums into out, then each full window is the difference of two of
+// them. The difference pass runs backwards so it can overwrite the sums it
+// no longer needs, and has no dependency between points, so it vectorises.
+static void moving_mean(const double* values, int32_t length, int32_t window, double* out) {
+    double sum = 0.0;
+    for (int32_t i = 0; i < length; i++) {
+        sum += values[i];
+        out[i] = sum;
+    }
+
+    int32_t i = length - 1;
+#ifdef __SSE2__
+    const __m128d scale = _mm_set1_pd((double)window);
+    for (; i - 1 >= window; i -= 2) {
+        __m128d upper = _mm_loadu_pd(out + i - 1);
+        __m128d lower = _mm_loadu_pd(out + i - 1 - window);
+        _mm_storeu_pd(out + i - 1, _mm_div_pd(_mm_sub_pd(upper, lower), scale));
+    }
+#endif
+    for (; i >= window; i--) {
+        out[i] = (out[i] - out[i - window]) / (double)window;
+    }
+    for (; i >= 0; i--) {
+        out[i] /= (double)(i + 1);
+    }
+}
+
+static void exponential_mean(const double* values, int32_t length, int32_t window, double* out) {
+    double alpha = 2.0 / ((double)window + 1.0);
+    double average = values[0];
+
+    for (int32_t i = 0; i < length; i++) {
+        average += alpha * (values[i] - average);
+        out[i] = average;
+    }
+}
+
+// Monotonic deque of indices whose values only rise (minimum) or fall
+// (maximum) from the front; the front is the window's extreme. Every index
+// is pushed and popped at most once.
+static int rolling_extreme(const double* values, int32_t length, int32_t window, int maximum, double* out) {
+    int32_t* queue = malloc(sizeof(int32_t) * (size_t)length);
+    if (queue == NULL) {
+        fprintf(stderr, "computeWindowStat: cannot allocate %d deque slots\n", length);
+        return -1;
+    }
+
+    int32_t head = 0, tail = 0;
+    for (int32_t i = 0; i < length; i++) {
+        double value = values[i];
+        while (tail > head && (maximum ? values[queue[tail - 1]] <= value : values[queue[tail - 1]] >= value)) {
+            tail--;
+        }
+        queue[tail++] = i;
+        if (queue[head] <= i - window) head++;
+        out[i] = values[queue[head]];
+    }
+
+    free(queue);
+    return 0;
+}
+
+// Welford's update, sliding: each step adds the new sample and, once the
+// window is full, removes the one leaving it
+static void rolling_stddev(const double* values, int32_t length, int32_t window, double* out) {
+    double mean = 0.0, m2 = 0.0;
+
+    for (int32_t i = 0; i < length; i++) {
+        double value = values[i];
+        if (i < window) {
+            double delta = value - mean;
+            mean += delta / (double)(i + 1);
+            m2 += delta * (value - mean);
+            out[i] = sqrt(fmax(m2, 0.0) / (double)(i + 1));
+        } else {
+            double leaving = values[i - window];
+            double previous = mean;
+            mean += (value - leaving) / (double)window;
+            m2 += (value - leaving) * (value - mean + leaving - previous);
+            out[i] = sqrt(fmax(m2, 0.0) / (double)window);
+        }
+    }
+}
+
+int computeWindowStat(int stat, const double* values, int32_t length, int32_t window, double* out) {
+    if (values == NULL || out == NULL || length < 0 || window < 1) return -1;
+    if (length == 0) return stat >= 0 && stat < WINDOW_STAT_COUNT ? 0 : -1;
+
+    switch (stat) {
+        case WINDOW_STAT_MEAN:
+            moving_mean(values, length, window, out);
+            return 0;
+        case WINDOW_STAT_EWMA:
+            exponential_mean(values, length, window, out);
+            return 0;
+        case WINDOW_STAT_MIN:
+            return rolling_extreme(values, length, window, 0, out);
+        case WINDOW_STAT_MAX:
+            return rolling_extreme(values, length, window, 1, out);
+        case WINDOW_STAT_STDDEV:
+            rolling_stddev(values, length, window, out);
+            return 0;
+    }
+    return -1;
+}
@@ -0,0 +1,35 @@
+#ifndef WINDOW_STATS_H
+#define WINDOW_STATS_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Trailing-window statistics of a series, each in one O(n) pass. Point i
+// covers samples max(0, i - window + 1)..i, so the first window - 1 points
+// use the shorter prefix that exists. The history keeps these cached per
+// raw sample (see getHistoryStatView() in history.h); this batch form is
+// for series that do not live in a ring.
+
+enum window_stat {
+    WINDOW_STAT_MEAN = 0,     // Moving average, from prefix sums
+    WINDOW_STAT_EWMA = 1,     // Exponential average, alpha = 2 / (window + 1)
+    WINDOW_STAT_MIN = 2,      // Rolling minimum, monotonic deque
+    WINDOW_STAT_MAX = 3,      // Rolling maximum, monotonic deque
+    WINDOW_STAT_STDDEV = 4,   // Rolling population standard deviation
+    WINDOW_STAT_COUNT
+};
+
+// Write `stat` over `window` samples of `values` into `out` (`length`
+// slots; may be `values` itself for the mean and EWMA). Samples must be
+// finite. Returns 0, or -1 for invalid arguments or if scratch memory for
+// the rolling min/max cannot be allocated.
+int computeWindowStat(int stat, const double* values, int32_t length, int32_t window, double* out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // WINDOW_STATS_H
@@ -0,0 +1,93 @@
+// Headless collector. Samples every interval with the library's sampler
+// thread and publishes snapshots and history to a shared memory segment
+// (common/shared_segment.h) that every dashboard on the host maps instead of
+// sampling on its own, and appends every sample to the on-disk history
+// (common/history_db.h). Runs until SIGINT or SIGTERM, then removes the
+// segment.
+//
+//   cpu_monitor_daemon [--interval-ms MS] [--name /SEGMENT] [--duration-ms MS]
+//                      [--history-dir DIR]
+
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "cpu_monitor.h"
+
+#define DEFAULT_INTERVAL_MS 1000
+
+static volatile sig_atomic_t stop_requested = 0;
+
+static void on_signal(int signal) {
+    (void)signal;
+    stop_requested = 1;
+}
+
+static void usage(const char* program) {
+    fprintf(stderr, "usage: %s [--interval-ms MS] [--name /SEGMENT] [--duration-ms MS] [--history-dir DIR]\n",
+            program);
+}
+
+int main(int argc, char** argv) {
+    int interval_ms = DEFAULT_INTERVAL_MS;
+    int duration_ms = 0;
+    const char* name = SHARED_SEGMENT_NAME;
+    const char* history_dir = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--interval-ms") == 0 && i + 1 < argc) {
+            interval_ms = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--name") == 0 && i + 1 < argc) {
+            name = argv[++i];
+        } else if (strcmp(argv[i], "--duration-ms") == 0 && i + 1 < argc) {
+            duration_ms = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--history-dir") == 0 && i + 1 < argc) {
+            history_dir = argv[++i];
+        } else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if (interval_ms <= 0 || duration_ms < 0 || name[0] != '/') {
+        usage(argv[0]);
+        return 2;
+    }
+
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = on_signal;
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGINT, &action, NULL);
+    sigaction(SIGTERM, &action, NULL);
+
+    if (shared_segment_create(name, interval_ms) != 0) {
+        return 1;
+    }
+    // Opened after the segment, so the last hour it preloads is shared too.
+    // Without it the daemon still publishes, it just keeps nothing on disk.
+    int history_open = openHistoryDatabase(history_dir) == 0;
+    if (history_open && getHistoryDatabaseMode() == 0) {
+        fprintf(stderr, "Another process writes the history database; not persisting samples\n");
+    }
+    if (startSampler(interval_ms) != 0) {
+        if (history_open) closeHistoryDatabase();
+        shared_segment_destroy();
+        return 1;
+    }
+    fprintf(stderr, "Publishing to %s every %d ms\n", name, interval_ms);
+
+    // The sampler thread does the work; wake now and then to notice signals
+    // and the optional run time
+    uint64_t deadline = duration_ms > 0 ? latency_now_ns() + (uint64_t)duration_ms * 1000000ull : 0;
+    struct timespec poll = {0, 50 * 1000000L};
+    while (!stop_requested && (deadline == 0 || latency_now_ns() < deadline)) {
+        nanosleep(&poll, NULL);
+    }
+
+    stopSampler();
+    if (history_open) closeHistoryDatabase();
+    shared_segment_destroy();
+    return 0;
+}
@@ -0,0 +1,294 @@
+#define _GNU_SOURCE
+#include <errno.h>
+#include <fcntl.h>
+#include <math.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/timerfd.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "cpu_monitor.h"
+#include "proc_parse.h"
+
+// The thread blocks in read() on a periodic timerfd armed against
+// CLOCK_MONOTONIC, so ticks stay on the timer's grid however long a sample
+// takes; read() also reports expirations that passed while the thread was
+// late, which the frame counts as missed. Jitter is the delay from the
+// latest expiration to the wakeup.
+//
+// Samples go into the current frame under frame_lock, which the UI thread
+// holds once per frame to take it; both sides only copy a few fields.
+
+#define NS_PER_SECOND 1000000000ull
+
+// The aggregate "cpu" line comes first, so one short read covers it
+#define STAT_READ 512
+#define PRESSURE_READ 256
+
+// Sources, guarded by control_lock
+static char stat_path[256] = "/proc/stat";
+static char pressure_path[256] = "/proc/pressure/cpu";
+
+// Thread state, guarded by control_lock
+static pthread_mutex_t control_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_t burst_thread;
+static int burst_running = 0;
+static int burst_rate_hz = 0;
+static atomic_int stop_requested = 0;
+// Set by the thread when its timer fails and it exits on its own
+static atomic_int burst_failed = 0;
+
+struct burst_source {
+    int timer_fd;
+    int stat_fd;
+    int pressure_fd;
+    uint64_t period_ns;
+    uint64_t first_ns;
+};
+static struct burst_source source = {-1, -1, -1, 0, 0};
+
+// Frame being filled, guarded by frame_lock
+static pthread_mutex_t frame_lock = PTHREAD_MUTEX_INITIALIZER;
+static struct burst_frame frame;
+static double frame_sums[BURST_SERIES_COUNT];
+static uint64_t frame_jitter_sum_ns;
+
+static uint64_t monotonic_ns(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * NS_PER_SECOND + (uint64_t)now.tv_nsec;
+}
+
+static void reset_frame_locked(void) {
+    memset(&frame, 0, sizeof(frame));
+    memset(frame_sums, 0, sizeof(frame_sums));
+    frame_jitter_sum_ns = 0;
+}
+
+static void add_value(struct burst_stats* stats, double* sum, double value) {
+    if (stats->count == 0 || value < stats->min) stats->min = value;
+    if (stats->count == 0 || value > stats->max) stats->max = value;
+    stats->last = value;
+    stats->count++;
+    *sum += value;
+}
+
+// Fold one tick into the frame; NaN values are not sampled this tick
+static void fold(uint64_t now_ns, uint64_t expirations, uint64_t jitter_ns, const double values[BURST_SERIES_COUNT]) {
+    pthread_mutex_lock(&frame_lock);
+    if (frame.ticks == 0) frame.start_ns = now_ns;
+    frame.end_ns = now_ns;
+    frame.ticks++;
+    frame.missed += (uint32_t)(expirations - 1);
+    frame_jitter_sum_ns += jitter_ns;
+    if (jitter_ns > frame.jitter_max_ns) frame.jitter_max_ns = jitter_ns;
+    for (int i = 0; i < BURST_SERIES_COUNT; i++) {
+        if (!isnan(values[i])) add_value(&frame.series[i], &frame_sums[i], values[i]);
+    }
+    pthread_mutex_unlock(&frame_lock);
+}
+
+// Aggregate busy/total ticks from the "cpu" line, as in cpu_monitor.c
+static int read_cpu(int fd, uint64_t* busy, uint64_t* total) {
+    char buffer[STAT_READ];
+    uint64_t fields[PROC_CPU_FIELD_COUNT] = {0};
+
+    if (fd < 0) return -1;
+    ssize_t bytes = pread(fd, buffer, sizeof(buffer), 0);
+    if (bytes < 4 || memcmp(buffer, "cpu ", 4) != 0) return -1;
+
+    const char* p = buffer + 4;
+    proc_parse_fields(&p, buffer + bytes, &proc_stat_cpu_fields, fields);
+    uint64_t sum = 0;
+    for (int i = 0; i < PROC_CPU_FIELD_COUNT; i++) sum += fields[i];
+    *total = sum;
+    *busy = sum - fields[PROC_CPU_IDLE] - fields[PROC_CPU_IOWAIT];
+    return 0;
+}
+
+// "some avg10=0.00 avg60=0.00 avg300=0.00 total=123456"
+static int read_stall_us(int fd, uint64_t* total_us) {
+    char buffer[PRESSURE_READ];
+
+    if (fd < 0) return -1;
+    ssize_t bytes = pread(fd, buffer, sizeof(buffer), 0);
+    if (bytes < 4 || memcmp(buffer, "some", 4) != 0) return -1;
+
+    const char* end = proc_next_line(buffer, buffer + bytes);
+    const char* total = memmem(buffer, (size_t)(end - buffer), "total=", 6);
+    if (total == NULL) return -1;
+    total += 6;
+    *total_us = proc_parse_u64(&total, end);
+    return 0;
+}
+
+static void* burst_main(void* arg) {
+    struct burst_source* own = (struct burst_source*)arg;
+    uint64_t prev_busy = 0, prev_total = 0, prev_stall_us = 0;
+    int has_cpu = read_cpu(own->stat_fd, &prev_busy, &prev_total) == 0;
+    int has_stall = read_stall_us(own->pressure_fd, &prev_stall_us) == 0;
+    uint64_t prev_stall_ns = monotonic_ns();
+    uint64_t first_ns = own->first_ns;
+    uint64_t expirations_total = 0;
+
+    while (!atomic_load_explicit(&stop_requested, memory_order_relaxed)) {
+        uint64_t expirations;
+        if (read(own->timer_fd, &expirations, sizeof(expirations)) != sizeof(expirations)) {
+            if (errno == EINTR) continue;
+            fprintf(stderr, "Error reading burst timer: %s\n", strerror(errno));
+            atomic_store_explicit(&burst_failed, 1, memory_order_relaxed);
+            break;
+        }
+        uint64_t now_ns = monotonic_ns();
+        expirations_total += expirations;
+        uint64_t due_ns = first_ns + (expirations_total - 1) * own->period_ns;
+        uint64_t jitter_ns = now_ns > due_ns ? now_ns - due_ns : 0;
+
+        double values[BURST_SERIES_COUNT] = {NAN, NAN};
+        uint64_t busy, total;
+        if (read_cpu(own->stat_fd, &busy, &total) == 0) {
+            if (has_cpu && total > prev_total) {
+                values[BURST_CPU] = (double)(busy - prev_busy) / (double)(total - prev_total) * 100.0;
+            }
+            if (!has_cpu || total > prev_total) {
+                prev_busy = busy;
+                prev_total = total;
+            }
+            has_cpu = 1;
+        }
+        uint64_t stall_us;
+        if (read_stall_us(own->pressure_fd, &stall_us) == 0) {
+            uint64_t read_ns = monotonic_ns();
+            if (has_stall && read_ns > prev_stall_ns) {
+                double percent = (double)(stall_us - prev_stall_us) * 1000.0 / (double)(read_ns - prev_stall_ns) * 100.0;
+                values[BURST_CPU_PRESSURE] = percent < 100.0 ? percent : 100.0;
+            }
+            prev_stall_us = stall_us;
+            prev_stall_ns = read_ns;
+            has_stall = 1;
+        }
+
+        fold(now_ns, expirations, jitter_ns, values);
+    }
+    return NULL;
+}
+
+static void close_source(struct burst_source* closing) {
+    if (closing->timer_fd >= 0) close(closing->timer_fd);
+    if (closing->stat_fd >= 0) close(closing->stat_fd);
+    if (closing->pressure_fd >= 0) close(closing->pressure_fd);
+    closing->timer_fd = closing->stat_fd = closing->pressure_fd = -1;
+}
+
+static void stop_locked(void) {
+    if (!burst_running) return;
+    atomic_store_explicit(&stop_requested, 1, memory_order_relaxed);
+    // The next tick wakes the thread, at most 1 / BURST_MIN_RATE_HZ away
+    pthread_join(burst_thread, NULL);
+    close_source(&source);
+    burst_running = 0;
+    burst_rate_hz = 0;
+}
+
+int startBurstSampler(int rate_hz) {
+    if (rate_hz < BURST_MIN_RATE_HZ) rate_hz = BURST_MIN_RATE_HZ;
+    if (rate_hz > BURST_MAX_RATE_HZ) rate_hz = BURST_MAX_RATE_HZ;
+
+    pthread_mutex_lock(&control_lock);
+    // A thread that failed has exited; restart it even at the same rate
+    if (burst_running && burst_rate_hz == rate_hz && !atomic_load_explicit(&burst_failed, memory_order_relaxed)) {
+        pthread_mutex_unlock(&control_lock);
+        return 0;
+    }
+    stop_locked();
+
+    source.timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC);
+    if (source.timer_fd < 0) {
+        fprintf(stderr, "Error creating burst timer: %s\n", strerror(errno));
+        pthread_mutex_unlock(&control_lock);
+        return -1;
+    }
+    // Either source may be missing (no PSI, say); its series stays empty
+    source.stat_fd = open(stat_path, O_RDONLY | O_CLOEXEC);
+    source.pressure_fd = open(pressure_path, O_RDONLY | O_CLOEXEC);
+    source.period_ns = NS_PER_SECOND / (uint64_t)rate_hz;
+
+    // Armed here rather than on the thread so a failure is reported to the
+    // caller instead of leaving a sampler that never ticks
+    source.first_ns = monotonic_ns() + source.period_ns;
+    struct itimerspec spec;
+    spec.it_interval.tv_sec = (time_t)(source.period_ns / NS_PER_SECOND);
+    spec.it_interval.tv_nsec = (long)(source.period_ns % NS_PER_SECOND);
+    spec.it_value.tv_sec = (time_t)(source.first_ns / NS_PER_SECOND);
+    spec.it_value.tv_nsec = (long)(source.first_ns % NS_PER_SECOND);
+    if (timerfd_settime(source.timer_fd, TFD_TIMER_ABSTIME, &spec, NULL) != 0) {
+        fprintf(stderr, "Error arming burst timer: %s\n", strerror(errno));
+        close_source(&source);
+        pthread_mutex_unlock(&control_lock);
+        return -1;
+    }
+
+    pthread_mutex_lock(&frame_lock);
+    reset_frame_locked();
+    pthread_mutex_unlock(&frame_lock);
+
+    atomic_store_explicit(&stop_requested, 0, memory_order_relaxed);
+    atomic_store_explicit(&burst_failed, 0, memory_order_relaxed);
+    if (pthread_create(&burst_thread, NULL, burst_main, &source) != 0) {
+        fprintf(stderr, "Error starting burst sampler thread\n");
+        close_source(&source);
+        pthread_mutex_unlock(&control_lock);
+        return -1;
+    }
+    burst_running = 1;
+    burst_rate_hz = rate_hz;
+    pthread_mutex_unlock(&control_lock);
+    return 0;
+}
+
+void stopBurstSampler() {
+    pthread_mutex_lock(&control_lock);
+    stop_locked();
+    pthread_mutex_unlock(&control_lock);
+}
+
+int getBurstRate() {
+    pthread_mutex_lock(&control_lock);
+    int rate = burst_rate_hz;
+    pthread_mutex_unlock(&control_lock);
+    return rate;
+}
+
+int readBurstFrame(struct burst_frame* out) {
+    if (out == NULL) return -1;
+
+    pthread_mutex_lock(&control_lock);
+    int running = burst_running && !atomic_load_explicit(&burst_failed, memory_order_relaxed);
+    pthread_mutex_unlock(&control_lock);
+    if (!running) return -1;
+
+    pthread_mutex_lock(&frame_lock);
+    *out = frame;
+    for (int i = 0; i < BURST_SERIES_COUNT; i++) {
+        struct burst_stats* stats = &out->series[i];
+        if (stats->count > 0) {
+            stats->mean = frame_sums[i] / stats->count;
+        } else {
+            stats->min = stats->max = stats->mean = stats->last = NAN;
+        }
+    }
+    out->jitter_mean_ns = frame.ticks > 0 ? frame_jitter_sum_ns / frame.ticks : 0;
+    reset_frame_locked();
+    pthread_mutex_unlock(&frame_lock);
+    return (int)out->ticks;
+}
+
+void burst_set_sources(const char* stat, const char* pressure) {
+    pthread_mutex_lock(&control_lock);
+    snprintf(stat_path, sizeof(stat_path), "%s", stat != NULL ? stat : "/proc/stat");
+    snprintf(pressure_path, sizeof(pressure_path), "%s", pressure != NULL ? pressure : "/proc/pressure/cpu");
+    pthread_mutex_unlock(&control_lock);
+}
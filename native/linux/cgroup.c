@@ -0,0 +1,470 @@
+#define _GNU_SOURCE
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "cpu_monitor.h"
+#include "proc_parse.h"
+
+// The group is found on first use. Its own accounting files and the
+// cpu.max and memory.max of each ancestor are opened then and stay open;
+// each read is a pread() per file, with no path lookups. A read that fails
+// on the group's cpu.stat means the group went away (the process moved),
+// so the next call looks it up again.
+//
+// The root group has no cgroup.type and no limits of its own, so a process
+// there is reported as the host. A container with its own cgroup namespace
+// sees its group as "/", but that group has cgroup.type and its limits.
+
+// Levels of ancestors whose limits are followed, the group included
+#define CGROUP_MAX_DEPTH 16
+
+#define NS_PER_SECOND 1000000000ull
+
+enum leaf_file {
+    LEAF_CPU_STAT,
+    LEAF_CPUSET,
+    LEAF_MEMORY_CURRENT,
+    LEAF_MEMORY_STAT,
+    LEAF_FILE_COUNT
+};
+
+static const char* const leaf_names[LEAF_FILE_COUNT] = {
+    "cpu.stat",
+    "cpuset.cpus.effective",
+    "memory.current",
+    "memory.stat",
+};
+
+struct limit_files {
+    int cpu_max_fd;
+    int memory_max_fd;
+};
+
+static const struct proc_key cpu_stat_keys[] = {
+    PROC_KEY("usage_usec"),
+    PROC_KEY("nr_periods"),
+    PROC_KEY("nr_throttled"),
+    PROC_KEY("throttled_usec"),
+};
+static const struct proc_key memory_stat_keys[] = {PROC_KEY("inactive_file")};
+static const struct proc_key meminfo_keys[] = {PROC_KEY("MemTotal"), PROC_KEY("MemAvailable")};
+
+// Everything below is guarded by cgroup_lock
+static pthread_mutex_t cgroup_lock = PTHREAD_MUTEX_INITIALIZER;
+static char proc_cgroup_path[256] = "/proc/self/cgroup";
+static char mountinfo_path[256] = "/proc/self/mountinfo";
+static char stat_path[256] = "/proc/stat";
+static char meminfo_path[256] = "/proc/meminfo";
+
+static int detected = 0;
+static int in_cgroup = 0;
+static char group_path[CGROUP_PATH_LEN];
+static int leaf_fds[LEAF_FILE_COUNT] = {-1, -1, -1, -1};
+static struct limit_files levels[CGROUP_MAX_DEPTH];
+static int level_count = 0;
+static int host_stat_fd = -1;
+static int host_meminfo_fd = -1;
+
+// Counters at the previous call
+static int has_baseline = 0;
+static uint64_t prev_ns;
+static uint64_t prev_usage_usec, prev_periods, prev_throttled, prev_throttled_usec;
+static uint64_t prev_busy, prev_total;
+
+static uint64_t monotonic_ns(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * NS_PER_SECOND + (uint64_t)now.tv_nsec;
+}
+
+static ssize_t read_fd(int fd, char* buffer, size_t size) {
+    if (fd < 0) return -1;
+    ssize_t bytes = pread(fd, buffer, size - 1, 0);
+    if (bytes >= 0) buffer[bytes] = '\0';
+    return bytes;
+}
+
+static void close_fd(int* fd) {
+    if (*fd >= 0) close(*fd);
+    *fd = -1;
+}
+
+static void forget_locked(void) {
+    for (int i = 0; i < LEAF_FILE_COUNT; i++) close_fd(&leaf_fds[i]);
+    for (int i = 0; i < level_count; i++) {
+        close_fd(&levels[i].cpu_max_fd);
+        close_fd(&levels[i].memory_max_fd);
+    }
+    level_count = 0;
+    close_fd(&host_stat_fd);
+    close_fd(&host_meminfo_fd);
+    in_cgroup = 0;
+    group_path[0] = '\0';
+    has_baseline = 0;
+    detected = 0;
+}
+
+// Copy one mountinfo field, undoing its octal escapes ("\040" for space)
+static const char* copy_field(const char* p, const char* end, char* out, size_t capacity) {
+    size_t length = 0;
+
+    while (p < end && *p == ' ') p++;
+    while (p < end && *p != ' ' && *p != '\n') {
+        char c = *p++;
+        if (c == '\\' && end - p >= 3) {
+            c = (char)(((p[0] - '0') << 6) | ((p[1] - '0') << 3) | (p[2] - '0'));
+            p += 3;
+        }
+        if (length + 1 < capacity) out[length++] = c;
+    }
+    out[length] = '\0';
+    return p;
+}
+
+// Root and mount point of the cgroup2 mount. Returns 0, or -1 without one.
+static int find_mount(char* root, size_t root_capacity, char* mount_point, size_t mount_capacity) {
+    char buffer[16384];
+    int fd = open(mountinfo_path, O_RDONLY | O_CLOEXEC);
+    ssize_t bytes = read_fd(fd, buffer, sizeof(buffer));
+    close_fd(&fd);
+    if (bytes <= 0) return -1;
+
+    const char* end = buffer + bytes;
+    for (const char* line = buffer; line < end; line = proc_next_line(line, end)) {
+        const char* line_end = proc_next_line(line, end);
+        // "36 25 0:30 <root> <mount point> <options> [optional...] - cgroup2 <source> <options>"
+        const char* separator = memmem(line, (size_t)(line_end - line), " - cgroup2 ", 11);
+        if (separator == NULL) continue;
+
+        const char* p = proc_skip_fields(line, line_end, 3);
+        p = copy_field(p, line_end, root, root_capacity);
+        copy_field(p, line_end, mount_point, mount_capacity);
+        return 0;
+    }
+    return -1;
+}
+
+// The "0::<path>" line of the unified hierarchy
+static int find_group(char* path, size_t capacity) {
+    char buffer[4096];
+    int fd = open(proc_cgroup_path, O_RDONLY | O_CLOEXEC);
+    ssize_t bytes = read_fd(fd, buffer, sizeof(buffer));
+    close_fd(&fd);
+    if (bytes <= 0) return -1;
+
+    const char* end = buffer + bytes;
+    for (const char* line = buffer; line < end; line = proc_next_line(line, end)) {
+        if (end - line < 3 || memcmp(line, "0::", 3) != 0) continue;
+        const char* start = line + 3;
+        const char* stop = memchr(start, '\n', (size_t)(end - start));
+        size_t length = (size_t)((stop != NULL ? stop : end) - start);
+        if (length == 0 || length >= capacity) return -1;
+        memcpy(path, start, length);
+        path[length] = '\0';
+        return 0;
+    }
+    return -1;
+}
+
+static int open_in(int dir_fd, const char* name) {
+    return openat(dir_fd, name, O_RDONLY | O_CLOEXEC);
+}
+
+static void detect_locked(void) {
+    char root[CGROUP_PATH_LEN], mount_point[CGROUP_PATH_LEN], path[CGROUP_PATH_LEN], dir[CGROUP_PATH_LEN * 2];
+
+    detected = 1;
+    host_stat_fd = open(stat_path, O_RDONLY | O_CLOEXEC);
+    host_meminfo_fd = open(meminfo_path, O_RDONLY | O_CLOEXEC);
+    if (find_group(path, sizeof(path)) != 0 || find_mount(root, sizeof(root), mount_point, sizeof(mount_point)) != 0) {
+        return;
+    }
+
+    // With a bind-mounted subtree the mount's root is a prefix of the path
+    const char* relative = path;
+    size_t root_length = strlen(root);
+    if (strcmp(root, "/") != 0) {
+        if (strncmp(path, root, root_length) != 0 || (path[root_length] != '/' && path[root_length] != '\0')) {
+            return;
+        }
+        relative = path + root_length;
+    }
+    if (strstr(relative, "/..") != NULL) return;
+    if (relative[0] == '\0') relative = "/";
+
+    int written = snprintf(dir, sizeof(dir), "%s%s", mount_point, strcmp(relative, "/") == 0 ? "" : relative);
+    if (written < 0 || (size_t)written >= sizeof(dir)) return;
+
+    int dir_fd = open(dir, O_PATH | O_DIRECTORY | O_CLOEXEC);
+    if (dir_fd < 0) return;
+    int type_fd = open_in(dir_fd, "cgroup.type");
+    if (type_fd < 0) {
+        close(dir_fd);
+        return;
+    }
+    close(type_fd);
+
+    for (int i = 0; i < LEAF_FILE_COUNT; i++) leaf_fds[i] = open_in(dir_fd, leaf_names[i]);
+    if (leaf_fds[LEAF_CPU_STAT] < 0) {
+        for (int i = 0; i < LEAF_FILE_COUNT; i++) close_fd(&leaf_fds[i]);
+        close(dir_fd);
+        return;
+    }
+
+    // Walk up to the mount, one directory level at a time, while each
+    // level is a non-root group
+    size_t mount_length = strlen(mount_point);
+    while (level_count < CGROUP_MAX_DEPTH) {
+        levels[level_count].cpu_max_fd = open_in(dir_fd, "cpu.max");
+        levels[level_count].memory_max_fd = open_in(dir_fd, "memory.max");
+        level_count++;
+        close(dir_fd);
+
+        char* slash = strrchr(dir, '/');
+        if (slash == NULL || (size_t)(slash - dir) < mount_length) break;
+        *slash = '\0';
+        dir_fd = open(dir, O_PATH | O_DIRECTORY | O_CLOEXEC);
+        if (dir_fd < 0) break;
+        type_fd = open_in(dir_fd, "cgroup.type");
+        if (type_fd < 0) {
+            close(dir_fd);
+            break;
+        }
+        close(type_fd);
+    }
+
+    snprintf(group_path, sizeof(group_path), "%s", relative);
+    in_cgroup = 1;
+}
+
+// "max 100000" or "<quota> <period>", in cores; 0 when unlimited
+static double read_cpu_max(int fd) {
+    char buffer[64];
+
+    if (read_fd(fd, buffer, sizeof(buffer)) <= 0 || memcmp(buffer, "max", 3) == 0) return 0;
+    const char* p = buffer;
+    const char* end = buffer + strlen(buffer);
+    uint64_t quota = proc_parse_u64(&p, end);
+    uint64_t period = proc_parse_u64(&p, end);
+    return quota > 0 && period > 0 ? (double)quota / (double)period : 0;
+}
+
+// "max" or bytes; 0 when unlimited
+static uint64_t read_memory_max(int fd) {
+    char buffer[64];
+
+    if (read_fd(fd, buffer, sizeof(buffer)) <= 0 || memcmp(buffer, "max", 3) == 0) return 0;
+    const char* p = buffer;
+    return proc_parse_u64(&p, buffer + strlen(buffer));
+}
+
+// Number of CPUs in a list such as "0-3,8,10-11"; 0 if empty or unreadable
+static int read_cpuset_count(int fd) {
+    char buffer[1024];
+    int count = 0;
+
+    if (read_fd(fd, buffer, sizeof(buffer)) <= 0) return 0;
+    const char* end = buffer + strlen(buffer);
+    for (const char* p = buffer; p < end && *p >= '0' && *p <= '9';) {
+        uint64_t first = proc_parse_u64(&p, end);
+        uint64_t last = first;
+        if (p < end && *p == '-') {
+            p++;
+            last = proc_parse_u64(&p, end);
+        }
+        if (last >= first) count += (int)(last - first + 1);
+        if (p < end && *p == ',') p++;
+    }
+    return count;
+}
+
+static int read_meminfo(uint64_t* total_kb, uint64_t* available_kb) {
+    char buffer[4096];
+    uint64_t values[2];
+
+    ssize_t bytes = read_fd(host_meminfo_fd, buffer, sizeof(buffer));
+    if (bytes <= 0 || proc_parse_keyed(buffer, buffer + bytes, meminfo_keys, 2, values) != 2) return -1;
+    *total_kb = values[0];
+    *available_kb = values[1];
+    return 0;
+}
+
+static int read_host_locked(struct cgroup_usage* out, uint64_t now_ns) {
+    char buffer[512];
+    uint64_t fields[PROC_CPU_FIELD_COUNT] = {0};
+    uint64_t total_kb, available_kb;
+    int found = 0;
+
+    ssize_t bytes = read_fd(host_stat_fd, buffer, sizeof(buffer));
+    if (bytes > 4 && memcmp(buffer, "cpu ", 4) == 0) {
+        const char* p = buffer + 4;
+        proc_parse_fields(&p, buffer + bytes, &proc_stat_cpu_fields, fields);
+        uint64_t total = 0;
+        for (int i = 0; i < PROC_CPU_FIELD_COUNT; i++) total += fields[i];
+        uint64_t busy = total - fields[PROC_CPU_IDLE] - fields[PROC_CPU_IOWAIT];
+        if (has_baseline && total > prev_total) {
+            out->cpu_percent = (double)(busy - prev_busy) / (double)(total - prev_total) * 100.0;
+        }
+        prev_busy = busy;
+        prev_total = total;
+        found = 1;
+    }
+
+    if (read_meminfo(&total_kb, &available_kb) == 0) {
+        out->memory_used_mb = (int64_t)((total_kb - available_kb) / 1024);
+        out->memory_current_mb = out->memory_used_mb;
+        out->memory_limit_mb = (int64_t)(total_kb / 1024);
+        found = 1;
+    }
+
+    prev_ns = now_ns;
+    has_baseline = found;
+    return found ? 0 : -1;
+}
+
+static int read_group_locked(struct cgroup_usage* out, uint64_t now_ns) {
+    char buffer[4096];
+    uint64_t stats[4] = {0};
+
+    ssize_t bytes = read_fd(leaf_fds[LEAF_CPU_STAT], buffer, sizeof(buffer));
+    if (bytes <= 0 || proc_parse_flat_keyed(buffer, buffer + bytes, cpu_stat_keys, 1, stats) != 1) return -1;
+    // Throttling counters only exist with the cpu controller enabled
+    proc_parse_flat_keyed(buffer, buffer + bytes, cpu_stat_keys + 1, 3, stats + 1);
+
+    // The tightest quota along the path, then the cpuset
+    double cores = out->cpu_limit;
+    for (int i = 0; i < level_count; i++) {
+        double quota = read_cpu_max(levels[i].cpu_max_fd);
+        if (quota > 0 && quota < cores) {
+            cores = quota;
+            out->limits |= CGROUP_LIMIT_CPU;
+        }
+    }
+    int cpuset = read_cpuset_count(leaf_fds[LEAF_CPUSET]);
+    if (cpuset > 0 && cpuset < cores) {
+        cores = cpuset;
+        out->limits |= CGROUP_LIMIT_CPU;
+    }
+    out->cpu_limit = cores;
+
+    if (has_baseline && now_ns > prev_ns) {
+        double wall_usec = (double)(now_ns - prev_ns) / 1000.0;
+        double percent = (double)(stats[0] - prev_usage_usec) / (wall_usec * cores) * 100.0;
+        out->cpu_percent = percent < 100.0 ? percent : 100.0;
+        if (stats[1] > prev_periods) {
+            out->throttled_percent = (double)(stats[2] - prev_throttled) / (double)(stats[1] - prev_periods) * 100.0;
+        }
+        out->throttled_ms = (double)(stats[3] - prev_throttled_usec) / 1000.0;
+    }
+    prev_usage_usec = stats[0];
+    prev_periods = stats[1];
+    prev_throttled = stats[2];
+    prev_throttled_usec = stats[3];
+    prev_ns = now_ns;
+    has_baseline = 1;
+
+    // Without the memory controller the group is charged nothing; keep the
+    // host's figures
+    bytes = read_fd(leaf_fds[LEAF_MEMORY_CURRENT], buffer, sizeof(buffer));
+    if (bytes > 0) {
+        const char* p = buffer;
+        uint64_t current = proc_parse_u64(&p, buffer + bytes);
+        uint64_t inactive_file = 0;
+        bytes = read_fd(leaf_fds[LEAF_MEMORY_STAT], buffer, sizeof(buffer));
+        if (bytes > 0) proc_parse_flat_keyed(buffer, buffer + bytes, memory_stat_keys, 1, &inactive_file);
+
+        // The working set, as container runtimes count it: page cache the
+        // kernel can drop at no cost is not in use
+        uint64_t used = current > inactive_file ? current - inactive_file : 0;
+        out->memory_current_mb = (int64_t)(current / (1024 * 1024));
+        out->memory_used_mb = (int64_t)(used / (1024 * 1024));
+
+        for (int i = 0; i < level_count; i++) {
+            uint64_t limit = read_memory_max(levels[i].memory_max_fd);
+            int64_t limit_mb = (int64_t)(limit / (1024 * 1024));
+            if (limit > 0 && (out->memory_limit_mb <= 0 || limit_mb < out->memory_limit_mb)) {
+                out->memory_limit_mb = limit_mb;
+                out->limits |= CGROUP_LIMIT_MEMORY;
+            }
+        }
+    }
+    return 0;
+}
+
+int getCgroupUsage(struct cgroup_usage* out) {
+    uint64_t total_kb, available_kb;
+
+    if (out == NULL) return -1;
+
+    pthread_mutex_lock(&cgroup_lock);
+    if (!detected) detect_locked();
+
+    memset(out, 0, sizeof(*out));
+    out->cpu_percent = -1.0;
+    uint64_t now_ns = monotonic_ns();
+
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    out->cpu_limit = cores > 0 ? (double)cores : 1.0;
+
+    int result;
+    if (in_cgroup) {
+        // Host memory until the group's own figures replace it
+        if (read_meminfo(&total_kb, &available_kb) == 0) {
+            out->memory_used_mb = (int64_t)((total_kb - available_kb) / 1024);
+            out->memory_current_mb = out->memory_used_mb;
+            out->memory_limit_mb = (int64_t)(total_kb / 1024);
+        }
+        out->in_cgroup = 1;
+        result = read_group_locked(out, now_ns);
+        if (result != 0) {
+            // Gone, or moved elsewhere: look again next time
+            forget_locked();
+        }
+    } else {
+        result = read_host_locked(out, now_ns);
+    }
+    pthread_mutex_unlock(&cgroup_lock);
+    return result;
+}
+
+const char* getCgroupPath() {
+    pthread_mutex_lock(&cgroup_lock);
+    if (!detected) detect_locked();
+    pthread_mutex_unlock(&cgroup_lock);
+    // Only rewritten by detection, after cgroup_set_sources() or when the
+    // group disappears
+    return group_path;
+}
+
+static void set_path(char* target, size_t capacity, const char* path, const char* fallback) {
+    snprintf(target, capacity, "%s", path != NULL ? path : fallback);
+}
+
+void cgroup_set_sources(const char* proc_cgroup, const char* mountinfo, const char* stat, const char* meminfo) {
+    pthread_mutex_lock(&cgroup_lock);
+    forget_locked();
+    set_path(proc_cgroup_path, sizeof(proc_cgroup_path), proc_cgroup, "/proc/self/cgroup");
+    set_path(mountinfo_path, sizeof(mountinfo_path), mountinfo, "/proc/self/mountinfo");
+    set_path(stat_path, sizeof(stat_path), stat, "/proc/stat");
+    set_path(meminfo_path, sizeof(meminfo_path), meminfo, "/proc/meminfo");
+    pthread_mutex_unlock(&cgroup_lock);
+}
+
+int cgroup_mount_point(char* out, size_t capacity) {
+    char root[CGROUP_PATH_LEN];
+
+    pthread_mutex_lock(&cgroup_lock);
+    int result = find_mount(root, sizeof(root), out, capacity);
+    pthread_mutex_unlock(&cgroup_lock);
+    return result;
+}
+
+void cgroup_cleanup() {
+    pthread_mutex_lock(&cgroup_lock);
+    forget_locked();
+    pthread_mutex_unlock(&cgroup_lock);
+}
@@ -0,0 +1,647 @@
+#define _GNU_SOURCE
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/inotify.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "../common/cgroup.h"
+#include "../common/cgroup_tree.h"
+#include "../common/latency.h"
+#include "proc_parse.h"
+
+// Groups live in one array in breadth-first order, so the children of a
+// group are contiguous and come after it. The counters read each refresh
+// sit in flat arrays beside it, and one pass over those turns them into
+// rates. A walk builds the array again and carries each surviving group's
+// descriptors, watch and counters over by ID, so rates do not restart when
+// an unrelated group comes or goes.
+
+// Deeper groups are left out
+#define CGROUP_TREE_MAX_DEPTH 32
+
+// Time allowed for the reads of one refresh. Like the process table, the
+// next refresh resumes where this one stopped; groups keep their own
+// timestamps, so rates stay correct for groups read less often.
+#define CGROUP_TREE_BUDGET_NS 4000000ull
+
+// Without inotify (no instance, or the watch limit reached) the hierarchy
+// is walked again this often
+#define CGROUP_TREE_RESCAN_NS 10000000000ull
+
+#define WATCH_MASK (IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_ONLYDIR)
+
+enum tree_file {
+    TREE_CPU_STAT,
+    TREE_MEMORY_CURRENT,
+    TREE_IO_STAT,
+    TREE_FILE_COUNT
+};
+
+static const char* const file_names[TREE_FILE_COUNT] = {"cpu.stat", "memory.current", "io.stat"};
+
+enum tree_counter {
+    COUNTER_CPU_USEC,
+    COUNTER_READ_BYTES,
+    COUNTER_WRITE_BYTES,
+    COUNTER_COUNT
+};
+
+struct tree_node {
+    int dir_fd;                       // -1 beyond the descriptor budget
+    int file_fds[TREE_FILE_COUNT];    // Cached while the budget lasts
+    int watch;                        // inotify watch, -1 if none
+    uint32_t missing;                 // Files the group does not have, by bit
+    int32_t first_child;              // Index of the first of usage.children
+    char* path;                       // Relative to the root, "." for the root
+    struct cgroup_node usage;
+};
+
+// Selection candidate for the children of one group
+struct candidate {
+    double key;
+    int32_t index;
+};
+
+static const struct proc_key cpu_stat_keys[] = {PROC_KEY("usage_usec")};
+
+static struct tree_node* nodes = NULL;
+static int32_t node_count = 0;
+
+// Flat arrays, one entry (COUNTER_COUNT for the counters) per group
+static uint64_t* counters = NULL;       // Read this refresh
+static uint64_t* previous = NULL;       // At the last refresh that read the group
+static uint64_t* read_ns = NULL;        // When `counters` was read; 0 if not this refresh
+static uint64_t* previous_ns = NULL;    // 0 until the group has been read once
+static struct candidate* candidates = NULL;
+
+// Group ID to index, open addressing with linear probing; rebuilt by each walk
+static int32_t* id_slots = NULL;
+static uint32_t id_mask = 0;
+
+static char root_override[CGROUP_PATH_LEN] = "";
+static char root_path[CGROUP_PATH_LEN];
+static int root_fd = -1;
+static int inotify_fd = -1;
+static int needs_walk = 1;
+static int unwatched = 0;               // Some group has no watch
+static uint64_t walked_ns = 0;
+static int32_t resume = 0;
+static uint64_t focus_id = 0;           // Last group whose children were asked for
+static int open_fds = 0;
+static int fd_budget = -1;
+
+static char file_buffer[8192];
+
+static void init_budget(void) {
+    struct rlimit limit;
+
+    // Leave most descriptors to the host application; groups beyond the
+    // budget open their files on each read instead
+    fd_budget = 256;
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur != RLIM_INFINITY) {
+        fd_budget = (int)(limit.rlim_cur / 4);
+    }
+}
+
+static void close_counted(int* fd) {
+    if (*fd >= 0) {
+        close(*fd);
+        open_fds--;
+    }
+    *fd = -1;
+}
+
+// Keep `fd` if the budget allows; returns it, or -1 after closing it
+static int keep_fd(int fd) {
+    if (fd < 0) return -1;
+    if (open_fds >= fd_budget) {
+        close(fd);
+        return -1;
+    }
+    open_fds++;
+    return fd;
+}
+
+static void free_node(struct tree_node* node, int remove_watch) {
+    close_counted(&node->dir_fd);
+    for (int i = 0; i < TREE_FILE_COUNT; i++) close_counted(&node->file_fds[i]);
+    // The kernel drops the watch of a removed directory by itself
+    if (remove_watch && node->watch >= 0 && inotify_fd >= 0) inotify_rm_watch(inotify_fd, node->watch);
+    node->watch = -1;
+    free(node->path);
+    node->path = NULL;
+}
+
+static uint32_t id_home(uint64_t id) {
+    return (uint32_t)((id * 0x9E3779B97F4A7C15ull) >> 32) & id_mask;
+}
+
+static int32_t find_index(uint64_t id) {
+    if (id_slots == NULL) return -1;
+    for (uint32_t i = id_home(id);; i = (i + 1) & id_mask) {
+        int32_t index = id_slots[i];
+        if (index < 0) return -1;
+        if (nodes[index].usage.id == id) return index;
+    }
+}
+
+static int build_index(void) {
+    uint32_t capacity = 64;
+    while (capacity < (uint32_t)node_count * 2) capacity *= 2;
+
+    int32_t* slots = realloc(id_slots, capacity * sizeof(*slots));
+    if (slots == NULL) return -1;
+    id_slots = slots;
+    id_mask = capacity - 1;
+    memset(id_slots, 0xff, capacity * sizeof(*id_slots));
+
+    for (int32_t index = 0; index < node_count; index++) {
+        uint32_t i = id_home(nodes[index].usage.id);
+        while (id_slots[i] >= 0) i = (i + 1) & id_mask;
+        id_slots[i] = index;
+    }
+    return 0;
+}
+
+static int open_root(void) {
+    if (root_override[0] != '\0') {
+        snprintf(root_path, sizeof(root_path), "%s", root_override);
+    } else if (cgroup_mount_point(root_path, sizeof(root_path)) != 0) {
+        return -1;
+    }
+
+    root_fd = open(root_path, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (root_fd < 0) return -1;
+    inotify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    needs_walk = 1;
+    return 0;
+}
+
+// Whether a group directory was created, removed or renamed since the last
+// call; reading empties the queue
+static int drain_events(void) {
+    char events[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+    int changed = 0;
+
+    for (;;) {
+        ssize_t bytes = read(inotify_fd, events, sizeof(events));
+        if (bytes <= 0) break;
+        for (const char* p = events; p < events + bytes;) {
+            const struct inotify_event* event = (const struct inotify_event*)p;
+            if (event->mask & (IN_ISDIR | IN_Q_OVERFLOW)) changed = 1;
+            p += sizeof(*event) + event->len;
+        }
+    }
+    return changed;
+}
+
+static void watch_node(struct tree_node* node) {
+    char path[CGROUP_PATH_LEN * 2];
+
+    if (node->watch >= 0) return;
+    if (inotify_fd >= 0) {
+        snprintf(path, sizeof(path), "%s/%s", root_path, node->path);
+        node->watch = inotify_add_watch(inotify_fd, path, WATCH_MASK);
+    }
+    if (node->watch < 0) unwatched = 1;
+}
+
+// Append a group found by the walk, taking over the state of the same
+// group in the previous tree if there was one
+static struct tree_node* append_node(struct tree_node** walked, int32_t* count, int32_t* capacity,
+                                     int32_t** origin, uint64_t id, const char* path) {
+    if (*count == *capacity) {
+        int32_t grown = *capacity > 0 ? *capacity * 2 : 256;
+        struct tree_node* new_walked = realloc(*walked, (size_t)grown * sizeof(**walked));
+        if (new_walked != NULL) *walked = new_walked;
+        int32_t* new_origin = realloc(*origin, (size_t)grown * sizeof(**origin));
+        if (new_origin != NULL) *origin = new_origin;
+        if (new_walked == NULL || new_origin == NULL) return NULL;
+        *capacity = grown;
+    }
+
+    char* own_path = strdup(path);
+    if (own_path == NULL) return NULL;
+
+    struct tree_node* node = &(*walked)[*count];
+    memset(node, 0, sizeof(*node));
+    node->usage.id = id;
+
+    int32_t old = find_index(id);
+    (*origin)[*count] = old;
+    if (old >= 0) {
+        // Moved over; the old entry is left without descriptors
+        struct tree_node* from = &nodes[old];
+        node->dir_fd = from->dir_fd;
+        memcpy(node->file_fds, from->file_fds, sizeof(node->file_fds));
+        node->watch = from->watch;
+        node->usage = from->usage;
+        from->dir_fd = -1;
+        for (int i = 0; i < TREE_FILE_COUNT; i++) from->file_fds[i] = -1;
+        from->watch = -1;
+    } else {
+        node->dir_fd = keep_fd(openat(root_fd, path, O_RDONLY | O_DIRECTORY | O_CLOEXEC));
+        for (int i = 0; i < TREE_FILE_COUNT; i++) node->file_fds[i] = -1;
+        node->watch = -1;
+    }
+    node->path = own_path;
+    (*count)++;
+    return node;
+}
+
+// List the subdirectories of walked[index] onto the end of the array
+static int walk_children(struct tree_node** walked, int32_t* count, int32_t* capacity, int32_t** origin,
+                         int32_t index) {
+    char path[CGROUP_PATH_LEN];
+    struct tree_node* parent = &(*walked)[index];
+
+    int list_fd = parent->dir_fd >= 0 ? openat(parent->dir_fd, ".", O_RDONLY | O_DIRECTORY | O_CLOEXEC)
+                                      : openat(root_fd, parent->path, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (list_fd < 0) return 0;
+    DIR* dir = fdopendir(list_fd);
+    if (dir == NULL) {
+        close(list_fd);
+        return 0;
+    }
+
+    int32_t depth = parent->usage.depth + 1;
+    uint64_t parent_id = parent->usage.id;
+    int32_t first = *count;
+    const char* parent_path = parent->path;
+    int root_level = strcmp(parent_path, ".") == 0;
+    int result = 0;
+    struct dirent* entry;
+
+    while ((entry = readdir(dir)) != NULL) {
+        const char* name = entry->d_name;
+        if (name[0] == '.' && (name[1] == '\0' || (name[1] == '.' && name[2] == '\0'))) continue;
+        if (entry->d_type != DT_DIR) {
+            struct stat info;
+            if (entry->d_type != DT_UNKNOWN || fstatat(dirfd(dir), name, &info, AT_SYMLINK_NOFOLLOW) != 0 ||
+                !S_ISDIR(info.st_mode)) {
+                continue;
+            }
+        }
+
+        int written = root_level ? snprintf(path, sizeof(path), "%s", name)
+                                 : snprintf(path, sizeof(path), "%s/%s", parent_path, name);
+        if (written < 0 || (size_t)written >= sizeof(path)) continue;
+
+        struct tree_node* child = append_node(walked, count, capacity, origin, (uint64_t)entry->d_ino, path);
+        if (child == NULL) {
+            result = -1;
+            break;
+        }
+        // The array may have moved
+        parent = &(*walked)[index];
+        parent_path = parent->path;
+
+        size_t name_length = strnlen(name, CGROUP_NAME_LEN - 1);
+        memcpy(child->usage.name, name, name_length);
+        child->usage.name[name_length] = '\0';
+        child->usage.parent_id = parent_id;
+        child->usage.depth = depth;
+    }
+    closedir(dir);
+
+    parent->first_child = first;
+    parent->usage.children = *count - first;
+    return result;
+}
+
+static void drop_tree(void) {
+    for (int32_t i = 0; i < node_count; i++) free_node(&nodes[i], 0);
+    free(nodes);
+    free(counters);
+    free(previous);
+    free(read_ns);
+    free(previous_ns);
+    free(candidates);
+    free(id_slots);
+    nodes = NULL;
+    counters = NULL;
+    previous = NULL;
+    read_ns = NULL;
+    previous_ns = NULL;
+    candidates = NULL;
+    id_slots = NULL;
+    id_mask = 0;
+    node_count = 0;
+    resume = 0;
+    needs_walk = 1;
+}
+
+// Walk the hierarchy breadth first into a new array, then move the
+// counters of surviving groups over and release the rest
+static int walk(uint64_t now_ns) {
+    struct tree_node* walked = NULL;
+    int32_t* origin = NULL;
+    int32_t count = 0;
+    int32_t capacity = 0;
+    struct stat info;
+    int result = 0;
+
+    unwatched = 0;
+    if (fstat(root_fd, &info) != 0) return -1;
+    struct tree_node* root = append_node(&walked, &count, &capacity, &origin, (uint64_t)info.st_ino, ".");
+    if (root == NULL) {
+        result = -1;
+    } else {
+        snprintf(root->usage.name, sizeof(root->usage.name), "/");
+        root->usage.parent_id = 0;
+        root->usage.depth = 0;
+    }
+
+    for (int32_t index = 0; result == 0 && index < count; index++) {
+        if (walked[index].usage.depth >= CGROUP_TREE_MAX_DEPTH) {
+            walked[index].first_child = count;
+            walked[index].usage.children = 0;
+            continue;
+        }
+        result = walk_children(&walked, &count, &capacity, &origin, index);
+    }
+
+    size_t size = (size_t)(capacity > 0 ? capacity : 1);
+    uint64_t* new_counters = calloc(size * COUNTER_COUNT, sizeof(*new_counters));
+    uint64_t* new_previous = calloc(size * COUNTER_COUNT, sizeof(*new_previous));
+    uint64_t* new_read_ns = calloc(size, sizeof(*new_read_ns));
+    uint64_t* new_previous_ns = calloc(size, sizeof(*new_previous_ns));
+    struct candidate* new_candidates = calloc(size, sizeof(*new_candidates));
+    if (result != 0 || new_counters == NULL || new_previous == NULL || new_read_ns == NULL ||
+        new_previous_ns == NULL || new_candidates == NULL) {
+        // Start again from nothing on the next refresh
+        for (int32_t i = 0; i < count; i++) free_node(&walked[i], 0);
+        free(walked);
+        free(origin);
+        free(new_counters);
+        free(new_previous);
+        free(new_read_ns);
+        free(new_previous_ns);
+        free(new_candidates);
+        drop_tree();
+        return -1;
+    }
+
+    for (int32_t i = 0; i < count; i++) {
+        int32_t old = origin[i];
+        if (old < 0) continue;
+        memcpy(&new_previous[(size_t)i * COUNTER_COUNT], &previous[(size_t)old * COUNTER_COUNT],
+               COUNTER_COUNT * sizeof(*new_previous));
+        new_previous_ns[i] = previous_ns[old];
+    }
+
+    // Groups that are gone; survivors no longer own anything here
+    for (int32_t i = 0; i < node_count; i++) free_node(&nodes[i], 1);
+    free(nodes);
+    free(counters);
+    free(previous);
+    free(read_ns);
+    free(previous_ns);
+    free(candidates);
+    free(origin);
+
+    nodes = walked;
+    node_count = count;
+    counters = new_counters;
+    previous = new_previous;
+    read_ns = new_read_ns;
+    previous_ns = new_previous_ns;
+    candidates = new_candidates;
+    if (build_index() != 0) {
+        drop_tree();
+        return -1;
+    }
+
+    for (int32_t i = 0; i < node_count; i++) watch_node(&nodes[i]);
+    resume = 0;
+    walked_ns = now_ns;
+    needs_walk = 0;
+    return 0;
+}
+
+// Read one of a group's files into file_buffer: through its cached
+// descriptor, else opened relative to the group's directory. Returns the
+// length, or -1.
+static ssize_t read_file(struct tree_node* node, int file) {
+    char path[CGROUP_PATH_LEN + 32];
+    int* fd = &node->file_fds[file];
+
+    if (node->missing & (1u << file)) return -1;
+    if (*fd >= 0) {
+        ssize_t bytes = pread(*fd, file_buffer, sizeof(file_buffer) - 1, 0);
+        if (bytes >= 0) {
+            file_buffer[bytes] = '\0';
+            return bytes;
+        }
+        // The group was removed under us
+        close_counted(fd);
+        needs_walk = 1;
+        return -1;
+    }
+
+    int opened;
+    if (node->dir_fd >= 0) {
+        opened = openat(node->dir_fd, file_names[file], O_RDONLY | O_CLOEXEC);
+    } else {
+        snprintf(path, sizeof(path), "%s/%s", node->path, file_names[file]);
+        opened = openat(root_fd, path, O_RDONLY | O_CLOEXEC);
+    }
+    if (opened < 0) {
+        // The controller is not enabled here, or this is the root group
+        if (errno == ENOENT) node->missing |= 1u << file;
+        return -1;
+    }
+
+    ssize_t bytes = pread(opened, file_buffer, sizeof(file_buffer) - 1, 0);
+    if (bytes >= 0) file_buffer[bytes] = '\0';
+    if (bytes >= 0) {
+        *fd = keep_fd(opened);
+    } else {
+        close(opened);
+    }
+    return bytes;
+}
+
+// Sum rbytes= and wbytes= over the device lines of io.stat
+static void parse_io_stat(const char* p, const char* end, uint64_t* read_bytes, uint64_t* write_bytes) {
+    *read_bytes = 0;
+    *write_bytes = 0;
+    for (const char* line = p; line < end;) {
+        const char* next = proc_next_line(line, end);
+        const char* field = memmem(line, (size_t)(next - line), " rbytes=", 8);
+        if (field != NULL) {
+            const char* value = field + 8;
+            *read_bytes += proc_parse_u64(&value, next);
+        }
+        field = memmem(line, (size_t)(next - line), " wbytes=", 8);
+        if (field != NULL) {
+            const char* value = field + 8;
+            *write_bytes += proc_parse_u64(&value, next);
+        }
+        line = next;
+    }
+}
+
+static void read_node(int32_t index, uint64_t now_ns) {
+    struct tree_node* node = &nodes[index];
+    uint64_t* values = &counters[(size_t)index * COUNTER_COUNT];
+
+    ssize_t bytes = read_file(node, TREE_CPU_STAT);
+    if (bytes <= 0) return;
+    values[COUNTER_CPU_USEC] = 0;
+    proc_parse_flat_keyed(file_buffer, file_buffer + bytes, cpu_stat_keys, 1, &values[COUNTER_CPU_USEC]);
+
+    bytes = read_file(node, TREE_MEMORY_CURRENT);
+    if (bytes > 0) {
+        const char* p = file_buffer;
+        node->usage.memory_kb = (int64_t)(proc_parse_u64(&p, file_buffer + bytes) / 1024);
+    }
+
+    bytes = read_file(node, TREE_IO_STAT);
+    if (bytes > 0) {
+        parse_io_stat(file_buffer, file_buffer + bytes, &values[COUNTER_READ_BYTES], &values[COUNTER_WRITE_BYTES]);
+    } else {
+        values[COUNTER_READ_BYTES] = 0;
+        values[COUNTER_WRITE_BYTES] = 0;
+    }
+    read_ns[index] = now_ns;
+}
+
+static uint64_t counter_delta(uint64_t current, uint64_t last) {
+    return current > last ? current - last : 0;
+}
+
+// One pass over the flat arrays: rates for the groups read this refresh,
+// whose counters then become their baseline
+static void compute_rates(void) {
+    for (int32_t i = 0; i < node_count; i++) {
+        uint64_t now_ns = read_ns[i];
+        if (now_ns == 0) continue;
+
+        const uint64_t* current = &counters[(size_t)i * COUNTER_COUNT];
+        uint64_t* last = &previous[(size_t)i * COUNTER_COUNT];
+        struct cgroup_node* usage = &nodes[i].usage;
+        if (previous_ns[i] != 0 && now_ns > previous_ns[i]) {
+            double seconds = (double)(now_ns - previous_ns[i]) / 1e9;
+            usage->cpu_percent = (double)counter_delta(current[COUNTER_CPU_USEC], last[COUNTER_CPU_USEC]) /
+                                 1e6 / seconds * 100.0;
+            usage->read_bytes_per_sec =
+                (double)counter_delta(current[COUNTER_READ_BYTES], last[COUNTER_READ_BYTES]) / seconds;
+            usage->write_bytes_per_sec =
+                (double)counter_delta(current[COUNTER_WRITE_BYTES], last[COUNTER_WRITE_BYTES]) / seconds;
+        }
+        memcpy(last, current, COUNTER_COUNT * sizeof(*last));
+        previous_ns[i] = now_ns;
+        read_ns[i] = 0;
+    }
+}
+
+int refreshCgroupTree() {
+    if (fd_budget < 0) init_budget();
+    if (root_fd < 0 && open_root() != 0) return -1;
+
+    uint64_t start = latency_now_ns();
+    if (inotify_fd >= 0 && drain_events()) needs_walk = 1;
+    if (unwatched && start - walked_ns >= CGROUP_TREE_RESCAN_NS) needs_walk = 1;
+    if (needs_walk && walk(start) != 0) return -1;
+
+    // The level on screen first, so it is fresh however large the tree
+    uint64_t deadline = start + CGROUP_TREE_BUDGET_NS;
+    int32_t focus = focus_id == 0 ? 0 : find_index(focus_id);
+    if (focus >= 0) {
+        read_node(focus, start);
+        for (int32_t i = 0; i < nodes[focus].usage.children; i++) {
+            if (i > 0 && (i & 63) == 0 && latency_now_ns() > deadline) break;
+            read_node(nodes[focus].first_child + i, start);
+        }
+    }
+
+    // Then the rest, round-robin from where the last refresh stopped
+    int32_t index = resume < node_count ? resume : 0;
+    for (int32_t visited = 0; visited < node_count; visited++) {
+        if ((visited & 63) == 0 && latency_now_ns() > deadline) break;
+        if (read_ns[index] == 0) read_node(index, start);
+        index = index + 1 < node_count ? index + 1 : 0;
+    }
+    resume = index;
+    compute_rates();
+
+    latency_record(LATENCY_CGROUPS, start);
+    return node_count;
+}
+
+static double sort_key(const struct cgroup_node* usage, int sort) {
+    switch (sort) {
+        case CGROUP_SORT_MEMORY:
+            return (double)usage->memory_kb;
+        case CGROUP_SORT_IO:
+            return usage->read_bytes_per_sec + usage->write_bytes_per_sec;
+        default:
+            return usage->cpu_percent;
+    }
+}
+
+// Busiest first; ties keep the walk's order so rows do not shuffle
+static int compare_descending(const void* a, const void* b) {
+    const struct candidate* x = a;
+    const struct candidate* y = b;
+    if (x->key != y->key) return x->key < y->key ? 1 : -1;
+    return (x->index > y->index) - (x->index < y->index);
+}
+
+int getCgroupChildren(uint64_t parent_id, int sort, struct cgroup_node* out, int capacity) {
+    if (out == NULL || capacity <= 0 || sort < 0 || sort >= CGROUP_SORT_COUNT) return -1;
+
+    int32_t parent = parent_id == 0 ? (node_count > 0 ? 0 : -1) : find_index(parent_id);
+    if (parent < 0) return -1;
+    focus_id = parent_id;
+
+    const struct tree_node* node = &nodes[parent];
+    int32_t count = node->usage.children;
+    for (int32_t i = 0; i < count; i++) {
+        int32_t child = node->first_child + i;
+        candidates[i].key = sort_key(&nodes[child].usage, sort);
+        candidates[i].index = child;
+    }
+    qsort(candidates, (size_t)count, sizeof(*candidates), compare_descending);
+
+    int n = capacity < count ? capacity : count;
+    for (int i = 0; i < n; i++) out[i] = nodes[candidates[i].index].usage;
+    return n;
+}
+
+int getCgroupNode(uint64_t id, struct cgroup_node* out) {
+    if (out == NULL) return -1;
+
+    int32_t index = id == 0 ? (node_count > 0 ? 0 : -1) : find_index(id);
+    if (index < 0) return -1;
+    *out = nodes[index].usage;
+    return 0;
+}
+
+void cgroup_tree_set_root(const char* path) {
+    cgroup_tree_cleanup();
+    snprintf(root_override, sizeof(root_override), "%s", path != NULL ? path : "");
+}
+
+void cgroup_tree_cleanup() {
+    drop_tree();
+    if (root_fd >= 0) {
+        close(root_fd);
+        root_fd = -1;
+    }
+    // Closing the instance drops every watch
+    if (inotify_fd >= 0) {
+        close(inotify_fd);
+        inotify_fd = -1;
+    }
+    unwatched = 0;
+    open_fds = 0;
+    focus_id = 0;
+}
@@ -0,0 +1,602 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/statfs.h>
+#include <sys/types.h>
+#include <sys/utsname.h>
+#include <time.h>
+
+#include "cpu_monitor.h"
+#include "proc_parse.h"
+
+// Export functions for FFI
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Global buffers for system information strings
+static char cpu_model_buffer[256] = {0};
+static char os_version_buffer[256] = {0};
+static char hostname_buffer[256] = {0};
+static char kernel_version_buffer[256] = {0};
+
+// Preallocated read buffers. The aggregate "cpu" line opens /proc/stat, so
+// aggregate-only reads stop after the first page; per-core reads cover every
+// "cpuN" line (~100 bytes each) but not the per-IRQ lines that follow.
+#define STAT_AGGREGATE_READ 4096
+#define STAT_BUFFER_SIZE (CORE_USAGE_MAX_CORES * 128)
+
+// Everything a sample mutates. Sources are opened once and re-read with
+// pread() at offset 0, which makes procfs regenerate the contents, so a
+// tick never reopens a file.
+struct monitor_ctx {
+    int proc_stat_fd;
+    int proc_meminfo_fd;
+
+    // Last CPU counters, used to calculate delta
+    unsigned long long prev_busy;
+    unsigned long long prev_total;
+
+    // Per-core counters; the two sets are swapped after every per-core sample
+    struct core_counters core_sets[2];
+    struct core_counters* core_current;
+    struct core_counters* core_previous;
+
+    size_t stat_length;
+    char stat_buffer[STAT_BUFFER_SIZE];
+    char meminfo_buffer[4096];
+};
+
+// Context behind the process-wide functions (getCpuUsage() and friends)
+static struct monitor_ctx default_ctx = {
+    .proc_stat_fd = -1,
+    .proc_meminfo_fd = -1,
+    .core_current = &default_ctx.core_sets[0],
+    .core_previous = &default_ctx.core_sets[1],
+};
+static int monitoring_initialized = 0;
+
+// Open a tick source once; returns -1 if it does not exist on this host
+static int open_source(const char* path) {
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        fprintf(stderr, "Error opening %s\n", path);
+    }
+    return fd;
+}
+
+static void open_sources(struct monitor_ctx* ctx) {
+    ctx->proc_stat_fd = open_source("/proc/stat");
+    ctx->proc_meminfo_fd = open_source("/proc/meminfo");
+}
+
+static void close_sources(struct monitor_ctx* ctx) {
+    if (ctx->proc_stat_fd >= 0) close(ctx->proc_stat_fd);
+    if (ctx->proc_meminfo_fd >= 0) close(ctx->proc_meminfo_fd);
+    ctx->proc_stat_fd = -1;
+    ctx->proc_meminfo_fd = -1;
+}
+
+// Re-read a persistent source into a preallocated buffer (NUL-terminated)
+static ssize_t read_source(int fd, char* buffer, size_t size) {
+    if (fd < 0) return -1;
+    ssize_t n = pread(fd, buffer, size - 1, 0);
+    if (n < 0) return -1;
+    buffer[n] = '\0';
+    return n;
+}
+
+// Re-read /proc/stat, up to `size` bytes, and remember how much is valid
+static ssize_t read_stat(struct monitor_ctx* ctx, size_t size) {
+    ssize_t n = read_source(ctx->proc_stat_fd, ctx->stat_buffer, size);
+    ctx->stat_length = n > 0 ? (size_t)n : 0;
+    return n;
+}
+
+// Parse the aggregate busy/total jiffies from the first /proc/stat line.
+// Guest time is already accounted in user/nice, so it is not added again.
+static int parse_cpu_aggregate(const char* buffer, const char* end, unsigned long long* busy,
+                               unsigned long long* total) {
+    uint64_t fields[PROC_CPU_FIELD_COUNT] = {0};
+
+    if (end - buffer < 4 || strncmp(buffer, "cpu ", 4) != 0) {
+        return -1;
+    }
+    const char* p = buffer + 4;
+    proc_parse_fields(&p, end, &proc_stat_cpu_fields, fields);
+
+    unsigned long long idle = fields[PROC_CPU_IDLE] + fields[PROC_CPU_IOWAIT];
+    unsigned long long sum = 0;
+    for (int i = 0; i < PROC_CPU_FIELD_COUNT; i++) {
+        sum += fields[i];
+    }
+
+    *total = sum;
+    *busy = sum - idle;
+    return 0;
+}
+
+// Parse every "cpuN" line into per-core counters indexed by CPU number, so
+// offline CPUs leave a gap rather than shifting the others
+static void parse_cpu_cores(const char* buffer, const char* end, struct core_counters* counters) {
+    int count = 0;
+
+    for (const char* line = proc_next_line(buffer, end);
+         end - line > 4 && strncmp(line, "cpu", 3) == 0 && line[3] >= '0' && line[3] <= '9';
+         line = proc_next_line(line, end)) {
+        uint64_t fields[PROC_CPU_FIELD_COUNT] = {0};
+        const char* p = line + 3;
+        uint64_t index = proc_parse_u64(&p, end);
+
+        proc_parse_fields(&p, end, &proc_stat_cpu_fields, fields);
+        if (index < CORE_USAGE_MAX_CORES) {
+            for (int i = count; i < (int)index; i++) {
+                counters->user[i] = counters->system[i] = counters->idle[i] = 0;
+                counters->iowait[i] = counters->steal[i] = 0;
+            }
+            counters->user[index] = fields[PROC_CPU_USER] + fields[PROC_CPU_NICE];
+            counters->system[index] = fields[PROC_CPU_SYSTEM] + fields[PROC_CPU_IRQ] + fields[PROC_CPU_SOFTIRQ];
+            counters->idle[index] = fields[PROC_CPU_IDLE];
+            counters->iowait[index] = fields[PROC_CPU_IOWAIT];
+            counters->steal[index] = fields[PROC_CPU_STEAL];
+            if ((int)index >= count) count = (int)index + 1;
+        }
+    }
+
+    counters->count = count;
+}
+
+// Turn aggregate counters into a usage percentage since the previous sample
+static double cpu_usage_since_previous(struct monitor_ctx* ctx, unsigned long long busy,
+                                       unsigned long long total) {
+    unsigned long long busy_delta = busy - ctx->prev_busy;
+    unsigned long long total_delta = total - ctx->prev_total;
+
+    // Save current values for next call
+    ctx->prev_busy = busy;
+    ctx->prev_total = total;
+
+    if (total_delta == 0) {
+        return 0.0;
+    }
+
+    // Calculate CPU usage percentage
+    return ((double)busy_delta / (double)total_delta) * 100.0;
+}
+
+// Read the aggregate busy/total jiffies from /proc/stat
+static int read_cpu_counters(struct monitor_ctx* ctx, unsigned long long* busy, unsigned long long* total) {
+    uint64_t start = latency_now_ns();
+    int result = -1;
+
+    if (read_stat(ctx, STAT_AGGREGATE_READ) > 0) {
+        result = parse_cpu_aggregate(ctx->stat_buffer, ctx->stat_buffer + ctx->stat_length, busy, total);
+    }
+
+    latency_record(LATENCY_CPU, start);
+    return result;
+}
+
+// Compute per-core shares from the /proc/stat contents already in the
+// context's stat buffer and advance its per-core baseline
+static int per_core_since_previous(struct monitor_ctx* ctx, double* out, int capacity) {
+    struct core_counters* swap;
+
+    parse_cpu_cores(ctx->stat_buffer, ctx->stat_buffer + ctx->stat_length, ctx->core_current);
+    int written = core_usage_compute(ctx->core_current, ctx->core_previous, out, capacity);
+
+    swap = ctx->core_previous;
+    ctx->core_previous = ctx->core_current;
+    ctx->core_current = swap;
+    return written;
+}
+
+// Take the per-core baseline from a fresh /proc/stat read, so the first
+// per-core sample covers the time since now rather than since boot
+static void seed_core_baseline(struct monitor_ctx* ctx) {
+    if (read_stat(ctx, STAT_BUFFER_SIZE) > 0) {
+        parse_cpu_cores(ctx->stat_buffer, ctx->stat_buffer + ctx->stat_length, ctx->core_previous);
+    }
+}
+
+// Initialize CPU monitoring
+void init_cpu_monitoring() {
+    if (monitoring_initialized) return;
+
+    open_sources(&default_ctx);
+
+    // Get initial CPU load
+    if (read_cpu_counters(&default_ctx, &default_ctx.prev_busy, &default_ctx.prev_total) != 0) {
+        fprintf(stderr, "Error getting CPU load info\n");
+    }
+    seed_core_baseline(&default_ctx);
+
+    monitoring_initialized = 1;
+}
+
+// Get CPU usage percentage (0-100)
+double getCpuUsage() {
+    unsigned long long busy, total;
+
+    if (!monitoring_initialized) {
+        // Counters start at boot, so the first call reports the average
+        // since boot instead of a placeholder value
+        init_cpu_monitoring();
+        default_ctx.prev_busy = 0;
+        default_ctx.prev_total = 0;
+    }
+
+    if (read_cpu_counters(&default_ctx, &busy, &total) != 0) {
+        fprintf(stderr, "Error getting CPU load info\n");
+        return -1.0;
+    }
+
+    return cpu_usage_since_previous(&default_ctx, busy, total);
+}
+
+// Get per-core user/system/idle/iowait shares since the previous call
+int getPerCoreUsage(double* out, int capacity) {
+    if (out == NULL) return -1;
+    if (!monitoring_initialized) init_cpu_monitoring();
+
+    if (read_stat(&default_ctx, STAT_BUFFER_SIZE) <= 0) {
+        fprintf(stderr, "Error getting per-core CPU info\n");
+        return -1;
+    }
+    return per_core_since_previous(&default_ctx, out, capacity);
+}
+
+static const struct proc_key meminfo_keys[] = {PROC_KEY("MemTotal"), PROC_KEY("MemAvailable")};
+
+// Read MemTotal and MemAvailable (kB) with a single pass over /proc/meminfo
+static int read_memory_kb(struct monitor_ctx* ctx, long long* total_kb, long long* available_kb) {
+    uint64_t start = latency_now_ns();
+    int result = -1;
+
+    ssize_t length = read_source(ctx->proc_meminfo_fd, ctx->meminfo_buffer, sizeof(ctx->meminfo_buffer));
+    uint64_t values[2];
+    if (length > 0 &&
+        proc_parse_keyed(ctx->meminfo_buffer, ctx->meminfo_buffer + length, meminfo_keys, 2, values) == 2) {
+        *total_kb = (long long)values[0];
+        *available_kb = (long long)values[1];
+        result = 0;
+    }
+
+    latency_record(LATENCY_MEMORY, start);
+    return result;
+}
+
+// statfs() the root filesystem, timed as the disk collector
+static int read_root_statfs(struct statfs* stats) {
+    uint64_t start = latency_now_ns();
+    int result = statfs("/", stats);
+
+    latency_record(LATENCY_DISK, start);
+    return result;
+}
+
+// Get used memory in MB
+int getMemoryUsed() {
+    long long total_kb, available_kb;
+
+    if (!monitoring_initialized) init_cpu_monitoring();
+    if (read_memory_kb(&default_ctx, &total_kb, &available_kb) != 0) {
+        fprintf(stderr, "Error getting memory info\n");
+        return -1;
+    }
+
+    // Convert kB to MB
+    return (int)((total_kb - available_kb) / 1024);
+}
+
+// Get total memory in MB, cached for SCHEDULE_STATIC_MEMORY_TOTAL's TTL
+int getMemoryTotal() {
+    long long total_kb, available_kb;
+    double cached;
+
+    if (schedule_static_get(SCHEDULE_STATIC_MEMORY_TOTAL, &cached)) return (int)cached;
+    if (!monitoring_initialized) init_cpu_monitoring();
+    if (read_memory_kb(&default_ctx, &total_kb, &available_kb) != 0) {
+        fprintf(stderr, "Error getting total memory\n");
+        return -1;
+    }
+
+    // Convert kB to MB
+    int total_mb = (int)(total_kb / 1024);
+    schedule_static_put(SCHEDULE_STATIC_MEMORY_TOTAL, total_mb);
+    return total_mb;
+}
+
+// Get disk usage percentage (0-100)
+double getDiskUsage() {
+    struct statfs stats;
+
+    if (read_root_statfs(&stats) == -1) {
+        fprintf(stderr, "Error getting disk info\n");
+        return -1.0;
+    }
+
+    // Calculate total and free space
+    double total = (double)stats.f_blocks * stats.f_bsize;
+    double free = (double)stats.f_bfree * stats.f_bsize;
+
+    if (total == 0) {
+        return 0.0;
+    }
+
+    // Calculate percentage used
+    return ((total - free) / total) * 100.0;
+}
+
+// Get disk used in MB
+double getDiskUsed() {
+    struct statfs stats;
+
+    if (read_root_statfs(&stats) == -1) {
+        fprintf(stderr, "Error getting disk info\n");
+        return -1.0;
+    }
+
+    // Calculate used space and convert to MB
+    double used = (double)(stats.f_blocks - stats.f_bfree) * stats.f_bsize;
+    return used / (1024.0 * 1024.0);
+}
+
+// Get total disk size in MB, cached for SCHEDULE_STATIC_DISK_TOTAL's TTL
+double getDiskTotal() {
+    struct statfs stats;
+    double cached;
+
+    if (schedule_static_get(SCHEDULE_STATIC_DISK_TOTAL, &cached)) return cached;
+    if (read_root_statfs(&stats) == -1) {
+        fprintf(stderr, "Error getting disk info\n");
+        return -1.0;
+    }
+
+    // Calculate total space and convert to MB
+    double total = (double)stats.f_blocks * stats.f_bsize / (1024.0 * 1024.0);
+    schedule_static_put(SCHEDULE_STATIC_DISK_TOTAL, total);
+    return total;
+}
+
+// Get CPU temperature in Celsius from the hottest package or core sensor
+double getTemperature() {
+    uint64_t start = latency_now_ns();
+
+    // No sensor is exposed in most VMs and containers
+    double celsius = sensors_cpu_temperature();
+
+    latency_record(LATENCY_TEMPERATURE, start);
+    return celsius;
+}
+
+// One /proc/stat read feeds both the aggregate and the per-core figures
+static void sample_cpu(struct monitor_ctx* ctx, struct system_snapshot* sample) {
+    unsigned long long busy, total;
+
+    uint64_t start = latency_now_ns();
+    if (read_stat(ctx, STAT_BUFFER_SIZE) > 0 &&
+        parse_cpu_aggregate(ctx->stat_buffer, ctx->stat_buffer + ctx->stat_length, &busy, &total) == 0) {
+        sample->cpu_usage = cpu_usage_since_previous(ctx, busy, total);
+        sample->core_count = per_core_since_previous(ctx, sample->per_core,
+                                                     SYSTEM_SNAPSHOT_MAX_CORES * CORE_USAGE_FIELDS);
+    } else {
+        sample->cpu_usage = -1.0;
+    }
+    latency_record(LATENCY_CPU, start);
+}
+
+static void sample_memory(struct monitor_ctx* ctx, struct system_snapshot* sample) {
+    long long total_kb, available_kb;
+
+    if (read_memory_kb(ctx, &total_kb, &available_kb) == 0) {
+        sample->memory_used = (total_kb - available_kb) / 1024;
+        sample->memory_total = total_kb / 1024;
+    } else {
+        sample->memory_used = -1;
+        sample->memory_total = -1;
+    }
+}
+
+static void sample_disk(struct system_snapshot* sample) {
+    struct statfs stats;
+
+    if (read_root_statfs(&stats) == 0) {
+        double total = (double)stats.f_blocks * stats.f_bsize;
+        double used = (double)(stats.f_blocks - stats.f_bfree) * stats.f_bsize;
+        sample->disk_total = total / (1024.0 * 1024.0);
+        sample->disk_used = used / (1024.0 * 1024.0);
+        sample->disk_usage = total > 0 ? (used / total) * 100.0 : 0.0;
+    } else {
+        sample->disk_total = -1.0;
+        sample->disk_used = -1.0;
+        sample->disk_usage = -1.0;
+    }
+}
+
+// Fill the per-tick metrics whose collectors are in `mask`: one /proc/stat
+// read, one /proc/meminfo read, one statfs("/") and the CPU sensor reads.
+// Metrics outside the mask keep the values `snapshot` already holds.
+static int sample_context(struct monitor_ctx* ctx, struct system_snapshot* snapshot, uint32_t mask) {
+    struct system_snapshot sample;
+
+    if (snapshot == NULL || snapshot->size < SYSTEM_SNAPSHOT_MIN_SIZE) {
+        return -1;
+    }
+
+    memset(&sample, 0, sizeof(sample));
+    if ((mask & SCHEDULE_SNAPSHOT_MASK) != SCHEDULE_SNAPSHOT_MASK) {
+        memcpy(&sample, snapshot, snapshot->size < sizeof(sample) ? snapshot->size : sizeof(sample));
+    }
+    sample.timestamp_ns = latency_now_ns();
+
+    if (mask & SCHEDULE_BIT(SCHEDULE_CPU)) sample_cpu(ctx, &sample);
+    if (mask & SCHEDULE_BIT(SCHEDULE_MEMORY)) sample_memory(ctx, &sample);
+    if (mask & SCHEDULE_BIT(SCHEDULE_DISK)) sample_disk(&sample);
+    if (mask & SCHEDULE_BIT(SCHEDULE_TEMPERATURE)) sample.temperature = getTemperature();
+
+    latency_record(LATENCY_SNAPSHOT, sample.timestamp_ns);
+    return system_snapshot_copy_out(snapshot, &sample);
+}
+
+int getSystemSnapshot(struct system_snapshot* snapshot) {
+    if (!monitoring_initialized) init_cpu_monitoring();
+    return sample_context(&default_ctx, snapshot, SCHEDULE_ALL);
+}
+
+struct monitor_ctx* monitor_create() {
+    // Zeroed aggregate baseline: the first CPU figure covers the time since
+    // boot. Per-core shares start from now.
+    struct monitor_ctx* ctx = calloc(1, sizeof(*ctx));
+    if (ctx == NULL) {
+        fprintf(stderr, "Error allocating monitor context\n");
+        return NULL;
+    }
+
+    open_sources(ctx);
+    if (ctx->proc_stat_fd < 0) {
+        close_sources(ctx);
+        free(ctx);
+        return NULL;
+    }
+    ctx->core_current = &ctx->core_sets[0];
+    ctx->core_previous = &ctx->core_sets[1];
+    seed_core_baseline(ctx);
+    return ctx;
+}
+
+int monitor_sample(struct monitor_ctx* ctx, struct system_snapshot* snapshot) {
+    if (ctx == NULL) return -1;
+    return sample_context(ctx, snapshot, SCHEDULE_ALL);
+}
+
+int monitor_sample_mask(struct monitor_ctx* ctx, struct system_snapshot* snapshot, uint32_t mask) {
+    if (ctx == NULL) return -1;
+    return sample_context(ctx, snapshot, mask);
+}
+
+void monitor_destroy(struct monitor_ctx* ctx) {
+    if (ctx == NULL) return;
+    close_sources(ctx);
+    free(ctx);
+}
+
+// Get CPU model name
+const char* getCpuModel() {
+    if (cpu_model_buffer[0] == '\0') {
+        FILE* cpuinfo = fopen("/proc/cpuinfo", "r");
+        char line[512];
+
+        if (cpuinfo) {
+            while (fgets(line, sizeof(line), cpuinfo)) {
+                // x86 reports "model name", most ARM kernels "Hardware" or "Model"
+                if (strncmp(line, "model name", 10) == 0 ||
+                    strncmp(line, "Hardware", 8) == 0 ||
+                    strncmp(line, "Model", 5) == 0) {
+                    char* value = strchr(line, ':');
+                    if (!value) continue;
+                    value++;
+                    while (*value == ' ' || *value == '\t') value++;
+                    char* newline = strchr(value, '\n');
+                    if (newline) *newline = '\0';
+                    snprintf(cpu_model_buffer, sizeof(cpu_model_buffer), "%.*s",
+                             (int)sizeof(cpu_model_buffer) - 1, value);
+                    break;
+                }
+            }
+            fclose(cpuinfo);
+        }
+
+        if (cpu_model_buffer[0] == '\0') {
+            strcpy(cpu_model_buffer, "Unknown CPU");
+        }
+    }
+    return cpu_model_buffer;
+}
+
+// Get OS version from os-release
+const char* getOsVersion() {
+    if (os_version_buffer[0] == '\0') {
+        FILE* os_release = fopen("/etc/os-release", "r");
+        char line[512];
+
+        if (os_release) {
+            while (fgets(line, sizeof(line), os_release)) {
+                if (strncmp(line, "PRETTY_NAME=", 12) == 0) {
+                    char* value = line + 12;
+                    if (*value == '"') value++;
+                    char* end = strpbrk(value, "\"\n");
+                    if (end) *end = '\0';
+                    snprintf(os_version_buffer, sizeof(os_version_buffer), "%.*s",
+                             (int)sizeof(os_version_buffer) - 1, value);
+                    break;
+                }
+            }
+            fclose(os_release);
+        }
+
+        if (os_version_buffer[0] == '\0') {
+            strcpy(os_version_buffer, "Unknown Linux");
+        }
+    }
+    return os_version_buffer;
+}
+
+// Get hostname
+const char* getHostname() {
+    if (hostname_buffer[0] == '\0') {
+        size_t len = sizeof(hostname_buffer);
+        if (gethostname(hostname_buffer, len) != 0) {
+            strcpy(hostname_buffer, "Unknown Host");
+        }
+    }
+    return hostname_buffer;
+}
+
+// Get kernel version
+const char* getKernelVersion() {
+    if (kernel_version_buffer[0] == '\0') {
+        struct utsname info;
+        if (uname(&info) != 0) {
+            strcpy(kernel_version_buffer, "Unknown Kernel");
+        } else {
+            snprintf(kernel_version_buffer, sizeof(kernel_version_buffer),
+                     "%s %s %s", info.sysname, info.release, info.machine);
+        }
+    }
+    return kernel_version_buffer;
+}
+
+// Get number of logical CPU cores, cached for SCHEDULE_STATIC_CORE_COUNT's TTL
+int getCpuCoreCount() {
+    double cached;
+    if (schedule_static_get(SCHEDULE_STATIC_CORE_COUNT, &cached)) return (int)cached;
+
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    if (cores < 1) {
+        cores = 1; // Default to 1 if we can't get the info
+    }
+    schedule_static_put(SCHEDULE_STATIC_CORE_COUNT, (double)cores);
+    return (int)cores;
+}
+
+// Cleanup resources
+void cleanup_cpu_monitoring() {
+    close_sources(&default_ctx);
+    monitoring_initialized = 0;
+    process_top_cleanup();
+    mount_usage_cleanup();
+    disk_io_cleanup();
+    net_io_cleanup();
+    pressure_cleanup();
+    sensors_cleanup();
+    cgroup_cleanup();
+    cgroup_tree_cleanup();
+}
+
+#ifdef __cplusplus
+}
+#endif
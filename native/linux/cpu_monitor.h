@@ -0,0 +1,71 @@
+#ifndef CPU_MONITOR_H
+#define CPU_MONITOR_H
+
+#include "../common/burst.h"
+#include "../common/cgroup.h"
+#include "../common/cgroup_tree.h"
+#include "../common/core_usage.h"
+#include "../common/dart_port.h"
+#include "../common/decimate.h"
+#include "../common/disk_io.h"
+#include "../common/history.h"
+#include "../common/history_db.h"
+#include "../common/latency.h"
+#include "../common/monitor_ctx.h"
+#include "../common/mount_usage.h"
+#include "../common/net_io.h"
+#include "../common/pressure.h"
+#include "../common/process_top.h"
+#include "../common/quantile.h"
+#include "../common/sampler.h"
+#include "../common/schedule.h"
+#include "../common/shared_segment.h"
+#include "../common/sensors.h"
+#include "../common/system_snapshot.h"
+#include "../common/window_stats.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// CPU monitoring functions
+void init_cpu_monitoring();
+double getCpuUsage();
+
+// Memory monitoring functions
+int getMemoryUsed();
+int getMemoryTotal();
+
+// Disk monitoring functions
+double getDiskUsage();
+double getDiskUsed();
+double getDiskTotal();
+
+// Per-device I/O rates since the previous call; with fold_partitions set,
+// partitions are omitted since their disk already counts their I/O. Returns
+// the number of rows written, or -1 on error.
+int getDiskIo(struct disk_io* out, int capacity, int fold_partitions);
+
+// Network monitoring functions
+// Per-interface rates since the previous call. Returns the number of rows
+// written, or -1 on error.
+int getNetworkIo(struct net_io* out, int capacity);
+
+// Temperature monitoring
+double getTemperature();
+
+// System information functions
+const char* getCpuModel();
+const char* getOsVersion();
+const char* getHostname();
+const char* getKernelVersion();
+int getCpuCoreCount();
+
+// Resource cleanup
+void cleanup_cpu_monitoring();
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CPU_MONITOR_H 
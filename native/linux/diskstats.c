@@ -0,0 +1,244 @@
+#define _GNU_SOURCE
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "cpu_monitor.h"
+#include "proc_parse.h"
+
+// /proc/diskstats is read into one buffer through a persistent descriptor.
+// Devices are kept in file order, so each tick matches line i to table
+// entry i by its major:minor numbers; names are only copied, and sysfs only
+// consulted, when the device set changes.
+#define SECTOR_BYTES 512.0
+
+struct device_counters {
+    uint64_t reads;
+    uint64_t read_sectors;
+    uint64_t read_ms;
+    uint64_t writes;
+    uint64_t write_sectors;
+    uint64_t write_ms;
+    uint64_t in_flight;
+    uint64_t busy_ms;
+};
+
+struct device_entry {
+    unsigned int major;
+    unsigned int minor;
+    int ignored;                  // loop and ram devices
+    int is_partition;
+    struct device_counters previous;
+    char name[DISK_IO_NAME_LEN];
+};
+
+static const char* diskstats_path = "/proc/diskstats";
+static const char* sys_block_path = "/sys/class/block";
+
+static int diskstats_fd = -1;
+static char* diskstats_buffer = NULL;
+static const char* diskstats_end = NULL;
+static size_t diskstats_capacity = 0;
+
+static struct device_entry* devices = NULL;
+static int device_count = 0;
+static int device_capacity = 0;
+static uint64_t previous_ns = 0;
+
+// Read the whole file into the shared buffer, growing it if a read fills it
+static ssize_t read_diskstats(void) {
+    if (diskstats_fd < 0) {
+        diskstats_fd = open(diskstats_path, O_RDONLY | O_CLOEXEC);
+        if (diskstats_fd < 0) return -1;
+    }
+
+    for (;;) {
+        if (diskstats_capacity == 0) {
+            diskstats_buffer = malloc(16384);
+            if (diskstats_buffer == NULL) return -1;
+            diskstats_capacity = 16384;
+        }
+
+        ssize_t bytes = pread(diskstats_fd, diskstats_buffer, diskstats_capacity - 1, 0);
+        if (bytes < 0) return -1;
+        if ((size_t)bytes < diskstats_capacity - 1) {
+            diskstats_buffer[bytes] = '\0';
+            diskstats_end = diskstats_buffer + bytes;
+            return bytes;
+        }
+
+        char* grown = realloc(diskstats_buffer, diskstats_capacity * 2);
+        if (grown == NULL) return -1;
+        diskstats_buffer = grown;
+        diskstats_capacity *= 2;
+    }
+}
+
+// Parse "major minor name" at the start of a line; returns the counters
+static const char* parse_device_id(const char* line, unsigned int* major, unsigned int* minor,
+                                   const char** name, size_t* name_len) {
+    const char* p = line;
+    *major = (unsigned int)proc_parse_u64(&p, diskstats_end);
+    *minor = (unsigned int)proc_parse_u64(&p, diskstats_end);
+    *name = proc_skip_fields(p, diskstats_end, 0);
+    p = proc_skip_fields(*name, diskstats_end, 1);
+    while (p > *name && (p[-1] == ' ' || p[-1] == '\n')) p--;
+    *name_len = (size_t)(p - *name);
+    return p;
+}
+
+static void parse_counters(const char* p, struct device_counters* counters) {
+    uint64_t fields[PROC_DISK_FIELD_COUNT] = {0};
+
+    proc_parse_fields(&p, diskstats_end, &proc_diskstats_fields, fields);
+    counters->reads = fields[PROC_DISK_READS];
+    counters->read_sectors = fields[PROC_DISK_READ_SECTORS];
+    counters->read_ms = fields[PROC_DISK_READ_MS];
+    counters->writes = fields[PROC_DISK_WRITES];
+    counters->write_sectors = fields[PROC_DISK_WRITE_SECTORS];
+    counters->write_ms = fields[PROC_DISK_WRITE_MS];
+    counters->in_flight = fields[PROC_DISK_IN_FLIGHT];
+    counters->busy_ms = fields[PROC_DISK_BUSY_MS];
+}
+
+// Rebuild the device table from the buffer just read
+static int rebuild_devices(void) {
+    int count = 0;
+    for (const char* line = diskstats_buffer; line < diskstats_end; line = proc_next_line(line, diskstats_end)) count++;
+
+    if (count > device_capacity) {
+        struct device_entry* grown = realloc(devices, (size_t)count * sizeof(*devices));
+        if (grown == NULL) return -1;
+        devices = grown;
+        device_capacity = count;
+    }
+
+    device_count = 0;
+    for (const char* line = diskstats_buffer; line < diskstats_end; line = proc_next_line(line, diskstats_end)) {
+        struct device_entry* device = &devices[device_count];
+        const char* name;
+        size_t name_len;
+        const char* counters = parse_device_id(line, &device->major, &device->minor, &name, &name_len);
+        if (name_len == 0) continue;
+
+        if (name_len >= DISK_IO_NAME_LEN) name_len = DISK_IO_NAME_LEN - 1;
+        memcpy(device->name, name, name_len);
+        device->name[name_len] = '\0';
+        device->ignored = strncmp(device->name, "loop", 4) == 0 || strncmp(device->name, "ram", 3) == 0;
+
+        // sysfs spells the '/' in names such as cciss/c0d0p1 as '!'
+        char sys_name[DISK_IO_NAME_LEN];
+        memcpy(sys_name, device->name, name_len + 1);
+        for (char* c = sys_name; *c != '\0'; c++) {
+            if (*c == '/') *c = '!';
+        }
+
+        char path[256];
+        snprintf(path, sizeof(path), "%s/%s/partition", sys_block_path, sys_name);
+        device->is_partition = access(path, F_OK) == 0;
+
+        parse_counters(counters, &device->previous);
+        device_count++;
+    }
+    return 0;
+}
+
+static double rate(uint64_t current, uint64_t previous, double seconds) {
+    return current >= previous ? (double)(current - previous) / seconds : 0.0;
+}
+
+int getDiskIo(struct disk_io* out, int capacity, int fold_partitions) {
+    if (out == NULL || capacity < 0) return -1;
+
+    uint64_t start = latency_now_ns();
+    if (read_diskstats() <= 0) {
+        fprintf(stderr, "Error reading disk stats\n");
+        return -1;
+    }
+
+    // First call, or the device set changed: new baseline, no rates yet
+    int changed = device_count == 0;
+    int index = 0;
+    for (const char* line = diskstats_buffer; line < diskstats_end && !changed; line = proc_next_line(line, diskstats_end)) {
+        unsigned int major, minor;
+        const char* name;
+        size_t name_len;
+        parse_device_id(line, &major, &minor, &name, &name_len);
+        if (name_len == 0) continue;
+        if (index >= device_count || devices[index].major != major || devices[index].minor != minor) {
+            changed = 1;
+        }
+        index++;
+    }
+    if (changed || index != device_count) {
+        int result = rebuild_devices();
+        previous_ns = start;
+        latency_record(LATENCY_DISK_IO, start);
+        return result == 0 ? 0 : -1;
+    }
+
+    double seconds = (double)(start - previous_ns) / 1e9;
+    previous_ns = start;
+    if (seconds <= 0) seconds = 1e-9;
+
+    int written = 0;
+    index = 0;
+    for (const char* line = diskstats_buffer; line < diskstats_end; line = proc_next_line(line, diskstats_end)) {
+        unsigned int major, minor;
+        const char* name;
+        size_t name_len;
+        const char* counters_text = parse_device_id(line, &major, &minor, &name, &name_len);
+        if (name_len == 0) continue;
+
+        struct device_entry* device = &devices[index++];
+        struct device_counters current;
+        parse_counters(counters_text, &current);
+
+        // A disk's counters already include its partitions, so folding
+        // partitions into their parent means leaving them out
+        int listed = !device->ignored && !(fold_partitions && device->is_partition);
+        if (listed && written < capacity) {
+            const struct device_counters* previous = &device->previous;
+            struct disk_io* row = &out[written++];
+            uint64_t requests = (current.reads - previous->reads) + (current.writes - previous->writes);
+            uint64_t request_ms = (current.read_ms - previous->read_ms) + (current.write_ms - previous->write_ms);
+
+            row->read_iops = rate(current.reads, previous->reads, seconds);
+            row->write_iops = rate(current.writes, previous->writes, seconds);
+            row->read_bytes_per_sec = rate(current.read_sectors, previous->read_sectors, seconds) * SECTOR_BYTES;
+            row->write_bytes_per_sec = rate(current.write_sectors, previous->write_sectors, seconds) * SECTOR_BYTES;
+            row->await_ms = requests > 0 ? (double)request_ms / (double)requests : 0.0;
+            row->utilization = rate(current.busy_ms, previous->busy_ms, seconds) / 10.0;
+            if (row->utilization > 100.0) row->utilization = 100.0;
+            row->in_flight = (int32_t)current.in_flight;
+            row->is_partition = device->is_partition;
+            memcpy(row->name, device->name, DISK_IO_NAME_LEN);
+        }
+        device->previous = current;
+    }
+
+    latency_record(LATENCY_DISK_IO, start);
+    return written;
+}
+
+void disk_io_set_sources(const char* new_diskstats_path, const char* new_sys_block_path) {
+    disk_io_cleanup();
+    diskstats_path = new_diskstats_path;
+    sys_block_path = new_sys_block_path;
+}
+
+void disk_io_cleanup() {
+    if (diskstats_fd >= 0) close(diskstats_fd);
+    diskstats_fd = -1;
+    free(diskstats_buffer);
+    free(devices);
+    diskstats_buffer = NULL;
+    diskstats_end = NULL;
+    diskstats_capacity = 0;
+    devices = NULL;
+    device_count = 0;
+    device_capacity = 0;
+    previous_ns = 0;
+}
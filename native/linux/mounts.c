@@ -0,0 +1,263 @@
+#define _GNU_SOURCE
+#include <fcntl.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/statfs.h>
+#include <unistd.h>
+
+#include "../common/latency.h"
+#include "../common/mount_usage.h"
+
+// Mounts are read from /proc/self/mountinfo, which stays open. The kernel
+// flags the descriptor with POLLPRI whenever the mount table changes, so the
+// filtered list is only rebuilt after a mount or unmount.
+struct cached_mount {
+    struct mount_usage usage;
+    char* path;                   // Full mount point for statfs()
+    unsigned int major;
+    unsigned int minor;
+    int whole_filesystem;         // Mounted from the filesystem root, not a bind of a subdirectory
+};
+
+static int mountinfo_fd = -1;
+static char* mountinfo_buffer = NULL;
+static size_t mountinfo_capacity = 0;
+// Set until a rebuild succeeds, so a failed read is retried on the next
+// call rather than waiting for the next mount change
+static int mounts_stale = 1;
+
+static struct cached_mount* mounts = NULL;
+static int mount_count = 0;
+static int mount_capacity = 0;
+
+// Pseudo and memory-backed filesystems that do not hold user data
+static const char* const ignored_types[] = {
+    "autofs", "binfmt_misc", "bpf", "cgroup", "cgroup2", "configfs", "debugfs",
+    "devpts", "devtmpfs", "efivarfs", "fusectl", "hugetlbfs", "mqueue", "nsfs",
+    "proc", "pstore", "ramfs", "rpc_pipefs", "securityfs", "selinuxfs",
+    "squashfs", "sysfs", "tmpfs", "tracefs",
+};
+
+static int is_ignored_type(const char* type) {
+    for (size_t i = 0; i < sizeof(ignored_types) / sizeof(ignored_types[0]); i++) {
+        if (strcmp(type, ignored_types[i]) == 0) return 1;
+    }
+    // Desktop FUSE helpers (gvfs, portals) are not storage
+    return strncmp(type, "fuse.gvfs", 9) == 0 || strcmp(type, "fuse.portal") == 0;
+}
+
+// Split off the next space-separated field, NUL-terminating it in place
+static char* next_field(char** cursor) {
+    char* p = *cursor;
+    while (*p == ' ') p++;
+    char* start = p;
+    while (*p != ' ' && *p != '\0') p++;
+    if (*p == ' ') *p++ = '\0';
+    *cursor = p;
+    return start;
+}
+
+// Undo the octal escapes mountinfo uses for spaces, tabs, newlines and
+// backslashes in paths
+static void unescape(char* s) {
+    char* out = s;
+    while (*s != '\0') {
+        if (s[0] == '\\' && s[1] >= '0' && s[1] <= '3' && s[2] >= '0' && s[2] <= '7' &&
+            s[3] >= '0' && s[3] <= '7') {
+            *out++ = (char)((s[1] - '0') * 64 + (s[2] - '0') * 8 + (s[3] - '0'));
+            s += 4;
+        } else {
+            *out++ = *s++;
+        }
+    }
+    *out = '\0';
+}
+
+static void copy_field(char* dst, size_t size, const char* src) {
+    snprintf(dst, size, "%.*s", (int)size - 1, src);
+}
+
+// Read the whole file; the read also clears the pending change notification
+static ssize_t read_mountinfo(void) {
+    size_t length = 0;
+
+    for (;;) {
+        if (length + 1 >= mountinfo_capacity) {
+            size_t grown = mountinfo_capacity ? mountinfo_capacity * 2 : 65536;
+            char* buffer = realloc(mountinfo_buffer, grown);
+            if (buffer == NULL) return -1;
+            mountinfo_buffer = buffer;
+            mountinfo_capacity = grown;
+        }
+
+        ssize_t bytes = pread(mountinfo_fd, mountinfo_buffer + length,
+                              mountinfo_capacity - length - 1, (off_t)length);
+        if (bytes < 0) return -1;
+        if (bytes == 0) break;
+        length += (size_t)bytes;
+    }
+
+    mountinfo_buffer[length] = '\0';
+    return (ssize_t)length;
+}
+
+static void clear_mounts(void) {
+    for (int i = 0; i < mount_count; i++) {
+        free(mounts[i].path);
+    }
+    mount_count = 0;
+}
+
+static struct cached_mount* find_device(unsigned int major, unsigned int minor) {
+    for (int i = 0; i < mount_count; i++) {
+        if (mounts[i].major == major && mounts[i].minor == minor) return &mounts[i];
+    }
+    return NULL;
+}
+
+// Parse one mountinfo line:
+// 36 35 98:0 /mnt1 /mnt/parent rw,noatime master:1 - ext3 /dev/root rw,errors=continue
+static void add_mount_line(char* line) {
+    char* cursor = line;
+    unsigned int major, minor;
+
+    next_field(&cursor);                      // mount ID
+    next_field(&cursor);                      // parent ID
+    if (sscanf(next_field(&cursor), "%u:%u", &major, &minor) != 2) return;
+    char* root = next_field(&cursor);
+    char* path = next_field(&cursor);
+    next_field(&cursor);                      // mount options
+
+    // Optional fields run up to a lone "-"
+    char* field;
+    do {
+        field = next_field(&cursor);
+    } while (field[0] != '\0' && strcmp(field, "-") != 0);
+    if (field[0] == '\0') return;
+
+    char* type = next_field(&cursor);
+    char* source = next_field(&cursor);
+    if (is_ignored_type(type)) return;
+
+    unescape(root);
+    unescape(path);
+    unescape(source);
+    int whole = strcmp(root, "/") == 0;
+
+    // Bind mounts share the device of the filesystem they expose; report
+    // each filesystem once, preferring its root mount, then the shortest path
+    struct cached_mount* existing = find_device(major, minor);
+    if (existing != NULL) {
+        int better = whole > existing->whole_filesystem ||
+                     (whole == existing->whole_filesystem && strlen(path) < strlen(existing->path));
+        if (!better) return;
+        free(existing->path);
+        existing->path = NULL;
+    } else {
+        if (mount_count == mount_capacity) {
+            int grown = mount_capacity ? mount_capacity * 2 : 32;
+            struct cached_mount* resized = realloc(mounts, (size_t)grown * sizeof(*mounts));
+            if (resized == NULL) return;
+            mounts = resized;
+            mount_capacity = grown;
+        }
+        existing = &mounts[mount_count++];
+        memset(existing, 0, sizeof(*existing));
+    }
+
+    existing->path = strdup(path);
+    if (existing->path == NULL) {
+        *existing = mounts[--mount_count];
+        return;
+    }
+    existing->major = major;
+    existing->minor = minor;
+    existing->whole_filesystem = whole;
+    copy_field(existing->usage.mount_point, sizeof(existing->usage.mount_point), path);
+    copy_field(existing->usage.fs_type, sizeof(existing->usage.fs_type), type);
+    copy_field(existing->usage.device, sizeof(existing->usage.device), source);
+}
+
+static int compare_mounts(const void* a, const void* b) {
+    return strcmp(((const struct cached_mount*)a)->path, ((const struct cached_mount*)b)->path);
+}
+
+static int rebuild_mounts(void) {
+    if (read_mountinfo() < 0) return -1;
+
+    clear_mounts();
+    char* line = mountinfo_buffer;
+    while (*line != '\0') {
+        char* end = strchr(line, '\n');
+        if (end != NULL) *end = '\0';
+        add_mount_line(line);
+        if (end == NULL) break;
+        line = end + 1;
+    }
+
+    if (mount_count > 1) qsort(mounts, (size_t)mount_count, sizeof(*mounts), compare_mounts);
+    return 0;
+}
+
+// True if the mount table changed since it was last read
+static int mounts_changed(void) {
+    struct pollfd watch = {.fd = mountinfo_fd, .events = POLLPRI};
+    return poll(&watch, 1, 0) > 0 && (watch.revents & (POLLPRI | POLLERR)) != 0;
+}
+
+int getMountUsage(struct mount_usage* out, int capacity) {
+    if (out == NULL || capacity < 0) return -1;
+
+    if (mountinfo_fd < 0) {
+        mountinfo_fd = open("/proc/self/mountinfo", O_RDONLY | O_CLOEXEC);
+        if (mountinfo_fd < 0) {
+            fprintf(stderr, "Error opening mount table\n");
+            return -1;
+        }
+        mounts_stale = 1;
+    }
+    if (mounts_changed()) mounts_stale = 1;
+    if (mounts_stale) {
+        if (rebuild_mounts() != 0) {
+            fprintf(stderr, "Error reading mount table\n");
+            return -1;
+        }
+        mounts_stale = 0;
+    }
+
+    uint64_t start = latency_now_ns();
+    int written = 0;
+    for (int i = 0; i < mount_count && written < capacity; i++) {
+        struct statfs stats;
+        if (statfs(mounts[i].path, &stats) != 0 || stats.f_blocks == 0) continue;
+
+        double block_mb = (double)stats.f_bsize / (1024.0 * 1024.0);
+        double used = (double)(stats.f_blocks - stats.f_bfree) * block_mb;
+        double available = (double)stats.f_bavail * block_mb;
+
+        struct mount_usage* row = &out[written++];
+        *row = mounts[i].usage;
+        row->total_mb = (double)stats.f_blocks * block_mb;
+        row->used_mb = used;
+        row->available_mb = available;
+        row->usage_percent = used + available > 0 ? used / (used + available) * 100.0 : 0.0;
+    }
+
+    latency_record(LATENCY_MOUNTS, start);
+    return written;
+}
+
+void mount_usage_cleanup() {
+    clear_mounts();
+    free(mounts);
+    free(mountinfo_buffer);
+    mounts = NULL;
+    mount_capacity = 0;
+    mountinfo_buffer = NULL;
+    mountinfo_capacity = 0;
+    if (mountinfo_fd >= 0) close(mountinfo_fd);
+    mountinfo_fd = -1;
+    mounts_stale = 1;
+}
@@ -0,0 +1,287 @@
+#define _GNU_SOURCE
+#include <dirent.h>
+#include <fcntl.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "cpu_monitor.h"
+#include "proc_parse.h"
+
+// Counters come from /proc/net/dev, re-read through a persistent descriptor
+// into one buffer. Each tick parses into a scratch table and compares it by
+// name, position for position, with the table from the previous tick; only
+// when the interface set changes is the scratch table taken as a new
+// baseline. Neither step allocates once the tables have grown to size.
+//
+// Without /proc/net/dev (or when tests ask for it), the counters are read
+// from /sys/class/net/<name>/statistics instead. That costs eight small file
+// reads per interface, so it is only a fallback.
+
+struct iface_counters {
+    uint64_t rx_bytes;
+    uint64_t rx_packets;
+    uint64_t rx_errors;
+    uint64_t rx_drops;
+    uint64_t tx_bytes;
+    uint64_t tx_packets;
+    uint64_t tx_errors;
+    uint64_t tx_drops;
+};
+
+struct iface_entry {
+    char name[NET_IO_NAME_LEN];
+    struct iface_counters counters;
+};
+
+static const struct {
+    const char* file;
+    size_t offset;
+} sysfs_counters[] = {
+    {"rx_bytes", offsetof(struct iface_counters, rx_bytes)},
+    {"rx_packets", offsetof(struct iface_counters, rx_packets)},
+    {"rx_errors", offsetof(struct iface_counters, rx_errors)},
+    {"rx_dropped", offsetof(struct iface_counters, rx_drops)},
+    {"tx_bytes", offsetof(struct iface_counters, tx_bytes)},
+    {"tx_packets", offsetof(struct iface_counters, tx_packets)},
+    {"tx_errors", offsetof(struct iface_counters, tx_errors)},
+    {"tx_dropped", offsetof(struct iface_counters, tx_drops)},
+};
+
+static const char* proc_net_dev_path = "/proc/net/dev";
+static const char* sys_net_path = "/sys/class/net";
+
+static int net_dev_fd = -1;
+static char* net_dev_buffer = NULL;
+static size_t net_dev_capacity = 0;
+static DIR* sys_net_dir = NULL;
+
+// `ifaces` holds the previous tick, `scratch` the one being read
+static struct iface_entry* ifaces = NULL;
+static struct iface_entry* scratch = NULL;
+static int iface_count = 0;
+static int iface_capacity = 0;
+static uint64_t previous_ns = 0;
+
+// Make room for `count` entries in both tables
+static int reserve_ifaces(int count) {
+    if (count <= iface_capacity) return 0;
+
+    int grown = iface_capacity ? iface_capacity : 16;
+    while (grown < count) grown *= 2;
+    struct iface_entry* resized = realloc(ifaces, (size_t)grown * sizeof(*ifaces));
+    if (resized == NULL) return -1;
+    ifaces = resized;
+    resized = realloc(scratch, (size_t)grown * sizeof(*scratch));
+    if (resized == NULL) return -1;
+    scratch = resized;
+    iface_capacity = grown;
+    return 0;
+}
+
+static ssize_t read_net_dev(void) {
+    for (;;) {
+        if (net_dev_capacity == 0) {
+            net_dev_buffer = malloc(16384);
+            if (net_dev_buffer == NULL) return -1;
+            net_dev_capacity = 16384;
+        }
+
+        ssize_t bytes = pread(net_dev_fd, net_dev_buffer, net_dev_capacity - 1, 0);
+        if (bytes < 0) return -1;
+        if ((size_t)bytes < net_dev_capacity - 1) {
+            net_dev_buffer[bytes] = '\0';
+            return bytes;
+        }
+
+        char* grown = realloc(net_dev_buffer, net_dev_capacity * 2);
+        if (grown == NULL) return -1;
+        net_dev_buffer = grown;
+        net_dev_capacity *= 2;
+    }
+}
+
+// Parse /proc/net/dev into the scratch table; returns the interface count.
+// After two header lines, each line is
+//   name: rx_bytes packets errs drop fifo frame compressed multicast
+//         tx_bytes packets errs drop fifo colls carrier compressed
+static int scan_proc_net_dev(void) {
+    ssize_t bytes = read_net_dev();
+    if (bytes < 0) return -1;
+
+    int count = 0;
+    const char* end = net_dev_buffer + bytes;
+    const char* line = proc_next_line(proc_next_line(net_dev_buffer, end), end);
+
+    while (line < end) {
+        const char* next = proc_next_line(line, end);
+        const char* colon = memchr(line, ':', (size_t)(next - line));
+        if (colon == NULL) break;
+
+        const char* name = line;
+        while (*name == ' ') name++;
+        size_t name_len = colon > name ? (size_t)(colon - name) : 0;
+        if (name_len >= NET_IO_NAME_LEN) name_len = NET_IO_NAME_LEN - 1;
+
+        if (count == iface_capacity && reserve_ifaces(count + 1) != 0) return -1;
+        struct iface_entry* entry = &scratch[count++];
+        memcpy(entry->name, name, name_len);
+        entry->name[name_len] = '\0';
+
+        const char* p = colon + 1;
+        uint64_t fields[PROC_NET_FIELD_COUNT] = {0};
+        proc_parse_fields(&p, end, &proc_net_dev_fields, fields);
+
+        struct iface_counters* counters = &entry->counters;
+        counters->rx_bytes = fields[PROC_NET_RX_BYTES];
+        counters->rx_packets = fields[PROC_NET_RX_PACKETS];
+        counters->rx_errors = fields[PROC_NET_RX_ERRORS];
+        counters->rx_drops = fields[PROC_NET_RX_DROPS];
+        counters->tx_bytes = fields[PROC_NET_TX_BYTES];
+        counters->tx_packets = fields[PROC_NET_TX_PACKETS];
+        counters->tx_errors = fields[PROC_NET_TX_ERRORS];
+        counters->tx_drops = fields[PROC_NET_TX_DROPS];
+
+        line = next;
+    }
+    return count;
+}
+
+static uint64_t read_sysfs_counter(int dir_fd, const char* name) {
+    char text[32];
+    int fd = openat(dir_fd, name, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return 0;
+
+    ssize_t bytes = read(fd, text, sizeof(text) - 1);
+    close(fd);
+    if (bytes <= 0) return 0;
+
+    const char* p = text;
+    return proc_parse_u64(&p, text + bytes);
+}
+
+static int compare_ifaces(const void* a, const void* b) {
+    return strcmp(((const struct iface_entry*)a)->name, ((const struct iface_entry*)b)->name);
+}
+
+// Read /sys/class/net/*/statistics into the scratch table, ordered by name
+// so that directory order cannot look like an interface change
+static int scan_sysfs(void) {
+    if (sys_net_dir == NULL) {
+        sys_net_dir = opendir(sys_net_path);
+        if (sys_net_dir == NULL) return -1;
+    } else {
+        rewinddir(sys_net_dir);
+    }
+
+    int count = 0;
+    struct dirent* dirent;
+    while ((dirent = readdir(sys_net_dir)) != NULL) {
+        if (dirent->d_name[0] == '.') continue;
+
+        char path[64];
+        snprintf(path, sizeof(path), "%.*s/statistics", NET_IO_NAME_LEN - 1, dirent->d_name);
+        int stats_fd = openat(dirfd(sys_net_dir), path, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        if (stats_fd < 0) continue;
+
+        if (reserve_ifaces(count + 1) != 0) {
+            close(stats_fd);
+            return -1;
+        }
+        struct iface_entry* entry = &scratch[count++];
+        snprintf(entry->name, sizeof(entry->name), "%.*s", NET_IO_NAME_LEN - 1, dirent->d_name);
+
+        for (size_t i = 0; i < sizeof(sysfs_counters) / sizeof(sysfs_counters[0]); i++) {
+            uint64_t* counter = (uint64_t*)((char*)&entry->counters + sysfs_counters[i].offset);
+            *counter = read_sysfs_counter(stats_fd, sysfs_counters[i].file);
+        }
+        close(stats_fd);
+    }
+
+    qsort(scratch, (size_t)count, sizeof(*scratch), compare_ifaces);
+    return count;
+}
+
+static int scan_interfaces(void) {
+    if (net_dev_fd < 0 && proc_net_dev_path != NULL) {
+        net_dev_fd = open(proc_net_dev_path, O_RDONLY | O_CLOEXEC);
+    }
+    return net_dev_fd >= 0 ? scan_proc_net_dev() : scan_sysfs();
+}
+
+static double rate(uint64_t current, uint64_t previous, double seconds) {
+    return current >= previous ? (double)(current - previous) / seconds : 0.0;
+}
+
+int getNetworkIo(struct net_io* out, int capacity) {
+    if (out == NULL || capacity < 0) return -1;
+
+    uint64_t start = latency_now_ns();
+    int count = scan_interfaces();
+    if (count < 0) {
+        fprintf(stderr, "Error reading network statistics\n");
+        return -1;
+    }
+
+    int changed = previous_ns == 0 || count != iface_count;
+    for (int i = 0; i < count && !changed; i++) {
+        changed = strcmp(scratch[i].name, ifaces[i].name) != 0;
+    }
+
+    double seconds = (double)(start - previous_ns) / 1e9;
+    if (seconds <= 0) seconds = 1e-9;
+    previous_ns = start;
+
+    int written = 0;
+    if (!changed) {
+        for (int i = 0; i < count && written < capacity; i++) {
+            const struct iface_counters* current = &scratch[i].counters;
+            const struct iface_counters* previous = &ifaces[i].counters;
+            struct net_io* row = &out[written++];
+
+            row->rx_bytes_per_sec = rate(current->rx_bytes, previous->rx_bytes, seconds);
+            row->tx_bytes_per_sec = rate(current->tx_bytes, previous->tx_bytes, seconds);
+            row->rx_packets_per_sec = rate(current->rx_packets, previous->rx_packets, seconds);
+            row->tx_packets_per_sec = rate(current->tx_packets, previous->tx_packets, seconds);
+            row->rx_errors_per_sec = rate(current->rx_errors, previous->rx_errors, seconds);
+            row->tx_errors_per_sec = rate(current->tx_errors, previous->tx_errors, seconds);
+            row->rx_drops_per_sec = rate(current->rx_drops, previous->rx_drops, seconds);
+            row->tx_drops_per_sec = rate(current->tx_drops, previous->tx_drops, seconds);
+            memcpy(row->name, scratch[i].name, NET_IO_NAME_LEN);
+        }
+    }
+
+    // This tick becomes the baseline for the next
+    struct iface_entry* swap = ifaces;
+    ifaces = scratch;
+    scratch = swap;
+    iface_count = count;
+
+    latency_record(LATENCY_NETWORK, start);
+    return written;
+}
+
+void net_io_set_sources(const char* new_proc_net_dev_path, const char* new_sys_net_path) {
+    net_io_cleanup();
+    proc_net_dev_path = new_proc_net_dev_path;
+    sys_net_path = new_sys_net_path;
+}
+
+void net_io_cleanup() {
+    if (net_dev_fd >= 0) close(net_dev_fd);
+    net_dev_fd = -1;
+    if (sys_net_dir != NULL) closedir(sys_net_dir);
+    sys_net_dir = NULL;
+    free(net_dev_buffer);
+    free(ifaces);
+    free(scratch);
+    net_dev_buffer = NULL;
+    net_dev_capacity = 0;
+    ifaces = NULL;
+    scratch = NULL;
+    iface_count = 0;
+    iface_capacity = 0;
+    previous_ns = 0;
+}
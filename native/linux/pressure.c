@@ -0,0 +1,444 @@
+#define _GNU_SOURCE
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/eventfd.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "cpu_monitor.h"
+#include "proc_parse.h"
+
+// Each kernel trigger is its own descriptor on /proc/pressure/<resource>,
+// opened O_RDWR with "some|full <stall us> <window us>" written to it; the
+// kernel then raises POLLPRI at most once per window while the threshold is
+// exceeded. The monitor thread polls those descriptors plus an eventfd used
+// to stop it or re-arm after the trigger list changes, with no timeout.
+//
+// A trigger the kernel refuses (no CONFIG_PSI triggers, no permission,
+// container filesystems) is polled instead: once per window the thread
+// compares the stall total with the previous check, which is the same test
+// the kernel applies.
+
+static const char* const resource_names[PRESSURE_RESOURCE_COUNT] = {"cpu", "memory", "io"};
+
+// Averages, read through persistent descriptors guarded by read_lock
+static pthread_mutex_t read_lock = PTHREAD_MUTEX_INITIALIZER;
+static char pressure_dir[256] = "/proc/pressure";
+static int forced_polling = 0;
+static int average_fds[PRESSURE_RESOURCE_COUNT] = {-1, -1, -1};
+
+struct trigger {
+    int32_t resource;
+    int32_t full;
+    uint32_t stall_us;
+    uint32_t window_us;
+    int fd;                       // Kernel trigger, or -1 when polled
+    int has_baseline;             // Polled: last_total_us is valid
+    uint64_t last_total_us;       // Polled: stall total at the last check
+    uint64_t next_check_ns;
+};
+
+// Monitor thread state, guarded by control_lock
+static pthread_mutex_t control_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_t monitor_thread;
+static int monitor_running = 0;
+static int stop_requested = 0;
+static int rearm_requested = 0;
+static int wake_fd = -1;
+static pressure_callback monitor_callback = NULL;
+static struct trigger triggers[PRESSURE_MAX_TRIGGERS];
+static int trigger_count = 0;
+
+// Recent events, guarded by event_lock
+static pthread_mutex_t event_lock = PTHREAD_MUTEX_INITIALIZER;
+static struct pressure_event events[PRESSURE_EVENT_CAPACITY];
+static uint64_t event_sequence = 0;
+
+static uint64_t monotonic_ns(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000ull + (uint64_t)now.tv_nsec;
+}
+
+static int64_t wall_ms(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_REALTIME, &now);
+    return (int64_t)now.tv_sec * 1000 + now.tv_nsec / 1000000;
+}
+
+// "some avg10=1.23 avg60=0.50 avg300=0.08 total=123456"
+static void parse_line(const char* p, const char* end, double averages[3], uint64_t* total) {
+    for (int i = 0; i < 4; i++) {
+        const char* equals = memchr(p, '=', (size_t)(end - p));
+        if (equals == NULL) return;
+        p = equals + 1;
+
+        uint64_t whole = proc_parse_u64(&p, end);
+        if (i == 3) {
+            *total = whole;
+            return;
+        }
+
+        double value = (double)whole;
+        if (p < end && *p == '.') {
+            const char* fraction = ++p;
+            uint64_t digits = proc_parse_u64(&p, end);
+            double scale = 1.0;
+            for (; fraction < p; fraction++) scale *= 10.0;
+            value += (double)digits / scale;
+        }
+        averages[i] = value;
+    }
+}
+
+static int read_stats_locked(int resource, struct pressure_stats* out) {
+    char buffer[256];
+
+    if (average_fds[resource] < 0) {
+        char path[320];
+        snprintf(path, sizeof(path), "%s/%s", pressure_dir, resource_names[resource]);
+        average_fds[resource] = open(path, O_RDONLY | O_CLOEXEC);
+        if (average_fds[resource] < 0) return -1;
+    }
+
+    ssize_t bytes = pread(average_fds[resource], buffer, sizeof(buffer), 0);
+    if (bytes <= 0) return -1;
+
+    const char* end = buffer + bytes;
+    double some[3] = {0};
+    double full[3] = {0};
+    int found = 0;
+
+    memset(out, 0, sizeof(*out));
+    for (const char* line = buffer; line < end; line = proc_next_line(line, end)) {
+        const char* line_end = proc_next_line(line, end);
+        if (line_end - line < 4) continue;
+        if (memcmp(line, "some", 4) == 0) {
+            parse_line(line, line_end, some, &out->some_total_us);
+            found++;
+        } else if (memcmp(line, "full", 4) == 0) {
+            parse_line(line, line_end, full, &out->full_total_us);
+            out->has_full = 1;
+            found++;
+        }
+    }
+
+    out->some_avg10 = some[0];
+    out->some_avg60 = some[1];
+    out->some_avg300 = some[2];
+    out->full_avg10 = full[0];
+    out->full_avg60 = full[1];
+    out->full_avg300 = full[2];
+    return found > 0 ? 0 : -1;
+}
+
+int getPressure(int resource, struct pressure_stats* out) {
+    if (resource < 0 || resource >= PRESSURE_RESOURCE_COUNT || out == NULL) return -1;
+
+    pthread_mutex_lock(&read_lock);
+    int result = read_stats_locked(resource, out);
+    pthread_mutex_unlock(&read_lock);
+    return result;
+}
+
+// Record an event and tell the listener. `stats` may be NULL when the
+// averages have not been read yet.
+static void fire(const struct trigger* trigger, const struct pressure_stats* stats) {
+    struct pressure_stats current;
+
+    if (stats == NULL && getPressure(trigger->resource, &current) == 0) stats = &current;
+
+    pthread_mutex_lock(&event_lock);
+    uint64_t sequence = ++event_sequence;
+    struct pressure_event* event = &events[(sequence - 1) % PRESSURE_EVENT_CAPACITY];
+    event->sequence = sequence;
+    event->timestamp_ms = wall_ms();
+    event->resource = trigger->resource;
+    event->full = trigger->full;
+    event->avg10 = stats == NULL ? 0.0 : trigger->full ? stats->full_avg10 : stats->some_avg10;
+    event->threshold_percent = (double)trigger->stall_us / (double)trigger->window_us * 100.0;
+    pthread_mutex_unlock(&event_lock);
+
+    if (monitor_callback != NULL) monitor_callback(trigger->resource);
+}
+
+// Take the baseline on the next pass of the monitor loop
+static void start_polling(struct trigger* trigger, uint64_t now_ns) {
+    trigger->has_baseline = 0;
+    trigger->next_check_ns = now_ns;
+}
+
+// An unreadable file drops the baseline and is retried a window later
+static void check_polled(struct trigger* trigger, uint64_t now_ns) {
+    struct pressure_stats stats;
+
+    if (getPressure(trigger->resource, &stats) == 0) {
+        uint64_t total = trigger->full ? stats.full_total_us : stats.some_total_us;
+        if (trigger->has_baseline && total - trigger->last_total_us >= trigger->stall_us) fire(trigger, &stats);
+        trigger->last_total_us = total;
+        trigger->has_baseline = 1;
+    } else {
+        trigger->has_baseline = 0;
+    }
+
+    uint64_t window_ns = (uint64_t)trigger->window_us * 1000;
+    trigger->next_check_ns += window_ns;
+    if (trigger->next_check_ns <= now_ns) trigger->next_check_ns = now_ns + window_ns;
+}
+
+// Register each trigger with the kernel, or fall back to polling it
+static void arm(struct trigger* armed, int count) {
+    int polling;
+    char dir[sizeof(pressure_dir)];
+
+    pthread_mutex_lock(&read_lock);
+    polling = forced_polling;
+    memcpy(dir, pressure_dir, sizeof(dir));
+    pthread_mutex_unlock(&read_lock);
+
+    uint64_t now_ns = monotonic_ns();
+    for (int i = 0; i < count; i++) {
+        struct trigger* trigger = &armed[i];
+        trigger->fd = -1;
+
+        if (!polling) {
+            char path[320];
+            char command[64];
+            snprintf(path, sizeof(path), "%s/%s", dir, resource_names[trigger->resource]);
+            int length = snprintf(command, sizeof(command), "%s %u %u", trigger->full ? "full" : "some",
+                                  trigger->stall_us, trigger->window_us);
+
+            int fd = open(path, O_RDWR | O_NONBLOCK | O_CLOEXEC);
+            if (fd >= 0 && write(fd, command, (size_t)length + 1) == length + 1) {
+                trigger->fd = fd;
+                continue;
+            }
+            if (fd >= 0) close(fd);
+        }
+        start_polling(trigger, now_ns);
+    }
+}
+
+static void disarm(struct trigger* armed, int count) {
+    for (int i = 0; i < count; i++) {
+        if (armed[i].fd >= 0) close(armed[i].fd);
+        armed[i].fd = -1;
+    }
+}
+
+static void wake_monitor(void) {
+    uint64_t one = 1;
+    if (write(wake_fd, &one, sizeof(one)) != sizeof(one)) {
+        fprintf(stderr, "Error waking pressure monitor\n");
+    }
+}
+
+static void* monitor_main(void* arg) {
+    struct trigger armed[PRESSURE_MAX_TRIGGERS];
+    struct pollfd fds[PRESSURE_MAX_TRIGGERS + 1];
+    int slots[PRESSURE_MAX_TRIGGERS + 1];        // Trigger behind fds[i]
+    int armed_count = 0;
+    (void)arg;
+
+    pthread_mutex_lock(&control_lock);
+    while (!stop_requested) {
+        if (rearm_requested) {
+            rearm_requested = 0;
+            disarm(armed, armed_count);
+            armed_count = trigger_count;
+            memcpy(armed, triggers, sizeof(triggers[0]) * (size_t)armed_count);
+            pthread_mutex_unlock(&control_lock);
+            arm(armed, armed_count);
+            pthread_mutex_lock(&control_lock);
+            continue;
+        }
+        pthread_mutex_unlock(&control_lock);
+
+        // Sleep until a kernel trigger fires, the next polled check is due,
+        // or stop / re-arm is requested
+        int nfds = 0;
+        int timeout_ms = -1;
+        uint64_t now_ns = monotonic_ns();
+        fds[nfds].fd = wake_fd;
+        fds[nfds].events = POLLIN;
+        slots[nfds++] = -1;
+        for (int i = 0; i < armed_count; i++) {
+            if (armed[i].fd >= 0) {
+                fds[nfds].fd = armed[i].fd;
+                fds[nfds].events = POLLPRI;
+                slots[nfds++] = i;
+            } else {
+                uint64_t wait_ns = armed[i].next_check_ns > now_ns ? armed[i].next_check_ns - now_ns : 0;
+                int wait_ms = (int)((wait_ns + 999999) / 1000000);
+                if (timeout_ms < 0 || wait_ms < timeout_ms) timeout_ms = wait_ms;
+            }
+        }
+
+        int ready = poll(fds, (nfds_t)nfds, timeout_ms);
+        if (ready < 0 && errno != EINTR) {
+            fprintf(stderr, "Error polling pressure triggers: %s\n", strerror(errno));
+            pthread_mutex_lock(&control_lock);
+            break;
+        }
+
+        if (ready > 0) {
+            if (fds[0].revents & POLLIN) {
+                uint64_t count;
+                if (read(wake_fd, &count, sizeof(count)) < 0 && errno != EAGAIN) {
+                    fprintf(stderr, "Error reading pressure monitor wakeup\n");
+                }
+            }
+            for (int j = 1; j < nfds; j++) {
+                struct trigger* trigger = &armed[slots[j]];
+                if (fds[j].revents & POLLERR) {
+                    // The kernel dropped the trigger; keep watching by polling
+                    close(trigger->fd);
+                    trigger->fd = -1;
+                    start_polling(trigger, monotonic_ns());
+                } else if (fds[j].revents & POLLPRI) {
+                    fire(trigger, NULL);
+                }
+            }
+        }
+
+        now_ns = monotonic_ns();
+        for (int i = 0; i < armed_count; i++) {
+            if (armed[i].fd < 0 && armed[i].next_check_ns <= now_ns) check_polled(&armed[i], now_ns);
+        }
+
+        pthread_mutex_lock(&control_lock);
+    }
+    pthread_mutex_unlock(&control_lock);
+
+    disarm(armed, armed_count);
+    return NULL;
+}
+
+int addPressureTrigger(int resource, int full, int stall_us, int window_us) {
+    if (resource < 0 || resource >= PRESSURE_RESOURCE_COUNT) return -1;
+    if (window_us < PRESSURE_MIN_WINDOW_US || window_us > PRESSURE_MAX_WINDOW_US) return -1;
+    if (stall_us <= 0 || stall_us > window_us) return -1;
+
+    pthread_mutex_lock(&control_lock);
+    if (trigger_count == PRESSURE_MAX_TRIGGERS) {
+        pthread_mutex_unlock(&control_lock);
+        return -1;
+    }
+    struct trigger* trigger = &triggers[trigger_count++];
+    memset(trigger, 0, sizeof(*trigger));
+    trigger->resource = resource;
+    trigger->full = full != 0;
+    trigger->stall_us = (uint32_t)stall_us;
+    trigger->window_us = (uint32_t)window_us;
+    trigger->fd = -1;
+    if (monitor_running) {
+        rearm_requested = 1;
+        wake_monitor();
+    }
+    pthread_mutex_unlock(&control_lock);
+    return 0;
+}
+
+void clearPressureTriggers() {
+    pthread_mutex_lock(&control_lock);
+    trigger_count = 0;
+    if (monitor_running) {
+        rearm_requested = 1;
+        wake_monitor();
+    }
+    pthread_mutex_unlock(&control_lock);
+}
+
+int startPressureMonitor(pressure_callback callback) {
+    pthread_mutex_lock(&control_lock);
+    if (monitor_running) {
+        pthread_mutex_unlock(&control_lock);
+        return 0;
+    }
+
+    wake_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (wake_fd < 0) {
+        fprintf(stderr, "Error creating pressure monitor eventfd: %s\n", strerror(errno));
+        pthread_mutex_unlock(&control_lock);
+        return -1;
+    }
+
+    stop_requested = 0;
+    rearm_requested = 1;
+    monitor_callback = callback;
+    if (pthread_create(&monitor_thread, NULL, monitor_main, NULL) != 0) {
+        fprintf(stderr, "Error starting pressure monitor thread\n");
+        close(wake_fd);
+        wake_fd = -1;
+        pthread_mutex_unlock(&control_lock);
+        return -1;
+    }
+    monitor_running = 1;
+    pthread_mutex_unlock(&control_lock);
+    return 0;
+}
+
+void stopPressureMonitor() {
+    pthread_mutex_lock(&control_lock);
+    if (!monitor_running) {
+        pthread_mutex_unlock(&control_lock);
+        return;
+    }
+    stop_requested = 1;
+    wake_monitor();
+    pthread_mutex_unlock(&control_lock);
+
+    pthread_join(monitor_thread, NULL);
+
+    pthread_mutex_lock(&control_lock);
+    monitor_running = 0;
+    close(wake_fd);
+    wake_fd = -1;
+    pthread_mutex_unlock(&control_lock);
+}
+
+int readPressureEvents(struct pressure_event* out, int capacity, uint64_t after_sequence) {
+    if (out == NULL || capacity < 0) return -1;
+
+    pthread_mutex_lock(&event_lock);
+    uint64_t oldest = event_sequence > PRESSURE_EVENT_CAPACITY ? event_sequence - PRESSURE_EVENT_CAPACITY + 1 : 1;
+    uint64_t sequence = after_sequence + 1 > oldest ? after_sequence + 1 : oldest;
+    int written = 0;
+    for (; sequence <= event_sequence && written < capacity; sequence++) {
+        out[written++] = events[(sequence - 1) % PRESSURE_EVENT_CAPACITY];
+    }
+    pthread_mutex_unlock(&event_lock);
+    return written;
+}
+
+static void close_average_fds_locked(void) {
+    for (int i = 0; i < PRESSURE_RESOURCE_COUNT; i++) {
+        if (average_fds[i] >= 0) close(average_fds[i]);
+        average_fds[i] = -1;
+    }
+}
+
+void pressure_set_sources(const char* dir) {
+    pthread_mutex_lock(&read_lock);
+    snprintf(pressure_dir, sizeof(pressure_dir), "%s", dir != NULL ? dir : "/proc/pressure");
+    forced_polling = dir != NULL;
+    close_average_fds_locked();
+    pthread_mutex_unlock(&read_lock);
+}
+
+void pressure_cleanup() {
+    stopPressureMonitor();
+    clearPressureTriggers();
+
+    pthread_mutex_lock(&event_lock);
+    event_sequence = 0;
+    pthread_mutex_unlock(&event_lock);
+
+    pthread_mutex_lock(&read_lock);
+    close_average_fds_locked();
+    pthread_mutex_unlock(&read_lock);
+}
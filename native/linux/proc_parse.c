@@ -0,0 +1,328 @@
+#include <string.h>
+
+#include "proc_parse.h"
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+// Word-at-a-time helpers assume little-endian loads; other hosts take the
+// byte loops, which give the same results
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#define PROC_PARSE_SWAR 1
+#else
+#define PROC_PARSE_SWAR 0
+#endif
+
+#define BYTES(value) (0x0101010101010101ull * (uint8_t)(value))
+#define HIGH_BITS 0x8080808080808080ull
+
+const struct proc_field_table proc_stat_cpu_fields = {
+    .count = PROC_CPU_FIELD_COUNT,
+    .positions = {0, 1, 2, 3, 4, 5, 6, 7},
+};
+
+// reads merged sectors ms writes merged sectors ms in_flight io_ms ...
+const struct proc_field_table proc_diskstats_fields = {
+    .count = PROC_DISK_FIELD_COUNT,
+    .positions = {0, 2, 3, 4, 6, 7, 8, 9},
+};
+
+// Counted from 0 = state: utime is field 14 of the whole line, stime 15,
+// num_threads 20, starttime 22 and rss 24
+const struct proc_field_table proc_pid_stat_fields = {
+    .count = PROC_PID_FIELD_COUNT,
+    .positions = {11, 12, 17, 19, 21},
+};
+
+// rx: bytes packets errs drop fifo frame compressed multicast, then tx:
+// bytes packets errs drop fifo colls carrier compressed
+const struct proc_field_table proc_net_dev_fields = {
+    .count = PROC_NET_FIELD_COUNT,
+    .positions = {0, 1, 2, 3, 8, 9, 10, 11},
+};
+
+_Static_assert(PROC_CPU_FIELD_COUNT <= PROC_FIELD_TABLE_MAX, "cpu field table too large");
+_Static_assert(PROC_DISK_FIELD_COUNT <= PROC_FIELD_TABLE_MAX, "diskstats field table too large");
+_Static_assert(PROC_PID_FIELD_COUNT <= PROC_FIELD_TABLE_MAX, "pid stat field table too large");
+_Static_assert(PROC_NET_FIELD_COUNT <= PROC_FIELD_TABLE_MAX, "net dev field table too large");
+
+static const uint64_t powers_of_ten[9] = {
+    1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000,
+};
+
+static inline int is_blank(char c) {
+    return c == ' ' || c == '\t';
+}
+
+static inline int is_digit(char c) {
+    return (unsigned char)(c - '0') < 10;
+}
+
+#if PROC_PARSE_SWAR
+static inline uint64_t load_word(const char* p) {
+    uint64_t word;
+    memcpy(&word, p, sizeof(word));
+    return word;
+}
+
+// High bit set in every byte of `word` that is not zero; exact per byte
+static inline uint64_t nonzero_bytes(uint64_t word) {
+    return (((word & ~HIGH_BITS) + ~HIGH_BITS) | word) & HIGH_BITS;
+}
+
+// Index of the first byte flagged in `mask`, or 8 if none
+static inline int first_byte(uint64_t mask) {
+    return mask ? __builtin_ctzll(mask) >> 3 : 8;
+}
+
+// Flags bytes that are not ASCII digits. Only the first flagged byte is
+// exact: the +6 can carry into the byte above a non-digit, which does not
+// matter as nothing past the first non-digit is used.
+static inline uint64_t nondigit_bytes(uint64_t word) {
+    uint64_t t = word ^ BYTES('0');
+    return (t | (t + BYTES(6))) & BYTES(0xF0);
+}
+
+// Value of the first `length` (1..8) digits of `word`
+static inline uint64_t decode_digits(uint64_t word, int length) {
+    uint64_t t = (word & BYTES(0x0F)) << (8 * (8 - length));
+    t = (t * 2561) >> 8;
+    t = ((t & 0x00FF00FF00FF00FFull) * 6553601) >> 16;
+    return ((t & 0x0000FFFF0000FFFFull) * 42949672960001ull) >> 32;
+}
+#endif
+
+static inline const char* skip_blanks(const char* p, const char* end) {
+#if PROC_PARSE_SWAR
+    while (end - p >= 8) {
+        uint64_t word = load_word(p);
+        int blanks = first_byte(nonzero_bytes(word ^ BYTES(' ')) & nonzero_bytes(word ^ BYTES('\t')));
+        p += blanks;
+        if (blanks < 8) return p;
+    }
+#endif
+    while (p < end && is_blank(*p)) p++;
+    return p;
+}
+
+// Decode the digits at `p` (no blanks first)
+static inline uint64_t decode_u64(const char** cursor, const char* end) {
+    const char* p = *cursor;
+    uint64_t value = 0;
+
+#if PROC_PARSE_SWAR
+    while (end - p >= 8) {
+        uint64_t word = load_word(p);
+        int length = first_byte(nondigit_bytes(word));
+        if (length > 0) value = value * powers_of_ten[length] + decode_digits(word, length);
+        p += length;
+        if (length < 8) {
+            *cursor = p;
+            return value;
+        }
+    }
+#endif
+    while (p < end && is_digit(*p)) value = value * 10 + (uint64_t)(*p++ - '0');
+    *cursor = p;
+    return value;
+}
+
+// Fields are found 64 bytes at a time: one bitmask marks the bytes that
+// belong to a field, and field starts are the bits whose predecessor is
+// clear. Walking the starts with ctz keeps the decoding of each field off the
+// dependency chain of finding the next one.
+struct token_cursor {
+    const char* block;            // First byte of the current 64-byte block
+    const char* end;
+    const char* line_end;         // Set once the end of the line is found
+    uint64_t starts;              // Field starts in the block not yet returned
+    uint64_t carry;               // The previous block ended inside a field
+};
+
+// Bit i set for each byte of the block at p that is not a blank or newline,
+// and in *newlines for each '\n'; bits past `end` are set in *newlines
+static inline uint64_t classify_block(const char* p, const char* end, uint64_t* newlines) {
+    char tail[64];
+    size_t available = (size_t)(end - p);
+
+    if (available < 64) {
+        memcpy(tail, p, available);
+        memset(tail + available, '\n', 64 - available);
+        p = tail;
+    }
+
+#ifdef __SSE2__
+    const __m128i space = _mm_set1_epi8(' ');
+    const __m128i tab = _mm_set1_epi8('\t');
+    const __m128i newline = _mm_set1_epi8('\n');
+    uint64_t separators = 0;
+    uint64_t breaks = 0;
+    for (int i = 0; i < 4; i++) {
+        __m128i bytes = _mm_loadu_si128((const __m128i*)(p + 16 * i));
+        __m128i is_newline = _mm_cmpeq_epi8(bytes, newline);
+        __m128i is_separator = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(bytes, space), _mm_cmpeq_epi8(bytes, tab)),
+                                            is_newline);
+        separators |= (uint64_t)(uint16_t)_mm_movemask_epi8(is_separator) << (16 * i);
+        breaks |= (uint64_t)(uint16_t)_mm_movemask_epi8(is_newline) << (16 * i);
+    }
+#else
+    uint64_t separators = 0;
+    uint64_t breaks = 0;
+    for (int i = 0; i < 64; i++) {
+        separators |= (uint64_t)(is_blank(p[i]) || p[i] == '\n') << i;
+        breaks |= (uint64_t)(p[i] == '\n') << i;
+    }
+#endif
+    *newlines = breaks;
+    return ~separators;
+}
+
+static inline void load_block(struct token_cursor* tokens) {
+    uint64_t newlines;
+    uint64_t fields = classify_block(tokens->block, tokens->end, &newlines);
+
+    if (newlines != 0) {
+        int stop = __builtin_ctzll(newlines);
+        fields &= (1ull << stop) - 1;
+        tokens->line_end = tokens->block + stop;
+        if (tokens->line_end > tokens->end) tokens->line_end = tokens->end;
+    }
+    tokens->starts = fields & ~((fields << 1) | tokens->carry);
+    tokens->carry = fields >> 63;
+}
+
+static inline void token_cursor_init(struct token_cursor* tokens, const char* p, const char* end) {
+    tokens->block = p;
+    tokens->end = end;
+    tokens->line_end = NULL;
+    tokens->carry = 0;
+    load_block(tokens);
+}
+
+// Start of the next field on the line, or NULL at the end of the line
+static inline const char* next_token(struct token_cursor* tokens) {
+    while (tokens->starts == 0) {
+        if (tokens->line_end != NULL) return NULL;
+        tokens->block += 64;
+        load_block(tokens);
+    }
+    const char* token = tokens->block + __builtin_ctzll(tokens->starts);
+    tokens->starts &= tokens->starts - 1;
+    return token;
+}
+
+const char* proc_next_line(const char* p, const char* end) {
+#ifdef __SSE2__
+    const __m128i newline = _mm_set1_epi8('\n');
+    while (end - p >= 16) {
+        int mask = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)p), newline));
+        if (mask != 0) return p + __builtin_ctz((unsigned int)mask) + 1;
+        p += 16;
+    }
+#endif
+    const char* newline_at = memchr(p, '\n', (size_t)(end - p));
+    return newline_at != NULL ? newline_at + 1 : end;
+}
+
+size_t proc_count_lines(const char* p, const char* end) {
+    size_t lines = 0;
+
+#ifdef __SSE2__
+    const __m128i newline = _mm_set1_epi8('\n');
+    while (end - p >= 16) {
+        int mask = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)p), newline));
+        lines += (size_t)__builtin_popcount((unsigned int)mask);
+        p += 16;
+    }
+#endif
+    for (; p < end; p++) {
+        if (*p == '\n') lines++;
+    }
+    return lines;
+}
+
+uint64_t proc_parse_u64(const char** cursor, const char* end) {
+    *cursor = skip_blanks(*cursor, end);
+    return decode_u64(cursor, end);
+}
+
+const char* proc_skip_fields(const char* p, const char* end, int count) {
+    struct token_cursor tokens;
+    const char* token;
+
+    token_cursor_init(&tokens, p, end);
+    while ((token = next_token(&tokens)) != NULL) {
+        if (count-- == 0) return token;
+    }
+    return tokens.line_end;
+}
+
+int proc_parse_u64s(const char** cursor, const char* end, uint64_t* out, int capacity) {
+    struct token_cursor tokens;
+    const char* p = *cursor;
+    const char* token;
+    int parsed = 0;
+
+    token_cursor_init(&tokens, p, end);
+    while (parsed < capacity && (token = next_token(&tokens)) != NULL) {
+        if (!is_digit(*token)) {
+            p = token;
+            break;
+        }
+        p = token;
+        out[parsed++] = decode_u64(&p, end);
+    }
+    *cursor = p;
+    return parsed;
+}
+
+int proc_parse_fields(const char** cursor, const char* end, const struct proc_field_table* table,
+                      uint64_t* out) {
+    struct token_cursor tokens;
+    const char* p = *cursor;
+    const char* token;
+    int position = 0;
+    int parsed = 0;
+
+    token_cursor_init(&tokens, p, end);
+    while (parsed < table->count && (token = next_token(&tokens)) != NULL) {
+        if (position++ != table->positions[parsed]) continue;
+        p = token;
+        out[parsed++] = decode_u64(&p, end);
+    }
+    *cursor = p;
+    return parsed;
+}
+
+static int parse_keyed(const char* p, const char* end, const struct proc_key* keys, int count, char separator,
+                       uint64_t* out) {
+    uint64_t found = 0;
+    int remaining = count < 64 ? count : 64;
+
+    for (; p < end && remaining > 0; p = proc_next_line(p, end)) {
+        for (int i = 0; i < count && i < 64; i++) {
+            size_t length = keys[i].length;
+            if ((found >> i) & 1 || (size_t)(end - p) <= length || p[length] != separator ||
+                memcmp(p, keys[i].name, length) != 0) {
+                continue;
+            }
+            const char* value = p + length + 1;
+            out[i] = proc_parse_u64(&value, end);
+            found |= 1ull << i;
+            remaining--;
+            break;
+        }
+    }
+    return __builtin_popcountll(found);
+}
+
+int proc_parse_keyed(const char* p, const char* end, const struct proc_key* keys, int count,
+                     uint64_t* out) {
+    return parse_keyed(p, end, keys, count, ':', out);
+}
+
+int proc_parse_flat_keyed(const char* p, const char* end, const struct proc_key* keys, int count,
+                          uint64_t* out) {
+    return parse_keyed(p, end, keys, count, ' ', out);
+}
@@ -0,0 +1,128 @@
+#ifndef PROC_PARSE_H
+#define PROC_PARSE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Parsing for the dense ASCII integer tables in /proc. Every function works
+// on a caller-owned [p, end) range, never reads at or past `end` and never
+// allocates. Lines and fields are found with SSE2 compares 16 or 64 bytes at
+// a time where available, and integers are decoded eight digits at a time.
+//
+// Fields are separated by spaces or tabs and never span lines. Integers are
+// unsigned decimal; values past UINT64_MAX wrap.
+
+// Start of the line after the one containing `p`, or `end`
+const char* proc_next_line(const char* p, const char* end);
+
+// Number of '\n' in [p, end)
+size_t proc_count_lines(const char* p, const char* end);
+
+// Skip blanks, then decode one unsigned integer and leave *cursor after its
+// digits. Returns 0, with *cursor at the first non-blank, if there is none.
+uint64_t proc_parse_u64(const char** cursor, const char* end);
+
+// Skip `count` fields of the current line, and the blanks after them
+const char* proc_skip_fields(const char* p, const char* end, int count);
+
+// Decode consecutive integer fields of the current line into `out`, up to
+// `capacity` of them. Stops at the end of the line or at the first field that
+// does not start with a digit, leaving *cursor there. Returns the number
+// decoded.
+int proc_parse_u64s(const char** cursor, const char* end, uint64_t* out, int capacity);
+
+// Which fields of a line to keep: `positions` are ascending, 0-based field
+// numbers counted from the cursor, and out[i] receives field positions[i]
+#define PROC_FIELD_TABLE_MAX 16
+
+struct proc_field_table {
+    uint8_t count;
+    uint8_t positions[PROC_FIELD_TABLE_MAX];
+};
+
+// Decode the fields a table selects from the current line. Returns the
+// number decoded, which is less than table->count if the line is short.
+int proc_parse_fields(const char** cursor, const char* end, const struct proc_field_table* table,
+                      uint64_t* out);
+
+// /proc/stat "cpu" and "cpuN" lines, after the label
+enum proc_stat_cpu_field {
+    PROC_CPU_USER,
+    PROC_CPU_NICE,
+    PROC_CPU_SYSTEM,
+    PROC_CPU_IDLE,
+    PROC_CPU_IOWAIT,
+    PROC_CPU_IRQ,
+    PROC_CPU_SOFTIRQ,
+    PROC_CPU_STEAL,
+    PROC_CPU_FIELD_COUNT
+};
+extern const struct proc_field_table proc_stat_cpu_fields;
+
+// /proc/diskstats lines, after the device name
+enum proc_diskstats_field {
+    PROC_DISK_READS,
+    PROC_DISK_READ_SECTORS,
+    PROC_DISK_READ_MS,
+    PROC_DISK_WRITES,
+    PROC_DISK_WRITE_SECTORS,
+    PROC_DISK_WRITE_MS,
+    PROC_DISK_IN_FLIGHT,
+    PROC_DISK_BUSY_MS,
+    PROC_DISK_FIELD_COUNT
+};
+extern const struct proc_field_table proc_diskstats_fields;
+
+// /proc/[pid]/stat, after the ')' closing the command name
+enum proc_pid_stat_field {
+    PROC_PID_UTIME,
+    PROC_PID_STIME,
+    PROC_PID_THREADS,
+    PROC_PID_START_TIME,
+    PROC_PID_RSS_PAGES,
+    PROC_PID_FIELD_COUNT
+};
+extern const struct proc_field_table proc_pid_stat_fields;
+
+// /proc/net/dev lines, after the ':' following the interface name
+enum proc_net_dev_field {
+    PROC_NET_RX_BYTES,
+    PROC_NET_RX_PACKETS,
+    PROC_NET_RX_ERRORS,
+    PROC_NET_RX_DROPS,
+    PROC_NET_TX_BYTES,
+    PROC_NET_TX_PACKETS,
+    PROC_NET_TX_ERRORS,
+    PROC_NET_TX_DROPS,
+    PROC_NET_FIELD_COUNT
+};
+extern const struct proc_field_table proc_net_dev_fields;
+
+// "Key:   value" files such as /proc/meminfo. PROC_KEY() computes the length
+// at compile time.
+struct proc_key {
+    const char* name;
+    uint8_t length;
+};
+#define PROC_KEY(name) {name, (uint8_t)(sizeof(name) - 1)}
+
+// Find each key at the start of a line and decode the number after its ':'.
+// Keys that are not found leave their `out` slot unchanged. Returns the
+// number of keys found.
+int proc_parse_keyed(const char* p, const char* end, const struct proc_key* keys, int count,
+                     uint64_t* out);
+
+// The same for "key value" files such as cgroup v2's cpu.stat and
+// memory.stat
+int proc_parse_flat_keyed(const char* p, const char* end, const struct proc_key* keys, int count,
+                          uint64_t* out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PROC_PARSE_H
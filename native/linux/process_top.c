@@ -0,0 +1,462 @@
+#define _GNU_SOURCE
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <unistd.h>
+
+#include "../common/latency.h"
+#include "../common/process_top.h"
+#include "proc_parse.h"
+
+// Per-PID state kept across ticks, in an open-addressing table keyed by PID
+// (linear probing, backward-shift deletion). Each live process is re-read
+// through a cached /proc/[pid]/stat descriptor; processes that no longer
+// appear in /proc are dropped at the end of the tick.
+struct process_entry {
+    int32_t pid;                  // 0 marks an empty slot
+    uint32_t seen;                // Tick in which the process was last listed
+    int stat_fd;                  // -1 when not cached (descriptor budget spent)
+    int io_fd;
+    int io_denied;                // /proc/[pid]/io is not readable by us
+    uint64_t start_time;          // Detects PID reuse
+    uint64_t cpu_ticks;           // utime + stime at stat_ns
+    uint64_t stat_ns;
+    uint64_t read_bytes;          // /proc/[pid]/io counters at io_ns
+    uint64_t write_bytes;
+    uint64_t io_ns;
+    struct process_usage usage;
+};
+
+// Selection candidate: the sort key next to the table slot, so the
+// partial selection only moves 16-byte records around
+struct candidate {
+    double key;
+    int32_t slot;
+};
+
+static struct process_entry* table = NULL;
+static uint32_t table_mask = 0;
+static int table_count = 0;
+
+static struct candidate* candidates = NULL;
+static int32_t* stale = NULL;
+
+// Time allowed for one refresh. On hosts with tens of thousands of
+// processes the stat reads do not all fit, so each tick resumes reading
+// where the previous one stopped; entries keep their own timestamps, so
+// rates stay correct for processes refreshed less often.
+#define PROCESS_TOP_BUDGET_NS 4000000ull
+
+static DIR* proc_dir = NULL;
+static uint32_t tick = 0;
+static uint32_t resume_slot = 0;
+static int open_fds = 0;
+static int fd_budget = -1;
+static double ticks_per_second = 100.0;
+static long page_kb = 4;
+
+static char stat_buffer[1024];
+static char io_buffer[512];
+
+static uint32_t home_slot(int32_t pid) {
+    return ((uint32_t)pid * 0x9E3779B1u) & table_mask;
+}
+
+static struct process_entry* find_entry(int32_t pid) {
+    for (uint32_t i = home_slot(pid);; i = (i + 1) & table_mask) {
+        if (table[i].pid == pid) return &table[i];
+        if (table[i].pid == 0) return NULL;
+    }
+}
+
+static void close_entry(struct process_entry* entry) {
+    if (entry->stat_fd >= 0) {
+        close(entry->stat_fd);
+        open_fds--;
+    }
+    if (entry->io_fd >= 0) {
+        close(entry->io_fd);
+        open_fds--;
+    }
+    entry->stat_fd = -1;
+    entry->io_fd = -1;
+}
+
+// Remove an entry and shift later members of its probe run back into the gap
+static void remove_entry(struct process_entry* entry) {
+    uint32_t gap = (uint32_t)(entry - table);
+
+    close_entry(entry);
+    table[gap].pid = 0;
+    table_count--;
+
+    for (uint32_t i = (gap + 1) & table_mask; table[i].pid != 0; i = (i + 1) & table_mask) {
+        uint32_t home = home_slot(table[i].pid);
+        // Move the entry if its home slot is not in (gap, i]
+        int movable = gap <= i ? (home <= gap || home > i) : (home <= gap && home > i);
+        if (movable) {
+            table[gap] = table[i];
+            table[i].pid = 0;
+            gap = i;
+        }
+    }
+}
+
+// Keep the table at most half full; grows the selection scratch with it
+static int reserve(int needed) {
+    uint32_t capacity = table_mask + 1;
+    if (table != NULL && (uint32_t)needed * 2 <= capacity) return 0;
+
+    uint32_t new_capacity = table != NULL ? capacity : 1024;
+    while ((uint32_t)needed * 2 > new_capacity) new_capacity *= 2;
+
+    struct process_entry* grown = calloc(new_capacity, sizeof(*grown));
+    struct candidate* new_candidates = realloc(candidates, new_capacity * sizeof(*candidates));
+    if (new_candidates != NULL) candidates = new_candidates;
+    int32_t* new_stale = realloc(stale, new_capacity * sizeof(*stale));
+    if (new_stale != NULL) stale = new_stale;
+    if (grown == NULL || new_candidates == NULL || new_stale == NULL) {
+        free(grown);
+        return -1;
+    }
+
+    struct process_entry* old = table;
+    table = grown;
+    table_mask = new_capacity - 1;
+    if (old != NULL) {
+        for (uint32_t i = 0; i < capacity; i++) {
+            if (old[i].pid == 0) continue;
+            uint32_t j = home_slot(old[i].pid);
+            while (table[j].pid != 0) j = (j + 1) & table_mask;
+            table[j] = old[i];
+        }
+        free(old);
+    }
+    return 0;
+}
+
+static struct process_entry* insert_entry(int32_t pid) {
+    if (reserve(table_count + 1) != 0) return NULL;
+
+    uint32_t i = home_slot(pid);
+    while (table[i].pid != 0) i = (i + 1) & table_mask;
+
+    struct process_entry* entry = &table[i];
+    memset(entry, 0, sizeof(*entry));
+    entry->pid = pid;
+    entry->stat_fd = -1;
+    entry->io_fd = -1;
+    table_count++;
+    return entry;
+}
+
+static void init_limits(void) {
+    struct rlimit limit;
+
+    // Leave most descriptors to the host application; processes beyond the
+    // budget are read with open/read/close instead of a cached descriptor
+    fd_budget = 256;
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur != RLIM_INFINITY) {
+        fd_budget = (int)(limit.rlim_cur / 4);
+    }
+
+    long hz = sysconf(_SC_CLK_TCK);
+    if (hz > 0) ticks_per_second = (double)hz;
+    long page = sysconf(_SC_PAGESIZE);
+    if (page > 0) page_kb = page / 1024;
+}
+
+// Read a per-PID file, through the cached descriptor when there is one.
+// A failed cached read is retried once on a fresh descriptor.
+static ssize_t read_pid_file(int* fd, int32_t pid, const char* file, char* buffer, size_t size) {
+    char path[64];
+    ssize_t bytes = -1;
+
+    if (*fd >= 0) {
+        bytes = pread(*fd, buffer, size - 1, 0);
+        if (bytes > 0) {
+            buffer[bytes] = '\0';
+            return bytes;
+        }
+        close(*fd);
+        *fd = -1;
+        open_fds--;
+    }
+
+    snprintf(path, sizeof(path), "/proc/%d/%s", (int)pid, file);
+    int opened = open(path, O_RDONLY | O_CLOEXEC);
+    if (opened < 0) return -1;
+
+    bytes = pread(opened, buffer, size - 1, 0);
+    if (bytes > 0) buffer[bytes] = '\0';
+
+    if (bytes > 0 && open_fds < fd_budget) {
+        *fd = opened;
+        open_fds++;
+    } else {
+        close(opened);
+    }
+    return bytes;
+}
+
+// Parse /proc/[pid]/stat; returns 0 on success
+static int parse_stat(struct process_entry* entry, size_t length, uint64_t now_ns) {
+    // The comm field may itself contain spaces and parentheses
+    const char* end = stat_buffer + length;
+    const char* open_paren = memchr(stat_buffer, '(', length);
+    const char* close_paren = memrchr(stat_buffer, ')', length);
+    if (open_paren == NULL || close_paren == NULL || close_paren < open_paren) return -1;
+
+    size_t name_len = (size_t)(close_paren - open_paren - 1);
+    if (name_len >= PROCESS_NAME_LEN) name_len = PROCESS_NAME_LEN - 1;
+    memcpy(entry->usage.name, open_paren + 1, name_len);
+    entry->usage.name[name_len] = '\0';
+
+    uint64_t fields[PROC_PID_FIELD_COUNT] = {0};
+    const char* p = close_paren + 1;
+    proc_parse_fields(&p, end, &proc_pid_stat_fields, fields);
+    uint64_t start_time = fields[PROC_PID_START_TIME];
+
+    uint64_t cpu_ticks = fields[PROC_PID_UTIME] + fields[PROC_PID_STIME];
+    if (entry->stat_ns == 0 || entry->start_time != start_time) {
+        // New process, or the PID was reused: no baseline yet
+        entry->start_time = start_time;
+        entry->usage.cpu_percent = 0.0;
+        entry->read_bytes = 0;
+        entry->write_bytes = 0;
+        entry->io_ns = 0;
+        entry->usage.read_bytes_per_sec = 0.0;
+        entry->usage.write_bytes_per_sec = 0.0;
+    } else if (now_ns > entry->stat_ns) {
+        double elapsed = (double)(now_ns - entry->stat_ns) / 1e9;
+        entry->usage.cpu_percent = (double)(cpu_ticks - entry->cpu_ticks) / ticks_per_second / elapsed * 100.0;
+    }
+
+    entry->cpu_ticks = cpu_ticks;
+    entry->stat_ns = now_ns;
+    entry->usage.pid = entry->pid;
+    entry->usage.threads = (int32_t)fields[PROC_PID_THREADS];
+    entry->usage.rss_kb = (int64_t)fields[PROC_PID_RSS_PAGES] * page_kb;
+    return 0;
+}
+
+static const struct proc_key io_keys[] = {PROC_KEY("read_bytes"), PROC_KEY("write_bytes")};
+#define IO_KEY_COUNT (int)(sizeof(io_keys) / sizeof(io_keys[0]))
+
+// Refresh storage I/O rates from /proc/[pid]/io. Other users' processes are
+// not readable without privileges; those are remembered and skipped.
+static void refresh_io(struct process_entry* entry, uint64_t now_ns) {
+    if (entry->io_denied) return;
+
+    ssize_t length = read_pid_file(&entry->io_fd, entry->pid, "io", io_buffer, sizeof(io_buffer));
+    if (length <= 0) {
+        if (errno == EACCES || errno == EPERM) entry->io_denied = 1;
+        return;
+    }
+
+    uint64_t values[IO_KEY_COUNT];
+    if (proc_parse_keyed(io_buffer, io_buffer + length, io_keys, IO_KEY_COUNT, values) != IO_KEY_COUNT) return;
+    uint64_t read_bytes = values[0];
+    uint64_t write_bytes = values[1];
+
+    if (entry->io_ns != 0 && now_ns > entry->io_ns) {
+        double elapsed = (double)(now_ns - entry->io_ns) / 1e9;
+        entry->usage.read_bytes_per_sec = (double)(read_bytes - entry->read_bytes) / elapsed;
+        entry->usage.write_bytes_per_sec = (double)(write_bytes - entry->write_bytes) / elapsed;
+    }
+    entry->read_bytes = read_bytes;
+    entry->write_bytes = write_bytes;
+    entry->io_ns = now_ns;
+}
+
+static double sort_key(const struct process_entry* entry, int sort) {
+    switch (sort) {
+        case PROCESS_SORT_RSS:
+            return (double)entry->usage.rss_kb;
+        case PROCESS_SORT_IO:
+            return entry->usage.read_bytes_per_sec + entry->usage.write_bytes_per_sec;
+        default:
+            return entry->usage.cpu_percent;
+    }
+}
+
+static void swap_candidates(struct candidate* a, struct candidate* b) {
+    struct candidate t = *a;
+    *a = *b;
+    *b = t;
+}
+
+static double median_of_three(double a, double b, double c) {
+    if (a > b) {
+        double t = a;
+        a = b;
+        b = t;
+    }
+    return c < a ? a : (c > b ? b : c);
+}
+
+// Quickselect: reorder so the `n` largest keys occupy [0, n), in no order.
+// Three-way partitioning keeps it linear when most keys are equal, which is
+// the common case (thousands of idle processes at 0% CPU).
+static void select_largest(struct candidate* items, int count, int n) {
+    int left = 0;
+    int right = count - 1;
+    int target = n - 1;
+
+    while (left < right) {
+        double pivot = median_of_three(items[left].key, items[left + (right - left) / 2].key,
+                                       items[right].key);
+
+        // [left, greater) > pivot, [greater, i) == pivot, (lesser, right] < pivot
+        int greater = left;
+        int lesser = right;
+        int i = left;
+        while (i <= lesser) {
+            if (items[i].key > pivot) {
+                swap_candidates(&items[i++], &items[greater++]);
+            } else if (items[i].key < pivot) {
+                swap_candidates(&items[i], &items[lesser--]);
+            } else {
+                i++;
+            }
+        }
+
+        if (target < greater) {
+            right = greater - 1;
+        } else if (target > lesser) {
+            left = lesser + 1;
+        } else {
+            return;
+        }
+    }
+}
+
+static int compare_descending(const void* a, const void* b) {
+    double x = ((const struct candidate*)a)->key;
+    double y = ((const struct candidate*)b)->key;
+    return (x < y) - (x > y);
+}
+
+int getTopProcesses(int sort, struct process_usage* out, int capacity) {
+    if (out == NULL || capacity <= 0 || sort < 0 || sort >= PROCESS_SORT_COUNT) return -1;
+
+    if (fd_budget < 0) init_limits();
+    if (proc_dir == NULL) {
+        proc_dir = opendir("/proc");
+        if (proc_dir == NULL) {
+            fprintf(stderr, "Error opening /proc\n");
+            return -1;
+        }
+    } else {
+        rewinddir(proc_dir);
+    }
+    if (reserve(1) != 0) return -1;
+
+    // The budget covers the /proc walk too. The walk cannot stop early
+    // (an unlisted PID counts as exited), so it comes out of the time left
+    // for stat reads.
+    uint64_t start = latency_now_ns();
+    uint64_t deadline = start + PROCESS_TOP_BUDGET_NS;
+    uint64_t now_ns = start;
+    struct dirent* dirent;
+    tick++;
+
+    // Mark every PID still listed in /proc
+    while ((dirent = readdir(proc_dir)) != NULL) {
+        const char* name = dirent->d_name;
+        if (name[0] < '1' || name[0] > '9') continue;
+
+        int32_t pid = 0;
+        while (*name >= '0' && *name <= '9') pid = pid * 10 + (*name++ - '0');
+        if (*name != '\0') continue;
+
+        struct process_entry* entry = find_entry(pid);
+        if (entry == NULL) entry = insert_entry(pid);
+        if (entry == NULL) break;
+        entry->seen = tick;
+    }
+
+    // Re-read live PIDs only, round-robin from where the last tick stopped.
+    // At least one batch of 64 is read even when the walk used up the
+    // budget, so every process is still refreshed eventually.
+    uint32_t slot = resume_slot & table_mask;
+    uint32_t reads = 0;
+    for (uint32_t visited = 0; visited <= table_mask; visited++, slot = (slot + 1) & table_mask) {
+        struct process_entry* entry = &table[slot];
+        if (entry->pid == 0 || entry->seen != tick) continue;
+
+        if (reads > 0 && (reads & 63) == 0 && latency_now_ns() > deadline) break;
+        reads++;
+
+        ssize_t length = read_pid_file(&entry->stat_fd, entry->pid, "stat", stat_buffer, sizeof(stat_buffer));
+        if (length <= 0 || parse_stat(entry, (size_t)length, now_ns) != 0) {
+            // Exited after readdir()
+            entry->seen = 0;
+            continue;
+        }
+        if (sort == PROCESS_SORT_IO) refresh_io(entry, now_ns);
+    }
+    resume_slot = slot;
+
+    // Drop processes that have exited, then collect the survivors
+    int stale_count = 0;
+    int count = 0;
+    for (uint32_t i = 0; i <= table_mask; i++) {
+        if (table[i].pid == 0) continue;
+        if (table[i].seen != tick) {
+            stale[stale_count++] = table[i].pid;
+        }
+    }
+    for (int i = 0; i < stale_count; i++) {
+        struct process_entry* entry = find_entry(stale[i]);
+        if (entry != NULL) remove_entry(entry);
+    }
+    for (uint32_t i = 0; i <= table_mask; i++) {
+        // Skip PIDs that have not been read yet
+        if (table[i].pid == 0 || table[i].stat_ns == 0) continue;
+        candidates[count].key = sort_key(&table[i], sort);
+        candidates[count].slot = (int32_t)i;
+        count++;
+    }
+
+    int n = capacity < count ? capacity : count;
+    if (n < count) select_largest(candidates, count, n);
+    qsort(candidates, (size_t)n, sizeof(*candidates), compare_descending);
+
+    for (int i = 0; i < n; i++) {
+        struct process_entry* entry = &table[candidates[i].slot];
+        // Other orders only need I/O for the rows that are shown
+        if (sort != PROCESS_SORT_IO) refresh_io(entry, now_ns);
+        out[i] = entry->usage;
+    }
+
+    latency_record(LATENCY_PROCESSES, start);
+    return n;
+}
+
+void process_top_cleanup() {
+    if (table != NULL) {
+        for (uint32_t i = 0; i <= table_mask; i++) {
+            if (table[i].pid != 0) close_entry(&table[i]);
+        }
+    }
+    free(table);
+    free(candidates);
+    free(stale);
+    table = NULL;
+    candidates = NULL;
+    stale = NULL;
+    table_mask = 0;
+    table_count = 0;
+    resume_slot = 0;
+    open_fds = 0;
+
+    if (proc_dir != NULL) {
+        closedir(proc_dir);
+        proc_dir = NULL;
+    }
+}
@@ -0,0 +1,376 @@
+#define _GNU_SOURCE
+#include <dirent.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "cpu_monitor.h"
+#include "proc_parse.h"
+
+// Inputs come from /sys/class/hwmon/hwmon*/{temp,fan}N_input, labelled by
+// the matching _label file and the chip's name, and from
+// /sys/class/thermal/thermal_zone*/temp. Thermal zones whose type is also a
+// hwmon chip name (acpitz, for one) are the same sensor twice and skipped.
+//
+// Discovery opens one descriptor per input and reads labels and critical
+// limits once; after that a tick is one pread() per sensor. The table is
+// shared by getSensors() and every monitor context's getTemperature(); those
+// only pread() and share a read lock, so concurrent samples do not queue.
+// Scans take the write lock.
+
+struct sensor {
+    int fd;
+    double scale;                 // Millidegrees to Celsius, or 1 for RPM
+    struct sensor_reading info;   // Everything except value
+};
+
+static const char* hwmon_path = "/sys/class/hwmon";
+static const char* thermal_path = "/sys/class/thermal";
+
+static pthread_rwlock_t sensors_lock = PTHREAD_RWLOCK_INITIALIZER;
+static struct sensor* sensors = NULL;
+static int sensor_count = 0;
+static int sensor_capacity = 0;
+static int sensors_scanned = 0;
+
+// Read a short sysfs attribute relative to `dir_fd`, without the newline.
+// Returns its length, or -1.
+static int read_attribute(int dir_fd, const char* name, char* text, size_t size) {
+    int fd = openat(dir_fd, name, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return -1;
+
+    ssize_t bytes = read(fd, text, size - 1);
+    close(fd);
+    if (bytes <= 0) return -1;
+    while (bytes > 0 && (text[bytes - 1] == '\n' || text[bytes - 1] == ' ')) bytes--;
+    text[bytes] = '\0';
+    return (int)bytes;
+}
+
+// Signed decimal; sensors below zero report negative millidegrees
+static double parse_value(const char* text, size_t length) {
+    const char* p = text;
+    const char* end = text + length;
+    int negative = p < end && *p == '-';
+    if (negative) p++;
+    double value = (double)proc_parse_u64(&p, end);
+    return negative ? -value : value;
+}
+
+static double read_millidegrees(int dir_fd, const char* name) {
+    char text[32];
+    int length = read_attribute(dir_fd, name, text, sizeof(text));
+    return length > 0 ? parse_value(text, (size_t)length) / 1000.0 : 0.0;
+}
+
+// Number at the end of `label` ("Core 12", "Tccd3"), or -1
+static int trailing_number(const char* label) {
+    const char* end = label + strlen(label);
+    const char* digits = end;
+    while (digits > label && digits[-1] >= '0' && digits[-1] <= '9') digits--;
+    return digits < end ? atoi(digits) : -1;
+}
+
+static int starts_with(const char* text, const char* prefix) {
+    return strncmp(text, prefix, strlen(prefix)) == 0;
+}
+
+// Kind of a temperature input from its chip name and label
+static int classify(const char* chip, const char* label, int* index) {
+    *index = -1;
+
+    if (strcmp(chip, "coretemp") == 0) {
+        *index = trailing_number(label);
+        return starts_with(label, "Core") ? SENSOR_CPU_CORE : SENSOR_CPU_PACKAGE;
+    }
+    if (strcmp(chip, "k10temp") == 0 || strcmp(chip, "zenpower") == 0) {
+        if (starts_with(label, "Tccd")) {
+            *index = trailing_number(label);
+            return SENSOR_CPU_CORE;
+        }
+        return SENSOR_CPU_PACKAGE;
+    }
+    if (strcmp(chip, "x86_pkg_temp") == 0 || strcmp(chip, "cpu_thermal") == 0 ||
+        strcmp(chip, "cpu-thermal") == 0 || strcmp(chip, "soc_thermal") == 0) {
+        return SENSOR_CPU_PACKAGE;
+    }
+    if (starts_with(chip, "nvme")) return SENSOR_NVME;
+    if (strcmp(chip, "amdgpu") == 0 || strcmp(chip, "radeon") == 0 || strcmp(chip, "nouveau") == 0 ||
+        strcmp(chip, "i915") == 0 || strcmp(chip, "xe") == 0) {
+        return SENSOR_GPU;
+    }
+    return SENSOR_OTHER;
+}
+
+static struct sensor* add_sensor(int fd) {
+    if (sensor_count == sensor_capacity) {
+        if (sensor_capacity == SENSOR_MAX_COUNT) return NULL;
+        int grown = sensor_capacity ? sensor_capacity * 2 : 16;
+        struct sensor* resized = realloc(sensors, (size_t)grown * sizeof(*sensors));
+        if (resized == NULL) return NULL;
+        sensors = resized;
+        sensor_capacity = grown;
+    }
+
+    struct sensor* sensor = &sensors[sensor_count++];
+    memset(sensor, 0, sizeof(*sensor));
+    sensor->fd = fd;
+    return sensor;
+}
+
+// `name` is "temp<N>_input" or "fan<N>_input"; returns N, or -1
+static int input_number(const char* name, const char* prefix) {
+    size_t prefix_len = strlen(prefix);
+    if (strncmp(name, prefix, prefix_len) != 0) return -1;
+
+    const char* p = name + prefix_len;
+    int number = 0;
+    if (*p < '0' || *p > '9') return -1;
+    while (*p >= '0' && *p <= '9') number = number * 10 + (*p++ - '0');
+    return strcmp(p, "_input") == 0 ? number : -1;
+}
+
+static void scan_hwmon_chip(int chip_fd, const char* dir_name) {
+    char chip[SENSOR_NAME_LEN];
+    if (read_attribute(chip_fd, "name", chip, sizeof(chip)) <= 0) {
+        snprintf(chip, sizeof(chip), "%.*s", SENSOR_NAME_LEN - 1, dir_name);
+    }
+
+    int list_fd = dup(chip_fd);
+    DIR* inputs = list_fd >= 0 ? fdopendir(list_fd) : NULL;
+    if (inputs == NULL) {
+        if (list_fd >= 0) close(list_fd);
+        return;
+    }
+
+    struct dirent* entry;
+    while ((entry = readdir(inputs)) != NULL) {
+        int temp = input_number(entry->d_name, "temp");
+        int fan = temp < 0 ? input_number(entry->d_name, "fan") : -1;
+        if (temp < 0 && fan < 0) continue;
+
+        int fd = openat(chip_fd, entry->d_name, O_RDONLY | O_CLOEXEC);
+        if (fd < 0) continue;
+        struct sensor* sensor = add_sensor(fd);
+        if (sensor == NULL) {
+            close(fd);
+            break;
+        }
+
+        char attribute[64];
+        struct sensor_reading* info = &sensor->info;
+        snprintf(info->chip, sizeof(info->chip), "%s", chip);
+        snprintf(attribute, sizeof(attribute), "%s%d_label", temp >= 0 ? "temp" : "fan", temp >= 0 ? temp : fan);
+        if (read_attribute(chip_fd, attribute, info->label, sizeof(info->label)) <= 0) {
+            snprintf(info->label, sizeof(info->label), "%s%d", temp >= 0 ? "temp" : "fan", temp >= 0 ? temp : fan);
+        }
+
+        if (fan >= 0) {
+            sensor->scale = 1.0;
+            info->kind = SENSOR_FAN;
+            info->index = fan;
+        } else {
+            sensor->scale = 0.001;
+            info->kind = classify(chip, info->label, &info->index);
+            snprintf(attribute, sizeof(attribute), "temp%d_crit", temp);
+            info->critical = read_millidegrees(chip_fd, attribute);
+        }
+    }
+    closedir(inputs);
+}
+
+static int hwmon_has_chip(const char* name) {
+    for (int i = 0; i < sensor_count; i++) {
+        if (sensors[i].info.kind != SENSOR_FAN && strcmp(sensors[i].info.chip, name) == 0) return 1;
+    }
+    return 0;
+}
+
+// Critical trip point of a thermal zone, or 0
+static double zone_critical(int zone_fd) {
+    char name[64];
+    char type[32];
+
+    for (int trip = 0; trip < 32; trip++) {
+        snprintf(name, sizeof(name), "trip_point_%d_type", trip);
+        if (read_attribute(zone_fd, name, type, sizeof(type)) <= 0) break;
+        if (strcmp(type, "critical") == 0) {
+            snprintf(name, sizeof(name), "trip_point_%d_temp", trip);
+            return read_millidegrees(zone_fd, name);
+        }
+    }
+    return 0.0;
+}
+
+static void scan_thermal_zone(int zone_fd) {
+    char type[SENSOR_NAME_LEN];
+    if (read_attribute(zone_fd, "type", type, sizeof(type)) <= 0) return;
+    if (hwmon_has_chip(type)) return;
+
+    int fd = openat(zone_fd, "temp", O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return;
+    struct sensor* sensor = add_sensor(fd);
+    if (sensor == NULL) {
+        close(fd);
+        return;
+    }
+
+    struct sensor_reading* info = &sensor->info;
+    sensor->scale = 0.001;
+    snprintf(info->chip, sizeof(info->chip), "%s", type);
+    snprintf(info->label, sizeof(info->label), "%s", type);
+    info->kind = classify(type, type, &info->index);
+    info->critical = zone_critical(zone_fd);
+}
+
+// Call `scan` with a descriptor for each subdirectory of `path` whose name
+// starts with `prefix`
+static void scan_directories(const char* path, const char* prefix, int thermal) {
+    DIR* dir = opendir(path);
+    if (dir == NULL) return;
+
+    struct dirent* entry;
+    while ((entry = readdir(dir)) != NULL) {
+        if (!starts_with(entry->d_name, prefix)) continue;
+
+        // Entries are symlinks into /sys/devices; opening follows them
+        int entry_fd = openat(dirfd(dir), entry->d_name, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        if (entry_fd < 0) continue;
+        if (thermal) {
+            scan_thermal_zone(entry_fd);
+        } else {
+            scan_hwmon_chip(entry_fd, entry->d_name);
+        }
+        close(entry_fd);
+    }
+    closedir(dir);
+}
+
+static int compare_sensors(const void* a, const void* b) {
+    const struct sensor_reading* left = &((const struct sensor*)a)->info;
+    const struct sensor_reading* right = &((const struct sensor*)b)->info;
+
+    if (left->kind != right->kind) return left->kind - right->kind;
+    int chip = strcmp(left->chip, right->chip);
+    if (chip != 0) return chip;
+    if (left->index != right->index) return left->index - right->index;
+    return strcmp(left->label, right->label);
+}
+
+static void drop_sensors_locked(void) {
+    for (int i = 0; i < sensor_count; i++) close(sensors[i].fd);
+    sensor_count = 0;
+    sensors_scanned = 0;
+}
+
+static void scan_sensors_locked(void) {
+    drop_sensors_locked();
+    // hwmon first so thermal zones that duplicate a chip can be skipped
+    scan_directories(hwmon_path, "hwmon", 0);
+    scan_directories(thermal_path, "thermal_zone", 1);
+    // `sensors` is still NULL on a host without any inputs
+    if (sensor_count > 1) qsort(sensors, (size_t)sensor_count, sizeof(*sensors), compare_sensors);
+    sensors_scanned = 1;
+}
+
+// Take the read lock on a scanned table, scanning first if needed
+static void lock_scanned(void) {
+    pthread_rwlock_rdlock(&sensors_lock);
+    while (!sensors_scanned) {
+        pthread_rwlock_unlock(&sensors_lock);
+        pthread_rwlock_wrlock(&sensors_lock);
+        if (!sensors_scanned) scan_sensors_locked();
+        pthread_rwlock_unlock(&sensors_lock);
+        pthread_rwlock_rdlock(&sensors_lock);
+    }
+}
+
+static int read_sensor(const struct sensor* sensor, double* value) {
+    char text[32];
+    ssize_t bytes = pread(sensor->fd, text, sizeof(text), 0);
+    if (bytes <= 0) return -1;
+
+    *value = parse_value(text, (size_t)bytes) * sensor->scale;
+    return 0;
+}
+
+int getSensors(struct sensor_reading* out, int capacity) {
+    if (out == NULL || capacity < 0) return -1;
+
+    lock_scanned();
+
+    int written = 0;
+    for (int i = 0; i < sensor_count && written < capacity; i++) {
+        double value;
+        if (read_sensor(&sensors[i], &value) != 0) continue;
+        out[written] = sensors[i].info;
+        out[written].value = value;
+        written++;
+    }
+    pthread_rwlock_unlock(&sensors_lock);
+    return written;
+}
+
+int rescanSensors() {
+    pthread_rwlock_wrlock(&sensors_lock);
+    scan_sensors_locked();
+    int count = sensor_count;
+    pthread_rwlock_unlock(&sensors_lock);
+    return count;
+}
+
+// ACPI thermal zones track the CPU on most laptops and many boards; other
+// SENSOR_OTHER chips (chipset, wifi, battery) do not
+static int is_cpu_proxy(const struct sensor_reading* info) {
+    return strcmp(info->chip, "acpitz") == 0;
+}
+
+double sensors_cpu_temperature() {
+    double package = -1.0;
+    double core = -1.0;
+    double other = -1.0;
+
+    lock_scanned();
+
+    for (int i = 0; i < sensor_count; i++) {
+        int kind = sensors[i].info.kind;
+        double value;
+        if (kind != SENSOR_CPU_PACKAGE && kind != SENSOR_CPU_CORE && kind != SENSOR_OTHER) continue;
+        if (kind == SENSOR_OTHER && !is_cpu_proxy(&sensors[i].info)) continue;
+        if (kind == SENSOR_CPU_CORE && package >= 0) break;        // Sorted: packages come first
+        if (kind == SENSOR_OTHER && (package >= 0 || core >= 0)) break;
+        if (read_sensor(&sensors[i], &value) != 0) continue;
+
+        if (kind == SENSOR_CPU_PACKAGE && value > package) package = value;
+        if (kind == SENSOR_CPU_CORE && value > core) core = value;
+        if (kind == SENSOR_OTHER && other < 0) {
+            other = value;
+            break;
+        }
+    }
+    pthread_rwlock_unlock(&sensors_lock);
+
+    if (package >= 0) return package;
+    if (core >= 0) return core;
+    return other;
+}
+
+void sensors_set_sources(const char* hwmon, const char* thermal) {
+    pthread_rwlock_wrlock(&sensors_lock);
+    hwmon_path = hwmon != NULL ? hwmon : "/sys/class/hwmon";
+    thermal_path = thermal != NULL ? thermal : "/sys/class/thermal";
+    drop_sensors_locked();
+    pthread_rwlock_unlock(&sensors_lock);
+}
+
+void sensors_cleanup() {
+    pthread_rwlock_wrlock(&sensors_lock);
+    drop_sensors_locked();
+    free(sensors);
+    sensors = NULL;
+    sensor_capacity = 0;
+    pthread_rwlock_unlock(&sensors_lock);
+}
@@ -14,6 +14,9 @@
 #include <sys/time.h>
 #include <IOKit/IOKitLib.h>
 
+#include "cpu_monitor.h"
+#include "../common/trace.h"
+
 // Export functions for FFI
 #ifdef __cplusplus
 extern "C" {
@@ -25,72 +28,159 @@ static char os_version_buffer[256] = {0};
 static char hostname_buffer[256] = {0};
 static char kernel_version_buffer[256] = {0};
 
-// Last CPU load state, used to calculate delta
-static host_cpu_load_info_data_t prev_load = {0};
-static struct timeval prev_time = {0};
+// Everything a sample mutates
+struct monitor_ctx {
+    // Last CPU load state, used to calculate delta
+    host_cpu_load_info_data_t prev_load;
+
+    // Per-core counters; the two sets are swapped after every per-core sample
+    struct core_counters core_sets[2];
+    struct core_counters* core_current;
+    struct core_counters* core_previous;
+};
+
+// Context behind the process-wide functions (getCpuUsage() and friends)
+static struct monitor_ctx default_ctx = {
+    .core_current = &default_ctx.core_sets[0],
+    .core_previous = &default_ctx.core_sets[1],
+};
+
+// Result of the last getCpuUsage(), for the temperature estimate; sampling
+// again there would consume the delta the next caller expects
+static double last_cpu_usage = 0.0;
+
+// Read the aggregate CPU ticks, timed as the CPU collector
+static kern_return_t read_cpu_load(host_cpu_load_info_data_t* load) {
+    mach_msg_type_number_t count = HOST_CPU_LOAD_INFO_COUNT;
+    uint64_t start = latency_now_ns();
+    kern_return_t result = host_statistics(mach_host_self(), HOST_CPU_LOAD_INFO, (host_info_t)load, &count);
+
+    latency_record(LATENCY_CPU, start);
+    return result;
+}
+
+// Read VM page counts, timed as the memory collector
+static kern_return_t read_vm_statistics(vm_statistics64_data_t* vm_stats) {
+    mach_msg_type_number_t count = HOST_VM_INFO64_COUNT;
+    uint64_t start = latency_now_ns();
+    kern_return_t result = host_statistics64(mach_host_self(), HOST_VM_INFO64, (host_info64_t)vm_stats, &count);
+
+    latency_record(LATENCY_MEMORY, start);
+    return result;
+}
+
+// statfs() the root filesystem, timed as the disk collector
+static int read_root_statfs(struct statfs* stats) {
+    uint64_t start = latency_now_ns();
+    int result = statfs("/", stats);
+
+    latency_record(LATENCY_DISK, start);
+    return result;
+}
 
 // Initialize CPU monitoring
 void init_cpu_monitoring() {
     // Get initial CPU load
-    mach_msg_type_number_t count = HOST_CPU_LOAD_INFO_COUNT;
-    if (host_statistics(mach_host_self(), HOST_CPU_LOAD_INFO, (host_info_t)&prev_load, &count) != KERN_SUCCESS) {
+    if (read_cpu_load(&default_ctx.prev_load) != KERN_SUCCESS) {
         fprintf(stderr, "Error getting CPU load info\n");
     }
-    
-    // Get initial time
-    gettimeofday(&prev_time, NULL);
+    // Per-core shares start from now rather than from boot
+    read_core_ticks(default_ctx.core_previous);
 }
 
-// Get CPU usage percentage (0-100)
-double getCpuUsage() {
+// Sample the aggregate CPU ticks and compute usage since the context's
+// previous sample. Tick counters start at boot, so a fresh context reports
+// the average since boot.
+static double cpu_usage_since_previous(struct monitor_ctx* ctx) {
     host_cpu_load_info_data_t load;
-    mach_msg_type_number_t count = HOST_CPU_LOAD_INFO_COUNT;
-    struct timeval current_time;
     
-    if (host_statistics(mach_host_self(), HOST_CPU_LOAD_INFO, (host_info_t)&load, &count) != KERN_SUCCESS) {
+    if (read_cpu_load(&load) != KERN_SUCCESS) {
         fprintf(stderr, "Error getting CPU load info\n");
         return -1.0;
     }
     
-    gettimeofday(&current_time, NULL);
-    
-    // If first call, initialize
-    if (prev_time.tv_sec == 0) {
-        init_cpu_monitoring();
-        return 30.0; // Return a default value for first call
-    }
-    
     // Calculate deltas for user, system, idle, nice
-    unsigned long user = load.cpu_ticks[CPU_STATE_USER] - prev_load.cpu_ticks[CPU_STATE_USER];
-    unsigned long sys = load.cpu_ticks[CPU_STATE_SYSTEM] - prev_load.cpu_ticks[CPU_STATE_SYSTEM];
-    unsigned long idle = load.cpu_ticks[CPU_STATE_IDLE] - prev_load.cpu_ticks[CPU_STATE_IDLE];
-    unsigned long nice = load.cpu_ticks[CPU_STATE_NICE] - prev_load.cpu_ticks[CPU_STATE_NICE];
+    unsigned long user = load.cpu_ticks[CPU_STATE_USER] - ctx->prev_load.cpu_ticks[CPU_STATE_USER];
+    unsigned long sys = load.cpu_ticks[CPU_STATE_SYSTEM] - ctx->prev_load.cpu_ticks[CPU_STATE_SYSTEM];
+    unsigned long idle = load.cpu_ticks[CPU_STATE_IDLE] - ctx->prev_load.cpu_ticks[CPU_STATE_IDLE];
+    unsigned long nice = load.cpu_ticks[CPU_STATE_NICE] - ctx->prev_load.cpu_ticks[CPU_STATE_NICE];
     
     // Calculate total ticks
     unsigned long total_ticks = user + sys + idle + nice;
     
     // Save current values for next call
-    prev_load = load;
-    prev_time = current_time;
+    ctx->prev_load = load;
     
     if (total_ticks == 0) {
-        return 5.0; // Return a small default value
+        return 0.0;
     }
     
     // Calculate CPU usage percentage
     double cpu_usage = ((double)(user + sys + nice) / (double)total_ticks) * 100.0;
-    fprintf(stdout, "Native CPU: user=%lu, sys=%lu, idle=%lu, nice=%lu, usage=%.2f%%\n", 
+    CPU_MONITOR_TRACE("Native CPU: user=%lu, sys=%lu, idle=%lu, nice=%lu, usage=%.2f%%\n", 
             user, sys, idle, nice, cpu_usage);
     return cpu_usage;
 }
 
+// Get CPU usage percentage (0-100)
+double getCpuUsage() {
+    double cpu_usage = cpu_usage_since_previous(&default_ctx);
+    if (cpu_usage >= 0) last_cpu_usage = cpu_usage;
+    return cpu_usage;
+}
+
+// Read every core's ticks since boot into `counters`
+static int read_core_ticks(struct core_counters* counters) {
+    natural_t cpu_count = 0;
+    processor_info_array_t info;
+    mach_msg_type_number_t info_count;
+
+    if (host_processor_info(mach_host_self(), PROCESSOR_CPU_LOAD_INFO, &cpu_count, &info, &info_count) != KERN_SUCCESS) {
+        fprintf(stderr, "Error getting per-core CPU info\n");
+        return -1;
+    }
+
+    processor_cpu_load_info_t load = (processor_cpu_load_info_t)info;
+    int count = cpu_count < CORE_USAGE_MAX_CORES ? (int)cpu_count : CORE_USAGE_MAX_CORES;
+    for (int i = 0; i < count; i++) {
+        // macOS has no iowait/steal accounting
+        counters->user[i] = load[i].cpu_ticks[CPU_STATE_USER] + load[i].cpu_ticks[CPU_STATE_NICE];
+        counters->system[i] = load[i].cpu_ticks[CPU_STATE_SYSTEM];
+        counters->idle[i] = load[i].cpu_ticks[CPU_STATE_IDLE];
+        counters->iowait[i] = 0;
+        counters->steal[i] = 0;
+    }
+    counters->count = count;
+    vm_deallocate(mach_task_self(), (vm_address_t)info, info_count * sizeof(integer_t));
+    return 0;
+}
+
+// Sample per-core ticks and compute shares since the context's previous
+// per-core sample
+static int per_core_since_previous(struct monitor_ctx* ctx, double* out, int capacity) {
+    struct core_counters* swap;
+
+    if (read_core_ticks(ctx->core_current) != 0) return -1;
+
+    int written = core_usage_compute(ctx->core_current, ctx->core_previous, out, capacity);
+
+    swap = ctx->core_previous;
+    ctx->core_previous = ctx->core_current;
+    ctx->core_current = swap;
+    return written;
+}
+
+// Get per-core user/system/idle/iowait shares since the previous call
+int getPerCoreUsage(double* out, int capacity) {
+    if (out == NULL) return -1;
+    return per_core_since_previous(&default_ctx, out, capacity);
+}
+
 // Get used memory in MB
 int getMemoryUsed() {
-    mach_port_t host = mach_host_self();
     vm_statistics64_data_t vm_stats;
-    mach_msg_type_number_t count = HOST_VM_INFO64_COUNT;
     
-    if (host_statistics64(host, HOST_VM_INFO64, (host_info64_t)&vm_stats, &count) != KERN_SUCCESS) {
+    if (read_vm_statistics(&vm_stats) != KERN_SUCCESS) {
         fprintf(stderr, "Error getting memory info\n");
         return -1;
     }
@@ -102,16 +192,18 @@ int getMemoryUsed() {
     int page_size = getpagesize();
     int used_mb = (int)((uint64_t)used_pages * page_size / (1024 * 1024));
     
-    fprintf(stdout, "Native Memory Used: %d MB\n", used_mb);
+    CPU_MONITOR_TRACE("Native Memory Used: %d MB\n", used_mb);
     return used_mb;
 }
 
-// Get total memory in MB
+// Get total memory in MB, cached for SCHEDULE_STATIC_MEMORY_TOTAL's TTL
 int getMemoryTotal() {
     int mib[2] = {CTL_HW, HW_MEMSIZE};
     int64_t memsize;
     size_t len = sizeof(memsize);
+    double cached;
     
+    if (schedule_static_get(SCHEDULE_STATIC_MEMORY_TOTAL, &cached)) return (int)cached;
     if (sysctl(mib, 2, &memsize, &len, NULL, 0) == -1) {
         fprintf(stderr, "Error getting total memory\n");
         return -1;
@@ -119,7 +211,8 @@ int getMemoryTotal() {
     
     // Convert bytes to MB
     int total_mb = (int)(memsize / (1024 * 1024));
-    fprintf(stdout, "Native Memory Total: %d MB\n", total_mb);
+    CPU_MONITOR_TRACE("Native Memory Total: %d MB\n", total_mb);
+    schedule_static_put(SCHEDULE_STATIC_MEMORY_TOTAL, total_mb);
     return total_mb;
 }
 
@@ -127,7 +220,7 @@ int getMemoryTotal() {
 double getDiskUsage() {
     struct statfs stats;
     
-    if (statfs("/", &stats) == -1) {
+    if (read_root_statfs(&stats) == -1) {
         fprintf(stderr, "Error getting disk info\n");
         return -1.0;
     }
@@ -142,7 +235,7 @@ double getDiskUsage() {
     
     // Calculate percentage used
     double usage = ((total - free) / total) * 100.0;
-    fprintf(stdout, "Native Disk Usage: %.2f%%\n", usage);
+    CPU_MONITOR_TRACE("Native Disk Usage: %.2f%%\n", usage);
     return usage;
 }
 
@@ -150,7 +243,7 @@ double getDiskUsage() {
 double getDiskUsed() {
     struct statfs stats;
     
-    if (statfs("/", &stats) == -1) {
+    if (read_root_statfs(&stats) == -1) {
         fprintf(stderr, "Error getting disk info\n");
         return -1.0;
     }
@@ -160,15 +253,17 @@ double getDiskUsed() {
     
     // Convert to MB
     double used_mb = used / (1024.0 * 1024.0);
-    fprintf(stdout, "Native Disk Used: %.2f MB\n", used_mb);
+    CPU_MONITOR_TRACE("Native Disk Used: %.2f MB\n", used_mb);
     return used_mb;
 }
 
-// Get total disk size in MB
+// Get total disk size in MB, cached for SCHEDULE_STATIC_DISK_TOTAL's TTL
 double getDiskTotal() {
     struct statfs stats;
+    double cached;
     
-    if (statfs("/", &stats) == -1) {
+    if (schedule_static_get(SCHEDULE_STATIC_DISK_TOTAL, &cached)) return cached;
+    if (read_root_statfs(&stats) == -1) {
         fprintf(stderr, "Error getting disk info\n");
         return -1.0;
     }
@@ -178,17 +273,69 @@ double getDiskTotal() {
     
     // Convert to MB
     double total_mb = total / (1024.0 * 1024.0);
-    fprintf(stdout, "Native Disk Total: %.2f MB\n", total_mb);
+    CPU_MONITOR_TRACE("Native Disk Total: %.2f MB\n", total_mb);
+    schedule_static_put(SCHEDULE_STATIC_DISK_TOTAL, total_mb);
     return total_mb;
 }
 
-// Get CPU temperature in Celsius
-double getTemperature() {
+static int compare_mount_points(const void* a, const void* b) {
+    return strcmp(((const struct mount_usage*)a)->mount_point, ((const struct mount_usage*)b)->mount_point);
+}
+
+// Get capacity of every browsable local or network volume
+int getMountUsage(struct mount_usage* out, int capacity) {
+    struct statfs* mounts;
+
+    if (out == NULL || capacity < 0) return -1;
+
+    // The list itself is cached by libc; sizes are refreshed below
+    int count = getmntinfo(&mounts, MNT_NOWAIT);
+    if (count <= 0) {
+        fprintf(stderr, "Error listing mounts\n");
+        return -1;
+    }
+
+    uint64_t start = latency_now_ns();
+    int written = 0;
+    for (int i = 0; i < count && written < capacity; i++) {
+        // Skip pseudo filesystems and hidden system volumes (VM, Preboot, ...)
+        if ((mounts[i].f_flags & MNT_DONTBROWSE) != 0 ||
+            strcmp(mounts[i].f_fstypename, "devfs") == 0 ||
+            strcmp(mounts[i].f_fstypename, "autofs") == 0) {
+            continue;
+        }
+
+        struct statfs stats;
+        if (statfs(mounts[i].f_mntonname, &stats) != 0 || stats.f_blocks == 0) continue;
+
+        double block_mb = (double)stats.f_bsize / (1024.0 * 1024.0);
+        struct mount_usage* row = &out[written++];
+        memset(row, 0, sizeof(*row));
+        row->total_mb = (double)stats.f_blocks * block_mb;
+        row->used_mb = (double)(stats.f_blocks - stats.f_bfree) * block_mb;
+        row->available_mb = (double)stats.f_bavail * block_mb;
+        row->usage_percent = row->used_mb + row->available_mb > 0
+            ? row->used_mb / (row->used_mb + row->available_mb) * 100.0 : 0.0;
+        strlcpy(row->mount_point, stats.f_mntonname, MOUNT_PATH_LEN);
+        strlcpy(row->fs_type, stats.f_fstypename, MOUNT_FSTYPE_LEN);
+        strlcpy(row->device, stats.f_mntfromname, MOUNT_DEVICE_LEN);
+    }
+
+    qsort(out, (size_t)written, sizeof(*out), compare_mount_points);
+    latency_record(LATENCY_MOUNTS, start);
+    return written;
+}
+
+// Estimate CPU temperature from an already sampled CPU usage
+static double estimate_temperature(double cpuUsage) {
+    uint64_t start = latency_now_ns();
+
     // Connect to the IOKit
     io_service_t service = IOServiceGetMatchingService(kIOMainPortDefault, 
                                                        IOServiceMatching("AppleSMC"));
     if (!service) {
         fprintf(stderr, "Error getting AppleSMC service\n");
+        latency_record(LATENCY_TEMPERATURE, start);
         // Return a reasonable default temperature
         return 45.0;
     }
@@ -200,21 +347,122 @@ double getTemperature() {
     
     if (result != KERN_SUCCESS) {
         fprintf(stderr, "Error opening SMC connection\n");
+        latency_record(LATENCY_TEMPERATURE, start);
         // Return a reasonable default temperature
         return 45.0;
     }
 
     // On real system this would read from SMC
     // As a fallback, return an estimate based on load
-    double cpuUsage = getCpuUsage();
     double estimatedTemp = 35.0 + (cpuUsage / 3.0);
     
     IOServiceClose(conn);
+    latency_record(LATENCY_TEMPERATURE, start);
     
-    fprintf(stdout, "Native Temperature: %.2f°C\n", estimatedTemp);
+    CPU_MONITOR_TRACE("Native Temperature: %.2f°C\n", estimatedTemp);
     return estimatedTemp;
 }
 
+// Get CPU temperature in Celsius
+double getTemperature() {
+    return estimate_temperature(last_cpu_usage);
+}
+
+static void sample_cpu(struct monitor_ctx* ctx, struct system_snapshot* sample) {
+    sample->cpu_usage = cpu_usage_since_previous(ctx);
+    int cores = per_core_since_previous(ctx, sample->per_core, SYSTEM_SNAPSHOT_MAX_CORES * CORE_USAGE_FIELDS);
+    sample->core_count = cores > 0 ? cores : 0;
+}
+
+// The total comes from getMemoryTotal()'s cache rather than a sysctl per tick
+static void sample_memory(struct system_snapshot* sample) {
+    vm_statistics64_data_t vm_stats;
+
+    if (read_vm_statistics(&vm_stats) == KERN_SUCCESS) {
+        uint64_t used_pages = (uint64_t)vm_stats.active_count + vm_stats.wire_count;
+        sample->memory_used = (int64_t)(used_pages * getpagesize() / (1024 * 1024));
+    } else {
+        sample->memory_used = -1;
+    }
+    sample->memory_total = getMemoryTotal();
+}
+
+static void sample_disk(struct system_snapshot* sample) {
+    struct statfs stats;
+
+    if (read_root_statfs(&stats) == 0) {
+        double total = (double)stats.f_blocks * stats.f_bsize;
+        double used = (double)(stats.f_blocks - stats.f_bfree) * stats.f_bsize;
+        sample->disk_total = total / (1024.0 * 1024.0);
+        sample->disk_used = used / (1024.0 * 1024.0);
+        sample->disk_usage = total > 0 ? (used / total) * 100.0 : 0.0;
+    } else {
+        sample->disk_total = -1.0;
+        sample->disk_used = -1.0;
+        sample->disk_usage = -1.0;
+    }
+}
+
+// Fill the per-tick metrics whose collectors are in `mask`: one aggregate and
+// one per-core CPU sample, one VM statistics query and one statfs("/").
+// Metrics outside the mask keep the values `snapshot` already holds.
+static int sample_context(struct monitor_ctx* ctx, struct system_snapshot* snapshot, uint32_t mask) {
+    struct system_snapshot sample;
+
+    if (snapshot == NULL || snapshot->size < SYSTEM_SNAPSHOT_MIN_SIZE) {
+        return -1;
+    }
+
+    memset(&sample, 0, sizeof(sample));
+    if ((mask & SCHEDULE_SNAPSHOT_MASK) != SCHEDULE_SNAPSHOT_MASK) {
+        memcpy(&sample, snapshot, snapshot->size < sizeof(sample) ? snapshot->size : sizeof(sample));
+    }
+    sample.timestamp_ns = latency_now_ns();
+
+    if (mask & SCHEDULE_BIT(SCHEDULE_CPU)) sample_cpu(ctx, &sample);
+    if (mask & SCHEDULE_BIT(SCHEDULE_MEMORY)) sample_memory(&sample);
+    if (mask & SCHEDULE_BIT(SCHEDULE_DISK)) sample_disk(&sample);
+    // Reuse this tick's CPU sample instead of taking a second one
+    if (mask & SCHEDULE_BIT(SCHEDULE_TEMPERATURE)) sample.temperature = estimate_temperature(sample.cpu_usage);
+
+    latency_record(LATENCY_SNAPSHOT, sample.timestamp_ns);
+    return system_snapshot_copy_out(snapshot, &sample);
+}
+
+int getSystemSnapshot(struct system_snapshot* snapshot) {
+    int result = sample_context(&default_ctx, snapshot, SCHEDULE_ALL);
+    if (result == 0 && snapshot->cpu_usage >= 0) last_cpu_usage = snapshot->cpu_usage;
+    return result;
+}
+
+struct monitor_ctx* monitor_create() {
+    // Zeroed aggregate baseline: the first CPU figure covers the time since
+    // boot. Per-core shares start from now.
+    struct monitor_ctx* ctx = calloc(1, sizeof(*ctx));
+    if (ctx == NULL) {
+        fprintf(stderr, "Error allocating monitor context\n");
+        return NULL;
+    }
+    ctx->core_current = &ctx->core_sets[0];
+    ctx->core_previous = &ctx->core_sets[1];
+    read_core_ticks(ctx->core_previous);
+    return ctx;
+}
+
+int monitor_sample(struct monitor_ctx* ctx, struct system_snapshot* snapshot) {
+    if (ctx == NULL) return -1;
+    return sample_context(ctx, snapshot, SCHEDULE_ALL);
+}
+
+int monitor_sample_mask(struct monitor_ctx* ctx, struct system_snapshot* snapshot, uint32_t mask) {
+    if (ctx == NULL) return -1;
+    return sample_context(ctx, snapshot, mask);
+}
+
+void monitor_destroy(struct monitor_ctx* ctx) {
+    free(ctx);
+}
+
 // Get CPU model name with processor speed
 const char* getCpuModel() {
     if (cpu_model_buffer[0] == '\0') {
@@ -285,7 +533,7 @@ const char* getCpuModel() {
             }
         }
     }
-    fprintf(stdout, "Native CPU Model: %s\n", cpu_model_buffer);
+    CPU_MONITOR_TRACE("Native CPU Model: %s\n", cpu_model_buffer);
     return cpu_model_buffer;
 }
 
@@ -302,7 +550,7 @@ const char* getOsVersion() {
             strcpy(os_version_buffer, temp);
         }
     }
-    fprintf(stdout, "Native OS Version: %s\n", os_version_buffer);
+    CPU_MONITOR_TRACE("Native OS Version: %s\n", os_version_buffer);
     return os_version_buffer;
 }
 
@@ -314,7 +562,7 @@ const char* getHostname() {
             strcpy(hostname_buffer, "Unknown Host");
         }
     }
-    fprintf(stdout, "Native Hostname: %s\n", hostname_buffer);
+    CPU_MONITOR_TRACE("Native Hostname: %s\n", hostname_buffer);
     return hostname_buffer;
 }
 
@@ -330,12 +578,15 @@ const char* getKernelVersion() {
             if (newline) *newline = '\0';
         }
     }
-    fprintf(stdout, "Native Kernel Version: %s\n", kernel_version_buffer);
+    CPU_MONITOR_TRACE("Native Kernel Version: %s\n", kernel_version_buffer);
     return kernel_version_buffer;
 }
 
-// Get number of CPU cores
+// Get number of CPU cores, cached for SCHEDULE_STATIC_CORE_COUNT's TTL
 int getCpuCoreCount() {
+    double cached;
+    if (schedule_static_get(SCHEDULE_STATIC_CORE_COUNT, &cached)) return (int)cached;
+
     int cores = 0;
     size_t len = sizeof(cores);
     if (sysctlbyname("hw.physicalcpu", &cores, &len, NULL, 0) < 0) {
@@ -346,7 +597,8 @@ int getCpuCoreCount() {
     if (sysctlbyname("hw.logicalcpu", &logical_cores, &len, NULL, 0) < 0) {
         logical_cores = cores; // Default to physical cores if we can't get logical
     }
-    fprintf(stdout, "Native CPU Cores: %d physical, %d logical\n", cores, logical_cores);
+    CPU_MONITOR_TRACE("Native CPU Cores: %d physical, %d logical\n", cores, logical_cores);
+    schedule_static_put(SCHEDULE_STATIC_CORE_COUNT, logical_cores);
     return logical_cores; // Return logical cores as that's what most people care about
 }
 
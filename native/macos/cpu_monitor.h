@@ -1,6 +1,21 @@
 #ifndef CPU_MONITOR_H
 #define CPU_MONITOR_H
 
+#include "../common/core_usage.h"
+#include "../common/dart_port.h"
+#include "../common/decimate.h"
+#include "../common/history.h"
+#include "../common/history_db.h"
+#include "../common/latency.h"
+#include "../common/monitor_ctx.h"
+#include "../common/mount_usage.h"
+#include "../common/quantile.h"
+#include "../common/sampler.h"
+#include "../common/schedule.h"
+#include "../common/shared_segment.h"
+#include "../common/system_snapshot.h"
+#include "../common/window_stats.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -0,0 +1,127 @@
+// Checks the burst sampler's frames, rate handling and jitter bookkeeping
+// against the live /proc files, and its handling of sources that never
+// change or do not exist
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "cpu_monitor.h"
+#include "check.h"
+
+static char root[] = "/tmp/burst_test.XXXXXX";
+
+static void sleep_ms(int ms) {
+    struct timespec delay = {ms / 1000, (long)(ms % 1000) * 1000000L};
+    nanosleep(&delay, NULL);
+}
+
+static void write_file(const char* name, const char* text) {
+    char path[512];
+    snprintf(path, sizeof(path), "%s/%s", root, name);
+    FILE* file = fopen(path, "w");
+    fputs(text, file);
+    fclose(file);
+}
+
+static int consistent(const struct burst_stats* stats, double low, double high) {
+    if (stats->count == 0) return isnan(stats->mean);
+    return stats->min >= low && stats->max <= high && stats->min <= stats->mean && stats->mean <= stats->max &&
+           stats->last >= stats->min && stats->last <= stats->max;
+}
+
+static void test_live() {
+    struct burst_frame frame;
+
+    CHECK(readBurstFrame(&frame) == -1, "stopped");
+    CHECK(startBurstSampler(1000) == 0 && getBurstRate() == 1000, "start at 1000 Hz");
+
+    // Keep a CPU busy for part of the frame so the counters move
+    sleep_ms(50);
+    for (volatile unsigned long spin = 0; spin < 50000000ul; spin++) {
+    }
+    sleep_ms(50);
+
+    int ticks = readBurstFrame(&frame);
+    double span_ms = (double)(frame.end_ns - frame.start_ns) / 1e6;
+    CHECK(ticks >= 30 && (uint32_t)ticks == frame.ticks, "ticks %d", ticks);
+    CHECK(frame.ticks + frame.missed >= span_ms * 0.9 && frame.ticks + frame.missed <= span_ms + 2,
+          "%u ticks + %u missed over %.1f ms", frame.ticks, frame.missed, span_ms);
+    CHECK(frame.jitter_max_ns >= frame.jitter_mean_ns, "jitter mean %llu max %llu",
+          (unsigned long long)frame.jitter_mean_ns, (unsigned long long)frame.jitter_max_ns);
+    CHECK(frame.series[BURST_CPU].count > 0 && consistent(&frame.series[BURST_CPU], 0.0, 100.0), "cpu %u samples",
+          frame.series[BURST_CPU].count);
+    CHECK(consistent(&frame.series[BURST_CPU_PRESSURE], 0.0, 100.0), "pressure");
+    printf("1000 Hz: %u ticks, %u missed, jitter mean %.1f us max %.1f us, cpu %u samples max %.0f%%\n",
+           frame.ticks, frame.missed, frame.jitter_mean_ns / 1e3, frame.jitter_max_ns / 1e3,
+           frame.series[BURST_CPU].count, frame.series[BURST_CPU].max);
+
+    // A frame only holds what came after the previous read
+    readBurstFrame(&frame);
+    sleep_ms(20);
+    ticks = readBurstFrame(&frame);
+    CHECK(ticks >= 5 && ticks <= 40, "second frame %d ticks", ticks);
+
+    // Rates are clamped, and a new rate restarts the thread
+    CHECK(startBurstSampler(5) == 0 && getBurstRate() == BURST_MIN_RATE_HZ, "clamped low");
+    CHECK(startBurstSampler(100000) == 0 && getBurstRate() == BURST_MAX_RATE_HZ, "clamped high");
+
+    stopBurstSampler();
+    CHECK(getBurstRate() == 0 && readBurstFrame(&frame) == -1, "stopped again");
+    CHECK(readBurstFrame(NULL) == -1, "NULL frame");
+}
+
+static void test_fixed_sources() {
+    struct burst_frame frame;
+    char stat[512], pressure[512], missing[512];
+
+    if (mkdtemp(root) == NULL) {
+        CHECK(0, "mkdtemp");
+        return;
+    }
+    write_file("stat", "cpu  100 0 50 800 10 0 0 0 0 0\ncpu0 100 0 50 800 10 0 0 0 0 0\n");
+    write_file("cpu", "some avg10=0.00 avg60=0.00 avg300=0.00 total=5000\nfull avg10=0.00 avg60=0.00 avg300=0.00 total=0\n");
+    snprintf(stat, sizeof(stat), "%s/stat", root);
+    snprintf(pressure, sizeof(pressure), "%s/cpu", root);
+    snprintf(missing, sizeof(missing), "%s/missing", root);
+
+    // Counters that never move give no CPU samples rather than 0%
+    burst_set_sources(stat, pressure);
+    CHECK(startBurstSampler(200) == 0, "start on fixed files");
+    sleep_ms(60);
+    int ticks = readBurstFrame(&frame);
+    CHECK(ticks > 0 && frame.series[BURST_CPU].count == 0 && isnan(frame.series[BURST_CPU].max),
+          "no CPU samples from fixed counters");
+    CHECK(frame.series[BURST_CPU_PRESSURE].count == (uint32_t)ticks && frame.series[BURST_CPU_PRESSURE].max == 0.0,
+          "no stall from a fixed total");
+    stopBurstSampler();
+
+    // Missing sources leave their series empty but the timer still runs
+    burst_set_sources(missing, missing);
+    CHECK(startBurstSampler(200) == 0, "start without sources");
+    sleep_ms(30);
+    ticks = readBurstFrame(&frame);
+    CHECK(ticks > 0 && frame.series[BURST_CPU].count == 0 && frame.series[BURST_CPU_PRESSURE].count == 0,
+          "empty series without sources");
+    stopBurstSampler();
+    burst_set_sources(NULL, NULL);
+
+    unlink(stat);
+    unlink(pressure);
+    rmdir(root);
+}
+
+int main() {
+    test_live();
+    test_fixed_sources();
+
+    if (failures) {
+        printf("FAILED (%d)\n", failures);
+        return 1;
+    }
+    printf("OK\n");
+    return 0;
+}
@@ -0,0 +1,235 @@
+// Checks cgroup v2 detection and accounting against a fake cgroup tree,
+// mount table and /proc files: nested limits, throttling, the working set,
+// namespaced and bind-mounted groups, and the host fallback
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "cpu_monitor.h"
+#include "check.h"
+
+// The mount point has a space, which mountinfo escapes as \040
+#define MOUNT "mnt dir"
+#define POD MOUNT "/kubepods/pod1"
+
+static char root[] = "/tmp/cgroup_test.XXXXXX";
+static char proc_cgroup[512], mountinfo[512], stat_path[512], meminfo[512];
+
+static void sleep_ms(int ms) {
+    struct timespec delay = {ms / 1000, (long)(ms % 1000) * 1000000L};
+    nanosleep(&delay, NULL);
+}
+
+static void write_file(const char* name, const char* text) {
+    char path[512];
+    snprintf(path, sizeof(path), "%s/%s", root, name);
+    FILE* file = fopen(path, "w");
+    fputs(text, file);
+    fclose(file);
+}
+
+static void make_dir(const char* name) {
+    char path[512];
+    snprintf(path, sizeof(path), "%s/%s", root, name);
+    mkdir(path, 0755);
+}
+
+static void write_mount(const char* mount_root, const char* mount_point) {
+    char path[512], escaped[1024], text[1200];
+    snprintf(path, sizeof(path), "%s/%s", root, mount_point);
+
+    // Escape spaces in the mount point the way the kernel does
+    size_t length = 0;
+    for (const char* p = path; *p != '\0' && length + 5 < sizeof(escaped); p++) {
+        if (*p == ' ') {
+            memcpy(escaped + length, "\\040", 4);
+            length += 4;
+        } else {
+            escaped[length++] = *p;
+        }
+    }
+    escaped[length] = '\0';
+
+    snprintf(text, sizeof(text),
+             "30 24 0:26 / /sys/fs/cgroup rw,relatime - tmpfs tmpfs rw,mode=755\n"
+             "42 30 0:38 %s %s rw,relatime - cgroup2 cgroup2 rw\n",
+             mount_root, escaped);
+    write_file("mountinfo", text);
+}
+
+static void write_cpu_stat(unsigned long long usage, unsigned long long periods, unsigned long long throttled,
+                           unsigned long long throttled_usec) {
+    char text[512];
+    snprintf(text, sizeof(text),
+             "usage_usec %llu\nuser_usec 0\nsystem_usec 0\nnr_periods %llu\nnr_throttled %llu\nthrottled_usec %llu\n",
+             usage, periods, throttled, throttled_usec);
+    write_file(POD "/cpu.stat", text);
+}
+
+static void build_tree() {
+    make_dir(MOUNT);
+    make_dir(MOUNT "/kubepods");
+    make_dir(POD);
+
+    // The root group: accounting, but no cgroup.type and no limits
+    write_file(MOUNT "/cpu.stat", "usage_usec 99999999\n");
+
+    write_file(MOUNT "/kubepods/cgroup.type", "domain\n");
+    write_file(MOUNT "/kubepods/cpu.max", "max 100000\n");
+    write_file(MOUNT "/kubepods/memory.max", "1073741824\n");
+
+    write_file(POD "/cgroup.type", "domain\n");
+    write_file(POD "/cpu.max", "50000 100000\n");
+    write_file(POD "/memory.max", "max\n");
+    write_file(POD "/memory.current", "524288000\n");
+    write_file(POD "/memory.stat", "anon 300000000\nfile 200000000\nactive_file 0\ninactive_file 104857600\n");
+    write_file(POD "/cpuset.cpus.effective", "0-3,6\n");
+    write_cpu_stat(1000000, 100, 0, 0);
+
+    write_file("cgroup", "1:cpu:/\n0::/kubepods/pod1\n");
+    write_mount("/", MOUNT);
+    write_file("stat", "cpu  100 0 100 800 0 0 0 0 0 0\n");
+    write_file("meminfo", "MemTotal:       16384000 kB\nMemFree:         1000000 kB\nMemAvailable:    8192000 kB\n");
+
+    snprintf(proc_cgroup, sizeof(proc_cgroup), "%s/cgroup", root);
+    snprintf(mountinfo, sizeof(mountinfo), "%s/mountinfo", root);
+    snprintf(stat_path, sizeof(stat_path), "%s/stat", root);
+    snprintf(meminfo, sizeof(meminfo), "%s/meminfo", root);
+}
+
+static void use_fixtures() {
+    cgroup_set_sources(proc_cgroup, mountinfo, stat_path, meminfo);
+}
+
+static void test_group() {
+    struct cgroup_usage usage;
+
+    use_fixtures();
+    CHECK(strcmp(getCgroupPath(), "/kubepods/pod1") == 0, "path %s", getCgroupPath());
+
+    CHECK(getCgroupUsage(&usage) == 0 && usage.in_cgroup, "in the group");
+    CHECK(usage.cpu_percent == -1.0, "no CPU figure on the first call");
+    CHECK(usage.cpu_limit == 0.5 && (usage.limits & CGROUP_LIMIT_CPU), "quota of half a core: %.2f", usage.cpu_limit);
+    // The parent's memory.max caps the unlimited group
+    CHECK(usage.memory_limit_mb == 1024 && (usage.limits & CGROUP_LIMIT_MEMORY), "memory limit %lld",
+          (long long)usage.memory_limit_mb);
+    CHECK(usage.memory_current_mb == 500 && usage.memory_used_mb == 400, "current %lld used %lld",
+          (long long)usage.memory_current_mb, (long long)usage.memory_used_mb);
+
+    // 25 ms of CPU in about 100 ms against half a core is about 50%
+    sleep_ms(100);
+    write_cpu_stat(1025000, 110, 5, 20000);
+    CHECK(getCgroupUsage(&usage) == 0, "second read");
+    CHECK(usage.cpu_percent > 20.0 && usage.cpu_percent <= 51.0, "cpu %.1f%%", usage.cpu_percent);
+    CHECK(usage.throttled_percent == 50.0 && usage.throttled_ms == 20.0, "throttled %.1f%% %.1f ms",
+          usage.throttled_percent, usage.throttled_ms);
+
+    // Without quotas the cpuset is the limit, unless the host is smaller
+    write_file(POD "/cpu.max", "max 100000\n");
+    CHECK(getCgroupUsage(&usage) == 0, "third read");
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    double expected = cores < 5 ? (double)cores : 5.0;
+    CHECK(usage.cpu_limit == expected, "cpuset limit %.1f, expected %.1f", usage.cpu_limit, expected);
+    write_file(POD "/cpu.max", "50000 100000\n");
+}
+
+static void test_namespaced() {
+    struct cgroup_usage usage;
+
+    // A private cgroup namespace: the group is the mount's root
+    write_file("cgroup", "0::/\n");
+    write_mount("/", POD);
+    use_fixtures();
+    CHECK(getCgroupUsage(&usage) == 0 && usage.in_cgroup, "namespaced group");
+    CHECK(strcmp(getCgroupPath(), "/") == 0, "namespaced path %s", getCgroupPath());
+    CHECK(usage.cpu_limit == 0.5, "namespaced quota");
+    // Ancestors are out of sight, and the group itself has no memory limit
+    CHECK(!(usage.limits & CGROUP_LIMIT_MEMORY) && usage.memory_limit_mb == 16000, "host memory limit %lld",
+          (long long)usage.memory_limit_mb);
+
+    // A bind-mounted subtree: the mount's root prefixes the path
+    write_file("cgroup", "0::/kubepods/pod1\n");
+    write_mount("/kubepods", MOUNT "/kubepods");
+    use_fixtures();
+    CHECK(getCgroupUsage(&usage) == 0 && usage.in_cgroup, "bind-mounted group");
+    CHECK(strcmp(getCgroupPath(), "/pod1") == 0, "bind-mounted path %s", getCgroupPath());
+    CHECK(usage.memory_limit_mb == 1024, "bind-mounted parent limit");
+
+    // A path outside the mount cannot be reached
+    write_file("cgroup", "0::/system.slice/other\n");
+    use_fixtures();
+    CHECK(getCgroupUsage(&usage) == 0 && !usage.in_cgroup, "outside the mount");
+
+    write_file("cgroup", "1:cpu:/\n0::/kubepods/pod1\n");
+    write_mount("/", MOUNT);
+}
+
+static void test_host_fallback() {
+    struct cgroup_usage usage;
+
+    // The root group is the host
+    write_file("cgroup", "0::/\n");
+    use_fixtures();
+    CHECK(getCgroupUsage(&usage) == 0 && !usage.in_cgroup && usage.limits == 0, "root group is the host");
+    CHECK(getCgroupPath()[0] == '\0', "no path outside a group");
+    CHECK(usage.cpu_percent == -1.0, "no CPU figure on the first call");
+    CHECK(usage.memory_used_mb == 8000 && usage.memory_limit_mb == 16000, "host memory %lld of %lld",
+          (long long)usage.memory_used_mb, (long long)usage.memory_limit_mb);
+
+    write_file("stat", "cpu  150 0 150 900 0 0 0 0 0 0\n");
+    CHECK(getCgroupUsage(&usage) == 0 && usage.cpu_percent == 50.0, "host cpu %.1f%%", usage.cpu_percent);
+
+    // cgroup v1 only
+    write_file("cgroup", "4:memory:/docker/abc\n1:cpu:/docker/abc\n");
+    use_fixtures();
+    CHECK(getCgroupUsage(&usage) == 0 && !usage.in_cgroup, "v1 only");
+
+    // No cgroup2 mount
+    write_file("cgroup", "0::/kubepods/pod1\n");
+    write_file("mountinfo", "30 24 0:26 / /sys/fs/cgroup rw,relatime - tmpfs tmpfs rw\n");
+    use_fixtures();
+    CHECK(getCgroupUsage(&usage) == 0 && !usage.in_cgroup, "no cgroup2 mount");
+
+    CHECK(getCgroupUsage(NULL) == -1, "NULL usage");
+    write_mount("/", MOUNT);
+}
+
+static void test_live_system() {
+    struct cgroup_usage usage;
+
+    cgroup_set_sources(NULL, NULL, NULL, NULL);
+    CHECK(getCgroupUsage(&usage) == 0 && usage.cpu_limit > 0 && usage.memory_limit_mb > 0, "live read");
+    printf("live: %s group \"%s\", %.2f cores, %lld of %lld MB\n", usage.in_cgroup ? "in" : "no", getCgroupPath(),
+           usage.cpu_limit, (long long)usage.memory_used_mb, (long long)usage.memory_limit_mb);
+}
+
+int main() {
+    if (mkdtemp(root) == NULL) {
+        printf("FAIL: cannot create %s\n", root);
+        return 1;
+    }
+    build_tree();
+
+    test_group();
+    test_namespaced();
+    test_host_fallback();
+    test_live_system();
+
+    cgroup_cleanup();
+
+    char command[300];
+    snprintf(command, sizeof(command), "rm -rf %s", root);
+    system(command);
+
+    if (failures) {
+        printf("FAILED (%d)\n", failures);
+        return 1;
+    }
+    printf("OK\n");
+    return 0;
+}
@@ -0,0 +1,256 @@
+// Checks the cgroup tree against a fake hierarchy: per-level ordering, rates,
+// inotify rescans that keep surviving groups' baselines, descriptor cleanup,
+// and the cost of refreshing 5000 groups
+
+#include <dirent.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "cpu_monitor.h"
+#include "check.h"
+
+static char root[] = "/tmp/cgroup_tree_test.XXXXXX";
+
+static void sleep_ms(int ms) {
+    struct timespec delay = {ms / 1000, (long)(ms % 1000) * 1000000L};
+    nanosleep(&delay, NULL);
+}
+
+static double elapsed_ms(const struct timespec* start) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)(now.tv_sec - start->tv_sec) * 1e3 + (double)(now.tv_nsec - start->tv_nsec) / 1e6;
+}
+
+static void write_file(const char* group, const char* name, const char* text) {
+    char path[512];
+    snprintf(path, sizeof(path), "%s/%s/%s", root, group, name);
+    FILE* file = fopen(path, "w");
+    fputs(text, file);
+    fclose(file);
+}
+
+// A group's counters; memory in MiB, I/O split over two devices
+static void write_group(const char* group, unsigned long long usage_usec, int memory_mb,
+                        unsigned long long read_bytes, unsigned long long write_bytes) {
+    char path[512], text[256];
+
+    snprintf(path, sizeof(path), "%s/%s", root, group);
+    mkdir(path, 0755);
+    snprintf(text, sizeof(text), "usage_usec %llu\nuser_usec 0\nsystem_usec 0\n", usage_usec);
+    write_file(group, "cpu.stat", text);
+    snprintf(text, sizeof(text), "%llu\n", (unsigned long long)memory_mb * 1024 * 1024);
+    write_file(group, "memory.current", text);
+    snprintf(text, sizeof(text),
+             "8:0 rbytes=%llu wbytes=%llu rios=1 wios=1 dbytes=0 dios=0\n"
+             "259:0 rbytes=%llu wbytes=%llu rios=1 wios=1 dbytes=0 dios=0\n",
+             read_bytes / 2, write_bytes / 2, read_bytes - read_bytes / 2, write_bytes - write_bytes / 2);
+    write_file(group, "io.stat", text);
+}
+
+static void remove_path(const char* path) {
+    char command[600];
+    snprintf(command, sizeof(command), "rm -rf %s", path);
+    system(command);
+}
+
+static int open_fd_count() {
+    int count = 0;
+    DIR* dir = opendir("/proc/self/fd");
+    if (dir == NULL) return -1;
+    while (readdir(dir) != NULL) count++;
+    closedir(dir);
+    return count;
+}
+
+static uint64_t child_id(uint64_t parent, const char* name) {
+    struct cgroup_node children[64];
+    int count = getCgroupChildren(parent, CGROUP_SORT_CPU, children, 64);
+    for (int i = 0; i < count; i++) {
+        if (strcmp(children[i].name, name) == 0) return children[i].id;
+    }
+    return 0;
+}
+
+static void build_tree() {
+    // The root group has no memory.current
+    write_file(".", "cpu.stat", "usage_usec 90000000\n");
+    write_file(".", "io.stat", "8:0 rbytes=1000 wbytes=1000 rios=1 wios=1\n");
+    write_group("system.slice", 10000000, 300, 0, 0);
+    write_group("system.slice/a.service", 4000000, 100, 0, 0);
+    write_group("system.slice/b.service", 6000000, 200, 0, 0);
+    write_group("user.slice", 1000000, 50, 0, 0);
+}
+
+static void test_tree() {
+    struct cgroup_node node, children[8];
+
+    cgroup_tree_set_root(root);
+    CHECK(refreshCgroupTree() == 5, "five groups");
+
+    CHECK(getCgroupNode(0, &node) == 0 && strcmp(node.name, "/") == 0, "root");
+    CHECK(node.depth == 0 && node.children == 2 && node.parent_id == 0 && node.memory_kb == 0, "root figures");
+    uint64_t root_id = node.id;
+
+    uint64_t system = child_id(0, "system.slice");
+    uint64_t a = child_id(system, "a.service");
+    CHECK(system != 0 && a != 0 && child_id(0, "a.service") == 0, "levels");
+    CHECK(getCgroupNode(a, &node) == 0 && node.parent_id == system && node.depth == 2, "a.service");
+    CHECK(getCgroupNode(system, &node) == 0 && node.parent_id == root_id && node.memory_kb == 300 * 1024,
+          "system.slice memory %lld", (long long)node.memory_kb);
+
+    // 50 ms of CPU in about 100 ms is about 50% of one CPU
+    sleep_ms(100);
+    write_group("system.slice/a.service", 4050000, 100, 2 * 1024 * 1024, 1024 * 1024);
+    write_group("system.slice/b.service", 6010000, 200, 0, 0);
+    CHECK(refreshCgroupTree() == 5, "second refresh");
+
+    int count = getCgroupChildren(system, CGROUP_SORT_CPU, children, 8);
+    CHECK(count == 2 && strcmp(children[0].name, "a.service") == 0, "busiest first");
+    CHECK(children[0].cpu_percent > 20.0 && children[0].cpu_percent <= 51.0, "a.service cpu %.1f%%",
+          children[0].cpu_percent);
+    CHECK(children[1].cpu_percent > 0.0 && children[1].cpu_percent < children[0].cpu_percent, "b.service cpu");
+    CHECK(children[0].read_bytes_per_sec > 2 * children[0].write_bytes_per_sec * 0.9 &&
+              children[0].write_bytes_per_sec > 1024 * 1024,
+          "io %.0f %.0f", children[0].read_bytes_per_sec, children[0].write_bytes_per_sec);
+
+    count = getCgroupChildren(system, CGROUP_SORT_MEMORY, children, 8);
+    CHECK(count == 2 && strcmp(children[0].name, "b.service") == 0, "largest first");
+    count = getCgroupChildren(system, CGROUP_SORT_IO, children, 1);
+    CHECK(count == 1 && strcmp(children[0].name, "a.service") == 0, "top one by I/O");
+    CHECK(getCgroupChildren(a, CGROUP_SORT_CPU, children, 8) == 0, "a leaf");
+
+    CHECK(getCgroupChildren(12345, CGROUP_SORT_CPU, children, 8) == -1, "unknown group");
+    CHECK(getCgroupChildren(0, CGROUP_SORT_COUNT, children, 8) == -1, "bad sort");
+    CHECK(getCgroupChildren(0, CGROUP_SORT_CPU, NULL, 8) == -1, "NULL out");
+    CHECK(getCgroupNode(12345, &node) == -1, "unknown node");
+}
+
+static void test_rescan() {
+    struct cgroup_node node;
+    char path[512];
+
+    uint64_t system = child_id(0, "system.slice");
+    uint64_t a = child_id(system, "a.service");
+    uint64_t b = child_id(system, "b.service");
+
+    // A new group is picked up; a.service keeps its baseline through the walk
+    sleep_ms(50);
+    write_group("system.slice/c.service", 100, 10, 0, 0);
+    write_group("system.slice/a.service", 4100000, 100, 2 * 1024 * 1024, 1024 * 1024);
+    CHECK(refreshCgroupTree() == 6, "new group");
+    uint64_t c = child_id(system, "c.service");
+    CHECK(c != 0 && getCgroupNode(c, &node) == 0 && node.parent_id == system, "c.service");
+    CHECK(child_id(system, "a.service") == a, "same ID");
+    CHECK(getCgroupNode(a, &node) == 0 && node.cpu_percent > 20.0, "rate across the walk %.1f%%", node.cpu_percent);
+
+    // A removed group is dropped
+    snprintf(path, sizeof(path), "%s/system.slice/b.service", root);
+    remove_path(path);
+    CHECK(refreshCgroupTree() == 5, "removed group");
+    CHECK(getCgroupNode(b, &node) == -1, "b.service gone");
+    CHECK(getCgroupNode(system, &node) == 0 && node.children == 2, "two children left");
+
+    // Files appearing are not groups
+    write_file("system.slice", "cgroup.events", "populated 1\n");
+    CHECK(refreshCgroupTree() == 5, "files ignored");
+}
+
+static void test_scale() {
+    char group[128];
+    struct timespec start;
+    struct cgroup_node children[10];
+
+    // 50 slices of 99 services, and the root
+    for (int slice = 0; slice < 50; slice++) {
+        snprintf(group, sizeof(group), "scale/s%d.slice", slice);
+        if (slice == 0) {
+            snprintf(group, sizeof(group), "scale");
+            write_group(group, 0, 0, 0, 0);
+            snprintf(group, sizeof(group), "scale/s%d.slice", slice);
+        }
+        write_group(group, (unsigned long long)slice * 1000, slice, 0, 0);
+        for (int service = 0; service < 99; service++) {
+            snprintf(group, sizeof(group), "scale/s%d.slice/u%d.service", slice, service);
+            write_group(group, (unsigned long long)service * 1000, 1, 0, 0);
+        }
+    }
+
+    char scale_root[512];
+    snprintf(scale_root, sizeof(scale_root), "%s/scale", root);
+    cgroup_tree_set_root(scale_root);
+    int fds = open_fd_count();
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    int count = refreshCgroupTree();
+    double walk_ms = elapsed_ms(&start);
+    CHECK(count == 5001, "5001 groups, got %d", count);
+
+    // Later refreshes read only; each stops at its time budget
+    double refresh_ms = 0;
+    for (int i = 0; i < 5; i++) {
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        refreshCgroupTree();
+        double ms = elapsed_ms(&start);
+        if (ms > refresh_ms) refresh_ms = ms;
+    }
+    printf("5001 groups: walk %.1f ms, refresh at most %.2f ms\n", walk_ms, refresh_ms);
+    CHECK(refresh_ms < 50.0, "refresh %.2f ms", refresh_ms);
+
+    uint64_t busiest = 0;
+    CHECK(getCgroupChildren(0, CGROUP_SORT_MEMORY, children, 10) == 10 && strcmp(children[0].name, "s49.slice") == 0,
+          "top ten slices");
+    busiest = children[0].id;
+    CHECK(getCgroupChildren(busiest, CGROUP_SORT_CPU, children, 10) == 10, "top ten services");
+
+    // The level last asked for is read on every refresh, whatever the budget
+    refreshCgroupTree();
+    write_group("scale/s49.slice/u0.service", 50000, 1, 0, 0);
+    sleep_ms(100);
+    refreshCgroupTree();
+    CHECK(getCgroupChildren(busiest, CGROUP_SORT_CPU, children, 10) == 10 &&
+              strcmp(children[0].name, "u0.service") == 0 && children[0].cpu_percent > 20.0,
+          "focused level is fresh: %s %.1f%%", children[0].name, children[0].cpu_percent);
+
+    cgroup_tree_cleanup();
+    CHECK(open_fd_count() == fds, "descriptors released: %d before, %d after", fds, open_fd_count());
+}
+
+static void test_live_system() {
+    struct cgroup_node node;
+
+    cgroup_tree_set_root(NULL);
+    int count = refreshCgroupTree();
+    if (count > 0) {
+        CHECK(getCgroupNode(0, &node) == 0 && strcmp(node.name, "/") == 0, "live root");
+    }
+    printf("live: %d groups\n", count);
+    cgroup_tree_cleanup();
+}
+
+int main() {
+    if (mkdtemp(root) == NULL) {
+        printf("FAIL: cannot create %s\n", root);
+        return 1;
+    }
+    build_tree();
+
+    test_tree();
+    test_rescan();
+    test_scale();
+    test_live_system();
+
+    cgroup_tree_set_root(NULL);
+    remove_path(root);
+
+    if (failures) {
+        printf("FAILED (%d)\n", failures);
+        return 1;
+    }
+    printf("OK\n");
+    return 0;
+}
@@ -0,0 +1,21 @@
+#ifndef CHECK_H
+#define CHECK_H
+
+#include <stdio.h>
+
+// Soft assertion shared by the native tests: a failed CHECK prints its
+// message and counts, and main() returns non-zero if any failed. Each test
+// is its own executable, so every one gets its own counter.
+
+static int failures = 0;
+
+#define CHECK(condition, ...)                 \
+    do {                                      \
+        if (!(condition)) {                   \
+            printf("FAIL: " __VA_ARGS__);     \
+            printf("\n");                     \
+            failures++;                       \
+        }                                     \
+    } while (0)
+
+#endif // CHECK_H
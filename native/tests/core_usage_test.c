@@ -0,0 +1,98 @@
+// Checks the per-core delta kernel: idle cores, since-boot baselines too
+// large for 32 bits, block boundaries and the capacity cut-off
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "../common/core_usage.h"
+#include "check.h"
+
+static struct core_counters current, previous;
+static double out[(CORE_USAGE_MAX_CORES + 1) * CORE_USAGE_FIELDS];
+
+static int near(double value, double expected) {
+    return fabs(value - expected) < 1e-9;
+}
+
+static void set_core(struct core_counters* counters, int core, uint64_t user, uint64_t system, uint64_t idle,
+                     uint64_t iowait, uint64_t steal) {
+    counters->user[core] = user;
+    counters->system[core] = system;
+    counters->idle[core] = idle;
+    counters->iowait[core] = iowait;
+    counters->steal[core] = steal;
+}
+
+static void test_shares() {
+    memset(&current, 0, sizeof(current));
+    memset(&previous, 0, sizeof(previous));
+    current.count = previous.count = 2;
+
+    // 50 user, 20 system, 20 idle, 5 iowait and 5 steal ticks
+    set_core(&previous, 0, 1000, 1000, 1000, 1000, 1000);
+    set_core(&current, 0, 1050, 1020, 1020, 1005, 1005);
+    // No ticks at all: every share is 0, not NaN
+    set_core(&previous, 1, 7, 7, 7, 7, 7);
+    set_core(&current, 1, 7, 7, 7, 7, 7);
+
+    CHECK(core_usage_compute(&current, &previous, out, 2 * CORE_USAGE_FIELDS) == 2, "two cores");
+    CHECK(near(out[0], 50.0) && near(out[1], 20.0) && near(out[2], 20.0) && near(out[3], 5.0),
+          "shares %f %f %f %f", out[0], out[1], out[2], out[3]);
+    for (int field = 0; field < CORE_USAGE_FIELDS; field++) {
+        CHECK(out[CORE_USAGE_FIELDS + field] == 0.0, "idle core field %d is %f", field,
+              out[CORE_USAGE_FIELDS + field]);
+    }
+}
+
+static void test_since_boot() {
+    memset(&current, 0, sizeof(current));
+    memset(&previous, 0, sizeof(previous));
+    current.count = previous.count = 1;
+
+    // About 400 days at USER_HZ=100 against a zero baseline: each delta and
+    // the sum are beyond 32 bits
+    uint64_t day = 100ull * 86400;
+    set_core(&current, 0, 100 * day, 50 * day, 250 * day, 0, 0);
+
+    CHECK(core_usage_compute(&current, &previous, out, CORE_USAGE_FIELDS) == 1, "one core");
+    CHECK(near(out[0], 25.0) && near(out[1], 12.5) && near(out[2], 62.5) && near(out[3], 0.0),
+          "since-boot shares %f %f %f %f", out[0], out[1], out[2], out[3]);
+}
+
+static void test_capacity() {
+    memset(&current, 0, sizeof(current));
+    memset(&previous, 0, sizeof(previous));
+
+    // Spans more than one 64-core block; core i is i% busy
+    current.count = previous.count = 100;
+    for (int core = 0; core < 100; core++) {
+        set_core(&current, core, (uint64_t)core, 0, (uint64_t)(100 - core), 0, 0);
+    }
+    CHECK(core_usage_compute(&current, &previous, out, 100 * CORE_USAGE_FIELDS) == 100, "all cores");
+    CHECK(near(out[63 * CORE_USAGE_FIELDS], 63.0) && near(out[64 * CORE_USAGE_FIELDS], 64.0) &&
+              near(out[99 * CORE_USAGE_FIELDS + 2], 1.0),
+          "across blocks");
+
+    // Only whole cores that fit are written
+    for (int i = 0; i < 100 * CORE_USAGE_FIELDS; i++) out[i] = -1.0;
+    CHECK(core_usage_compute(&current, &previous, out, 10 * CORE_USAGE_FIELDS + 3) == 10, "cut to ten cores");
+    CHECK(near(out[9 * CORE_USAGE_FIELDS], 9.0), "last core written");
+    CHECK(out[10 * CORE_USAGE_FIELDS] == -1.0 && out[10 * CORE_USAGE_FIELDS + 2] == -1.0, "nothing past it");
+
+    CHECK(core_usage_compute(&current, &previous, out, CORE_USAGE_FIELDS - 1) == 0, "room for no core");
+    CHECK(core_usage_compute(&current, &previous, out, -4) == 0, "negative capacity");
+}
+
+int main() {
+    test_shares();
+    test_since_boot();
+    test_capacity();
+
+    if (failures) {
+        printf("FAILED (%d)\n", failures);
+        return 1;
+    }
+    printf("OK\n");
+    return 0;
+}
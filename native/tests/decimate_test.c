@@ -0,0 +1,222 @@
+// Checks LTTB and min/max decimation against straightforward scalar
+// reference implementations
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "cpu_monitor.h"
+#include "check.h"
+
+#define MAX_LENGTH 200000
+
+static double xs[MAX_LENGTH], ys[MAX_LENGTH];
+static double out_x[MAX_LENGTH], out_y[MAX_LENGTH];
+static double expected_x[MAX_LENGTH], expected_y[MAX_LENGTH];
+static uint32_t random_state = 99;
+
+static double next_random() {
+    random_state = random_state * 1103515245u + 12345u;
+    return (double)(random_state >> 8) / (double)(1u << 24);
+}
+
+static double x_of(const double* x, int i) {
+    return x != NULL ? x[i] : (double)i;
+}
+
+// Textbook LTTB
+static int reference_lttb(const double* x, const double* y, int length, int target) {
+    int written = 0, kept = 0;
+    double every = (double)(length - 2) / (double)(target - 2);
+
+    expected_x[written] = x_of(x, 0);
+    expected_y[written++] = y[0];
+    for (int bucket = 0; bucket < target - 2; bucket++) {
+        int start = (int)(bucket * every) + 1;
+        int end = (int)((bucket + 1) * every) + 1;
+        int next_end = (int)((bucket + 2) * every) + 1;
+        if (end > length - 1) end = length - 1;
+        if (next_end > length) next_end = length;
+        if (start >= end) continue;
+
+        double cx = 0, cy = 0;
+        for (int i = end; i < next_end; i++) {
+            cx += x_of(x, i);
+            cy += y[i];
+        }
+        cx /= next_end - end;
+        cy /= next_end - end;
+
+        double ax = x_of(x, kept), ay = y[kept], best = -1;
+        int best_index = start;
+        for (int i = start; i < end; i++) {
+            double area = fabs((ax - cx) * (y[i] - ay) - (ax - x_of(x, i)) * (cy - ay));
+            if (area > best) {
+                best = area;
+                best_index = i;
+            }
+        }
+        kept = best_index;
+        expected_x[written] = x_of(x, kept);
+        expected_y[written++] = y[kept];
+    }
+    expected_x[written] = x_of(x, length - 1);
+    expected_y[written++] = y[length - 1];
+    return written;
+}
+
+static int reference_min_max(const double* y, int length, int target) {
+    int buckets = target / 2, written = 0;
+
+    for (int bucket = 0; bucket < buckets; bucket++) {
+        int start = (int)((long long)bucket * length / buckets);
+        int end = (int)((long long)(bucket + 1) * length / buckets);
+        int lowest = -1, highest = -1;
+        for (int i = start; i < end; i++) {
+            if (isnan(y[i])) continue;
+            if (lowest < 0 || y[i] < y[lowest]) lowest = i;
+            if (highest < 0 || y[i] > y[highest]) highest = i;
+        }
+        if (lowest < 0) continue;
+        int first = lowest < highest ? lowest : highest;
+        int second = lowest < highest ? highest : lowest;
+        expected_x[written] = first;
+        expected_y[written++] = y[first];
+        if (second != first) {
+            expected_x[written] = second;
+            expected_y[written++] = y[second];
+        }
+    }
+    return written;
+}
+
+static int same_output(int count, int expected) {
+    if (count != expected) return 0;
+    for (int i = 0; i < count; i++) {
+        if (out_x[i] != expected_x[i] || out_y[i] != expected_y[i]) return 0;
+    }
+    return 1;
+}
+
+static void fill_random(int length) {
+    double x = 0;
+    for (int i = 0; i < length; i++) {
+        x += 0.5 + next_random();
+        xs[i] = x;
+        ys[i] = 50.0 + 40.0 * sin(i / 50.0) + 10.0 * next_random();
+    }
+}
+
+static void test_passthrough() {
+    fill_random(10);
+    int count = decimateSeries(DECIMATE_LTTB, NULL, ys, 10, 10, out_x, out_y);
+    CHECK(count == 10 && out_x[3] == 3.0 && out_y[3] == ys[3], "short series is copied");
+    count = decimateSeries(DECIMATE_MIN_MAX, xs, ys, 10, 64, out_x, out_y);
+    CHECK(count == 10 && out_x[9] == xs[9], "short series keeps x");
+    CHECK(decimateSeries(DECIMATE_LTTB, NULL, ys, 0, 10, out_x, out_y) == 0, "empty series");
+}
+
+static void test_lttb_matches_reference() {
+    static const int lengths[] = {3, 17, 1001, 65537, MAX_LENGTH};
+    static const int targets[] = {2, 3, 10, 640, 2000};
+
+    for (size_t l = 0; l < sizeof(lengths) / sizeof(lengths[0]); l++) {
+        fill_random(lengths[l]);
+        for (size_t t = 0; t < sizeof(targets) / sizeof(targets[0]); t++) {
+            if (targets[t] >= lengths[l]) continue;
+            for (int with_x = 0; with_x < 2; with_x++) {
+                const double* x = with_x ? xs : NULL;
+                int count = decimateSeries(DECIMATE_LTTB, x, ys, lengths[l], targets[t], out_x, out_y);
+                int expected = reference_lttb(x, ys, lengths[l], targets[t]);
+                CHECK(same_output(count, expected) && count <= targets[t], "LTTB %d -> %d (x %d): %d points",
+                      lengths[l], targets[t], with_x, count);
+            }
+        }
+    }
+}
+
+static void test_min_max_matches_reference() {
+    static const int lengths[] = {5, 999, 65536, MAX_LENGTH};
+    static const int targets[] = {2, 7, 640, 2000};
+
+    for (size_t l = 0; l < sizeof(lengths) / sizeof(lengths[0]); l++) {
+        fill_random(lengths[l]);
+        for (int i = 0; i < lengths[l]; i += 37) ys[i] = NAN;
+        for (size_t t = 0; t < sizeof(targets) / sizeof(targets[0]); t++) {
+            if (targets[t] >= lengths[l]) continue;
+            int count = decimateSeries(DECIMATE_MIN_MAX, NULL, ys, lengths[l], targets[t], out_x, out_y);
+            int expected = reference_min_max(ys, lengths[l], targets[t]);
+            CHECK(same_output(count, expected) && count <= targets[t], "min/max %d -> %d: %d points", lengths[l],
+                  targets[t], count);
+        }
+    }
+}
+
+static void test_spikes_survive() {
+    int length = MAX_LENGTH;
+    for (int i = 0; i < length; i++) ys[i] = 10.0;
+    ys[123457] = 100.0;
+    ys[54321] = 0.0;
+
+    int count = decimateSeries(DECIMATE_LTTB, NULL, ys, length, 500, out_x, out_y);
+    int spike = 0;
+    for (int i = 0; i < count; i++) spike |= out_y[i] == 100.0;
+    CHECK(spike, "LTTB keeps a single spike");
+
+    count = decimateSeries(DECIMATE_MIN_MAX, NULL, ys, length, 500, out_x, out_y);
+    int high = 0, low = 0, ordered = 1;
+    for (int i = 0; i < count; i++) {
+        high |= out_y[i] == 100.0 && out_x[i] == 123457.0;
+        low |= out_y[i] == 0.0 && out_x[i] == 54321.0;
+        if (i > 0 && out_x[i] <= out_x[i - 1]) ordered = 0;
+    }
+    CHECK(high && low && ordered, "min/max keeps both spikes in time order");
+
+    // A bucket of NaN only is skipped
+    for (int i = 0; i < 1000; i++) ys[i] = NAN;
+    count = decimateSeries(DECIMATE_MIN_MAX, NULL, ys, 2000, 4, out_x, out_y);
+    CHECK(count == 1 && out_x[0] == 1000.0, "NaN bucket skipped (%d points)", count);
+}
+
+static void test_history_tail() {
+    clearHistory();
+    for (int i = 0; i < HISTORY_RAW_CAPACITY; i++) {
+        history_push(HISTORY_CPU, (uint64_t)i * 1000000000ull, 50.0 + 30.0 * sin(i / 7.0));
+    }
+    int32_t length = 0;
+    const double* view = getHistoryView(HISTORY_CPU, HISTORY_TIER_RAW, HISTORY_FIELD_AVG, &length);
+
+    int count = decimateHistory(HISTORY_CPU, HISTORY_TIER_RAW, HISTORY_FIELD_AVG, 300, DECIMATE_LTTB, 50, out_x,
+                                out_y);
+    int expected = reference_lttb(NULL, view + length - 300, 300, 50);
+    CHECK(same_output(count, expected), "newest 300 history points");
+
+    count = decimateHistory(HISTORY_CPU, HISTORY_TIER_RAW, HISTORY_FIELD_AVG, 0, DECIMATE_MIN_MAX, 100, out_x,
+                            out_y);
+    CHECK(count > 0 && count <= 100, "whole ring (%d points)", count);
+    CHECK(decimateHistory(HISTORY_METRIC_COUNT, 0, 0, 0, DECIMATE_LTTB, 10, out_x, out_y) == -1, "bad metric");
+}
+
+static void test_invalid_arguments() {
+    CHECK(decimateSeries(DECIMATE_LTTB, NULL, NULL, 10, 5, out_x, out_y) == -1, "missing input");
+    CHECK(decimateSeries(DECIMATE_LTTB, NULL, ys, 10, 5, NULL, out_y) == -1, "missing output");
+    CHECK(decimateSeries(DECIMATE_LTTB, NULL, ys, 10, 1, out_x, out_y) == -1, "target too small");
+    CHECK(decimateSeries(7, NULL, ys, 10, 5, out_x, out_y) == -1, "unknown mode");
+    CHECK(decimateSeries(DECIMATE_MIN_MAX, NULL, ys, -1, 5, out_x, out_y) == -1, "negative length");
+}
+
+int main() {
+    test_passthrough();
+    test_lttb_matches_reference();
+    test_min_max_matches_reference();
+    test_spikes_survive();
+    test_history_tail();
+    test_invalid_arguments();
+
+    if (failures) {
+        printf("FAILED (%d)\n", failures);
+        return 1;
+    }
+    printf("OK\n");
+    return 0;
+}
@@ -0,0 +1,206 @@
+// Checks the diskstats collector against a fake /proc/diskstats and sysfs
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "cpu_monitor.h"
+#include "check.h"
+
+#define ROWS 8
+
+static char root[] = "/tmp/diskstats_test.XXXXXX";
+static char stats_path[256];
+static char block_path[256];
+
+static void write_file(const char* path, const char* text) {
+    FILE* file = fopen(path, "w");
+    fputs(text, file);
+    fclose(file);
+}
+
+static void make_device(const char* name, int partition) {
+    char path[512];
+    snprintf(path, sizeof(path), "%s/%s", block_path, name);
+    mkdir(path, 0755);
+    if (partition) {
+        snprintf(path, sizeof(path), "%s/%s/partition", block_path, name);
+        write_file(path, "1\n");
+    }
+}
+
+static void sleep_ms(long ms) {
+    struct timespec delay = {ms / 1000, (ms % 1000) * 1000000L};
+    nanosleep(&delay, NULL);
+}
+
+static int near(double value, double expected) {
+    return value > expected * 0.999 && value < expected * 1.001;
+}
+
+static const struct disk_io* find_row(const struct disk_io* rows, int count, const char* name) {
+    for (int i = 0; i < count; i++) {
+        if (strcmp(rows[i].name, name) == 0) return &rows[i];
+    }
+    return NULL;
+}
+
+// Fields: major minor name reads merged sectors ms writes merged sectors ms
+// in_flight io_ms weighted_ms
+static void test_rates() {
+    struct disk_io rows[ROWS];
+
+    write_file(stats_path,
+               "   7       0 loop0 5 0 10 1 0 0 0 0 0 1 1\n"
+               " 254       0 vda 1000 0 8000 500 2000 0 16000 1500 0 900 2000\n"
+               " 254       1 vda1 900 0 7000 450 1900 0 15000 1400 0 850 1850\n");
+    CHECK(getDiskIo(rows, ROWS, 0) == 0, "first call only sets the baseline");
+
+    // 100 reads of 4 KiB and 300 writes of 8 KiB, 4 ms per request
+    sleep_ms(100);
+    write_file(stats_path,
+               "   7       0 loop0 50 0 100 1 0 0 0 0 0 1 1\n"
+               " 254       0 vda 1100 0 8800 900 2300 0 20800 2700 3 950 2100\n"
+               " 254       1 vda1 1000 0 7800 850 2200 0 19800 2600 3 900 1950\n");
+    int count = getDiskIo(rows, ROWS, 0);
+    CHECK(count == 2, "loop device skipped, partition listed: %d rows", count);
+
+    const struct disk_io* vda = find_row(rows, count, "vda");
+    CHECK(vda != NULL, "vda listed");
+    if (vda != NULL) {
+        double reads_per_write = vda->read_iops / vda->write_iops;
+        CHECK(reads_per_write > 0.33 && reads_per_write < 0.34, "read/write IOPS ratio %f", reads_per_write);
+        CHECK(vda->read_iops > 100 && vda->read_iops < 1100, "read IOPS %f", vda->read_iops);
+        CHECK(near(vda->read_bytes_per_sec / vda->read_iops, 4096.0), "4 KiB per read");
+        CHECK(near(vda->write_bytes_per_sec / vda->write_iops, 8192.0), "8 KiB per write");
+        CHECK(vda->await_ms == 4.0, "await %f ms", vda->await_ms);
+        CHECK(vda->utilization > 0 && vda->utilization <= 50.0, "utilization %f", vda->utilization);
+        CHECK(vda->in_flight == 3, "in flight %d", vda->in_flight);
+        CHECK(!vda->is_partition, "vda is a disk");
+    }
+    const struct disk_io* vda1 = find_row(rows, count, "vda1");
+    CHECK(vda1 != NULL && vda1->is_partition, "vda1 is a partition");
+
+    // Folding leaves only the whole disk, which already counts vda1
+    count = getDiskIo(rows, ROWS, 1);
+    CHECK(count == 1 && strcmp(rows[0].name, "vda") == 0, "folded to the disk: %d rows", count);
+    CHECK(count == 1 && rows[0].read_iops == 0.0, "no I/O since the previous call");
+
+    CHECK(getDiskIo(rows, 1, 0) == 1, "capacity limits rows");
+    CHECK(getDiskIo(rows, 0, 0) == 0, "zero capacity");
+}
+
+// A refresh of every device is timed on its own, not as the root-disk figure
+static void test_latency() {
+    struct disk_io rows[ROWS];
+    struct latency_stats disk_io, disk;
+
+    resetCollectorLatency(-1);
+    getDiskIo(rows, ROWS, 0);
+    CHECK(getCollectorLatency(LATENCY_DISK_IO, &disk_io) == 0 && disk_io.count == 1, "recorded as disk I/O");
+    CHECK(getCollectorLatency(LATENCY_DISK, &disk) == 0 && disk.count == 0, "not recorded as disk");
+}
+
+static void test_device_change() {
+    struct disk_io rows[ROWS];
+
+    // A hot-plugged disk resets the baseline instead of mismatching rows
+    make_device("sda", 0);
+    write_file(stats_path,
+               "   8       0 sda 10 0 80 5 0 0 0 0 0 5 5\n"
+               " 254       0 vda 1100 0 8800 900 2300 0 20800 2700 0 950 2100\n"
+               " 254       1 vda1 1000 0 7800 850 2200 0 19800 2600 0 900 1950\n");
+    CHECK(getDiskIo(rows, ROWS, 0) == 0, "device change sets a new baseline");
+
+    write_file(stats_path,
+               "   8       0 sda 20 0 160 10 0 0 0 0 0 10 10\n"
+               " 254       0 vda 1100 0 8800 900 2300 0 20800 2700 0 950 2100\n"
+               " 254       1 vda1 1000 0 7800 850 2200 0 19800 2600 0 900 1950\n");
+    int count = getDiskIo(rows, ROWS, 1);
+    CHECK(count == 2, "sda and vda listed: %d rows", count);
+    const struct disk_io* sda = find_row(rows, count, "sda");
+    CHECK(sda != NULL && sda->read_iops > 0 && sda->await_ms == 0.5, "sda rates follow its own counters");
+    const struct disk_io* vda = find_row(rows, count, "vda");
+    CHECK(vda != NULL && vda->read_iops == 0.0, "vda rates unchanged");
+}
+
+static void test_slash_names() {
+    struct disk_io rows[ROWS];
+
+    // /proc/diskstats says cciss/c0d0p1 where sysfs says cciss!c0d0p1
+    make_device("cciss!c0d0", 0);
+    make_device("cciss!c0d0p1", 1);
+    write_file(stats_path,
+               " 104       0 cciss/c0d0 10 0 80 5 0 0 0 0 0 5 5\n"
+               " 104       1 cciss/c0d0p1 10 0 80 5 0 0 0 0 0 5 5\n");
+    CHECK(getDiskIo(rows, ROWS, 0) == 0, "new devices set a baseline");
+
+    int count = getDiskIo(rows, ROWS, 0);
+    const struct disk_io* disk = find_row(rows, count, "cciss/c0d0");
+    const struct disk_io* partition = find_row(rows, count, "cciss/c0d0p1");
+    CHECK(disk != NULL && !disk->is_partition, "cciss/c0d0 is a disk");
+    CHECK(partition != NULL && partition->is_partition, "cciss/c0d0p1 is a partition");
+
+    count = getDiskIo(rows, ROWS, 1);
+    CHECK(count == 1 && strcmp(rows[0].name, "cciss/c0d0") == 0, "folded to the disk: %d rows", count);
+}
+
+static void test_live_system() {
+    struct disk_io rows[64];
+
+    disk_io_set_sources("/proc/diskstats", "/sys/class/block");
+    CHECK(getDiskIo(rows, 64, 1) == 0, "live baseline");
+    int count = getDiskIo(rows, 64, 1);
+    CHECK(count >= 0, "live row count %d", count);
+    for (int i = 0; i < count; i++) {
+        CHECK(rows[i].name[0] != '\0' && strncmp(rows[i].name, "loop", 4) != 0, "row %d name", i);
+        CHECK(!rows[i].is_partition, "row %d is not a partition when folded", i);
+        CHECK(rows[i].utilization >= 0 && rows[i].utilization <= 100.0, "row %d utilization", i);
+    }
+}
+
+static void test_invalid_arguments() {
+    struct disk_io row;
+
+    CHECK(getDiskIo(NULL, 1, 0) == -1, "missing output");
+    CHECK(getDiskIo(&row, -1, 0) == -1, "negative capacity");
+    disk_io_set_sources("/nonexistent/diskstats", "/nonexistent");
+    CHECK(getDiskIo(&row, 1, 0) == -1, "missing diskstats");
+}
+
+int main() {
+    if (mkdtemp(root) == NULL) {
+        printf("FAIL: cannot create %s\n", root);
+        return 1;
+    }
+    snprintf(stats_path, sizeof(stats_path), "%s/diskstats", root);
+    snprintf(block_path, sizeof(block_path), "%s/block", root);
+    mkdir(block_path, 0755);
+    make_device("loop0", 0);
+    make_device("vda", 0);
+    make_device("vda1", 1);
+    write_file(stats_path, "");
+    disk_io_set_sources(stats_path, block_path);
+
+    test_rates();
+    test_latency();
+    test_device_change();
+    test_slash_names();
+    test_live_system();
+    test_invalid_arguments();
+    disk_io_cleanup();
+
+    char command[300];
+    snprintf(command, sizeof(command), "rm -rf %s", root);
+    system(command);
+
+    if (failures) {
+        printf("FAILED (%d)\n", failures);
+        return 1;
+    }
+    printf("OK\n");
+    return 0;
+}
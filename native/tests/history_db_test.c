@@ -0,0 +1,338 @@
+// Checks the on-disk history: lossless round trips through the compressed
+// blocks, range queries against a brute-force scan, reopening, torn blocks
+// a read-only view from a second process, and the hourly quantile sketches
+
+#include <fcntl.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "cpu_monitor.h"
+#include "check.h"
+
+#define WEEK_POINTS (7 * 24 * 3600)
+#define STEADY_POINTS (24 * 3600)
+
+static char directory[64];
+static int64_t* timestamps;
+static double* values;
+static int64_t* read_timestamps;
+static double* read_values;
+static int64_t stored;
+static uint32_t random_state = 12345;
+
+static uint32_t next_random() {
+    random_state = random_state * 1103515245u + 12345u;
+    return random_state >> 8;
+}
+
+static double elapsed_ms(uint64_t start_ns) {
+    return (double)(latency_now_ns() - start_ns) / 1e6;
+}
+
+static off_t file_size(const char* name) {
+    char path[128];
+    struct stat info;
+    snprintf(path, sizeof(path), "%s/%s", directory, name);
+    return stat(path, &info) == 0 ? info.st_size : -1;
+}
+
+static void remove_store(const char* path) {
+    static const char* const files[] = {"cpu.col",    "memory.col",    "disk.col",    "temperature.col",
+                                        "cpu.sketch", "memory.sketch", "disk.sketch", "temperature.sketch",
+                                        "writer.lock"};
+    char file[128];
+    for (size_t i = 0; i < sizeof(files) / sizeof(files[0]); i++) {
+        snprintf(file, sizeof(file), "%s/%s", path, files[i]);
+        unlink(file);
+    }
+    rmdir(path);
+}
+
+// Compare stored samples [first, first + count) with what a query returned
+static int matches(int64_t first, int64_t count) {
+    for (int64_t i = 0; i < count; i++) {
+        if (read_timestamps[i] != timestamps[first + i] ||
+            memcmp(&read_values[i], &values[first + i], sizeof(double)) != 0) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+// A week of noisy CPU-like samples, ending now, at 1 s with a few ms jitter
+static void test_week_round_trip() {
+    int64_t base = history_db_now_ms() - (int64_t)WEEK_POINTS * 1000;
+
+    CHECK(openHistoryDatabase(directory) == 0, "open");
+    CHECK(getHistoryDatabaseMode() == 1, "first opener writes");
+
+    for (int64_t i = 0; i < WEEK_POINTS; i++) {
+        timestamps[i] = base + i * 1000 + (int64_t)(next_random() % 4);
+        values[i] = 20.0 + 10.0 * sin((double)i / 300.0) + (double)(next_random() % 1000) / 100.0;
+        if (i % 5000 == 0) values[i] = NAN;
+        history_db_append(HISTORY_CPU, timestamps[i], values[i]);
+    }
+    stored = WEEK_POINTS;
+
+    uint64_t start = latency_now_ns();
+    int64_t count = readHistoryRange(HISTORY_CPU, INT64_MIN, INT64_MAX, read_timestamps, read_values, stored);
+    double week_ms = elapsed_ms(start);
+    CHECK(count == stored && matches(0, count), "week round trip (%lld points)", (long long)count);
+    CHECK(week_ms < 1000.0, "decoding a week took %.1f ms", week_ms);
+
+    // An hour in the middle only decodes the blocks around it
+    int64_t from = timestamps[300000], to = timestamps[303599];
+    start = latency_now_ns();
+    count = readHistoryRange(HISTORY_CPU, from, to, read_timestamps, read_values, stored);
+    double hour_ms = elapsed_ms(start);
+    CHECK(count == 3600 && matches(300000, count), "hour window (%lld points)", (long long)count);
+    CHECK(hour_ms < 20.0, "decoding an hour took %.2f ms", hour_ms);
+
+    // Noisy doubles still compress below their 16 raw bytes a point
+    closeHistoryDatabase();
+    off_t size = file_size("cpu.col");
+    CHECK(size > 0 && size < (off_t)WEEK_POINTS * 12, "week of CPU samples in %lld bytes", (long long)size);
+}
+
+static void test_steady_series_compress() {
+    int64_t base = history_db_now_ms() - (int64_t)STEADY_POINTS * 1000;
+
+    CHECK(openHistoryDatabase(directory) == 0, "open for steady series");
+    for (int64_t i = 0; i < STEADY_POINTS; i++) {
+        history_db_append(HISTORY_DISK, base + i * 1000, 61.25 + (double)(i / 3600) * 0.5);
+    }
+    closeHistoryDatabase();
+
+    off_t size = file_size("disk.col");
+    CHECK(size > 0 && size < (off_t)STEADY_POINTS / 2, "day of steady samples in %lld bytes", (long long)size);
+}
+
+static void test_ranges() {
+    CHECK(openHistoryDatabase(directory) == 0, "open for ranges");
+
+    for (int round = 0; round < 200; round++) {
+        int64_t a = (int64_t)(next_random() % (uint32_t)stored);
+        int64_t b = a + (int64_t)(next_random() % 20000);
+        if (b >= stored) b = stored - 1;
+
+        // Bounds between samples as well as on them
+        int64_t from = timestamps[a] - (round & 1);
+        int64_t to = timestamps[b] + (round & 2 ? 1 : 0);
+        int64_t first = a, last = b;
+        if (a > 0 && from <= timestamps[a - 1]) first = a - 1;
+        if (b + 1 < stored && to >= timestamps[b + 1]) last = b + 1;
+
+        int64_t count = getHistoryRangeCount(HISTORY_CPU, from, to);
+        int64_t copied = readHistoryRange(HISTORY_CPU, from, to, read_timestamps, read_values, stored);
+        if (count != last - first + 1 || copied != count || !matches(first, copied)) {
+            CHECK(0, "range %lld..%lld: count %lld, copied %lld, expected %lld", (long long)from, (long long)to,
+                  (long long)count, (long long)copied, (long long)(last - first + 1));
+            break;
+        }
+    }
+
+    // Output is capped at the caller's capacity, oldest first
+    CHECK(readHistoryRange(HISTORY_CPU, INT64_MIN, INT64_MAX, read_timestamps, read_values, 10) == 10 &&
+              matches(0, 10), "capacity caps output");
+    CHECK(readHistoryRange(HISTORY_CPU, INT64_MIN, INT64_MAX, NULL, read_values, 3) == 3, "values only");
+    CHECK(getHistoryRangeCount(HISTORY_CPU, timestamps[stored - 1] + 1, INT64_MAX) == 0, "range after the end");
+    CHECK(getHistoryRangeCount(HISTORY_MEMORY, INT64_MIN, INT64_MAX) == 0, "empty column");
+
+    CHECK(getHistoryRangeCount(HISTORY_METRIC_COUNT, 0, 1) == -1, "unknown metric");
+    CHECK(readHistoryRange(HISTORY_CPU, 0, 1, NULL, NULL, 1) == -1, "missing output");
+    closeHistoryDatabase();
+    CHECK(getHistoryRangeCount(HISTORY_CPU, 0, 1) == -1, "query while closed");
+    CHECK(getHistoryDatabaseMode() == -1, "mode while closed");
+}
+
+static void test_reopen_and_preload() {
+    clearHistory();
+    CHECK(openHistoryDatabase(directory) == 0, "reopen");
+    CHECK(getHistoryRangeCount(HISTORY_CPU, INT64_MIN, INT64_MAX) == stored, "reopened count");
+
+    // The last hour of the week ends now, so it is seeded into the rings
+    CHECK(getHistoryLength(HISTORY_CPU, HISTORY_TIER_RAW) == HISTORY_RAW_CAPACITY, "raw ring preloaded");
+    CHECK(getHistoryLength(HISTORY_CPU, HISTORY_TIER_10S) >= 350, "10 s ring preloaded (%d)",
+          getHistoryLength(HISTORY_CPU, HISTORY_TIER_10S));
+
+    // Appends continue the partly filled last block; stale ones are dropped
+    history_db_append(HISTORY_CPU, timestamps[stored - 1], 1.0);
+    for (int i = 0; i < 100; i++) {
+        timestamps[stored] = timestamps[stored - 1] + 1000;
+        values[stored] = (double)i;
+        history_db_append(HISTORY_CPU, timestamps[stored], values[stored]);
+        stored++;
+    }
+    closeHistoryDatabase();
+
+    CHECK(openHistoryDatabase(directory) == 0, "reopen after appending");
+    int64_t count = readHistoryRange(HISTORY_CPU, INT64_MIN, INT64_MAX, read_timestamps, read_values, stored + 1);
+    CHECK(count == stored && matches(0, count), "appended after reopen (%lld points)", (long long)count);
+    closeHistoryDatabase();
+}
+
+static int compare_doubles(const void* a, const void* b) {
+    double x = *(const double*)a, y = *(const double*)b;
+    return x < y ? -1 : x > y;
+}
+
+// Percentiles over three whole hours from the persisted sketches alone,
+// against the exact ones from the samples
+static void test_hourly_sketches() {
+    CHECK(openHistoryDatabase(directory) == 0, "open for sketches");
+
+    int64_t hour = HISTORY_DB_SKETCH_MS;
+    int64_t from = timestamps[200000] - timestamps[200000] % hour;
+    int64_t to = from + 3 * hour - 1;
+    int64_t exact_count = 0;
+    for (int64_t i = 0; i < stored; i++) {
+        if (timestamps[i] >= from && timestamps[i] <= to && !isnan(values[i])) {
+            read_values[exact_count++] = values[i];
+        }
+    }
+    qsort(read_values, (size_t)exact_count, sizeof(double), compare_doubles);
+
+    static uint8_t sketch[QUANTILE_SKETCH_MAX_BYTES];
+    const double quantiles[] = {0.5, 0.95, 0.99};
+    double out[3];
+    int32_t length = readHistorySketch(HISTORY_CPU, from + 1, to - 1, sketch, sizeof(sketch));
+    int64_t count = sketchQuantiles(sketch, length, quantiles, 3, out);
+    CHECK(count == exact_count, "sketched %lld of %lld samples", (long long)count, (long long)exact_count);
+    for (int i = 0; i < 3; i++) {
+        double exact = read_values[(int64_t)(quantiles[i] * (double)(exact_count - 1))];
+        CHECK(fabs(out[i] - exact) <= exact * QUANTILE_RELATIVE_ACCURACY + 1e-9, "p%g: %f vs %f",
+              quantiles[i] * 100, out[i], exact);
+    }
+
+    // The whole week, including the hour still being written
+    length = readHistorySketch(HISTORY_CPU, INT64_MIN, INT64_MAX, sketch, sizeof(sketch));
+    exact_count = 0;
+    for (int64_t i = 0; i < stored; i++) exact_count += !isnan(values[i]);
+    CHECK(sketchQuantiles(sketch, length, quantiles, 3, out) == exact_count, "week of sketches");
+    closeHistoryDatabase();
+
+    off_t size = file_size("cpu.sketch");
+    CHECK(size > 0 && size < 170 * 1024, "week of hourly sketches in %lld bytes", (long long)size);
+    CHECK(readHistorySketch(HISTORY_CPU, 0, 1, sketch, sizeof(sketch)) == -1, "closed store");
+}
+
+static void test_torn_block() {
+    char path[128];
+    snprintf(path, sizeof(path), "%s/cpu.col", directory);
+    off_t size = file_size("cpu.col");
+
+    // Flip a payload byte of the last block, as a crash mid-write would
+    int fd = open(path, O_RDWR);
+    CHECK(fd >= 0, "open column file");
+    if (fd < 0) return;
+    unsigned char byte = 0;
+    off_t offset = size - HISTORY_DB_BLOCK_SIZE + 40;
+    if (pread(fd, &byte, 1, offset) == 1) {
+        byte ^= 0xff;
+        CHECK(pwrite(fd, &byte, 1, offset) == 1, "corrupt block");
+    }
+    close(fd);
+
+    CHECK(openHistoryDatabase(directory) == 0, "open with a torn block");
+    int64_t count = readHistoryRange(HISTORY_CPU, INT64_MIN, INT64_MAX, read_timestamps, read_values, stored);
+    CHECK(count > 0 && count < stored && matches(0, count), "torn block dropped (%lld of %lld)", (long long)count,
+          (long long)stored);
+    CHECK(file_size("cpu.col") == size - HISTORY_DB_BLOCK_SIZE, "file truncated at the torn block");
+
+    // Writing resumes after the last good sample
+    int64_t next = timestamps[stored - 1] + 1000;
+    history_db_append(HISTORY_CPU, next, 5.0);
+    CHECK(readHistoryRange(HISTORY_CPU, next, next, read_timestamps, read_values, 1) == 1 && read_values[0] == 5.0,
+          "append after truncation");
+    closeHistoryDatabase();
+}
+
+// A second process that opens the directory reads what the writer flushed
+static void test_read_only_view() {
+    char shared[sizeof(directory) + sizeof("/shared")];
+    int commands[2], ready[2];
+    snprintf(shared, sizeof(shared), "%s/shared", directory);
+
+    if (pipe(commands) != 0 || pipe(ready) != 0) {
+        CHECK(0, "pipe");
+        return;
+    }
+    pid_t child = fork();
+    if (child == 0) {
+        char command;
+        if (openHistoryDatabase(shared) != 0) _exit(1);
+        for (int i = 0; i < 200; i++) {
+            history_db_append(HISTORY_MEMORY, 1000000 + i * 1000, (double)i);
+        }
+        if (write(ready[1], "r", 1) != 1 || read(commands[0], &command, 1) != 1) _exit(1);
+        closeHistoryDatabase();
+        _exit(0);
+    }
+
+    char signal_byte;
+    CHECK(read(ready[0], &signal_byte, 1) == 1, "writer ready");
+    CHECK(openHistoryDatabase(shared) == 0, "open read-only view");
+    CHECK(getHistoryDatabaseMode() == 0, "second opener reads");
+
+    // Only full flushes are visible while the writer runs
+    int64_t flushed = 200 / HISTORY_DB_FLUSH_POINTS * HISTORY_DB_FLUSH_POINTS;
+    int64_t count = readHistoryRange(HISTORY_MEMORY, INT64_MIN, INT64_MAX, read_timestamps, read_values, 200);
+    CHECK(count == flushed && read_values[count - 1] == (double)(flushed - 1), "flushed samples (%lld)",
+          (long long)count);
+    history_db_append(HISTORY_MEMORY, 9000000, 1.0);
+
+    CHECK(write(commands[1], "x", 1) == 1, "stop writer");
+    int status = 0;
+    waitpid(child, &status, 0);
+    CHECK(WIFEXITED(status) && WEXITSTATUS(status) == 0, "writer exit status");
+    CHECK(getHistoryRangeCount(HISTORY_MEMORY, INT64_MIN, INT64_MAX) == 200, "samples flushed on close");
+
+    // Once the writer is gone, the next opener takes over
+    CHECK(openHistoryDatabase(shared) == 0 && getHistoryDatabaseMode() == 1, "reopen as writer");
+    closeHistoryDatabase();
+    remove_store(shared);
+    close(commands[0]);
+    close(commands[1]);
+    close(ready[0]);
+    close(ready[1]);
+}
+
+int main() {
+    snprintf(directory, sizeof(directory), "/tmp/history_db_test_XXXXXX");
+    if (mkdtemp(directory) == NULL) {
+        printf("FAILED: mkdtemp\n");
+        return 1;
+    }
+
+    size_t capacity = WEEK_POINTS + 1000;
+    timestamps = malloc(capacity * sizeof(*timestamps));
+    values = malloc(capacity * sizeof(*values));
+    read_timestamps = malloc(capacity * sizeof(*read_timestamps));
+    read_values = malloc(capacity * sizeof(*read_values));
+
+    test_week_round_trip();
+    test_steady_series_compress();
+    test_ranges();
+    test_reopen_and_preload();
+    test_hourly_sketches();
+    test_torn_block();
+    test_read_only_view();
+
+    remove_store(directory);
+    free(timestamps);
+    free(values);
+    free(read_timestamps);
+    free(read_values);
+
+    if (failures) {
+        printf("FAILED (%d)\n", failures);
+        return 1;
+    }
+    printf("OK\n");
+    return 0;
+}
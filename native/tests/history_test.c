@@ -0,0 +1,84 @@
+// Checks the mirrored history rings and their incremental rollups
+
+#include <stdio.h>
+
+#include "../common/history.h"
+#include "check.h"
+
+#define NS_PER_SECOND 1000000000ull
+
+static void test_raw_window_is_contiguous() {
+    int32_t length = 0;
+    const double* view;
+
+    clearHistory();
+    view = getHistoryView(HISTORY_CPU, HISTORY_TIER_RAW, HISTORY_FIELD_AVG, &length);
+    CHECK(view != NULL && length == 0, "empty history has a zero-length view");
+
+    // Wrap the ring several times; the view must always hold the newest
+    // samples in order
+    for (int i = 0; i < HISTORY_RAW_CAPACITY * 3 + 17; i++) {
+        history_push(HISTORY_CPU, (uint64_t)i * NS_PER_SECOND, (double)i);
+    }
+    view = getHistoryView(HISTORY_CPU, HISTORY_TIER_RAW, HISTORY_FIELD_AVG, &length);
+    CHECK(length == HISTORY_RAW_CAPACITY, "raw length %d", length);
+
+    double first = (double)(HISTORY_RAW_CAPACITY * 3 + 17 - HISTORY_RAW_CAPACITY);
+    int ordered = 1;
+    for (int i = 0; i < length; i++) {
+        if (view[i] != first + i) ordered = 0;
+    }
+    CHECK(ordered, "raw window is ordered oldest to newest");
+    CHECK(getHistoryLength(HISTORY_CPU, HISTORY_TIER_RAW) == HISTORY_RAW_CAPACITY, "length query");
+}
+
+static void test_rollups() {
+    int32_t length = 0;
+    const double* avg;
+    const double* min;
+    const double* max;
+
+    clearHistory();
+
+    // Two minutes of 1 s samples: value = second within the 10 s bucket
+    for (int second = 0; second <= 120; second++) {
+        history_push(HISTORY_MEMORY, (uint64_t)second * NS_PER_SECOND, (double)(second % 10));
+    }
+
+    avg = getHistoryView(HISTORY_MEMORY, HISTORY_TIER_10S, HISTORY_FIELD_AVG, &length);
+    min = getHistoryView(HISTORY_MEMORY, HISTORY_TIER_10S, HISTORY_FIELD_MIN, &length);
+    max = getHistoryView(HISTORY_MEMORY, HISTORY_TIER_10S, HISTORY_FIELD_MAX, &length);
+    CHECK(length == 12, "10 s buckets closed: %d", length);
+    CHECK(length > 0 && avg[0] == 4.5 && min[0] == 0.0 && max[0] == 9.0,
+          "10 s rollup avg/min/max");
+
+    avg = getHistoryView(HISTORY_MEMORY, HISTORY_TIER_1MIN, HISTORY_FIELD_AVG, &length);
+    max = getHistoryView(HISTORY_MEMORY, HISTORY_TIER_1MIN, HISTORY_FIELD_MAX, &length);
+    CHECK(length == 1, "1 min buckets closed: %d", length);
+    CHECK(length > 0 && avg[0] == 4.5 && max[0] == 9.0, "1 min rollup avg/max");
+
+    // Other metrics are untouched
+    CHECK(getHistoryLength(HISTORY_DISK, HISTORY_TIER_RAW) == 0, "metrics are independent");
+}
+
+static void test_invalid_arguments() {
+    int32_t length = 0;
+
+    CHECK(getHistoryView(HISTORY_METRIC_COUNT, 0, 0, &length) == NULL, "bad metric");
+    CHECK(getHistoryView(0, HISTORY_TIER_COUNT, 0, &length) == NULL, "bad tier");
+    CHECK(getHistoryView(0, 0, HISTORY_FIELD_COUNT, &length) == NULL, "bad field");
+    CHECK(getHistoryView(0, 0, 0, NULL) == NULL, "missing length");
+}
+
+int main() {
+    test_raw_window_is_contiguous();
+    test_rollups();
+    test_invalid_arguments();
+
+    if (failures) {
+        printf("FAILED (%d)\n", failures);
+        return 1;
+    }
+    printf("OK\n");
+    return 0;
+}
@@ -0,0 +1,93 @@
+// Checks the per-collector latency histograms and their percentile error
+
+#include <stdio.h>
+
+#include "../common/latency.h"
+#include "check.h"
+
+// True if `value` is within `percent` of `expected`
+static int within(uint64_t value, uint64_t expected, double percent) {
+    double error = (double)value - (double)expected;
+    if (error < 0) error = -error;
+    return error <= (double)expected * percent / 100.0;
+}
+
+static void test_percentiles() {
+    struct latency_stats stats;
+
+    resetCollectorLatency(-1);
+    CHECK(getCollectorLatency(LATENCY_DISK, &stats) == 0, "empty collector is readable");
+    CHECK(stats.count == 0 && stats.p99_ns == 0 && stats.max_ns == 0, "empty collector is zero");
+
+    // 1..1000 us; recording adds a few hundred ns at most, well inside the
+    // bucket error at these magnitudes
+    for (int i = 1; i <= 1000; i++) {
+        latency_record(LATENCY_DISK, latency_now_ns() - (uint64_t)i * 1000);
+    }
+
+    CHECK(getCollectorLatency(LATENCY_DISK, &stats) == 0, "populated collector is readable");
+    CHECK(stats.count == 1000, "count %llu", (unsigned long long)stats.count);
+    CHECK(within(stats.p50_ns, 500000, 7.0), "p50 %llu", (unsigned long long)stats.p50_ns);
+    CHECK(within(stats.p99_ns, 990000, 7.0), "p99 %llu", (unsigned long long)stats.p99_ns);
+    CHECK(within(stats.mean_ns, 500500, 1.0), "mean %llu", (unsigned long long)stats.mean_ns);
+    CHECK(stats.max_ns >= 1000000 && within(stats.max_ns, 1000000, 1.0),
+          "max %llu", (unsigned long long)stats.max_ns);
+    CHECK(stats.p50_ns <= stats.p99_ns && stats.p99_ns <= stats.max_ns, "percentiles are ordered");
+
+    // Other collectors are untouched
+    CHECK(getCollectorLatency(LATENCY_CPU, &stats) == 0 && stats.count == 0, "collectors are independent");
+}
+
+static void test_reset() {
+    struct latency_stats stats;
+
+    latency_record(LATENCY_CPU, latency_now_ns());
+    latency_record(LATENCY_MEMORY, latency_now_ns());
+    resetCollectorLatency(LATENCY_CPU);
+
+    getCollectorLatency(LATENCY_CPU, &stats);
+    CHECK(stats.count == 0, "reset clears the collector");
+    getCollectorLatency(LATENCY_MEMORY, &stats);
+    CHECK(stats.count == 1, "reset leaves other collectors");
+
+    resetCollectorLatency(-1);
+    getCollectorLatency(LATENCY_MEMORY, &stats);
+    CHECK(stats.count == 0, "reset -1 clears every collector");
+}
+
+// Every collector, the newest included, keeps its own histogram
+static void test_every_collector() {
+    struct latency_stats stats;
+
+    resetCollectorLatency(-1);
+    for (int collector = 0; collector < LATENCY_COLLECTOR_COUNT; collector++) {
+        for (int i = 0; i <= collector; i++) latency_record(collector, latency_now_ns());
+    }
+    for (int collector = 0; collector < LATENCY_COLLECTOR_COUNT; collector++) {
+        CHECK(getCollectorLatency(collector, &stats) == 0 && stats.count == (uint64_t)collector + 1,
+              "collector %d count %llu", collector, (unsigned long long)stats.count);
+    }
+    resetCollectorLatency(-1);
+}
+
+static void test_invalid_arguments() {
+    struct latency_stats stats;
+
+    CHECK(getCollectorLatency(-1, &stats) == -1, "negative collector");
+    CHECK(getCollectorLatency(LATENCY_COLLECTOR_COUNT, &stats) == -1, "bad collector");
+    CHECK(getCollectorLatency(LATENCY_CPU, NULL) == -1, "missing stats");
+}
+
+int main() {
+    test_percentiles();
+    test_reset();
+    test_every_collector();
+    test_invalid_arguments();
+
+    if (failures) {
+        printf("FAILED (%d)\n", failures);
+        return 1;
+    }
+    printf("OK\n");
+    return 0;
+}
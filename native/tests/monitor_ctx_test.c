@@ -0,0 +1,157 @@
+// Checks that monitor contexts keep independent CPU baselines and can be
+// sampled from several threads at once
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "../common/monitor_ctx.h"
+#include "check.h"
+
+#define THREAD_COUNT 4
+#define SAMPLES_PER_THREAD 200
+
+static double now_seconds() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec + (double)now.tv_nsec / 1e9;
+}
+
+static void prepare(struct system_snapshot* snapshot) {
+    memset(snapshot, 0, sizeof(*snapshot));
+    snapshot->version = SYSTEM_SNAPSHOT_VERSION;
+    snapshot->size = sizeof(*snapshot);
+}
+
+static int shares_are_sane(const struct system_snapshot* snapshot) {
+    for (int core = 0; core < snapshot->core_count && core < SYSTEM_SNAPSHOT_MAX_CORES; core++) {
+        double sum = 0.0;
+        for (int field = 0; field < CORE_USAGE_FIELDS; field++) {
+            double share = snapshot->per_core[core * CORE_USAGE_FIELDS + field];
+            if (share < 0.0 || share > 100.0 + 1e-6) return 0;
+            sum += share;
+        }
+        // A core with no ticks in the interval reports all zeros
+        if (sum > 100.0 + 1e-6) return 0;
+    }
+    return 1;
+}
+
+// Sampling one context must not move another's baseline: A's second sample
+// covers the whole busy loop even though B sampled throughout it
+static void test_independent_baselines() {
+    struct system_snapshot snapshot;
+    struct monitor_ctx* a = monitor_create();
+    struct monitor_ctx* b = monitor_create();
+    CHECK(a != NULL && b != NULL, "create contexts");
+    if (a == NULL || b == NULL) {
+        monitor_destroy(a);
+        monitor_destroy(b);
+        return;
+    }
+
+    // The first sample of a fresh context is the average since boot; its
+    // per-core shares cover the time since monitor_create()
+    prepare(&snapshot);
+    CHECK(monitor_sample(a, &snapshot) == 0, "first sample of a");
+    CHECK(snapshot.cpu_usage >= 0.0 && snapshot.cpu_usage <= 100.0, "since-boot usage %f", snapshot.cpu_usage);
+    CHECK(snapshot.core_count > 0 && shares_are_sane(&snapshot), "first per-core shares");
+    prepare(&snapshot);
+    monitor_sample(b, &snapshot);
+
+    // Keep one CPU busy for 300 ms while B samples every few milliseconds
+    double deadline = now_seconds() + 0.3;
+    volatile unsigned long spin = 0;
+    double next_b = 0.0;
+    while (now_seconds() < deadline) {
+        spin++;
+        if (now_seconds() >= next_b) {
+            prepare(&snapshot);
+            CHECK(monitor_sample(b, &snapshot) == 0, "sample b");
+            next_b = now_seconds() + 0.005;
+        }
+    }
+
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    if (cpus < 1) cpus = 1;
+    prepare(&snapshot);
+    CHECK(monitor_sample(a, &snapshot) == 0, "second sample of a");
+    CHECK(snapshot.cpu_usage >= 50.0 / (double)cpus,
+          "a covers the busy loop: %.2f%% on %ld CPUs", snapshot.cpu_usage, cpus);
+
+    monitor_destroy(a);
+    monitor_destroy(b);
+}
+
+struct worker_result {
+    int samples;
+    int errors;
+};
+
+static void* sample_worker(void* arg) {
+    struct worker_result* result = arg;
+    struct system_snapshot* snapshot = malloc(sizeof(*snapshot));
+    struct monitor_ctx* ctx = monitor_create();
+
+    if (ctx == NULL || snapshot == NULL) {
+        result->errors++;
+    } else {
+        for (int i = 0; i < SAMPLES_PER_THREAD; i++) {
+            prepare(snapshot);
+            if (monitor_sample(ctx, snapshot) != 0 || snapshot->cpu_usage < 0.0 ||
+                snapshot->cpu_usage > 100.0 || !shares_are_sane(snapshot)) {
+                result->errors++;
+            }
+            result->samples++;
+        }
+    }
+
+    monitor_destroy(ctx);
+    free(snapshot);
+    return NULL;
+}
+
+static void test_concurrent_contexts() {
+    pthread_t threads[THREAD_COUNT];
+    struct worker_result results[THREAD_COUNT];
+
+    memset(results, 0, sizeof(results));
+    for (int i = 0; i < THREAD_COUNT; i++) {
+        pthread_create(&threads[i], NULL, sample_worker, &results[i]);
+    }
+    for (int i = 0; i < THREAD_COUNT; i++) {
+        pthread_join(threads[i], NULL);
+        CHECK(results[i].errors == 0, "thread %d: %d of %d samples invalid", i, results[i].errors,
+              results[i].samples);
+    }
+}
+
+static void test_invalid_arguments() {
+    struct system_snapshot snapshot;
+    struct monitor_ctx* ctx = monitor_create();
+
+    prepare(&snapshot);
+    CHECK(monitor_sample(NULL, &snapshot) == -1, "NULL context");
+    CHECK(monitor_sample(ctx, NULL) == -1, "NULL snapshot");
+    snapshot.size = SYSTEM_SNAPSHOT_MIN_SIZE - 8;
+    CHECK(monitor_sample(ctx, &snapshot) == -1, "snapshot below the minimum size");
+
+    monitor_destroy(ctx);
+    monitor_destroy(NULL);
+}
+
+int main() {
+    test_independent_baselines();
+    test_concurrent_contexts();
+    test_invalid_arguments();
+
+    if (failures) {
+        printf("FAILED (%d)\n", failures);
+        return 1;
+    }
+    printf("OK\n");
+    return 0;
+}
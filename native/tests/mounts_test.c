@@ -0,0 +1,71 @@
+// Checks the mount collector against the host mount table
+
+#include <stdio.h>
+#include <string.h>
+
+#include "cpu_monitor.h"
+#include "check.h"
+
+#define MAX_MOUNTS 256
+
+static struct mount_usage rows[MAX_MOUNTS];
+
+static void test_mount_list() {
+    int count = getMountUsage(rows, MAX_MOUNTS);
+    CHECK(count > 0, "mount count %d", count);
+
+    int has_root = 0;
+    for (int i = 0; i < count; i++) {
+        const struct mount_usage* row = &rows[i];
+        if (strcmp(row->mount_point, "/") == 0) has_root = 1;
+
+        CHECK(row->total_mb > 0, "%s has capacity", row->mount_point);
+        CHECK(row->used_mb >= 0 && row->used_mb <= row->total_mb, "%s used is within total", row->mount_point);
+        CHECK(row->usage_percent >= 0 && row->usage_percent <= 100.0, "%s usage %.1f", row->mount_point,
+              row->usage_percent);
+        CHECK(strcmp(row->fs_type, "proc") != 0 && strcmp(row->fs_type, "sysfs") != 0 &&
+              strcmp(row->fs_type, "tmpfs") != 0, "%s (%s) is not a pseudo filesystem", row->mount_point,
+              row->fs_type);
+        if (i > 0) {
+            CHECK(strcmp(rows[i - 1].mount_point, row->mount_point) < 0, "mounts are sorted and unique");
+        }
+    }
+    CHECK(has_root, "root filesystem is listed");
+
+    // The cached list is reused while the mount table is unchanged
+    int again = getMountUsage(rows, MAX_MOUNTS);
+    CHECK(again == count, "stable mount count %d vs %d", again, count);
+
+    // Capacity limits the rows written
+    CHECK(getMountUsage(rows, 1) == 1, "capacity of one");
+    CHECK(getMountUsage(rows, 0) == 0, "capacity of zero");
+}
+
+// A refresh of every mount is timed on its own, not as the root-disk figure
+static void test_latency() {
+    struct latency_stats mounts, disk;
+
+    resetCollectorLatency(-1);
+    getMountUsage(rows, MAX_MOUNTS);
+    CHECK(getCollectorLatency(LATENCY_MOUNTS, &mounts) == 0 && mounts.count == 1, "recorded as mounts");
+    CHECK(getCollectorLatency(LATENCY_DISK, &disk) == 0 && disk.count == 0, "not recorded as disk");
+}
+
+static void test_invalid_arguments() {
+    CHECK(getMountUsage(NULL, 1) == -1, "missing output");
+    CHECK(getMountUsage(rows, -1) == -1, "negative capacity");
+}
+
+int main() {
+    test_mount_list();
+    test_latency();
+    test_invalid_arguments();
+    mount_usage_cleanup();
+
+    if (failures) {
+        printf("FAILED (%d)\n", failures);
+        return 1;
+    }
+    printf("OK\n");
+    return 0;
+}
@@ -0,0 +1,189 @@
+// Checks the network collector against fake /proc/net/dev and sysfs trees
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "cpu_monitor.h"
+#include "check.h"
+
+#define ROWS 8
+
+static char root[] = "/tmp/netdev_test.XXXXXX";
+static char dev_path[256];
+static char sys_path[256];
+
+static const char* header =
+    "Inter-|   Receive                                                |  Transmit\n"
+    " face |bytes    packets errs drop fifo frame compressed multicast|bytes    packets errs drop fifo colls carrier compressed\n";
+
+static void write_file(const char* path, const char* text) {
+    FILE* file = fopen(path, "w");
+    fputs(text, file);
+    fclose(file);
+}
+
+static void write_net_dev(const char* lines) {
+    char text[4096];
+    snprintf(text, sizeof(text), "%s%s", header, lines);
+    write_file(dev_path, text);
+}
+
+// Create /sys/class/net/<name>/statistics with the given rx_bytes and
+// tx_bytes; the other counters follow from them
+static void write_sysfs(const char* name, unsigned long long rx_bytes, unsigned long long tx_bytes) {
+    static const char* const files[] = {
+        "rx_bytes", "rx_packets", "rx_errors", "rx_dropped",
+        "tx_bytes", "tx_packets", "tx_errors", "tx_dropped",
+    };
+    unsigned long long values[] = {rx_bytes, rx_bytes / 100, 0, 1, tx_bytes, tx_bytes / 100, 0, 0};
+    char path[512];
+
+    snprintf(path, sizeof(path), "%s/%s", sys_path, name);
+    mkdir(path, 0755);
+    snprintf(path, sizeof(path), "%s/%s/statistics", sys_path, name);
+    mkdir(path, 0755);
+    for (int i = 0; i < 8; i++) {
+        char value[32];
+        snprintf(path, sizeof(path), "%s/%s/statistics/%s", sys_path, name, files[i]);
+        snprintf(value, sizeof(value), "%llu\n", values[i]);
+        write_file(path, value);
+    }
+}
+
+static void sleep_ms(long ms) {
+    struct timespec delay = {ms / 1000, (ms % 1000) * 1000000L};
+    nanosleep(&delay, NULL);
+}
+
+static int near(double value, double expected) {
+    return value > expected * 0.999 && value < expected * 1.001;
+}
+
+static const struct net_io* find_row(const struct net_io* rows, int count, const char* name) {
+    for (int i = 0; i < count; i++) {
+        if (strcmp(rows[i].name, name) == 0) return &rows[i];
+    }
+    return NULL;
+}
+
+static void test_proc_rates() {
+    struct net_io rows[ROWS];
+
+    net_io_set_sources(dev_path, sys_path);
+    write_net_dev("    lo:    1000      10    0    0    0     0          0         0     1000      10    0    0    0     0       0          0\n"
+                  "  eth0:  500000    1000    2    3    0     0          0         0   200000     800    1    0    0     0       0          0\n");
+    CHECK(getNetworkIo(rows, ROWS) == 0, "first call only sets the baseline");
+
+    sleep_ms(100);
+    write_net_dev("    lo:    1000      10    0    0    0     0          0         0     1000      10    0    0    0     0       0          0\n"
+                  "  eth0:  900000    1400    2    7    0     0          0         0   300000    1000    1    0    0     0       0          0\n");
+    int count = getNetworkIo(rows, ROWS);
+    CHECK(count == 2, "row count %d", count);
+
+    const struct net_io* eth0 = find_row(rows, count, "eth0");
+    CHECK(eth0 != NULL, "eth0 listed");
+    if (eth0 != NULL) {
+        double bytes_per_packet = eth0->rx_bytes_per_sec / eth0->rx_packets_per_sec;
+        CHECK(near(bytes_per_packet, 1000.0), "rx bytes per packet %f", bytes_per_packet);
+        CHECK(eth0->rx_bytes_per_sec > 400000.0 && eth0->rx_bytes_per_sec <= 4000000.0,
+              "rx rate %f", eth0->rx_bytes_per_sec);
+        CHECK(near(eth0->tx_bytes_per_sec / eth0->tx_packets_per_sec, 500.0), "tx bytes per packet");
+        CHECK(eth0->rx_drops_per_sec > 0 && eth0->rx_errors_per_sec == 0.0, "drops and errors");
+    }
+    const struct net_io* lo = find_row(rows, count, "lo");
+    CHECK(lo != NULL && lo->rx_bytes_per_sec == 0.0 && lo->tx_bytes_per_sec == 0.0, "idle loopback");
+
+    // A counter that goes backwards (driver reset) reads as no traffic
+    write_net_dev("    lo:    1000      10    0    0    0     0          0         0     1000      10    0    0    0     0       0          0\n"
+                  "  eth0:     100       1    0    0    0     0          0         0      100       1    0    0    0     0       0          0\n");
+    count = getNetworkIo(rows, ROWS);
+    eth0 = find_row(rows, count, "eth0");
+    CHECK(eth0 != NULL && eth0->rx_bytes_per_sec == 0.0, "counter reset reads as zero");
+
+    CHECK(getNetworkIo(rows, 1) == 1, "capacity limits rows");
+    CHECK(getNetworkIo(rows, 0) == 0, "zero capacity");
+
+    // A new interface resets the baseline rather than shifting rates
+    write_net_dev("    lo:    1000      10    0    0    0     0          0         0     1000      10    0    0    0     0       0          0\n"
+                  "veth12ab34cd56ef:       0       0    0    0    0     0          0         0        0       0    0    0    0     0       0          0\n"
+                  "  eth0:     100       1    0    0    0     0          0         0      100       1    0    0    0     0       0          0\n");
+    CHECK(getNetworkIo(rows, ROWS) == 0, "interface change sets a new baseline");
+    count = getNetworkIo(rows, ROWS);
+    CHECK(count == 3, "three interfaces after the change: %d", count);
+    CHECK(find_row(rows, count, "veth12ab34cd56e") != NULL, "long names are truncated");
+}
+
+static void test_sysfs_fallback() {
+    struct net_io rows[ROWS];
+
+    net_io_set_sources(NULL, sys_path);
+    write_sysfs("wlan0", 10000, 5000);
+    write_sysfs("eth1", 0, 0);
+    CHECK(getNetworkIo(rows, ROWS) == 0, "sysfs baseline");
+
+    sleep_ms(50);
+    write_sysfs("wlan0", 30000, 6000);
+    int count = getNetworkIo(rows, ROWS);
+    CHECK(count == 2, "sysfs row count %d", count);
+    CHECK(count == 2 && strcmp(rows[0].name, "eth1") == 0, "sysfs rows are ordered by name");
+
+    const struct net_io* wlan0 = find_row(rows, count, "wlan0");
+    CHECK(wlan0 != NULL, "wlan0 listed");
+    if (wlan0 != NULL) {
+        CHECK(near(wlan0->rx_bytes_per_sec / wlan0->tx_bytes_per_sec, 20.0), "rx/tx ratio");
+        CHECK(near(wlan0->rx_bytes_per_sec / wlan0->rx_packets_per_sec, 100.0), "rx bytes per packet");
+    }
+}
+
+static void test_live_system() {
+    struct net_io rows[256];
+
+    net_io_set_sources("/proc/net/dev", "/sys/class/net");
+    CHECK(getNetworkIo(rows, 256) == 0, "live baseline");
+    int count = getNetworkIo(rows, 256);
+    CHECK(count > 0, "live row count %d", count);
+    CHECK(find_row(rows, count, "lo") != NULL, "loopback listed");
+    for (int i = 0; i < count; i++) {
+        CHECK(rows[i].rx_bytes_per_sec >= 0 && rows[i].tx_bytes_per_sec >= 0, "row %d rates", i);
+    }
+}
+
+static void test_invalid_arguments() {
+    struct net_io row;
+
+    CHECK(getNetworkIo(NULL, 1) == -1, "missing output");
+    CHECK(getNetworkIo(&row, -1) == -1, "negative capacity");
+    net_io_set_sources(NULL, "/nonexistent");
+    CHECK(getNetworkIo(&row, 1) == -1, "no sources");
+}
+
+int main() {
+    if (mkdtemp(root) == NULL) {
+        printf("FAIL: cannot create %s\n", root);
+        return 1;
+    }
+    snprintf(dev_path, sizeof(dev_path), "%s/dev", root);
+    snprintf(sys_path, sizeof(sys_path), "%s/net", root);
+    mkdir(sys_path, 0755);
+
+    test_proc_rates();
+    test_sysfs_fallback();
+    test_live_system();
+    test_invalid_arguments();
+    net_io_cleanup();
+
+    char command[300];
+    snprintf(command, sizeof(command), "rm -rf %s", root);
+    system(command);
+
+    if (failures) {
+        printf("FAILED (%d)\n", failures);
+        return 1;
+    }
+    printf("OK\n");
+    return 0;
+}
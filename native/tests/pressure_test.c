@@ -0,0 +1,177 @@
+// Checks the PSI collector against fake /proc/pressure files; the trigger
+// path runs through the polling fallback since plain files cannot raise
+// POLLPRI
+
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "cpu_monitor.h"
+#include "check.h"
+
+static char root[] = "/tmp/pressure_test.XXXXXX";
+
+static atomic_int callbacks = 0;
+static atomic_int last_resource = -1;
+
+static void on_pressure(int32_t resource) {
+    atomic_store(&last_resource, resource);
+    atomic_fetch_add(&callbacks, 1);
+}
+
+static void write_file(const char* name, const char* text) {
+    char path[512];
+    snprintf(path, sizeof(path), "%s/%s", root, name);
+    FILE* file = fopen(path, "w");
+    fputs(text, file);
+    fclose(file);
+}
+
+static void write_memory(unsigned long long some_total) {
+    char text[256];
+    snprintf(text, sizeof(text),
+             "some avg10=12.50 avg60=4.05 avg300=0.80 total=%llu\n"
+             "full avg10=3.00 avg60=1.00 avg300=0.25 total=900\n",
+             some_total);
+    write_file("memory", text);
+}
+
+static void sleep_ms(long ms) {
+    struct timespec delay = {ms / 1000, (ms % 1000) * 1000000L};
+    nanosleep(&delay, NULL);
+}
+
+static int near(double value, double expected) {
+    return value > expected - 1e-9 && value < expected + 1e-9;
+}
+
+static void test_averages() {
+    struct pressure_stats stats;
+
+    // Kernels before 5.13 have no "full" line for CPU
+    write_file("cpu", "some avg10=1.23 avg60=0.50 avg300=0.08 total=123456\n");
+    write_memory(5000);
+    write_file("io", "some avg10=0.00 avg60=0.00 avg300=0.00 total=0\n"
+                     "full avg10=0.00 avg60=0.00 avg300=0.00 total=0\n");
+
+    CHECK(getPressure(PRESSURE_CPU, &stats) == 0, "cpu pressure unreadable");
+    CHECK(near(stats.some_avg10, 1.23) && near(stats.some_avg60, 0.5) && near(stats.some_avg300, 0.08),
+          "cpu averages %f %f %f", stats.some_avg10, stats.some_avg60, stats.some_avg300);
+    CHECK(stats.some_total_us == 123456, "cpu total %llu", (unsigned long long)stats.some_total_us);
+    CHECK(!stats.has_full && stats.full_avg10 == 0.0, "cpu has no full line");
+
+    CHECK(getPressure(PRESSURE_MEMORY, &stats) == 0, "memory pressure unreadable");
+    CHECK(near(stats.some_avg10, 12.5) && near(stats.full_avg10, 3.0) && near(stats.full_avg300, 0.25),
+          "memory averages %f %f %f", stats.some_avg10, stats.full_avg10, stats.full_avg300);
+    CHECK(stats.has_full && stats.some_total_us == 5000 && stats.full_total_us == 900, "memory totals");
+
+    CHECK(getPressure(PRESSURE_IO, &stats) == 0 && stats.has_full, "io pressure");
+}
+
+static void test_polled_trigger() {
+    struct pressure_event events[4];
+
+    write_memory(5000);
+    CHECK(addPressureTrigger(PRESSURE_MEMORY, 0, 100000, 500000) == 0, "add trigger");
+    CHECK(startPressureMonitor(on_pressure) == 0, "start monitor");
+    CHECK(startPressureMonitor(on_pressure) == 0, "second start is a no-op");
+
+    // No stall growth: no event after a full window
+    sleep_ms(700);
+    CHECK(atomic_load(&callbacks) == 0, "event without stall growth");
+    CHECK(readPressureEvents(events, 4, 0) == 0, "events recorded without stall growth");
+
+    // 200 ms of stall inside a 500 ms window crosses the 100 ms threshold
+    write_memory(205000);
+    for (int waited = 0; waited < 2000 && atomic_load(&callbacks) == 0; waited += 10) sleep_ms(10);
+    CHECK(atomic_load(&callbacks) == 1, "%d callbacks after the threshold", atomic_load(&callbacks));
+    CHECK(atomic_load(&last_resource) == PRESSURE_MEMORY, "callback resource %d", atomic_load(&last_resource));
+
+    int count = readPressureEvents(events, 4, 0);
+    CHECK(count == 1, "%d events", count);
+    if (count == 1) {
+        CHECK(events[0].sequence == 1 && events[0].resource == PRESSURE_MEMORY && !events[0].full,
+              "event fields");
+        CHECK(near(events[0].avg10, 12.5), "event avg10 %f", events[0].avg10);
+        CHECK(near(events[0].threshold_percent, 20.0), "event threshold %f", events[0].threshold_percent);
+        CHECK(events[0].timestamp_ms > 0, "event timestamp");
+        CHECK(readPressureEvents(events, 4, events[0].sequence) == 0, "events after the newest");
+    }
+
+    // Removing the trigger re-arms the running thread with nothing to watch
+    clearPressureTriggers();
+    write_memory(905000);
+    sleep_ms(700);
+    CHECK(atomic_load(&callbacks) == 1, "event after the trigger was cleared");
+
+    stopPressureMonitor();
+    stopPressureMonitor();
+}
+
+static void test_live_system() {
+    struct pressure_stats stats;
+
+    pressure_set_sources(NULL);
+    if (access("/proc/pressure/cpu", R_OK) != 0) {
+        printf("SKIP: /proc/pressure is not available\n");
+        return;
+    }
+    CHECK(getPressure(PRESSURE_CPU, &stats) == 0, "live cpu pressure unreadable");
+    CHECK(stats.some_avg10 >= 0.0 && stats.some_avg10 <= 100.0, "live avg10 %f", stats.some_avg10);
+
+    // The kernel may refuse triggers; either way the monitor must start and stop
+    CHECK(addPressureTrigger(PRESSURE_CPU, 0, 500000, 1000000) == 0, "add live trigger");
+    CHECK(startPressureMonitor(NULL) == 0, "start live monitor");
+    sleep_ms(50);
+    stopPressureMonitor();
+    clearPressureTriggers();
+}
+
+static void test_invalid_arguments() {
+    struct pressure_stats stats;
+    struct pressure_event event;
+
+    CHECK(getPressure(-1, &stats) == -1, "negative resource");
+    CHECK(getPressure(PRESSURE_RESOURCE_COUNT, &stats) == -1, "resource out of range");
+    CHECK(getPressure(PRESSURE_CPU, NULL) == -1, "NULL stats");
+    CHECK(addPressureTrigger(PRESSURE_IO, 0, 1000, 100000) == -1, "window below the kernel minimum");
+    CHECK(addPressureTrigger(PRESSURE_IO, 0, 1000, 20000000) == -1, "window above the kernel maximum");
+    CHECK(addPressureTrigger(PRESSURE_IO, 0, 2000000, 1000000) == -1, "stall longer than the window");
+    CHECK(addPressureTrigger(PRESSURE_IO, 0, 0, 1000000) == -1, "zero stall");
+    CHECK(readPressureEvents(NULL, 1, 0) == -1, "NULL events");
+    CHECK(readPressureEvents(&event, -1, 0) == -1, "negative capacity");
+
+    for (int i = 0; i < PRESSURE_MAX_TRIGGERS; i++) {
+        CHECK(addPressureTrigger(PRESSURE_IO, 1, 100000, 1000000) == 0, "trigger %d", i);
+    }
+    CHECK(addPressureTrigger(PRESSURE_IO, 1, 100000, 1000000) == -1, "more than PRESSURE_MAX_TRIGGERS");
+    clearPressureTriggers();
+}
+
+int main() {
+    if (mkdtemp(root) == NULL) {
+        printf("FAIL: cannot create %s\n", root);
+        return 1;
+    }
+    pressure_set_sources(root);
+
+    test_averages();
+    test_polled_trigger();
+    test_live_system();
+    test_invalid_arguments();
+    pressure_cleanup();
+
+    char command[300];
+    snprintf(command, sizeof(command), "rm -rf %s", root);
+    system(command);
+
+    if (failures) {
+        printf("FAILED (%d)\n", failures);
+        return 1;
+    }
+    printf("OK\n");
+    return 0;
+}
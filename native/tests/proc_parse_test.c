@@ -0,0 +1,359 @@
+// Checks the /proc parser against sscanf() on captured samples, the live
+// /proc files and random input placed against an unmapped page
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "proc_parse.h"
+#include "check.h"
+
+#define FUZZ_ROUNDS 20000
+
+static char file_buffer[1 << 20];
+
+static size_t load(const char* path) {
+    FILE* file = fopen(path, "r");
+    if (file == NULL) return 0;
+    size_t length = fread(file_buffer, 1, sizeof(file_buffer) - 1, file);
+    fclose(file);
+    file_buffer[length] = '\0';
+    return length;
+}
+
+static size_t load_sample(const char* name) {
+    char path[512];
+    snprintf(path, sizeof(path), "%s/%s", PROC_SAMPLES_DIR, name);
+    size_t length = load(path);
+    CHECK(length > 0, "sample %s is readable", name);
+    return length;
+}
+
+// Copy of one line, NUL-terminated, for the sscanf reference
+static void copy_line(char* dst, size_t size, const char* line, const char* end) {
+    size_t length = (size_t)(proc_next_line(line, end) - line);
+    if (length >= size) length = size - 1;
+    memcpy(dst, line, length);
+    dst[length] = '\0';
+}
+
+static void check_lines(const char* label, const char* buffer, size_t length) {
+    const char* end = buffer + length;
+    size_t newlines = 0;
+    for (size_t i = 0; i < length; i++) {
+        if (buffer[i] == '\n') newlines++;
+    }
+    CHECK(proc_count_lines(buffer, end) == newlines, "%s: line count", label);
+
+    size_t lines = 0;
+    for (const char* line = buffer; line < end; line = proc_next_line(line, end)) {
+        const char* newline = memchr(line, '\n', (size_t)(end - line));
+        CHECK(proc_next_line(line, end) == (newline ? newline + 1 : end), "%s: next line", label);
+        lines++;
+    }
+    CHECK(lines == newlines + (length > 0 && buffer[length - 1] != '\n'), "%s: lines walked", label);
+}
+
+static void check_stat(const char* label, const char* buffer, size_t length) {
+    const char* end = buffer + length;
+    int cpu_lines = 0;
+
+    for (const char* line = buffer; line < end; line = proc_next_line(line, end)) {
+        if (strncmp(line, "cpu", 3) != 0) continue;
+        char text[512];
+        unsigned long long expected[8];
+        uint64_t fields[PROC_CPU_FIELD_COUNT];
+        copy_line(text, sizeof(text), line, end);
+
+        int scanned = sscanf(text, "%*s %llu %llu %llu %llu %llu %llu %llu %llu", &expected[0], &expected[1],
+                             &expected[2], &expected[3], &expected[4], &expected[5], &expected[6], &expected[7]);
+        const char* cursor = proc_skip_fields(line, end, 1);
+        int parsed = proc_parse_fields(&cursor, end, &proc_stat_cpu_fields, fields);
+
+        CHECK(parsed == scanned, "%s: cpu field count %d vs %d", label, parsed, scanned);
+        for (int i = 0; i < parsed && i < scanned; i++) {
+            CHECK(fields[i] == expected[i], "%s: cpu line %d field %d", label, cpu_lines, i);
+        }
+        cpu_lines++;
+    }
+    CHECK(cpu_lines >= 2, "%s: has cpu lines", label);
+}
+
+static void check_meminfo(const char* label, const char* buffer, size_t length) {
+    const char* end = buffer + length;
+    static const struct proc_key keys[] = {
+        PROC_KEY("MemTotal"), PROC_KEY("MemAvailable"), PROC_KEY("SwapTotal"), PROC_KEY("Dirty"),
+    };
+    uint64_t values[4] = {0};
+    int found = proc_parse_keyed(buffer, end, keys, 4, values);
+    CHECK(found == 4, "%s: found %d keys", label, found);
+
+    for (const char* line = buffer; line < end; line = proc_next_line(line, end)) {
+        char text[256], key[64];
+        unsigned long long expected;
+        copy_line(text, sizeof(text), line, end);
+        if (sscanf(text, "%63[^:]: %llu", key, &expected) != 2) continue;
+        for (int i = 0; i < 4; i++) {
+            if (strcmp(key, keys[i].name) == 0) {
+                CHECK(values[i] == expected, "%s: %s %llu vs %llu", label, key,
+                      (unsigned long long)values[i], expected);
+            }
+        }
+    }
+
+    // Missing keys leave their slots alone
+    static const struct proc_key missing[] = {PROC_KEY("MemTotal"), PROC_KEY("NoSuchKey")};
+    uint64_t slots[2] = {7, 7};
+    CHECK(proc_parse_keyed(buffer, end, missing, 2, slots) == 1 && slots[1] == 7, "%s: missing key", label);
+    CHECK(proc_parse_keyed(buffer, end, missing + 1, 1, slots) == 0, "%s: only missing key", label);
+}
+
+static void check_diskstats(const char* label, const char* buffer, size_t length) {
+    const char* end = buffer + length;
+
+    for (const char* line = buffer; line < end; line = proc_next_line(line, end)) {
+        char text[512];
+        unsigned long long expected[8];
+        uint64_t fields[PROC_DISK_FIELD_COUNT];
+        copy_line(text, sizeof(text), line, end);
+
+        int scanned = sscanf(text, "%*u %*u %*s %llu %*u %llu %llu %llu %*u %llu %llu %llu %llu", &expected[0],
+                             &expected[1], &expected[2], &expected[3], &expected[4], &expected[5], &expected[6],
+                             &expected[7]);
+        const char* cursor = proc_skip_fields(line, end, 3);
+        int parsed = proc_parse_fields(&cursor, end, &proc_diskstats_fields, fields);
+
+        CHECK(parsed == scanned && parsed == PROC_DISK_FIELD_COUNT, "%s: diskstats fields %d vs %d", label,
+              parsed, scanned);
+        for (int i = 0; i < parsed && i < scanned; i++) {
+            CHECK(fields[i] == expected[i], "%s: diskstats field %d", label, i);
+        }
+    }
+}
+
+static void check_pid_stat(const char* label, const char* buffer, size_t length) {
+    const char* end = buffer + length;
+    int lines = 0;
+
+    for (const char* line = buffer; line < end; line = proc_next_line(line, end)) {
+        char text[1024];
+        unsigned long long expected[5];
+        uint64_t fields[PROC_PID_FIELD_COUNT];
+        copy_line(text, sizeof(text), line, end);
+
+        // The command name may hold spaces and parentheses; fields resume
+        // after the last ')'
+        char* close_paren = strrchr(text, ')');
+        const char* line_close = memrchr(line, ')', (size_t)(proc_next_line(line, end) - line));
+        if (close_paren == NULL || line_close == NULL) continue;
+
+        int scanned = sscanf(close_paren + 1,
+                             " %*c %*d %*d %*d %*d %*d %*u %*u %*u %*u %*u %llu %llu %*d %*d %*d %*d %llu %*d %llu "
+                             "%*u %llu",
+                             &expected[0], &expected[1], &expected[2], &expected[3], &expected[4]);
+        const char* cursor = line_close + 1;
+        int parsed = proc_parse_fields(&cursor, end, &proc_pid_stat_fields, fields);
+
+        CHECK(parsed == scanned && parsed == PROC_PID_FIELD_COUNT, "%s: pid stat fields %d vs %d", label,
+              parsed, scanned);
+        for (int i = 0; i < parsed && i < scanned; i++) {
+            CHECK(fields[i] == expected[i], "%s: pid stat line %d field %d", label, lines, i);
+        }
+        lines++;
+    }
+    CHECK(lines > 0, "%s: has pid stat lines", label);
+}
+
+static void check_net_dev(const char* label, const char* buffer, size_t length) {
+    const char* end = buffer + length;
+    const char* line = proc_next_line(proc_next_line(buffer, end), end);
+    int interfaces = 0;
+
+    for (; line < end; line = proc_next_line(line, end)) {
+        char text[512];
+        unsigned long long expected[8];
+        uint64_t fields[PROC_NET_FIELD_COUNT];
+        copy_line(text, sizeof(text), line, end);
+
+        char* colon = strchr(text, ':');
+        const char* line_colon = memchr(line, ':', (size_t)(end - line));
+        if (colon == NULL || line_colon == NULL) continue;
+
+        int scanned = sscanf(colon + 1, "%llu %llu %llu %llu %*u %*u %*u %*u %llu %llu %llu %llu", &expected[0],
+                             &expected[1], &expected[2], &expected[3], &expected[4], &expected[5], &expected[6],
+                             &expected[7]);
+        const char* cursor = line_colon + 1;
+        int parsed = proc_parse_fields(&cursor, end, &proc_net_dev_fields, fields);
+
+        CHECK(parsed == scanned && parsed == PROC_NET_FIELD_COUNT, "%s: net dev fields %d vs %d", label, parsed,
+              scanned);
+        for (int i = 0; i < parsed && i < scanned; i++) {
+            CHECK(fields[i] == expected[i], "%s: interface %d field %d", label, interfaces, i);
+        }
+        interfaces++;
+    }
+    CHECK(interfaces > 0, "%s: has interfaces", label);
+}
+
+static void test_samples() {
+    size_t length;
+
+    length = load_sample("stat");
+    check_lines("stat sample", file_buffer, length);
+    check_stat("stat sample", file_buffer, length);
+
+    length = load_sample("meminfo");
+    check_lines("meminfo sample", file_buffer, length);
+    check_meminfo("meminfo sample", file_buffer, length);
+
+    length = load_sample("diskstats");
+    check_diskstats("diskstats sample", file_buffer, length);
+
+    length = load_sample("pid_stat");
+    check_lines("pid_stat sample", file_buffer, length);
+    check_pid_stat("pid_stat sample", file_buffer, length);
+
+    length = load_sample("net_dev");
+    check_lines("net_dev sample", file_buffer, length);
+    check_net_dev("net_dev sample", file_buffer, length);
+}
+
+static void test_live_files() {
+    size_t length;
+
+    if ((length = load("/proc/stat")) > 0) check_stat("/proc/stat", file_buffer, length);
+    if ((length = load("/proc/meminfo")) > 0) check_meminfo("/proc/meminfo", file_buffer, length);
+    if ((length = load("/proc/diskstats")) > 0) check_diskstats("/proc/diskstats", file_buffer, length);
+    if ((length = load("/proc/self/stat")) > 0) check_pid_stat("/proc/self/stat", file_buffer, length);
+    if ((length = load("/proc/net/dev")) > 0) check_net_dev("/proc/net/dev", file_buffer, length);
+}
+
+static uint64_t random_u64(void) {
+    uint64_t value = 0;
+    for (int i = 0; i < 4; i++) value = (value << 16) ^ (uint64_t)(rand() & 0xFFFF);
+    // Spread the digit counts evenly rather than almost always 19-20
+    return value >> (rand() % 64);
+}
+
+// Random lines of numbers and blank runs, ending exactly at an unmapped page
+// so any read past `end` faults
+static void test_fuzz() {
+    long page = sysconf(_SC_PAGESIZE);
+    char* pages = mmap(NULL, (size_t)page * 2, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (pages == MAP_FAILED || mprotect(pages + page, (size_t)page, PROT_NONE) != 0) {
+        printf("FAIL: cannot map guard page\n");
+        failures++;
+        return;
+    }
+    char* limit = pages + page;
+
+    srand(12345);
+    for (int round = 0; round < FUZZ_ROUNDS; round++) {
+        char text[1024];
+        uint64_t expected[32];
+        int count = rand() % 32;
+        size_t length = 0;
+
+        for (int i = 0; i < count; i++) {
+            int blanks = (i == 0 ? 0 : 1) + rand() % 12;
+            for (int b = 0; b < blanks; b++) text[length++] = rand() % 4 ? ' ' : '\t';
+            expected[i] = random_u64();
+            length += (size_t)sprintf(text + length, "%llu", (unsigned long long)expected[i]);
+        }
+        if (rand() % 2) {
+            int blanks = rand() % 10;
+            for (int b = 0; b < blanks; b++) text[length++] = ' ';
+        }
+        if (rand() % 2) text[length++] = '\n';
+        text[length] = '\0';
+
+        // sscanf reference, one field at a time
+        unsigned long long reference[32];
+        int scanned = 0;
+        int offset = 0, consumed;
+        while (scanned < 32 && sscanf(text + offset, "%llu%n", &reference[scanned], &consumed) == 1) {
+            offset += consumed;
+            scanned++;
+        }
+
+        char* start = limit - length;
+        memcpy(start, text, length);
+        const char* cursor = start;
+        uint64_t fields[32];
+        int parsed = proc_parse_u64s(&cursor, limit, fields, 32);
+
+        CHECK(parsed == count && scanned == count, "round %d: parsed %d, sscanf %d, expected %d", round, parsed,
+              scanned, count);
+        for (int i = 0; i < parsed && i < scanned; i++) {
+            CHECK(fields[i] == reference[i] && fields[i] == expected[i], "round %d field %d: %llu vs %llu", round,
+                  i, (unsigned long long)fields[i], reference[i]);
+        }
+        check_lines("fuzz", start, length);
+
+        // Field tables over the same line: every odd field
+        struct proc_field_table odd = {.count = 0};
+        for (int i = 1; i < count && odd.count < PROC_FIELD_TABLE_MAX; i += 2) odd.positions[odd.count++] = (uint8_t)i;
+        cursor = start;
+        parsed = proc_parse_fields(&cursor, limit, &odd, fields);
+        CHECK(parsed == odd.count, "round %d: %d of %d odd fields", round, parsed, odd.count);
+        for (int i = 0; i < parsed; i++) {
+            CHECK(fields[i] == expected[odd.positions[i]], "round %d: odd field %d", round, i);
+        }
+    }
+
+    munmap(pages, (size_t)page * 2);
+}
+
+static void test_edge_cases() {
+    const char* text = "  18446744073709551615 0 007 12345678 123456789 x 5\n9";
+    const char* end = text + strlen(text);
+    const char* cursor = text;
+    uint64_t fields[8];
+
+    int parsed = proc_parse_u64s(&cursor, end, fields, 8);
+    CHECK(parsed == 5, "stops at a non-number: %d", parsed);
+    CHECK(fields[0] == UINT64_MAX, "UINT64_MAX");
+    CHECK(fields[1] == 0 && fields[2] == 7, "zero and leading zeros");
+    CHECK(fields[3] == 12345678 && fields[4] == 123456789, "eight and nine digits");
+    CHECK(*cursor == 'x', "cursor left at the non-number");
+
+    cursor = "1 2\n3 4";
+    parsed = proc_parse_u64s(&cursor, cursor + 7, fields, 8);
+    CHECK(parsed == 2 && *cursor == '\n', "stops at the end of the line");
+
+    cursor = "";
+    CHECK(proc_parse_u64(&cursor, cursor) == 0, "empty input");
+    CHECK(proc_count_lines("", "") == 0, "no lines");
+
+    // Non-numeric fields are skipped whole
+    const char* stat = "R -1 5 6";
+    struct proc_field_table table = {.count = 2, .positions = {1, 3}};
+    cursor = stat;
+    parsed = proc_parse_fields(&cursor, stat + strlen(stat), &table, fields);
+    CHECK(parsed == 2 && fields[1] == 6, "fields after a negative number");
+
+    // cgroup files separate keys with a space, and one key may prefix another
+    const char* memory_stat = "file 200\nactive_file 0\ninactive_file 100\nfile_dirty 3\n";
+    static const struct proc_key flat[] = {PROC_KEY("inactive_file"), PROC_KEY("file")};
+    uint64_t values[2] = {0};
+    parsed = proc_parse_flat_keyed(memory_stat, memory_stat + strlen(memory_stat), flat, 2, values);
+    CHECK(parsed == 2 && values[0] == 100 && values[1] == 200, "flat keyed: %d %llu %llu", parsed,
+          (unsigned long long)values[0], (unsigned long long)values[1]);
+}
+
+int main() {
+    test_edge_cases();
+    test_samples();
+    test_live_files();
+    test_fuzz();
+
+    if (failures) {
+        printf("FAILED (%d)\n", failures);
+        return 1;
+    }
+    printf("OK\n");
+    return 0;
+}
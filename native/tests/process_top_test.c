@@ -0,0 +1,236 @@
+// Checks the top-N process collector against live processes
+
+#include <dirent.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "cpu_monitor.h"
+#include "check.h"
+
+#define TOP_COUNT 8
+#define IDLE_CHILDREN 1000
+
+static int find_pid(const struct process_usage* rows, int count, pid_t pid) {
+    for (int i = 0; i < count; i++) {
+        if (rows[i].pid == pid) return i;
+    }
+    return -1;
+}
+
+static void sleep_ms(long ms) {
+    struct timespec delay = {ms / 1000, (ms % 1000) * 1000000L};
+    nanosleep(&delay, NULL);
+}
+
+static double now_seconds() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec + (double)now.tv_nsec / 1e9;
+}
+
+// utime + stime of a process in clock ticks, or -1
+static long long cpu_ticks(pid_t pid) {
+    char path[64], text[1024];
+    snprintf(path, sizeof(path), "/proc/%d/stat", (int)pid);
+    FILE* file = fopen(path, "r");
+    if (file == NULL) return -1;
+    size_t length = fread(text, 1, sizeof(text) - 1, file);
+    fclose(file);
+    text[length] = '\0';
+
+    // Fields 14 and 15, counted after the parenthesised name
+    char* p = strrchr(text, ')');
+    unsigned long long utime, stime;
+    if (p == NULL || sscanf(p + 2, "%*c %*d %*d %*d %*d %*d %*u %*u %*u %*u %*u %llu %llu", &utime, &stime) != 2) {
+        return -1;
+    }
+    return (long long)(utime + stime);
+}
+
+// The busy child's share must match the CPU time the kernel charged it
+// over the same interval. On a loaded machine (ctest -j) it may get far
+// less than a whole CPU, so no fixed threshold is assumed.
+static void test_busy_child() {
+    struct process_usage rows[TOP_COUNT];
+    struct process_usage* all = malloc(65536 * sizeof(*all));
+
+    pid_t child = fork();
+    if (child == 0) {
+        volatile unsigned long spin = 0;
+        for (;;) spin++;
+    }
+
+    // The first call only sets the per-PID baselines
+    long long ticks_before = cpu_ticks(child);
+    double start = now_seconds();
+    getTopProcesses(PROCESS_SORT_CPU, rows, TOP_COUNT);
+    sleep_ms(300);
+    int count = getTopProcesses(PROCESS_SORT_CPU, all, 65536);
+    double seconds = now_seconds() - start;
+    long long ticks_after = cpu_ticks(child);
+
+    CHECK(count > 0, "row count %d", count);
+    int index = find_pid(all, count, child);
+    CHECK(index >= 0, "busy child %d is listed", (int)child);
+    if (index >= 0) {
+        CHECK(all[index].threads == 1, "busy child threads %d", all[index].threads);
+        // RSS of a fresh fork can read as 0: the kernel reports the
+        // approximate per-CPU counter, so only check it is sane
+        CHECK(all[index].rss_kb >= 0, "busy child RSS %lld", (long long)all[index].rss_kb);
+    }
+    if (index >= 0 && ticks_before >= 0 && ticks_after >= 0) {
+        double hz = (double)sysconf(_SC_CLK_TCK);
+        double expected = (double)(ticks_after - ticks_before) / hz / seconds * 100.0;
+        // Two ticks of rounding at either end, plus 10% for the slightly
+        // different interval the collector measured
+        double tolerance = 2.0 / hz / seconds * 100.0 + expected * 0.1;
+        CHECK(all[index].cpu_percent > 0.0, "busy child CPU %.1f%%", all[index].cpu_percent);
+        CHECK(all[index].cpu_percent > expected - tolerance && all[index].cpu_percent < expected + tolerance,
+              "busy child CPU %.1f%%, charged %.1f%%", all[index].cpu_percent, expected);
+    }
+    for (int i = 1; i < count; i++) {
+        CHECK(all[i - 1].cpu_percent >= all[i].cpu_percent, "rows are sorted by CPU");
+    }
+    CHECK(getTopProcesses(PROCESS_SORT_CPU, rows, TOP_COUNT) <= TOP_COUNT, "capacity limits rows");
+
+    // Exited processes are dropped from the table
+    kill(child, SIGKILL);
+    waitpid(child, NULL, 0);
+    count = getTopProcesses(PROCESS_SORT_CPU, all, 65536);
+    CHECK(find_pid(all, count, child) < 0, "exited child is dropped");
+    free(all);
+}
+
+static void test_rss_order() {
+    struct process_usage rows[TOP_COUNT];
+
+    int count = getTopProcesses(PROCESS_SORT_RSS, rows, TOP_COUNT);
+    CHECK(count > 0, "RSS row count %d", count);
+    for (int i = 1; i < count; i++) {
+        CHECK(rows[i - 1].rss_kb >= rows[i].rss_kb, "rows are sorted by RSS");
+    }
+    for (int i = 0; i < count; i++) {
+        CHECK(rows[i].pid > 0 && rows[i].name[0] != '\0', "row %d has a pid and name", i);
+        CHECK(memchr(rows[i].name, '\0', PROCESS_NAME_LEN) != NULL, "row %d name is terminated", i);
+    }
+
+    // Our own process is always listed when asking for everything
+    struct process_usage* all = malloc(65536 * sizeof(*all));
+    count = getTopProcesses(PROCESS_SORT_IO, all, 65536);
+    CHECK(find_pid(all, count, getpid()) >= 0, "own pid is listed");
+    free(all);
+}
+
+static double elapsed_ms(clockid_t clock, const struct timespec* start) {
+    struct timespec now;
+    clock_gettime(clock, &now);
+    return (double)(now.tv_sec - start->tv_sec) * 1e3 + (double)(now.tv_nsec - start->tv_nsec) / 1e6;
+}
+
+// Cost of listing /proc alone, which every tick pays before its stat
+// reads; the best of a few walks, as the collector's directory stays open
+static double enumeration_ms(int* pids) {
+    struct timespec start;
+    struct dirent* dirent;
+    double best = -1.0;
+
+    DIR* dir = opendir("/proc");
+    if (dir == NULL) return 0.0;
+    for (int walk = 0; walk < 5; walk++) {
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        rewinddir(dir);
+        *pids = 0;
+        while ((dirent = readdir(dir)) != NULL) {
+            if (dirent->d_name[0] >= '1' && dirent->d_name[0] <= '9') (*pids)++;
+        }
+        double ms = elapsed_ms(CLOCK_MONOTONIC, &start);
+        if (best < 0 || ms < best) best = ms;
+    }
+    closedir(dir);
+    return best;
+}
+
+// A thousand idle processes do not fit in one tick's stat reads; the ticks
+// resume round-robin until every one has been read, and each tick costs
+// the /proc walk plus about the budget
+static void test_tick_budget() {
+    static pid_t children[IDLE_CHILDREN];
+    struct process_usage* all = malloc(65536 * sizeof(*all));
+    struct timespec start;
+    int spawned = 0;
+
+    for (; spawned < IDLE_CHILDREN; spawned++) {
+        pid_t child = fork();
+        if (child < 0) break;
+        if (child == 0) {
+            pause();
+            _exit(0);
+        }
+        children[spawned] = child;
+    }
+
+    int pids = 0;
+    double walk_ms = enumeration_ms(&pids);
+
+    // The first tick also opens a descriptor per new PID; later ones only
+    // re-read, and each is timed as the dashboard calls it. CPU time, so a
+    // tick preempted on a loaded machine is not charged for the wait.
+    getTopProcesses(PROCESS_SORT_CPU, all, TOP_COUNT);
+    double tick_ms = 0;
+    for (int tick = 0; tick < 5; tick++) {
+        clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+        getTopProcesses(PROCESS_SORT_CPU, all, TOP_COUNT);
+        double ms = elapsed_ms(CLOCK_THREAD_CPUTIME_ID, &start);
+        if (ms > tick_ms) tick_ms = ms;
+    }
+    printf("%d pids: /proc walk %.2f ms (%.0f ns per pid), tick at most %.2f ms\n", pids, walk_ms,
+           pids > 0 ? walk_ms * 1e6 / pids : 0.0, tick_ms);
+    // Generous: the budget itself is wall-clock, so it runs over by one
+    // stat batch, and sanitizer builds are several times slower
+    CHECK(tick_ms < 50.0, "tick %.2f ms", tick_ms);
+
+    // Every tick reads at least 64 processes, however slow, so enough
+    // ticks reach every child even when each one runs out of budget
+    int count = 0;
+    for (int tick = 0; tick <= (pids + 63) / 64; tick++) {
+        count = getTopProcesses(PROCESS_SORT_CPU, all, TOP_COUNT);
+    }
+    count = getTopProcesses(PROCESS_SORT_CPU, all, 65536);
+    int listed = 0;
+    for (int i = 0; i < spawned; i++) {
+        if (find_pid(all, count, children[i]) >= 0) listed++;
+    }
+    CHECK(listed == spawned, "%d of %d idle children read", listed, spawned);
+
+    for (int i = 0; i < spawned; i++) kill(children[i], SIGKILL);
+    for (int i = 0; i < spawned; i++) waitpid(children[i], NULL, 0);
+    free(all);
+}
+
+static void test_invalid_arguments() {
+    struct process_usage row;
+
+    CHECK(getTopProcesses(PROCESS_SORT_CPU, NULL, 1) == -1, "missing output");
+    CHECK(getTopProcesses(PROCESS_SORT_CPU, &row, 0) == -1, "zero capacity");
+    CHECK(getTopProcesses(PROCESS_SORT_COUNT, &row, 1) == -1, "bad sort");
+}
+
+int main() {
+    test_busy_child();
+    test_rss_order();
+    test_tick_budget();
+    test_invalid_arguments();
+    process_top_cleanup();
+
+    if (failures) {
+        printf("FAILED (%d)\n", failures);
+        return 1;
+    }
+    printf("OK\n");
+    return 0;
+}
@@ -0,0 +1,168 @@
+// Checks the quantile sketches against exact quantiles, their encoding and
+// merging, the sliding windows and the per-metric history windows
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "cpu_monitor.h"
+#include "check.h"
+
+#define NS_PER_SECOND 1000000000ull
+#define SAMPLES 100000
+
+static const double quantiles[] = {0.0, 0.25, 0.5, 0.9, 0.95, 0.99, 0.999, 1.0};
+#define QUANTILE_COUNT ((int)(sizeof(quantiles) / sizeof(quantiles[0])))
+
+static double samples[SAMPLES], sorted[SAMPLES];
+static struct quantile_sketch sketch, other;
+static uint8_t encoded[QUANTILE_SKETCH_MAX_BYTES], encoded_other[QUANTILE_SKETCH_MAX_BYTES];
+static uint8_t merged[QUANTILE_SKETCH_MAX_BYTES];
+static uint32_t random_state = 4242;
+
+static double next_random() {
+    random_state = random_state * 1103515245u + 12345u;
+    return (double)(random_state >> 8) / (double)(1u << 24);
+}
+
+static int compare_doubles(const void* a, const void* b) {
+    double x = *(const double*)a, y = *(const double*)b;
+    return x < y ? -1 : x > y;
+}
+
+// Mostly idle with a heavy tail, like CPU usage
+static double cpu_like() {
+    double u = next_random();
+    if (u < 0.05) return 0.0;
+    return fmin(100.0, 3.0 + 8.0 * -log(1.0 - next_random()) + (u > 0.98 ? 60.0 * next_random() : 0.0));
+}
+
+static int within_accuracy(double estimate, double exact) {
+    if (exact < QUANTILE_MIN_VALUE) return estimate == 0.0;
+    return fabs(estimate - exact) <= exact * QUANTILE_RELATIVE_ACCURACY + 1e-9;
+}
+
+static void test_accuracy() {
+    quantile_sketch_clear(&sketch);
+    for (int i = 0; i < SAMPLES; i++) {
+        samples[i] = cpu_like();
+        sorted[i] = samples[i];
+        quantile_sketch_add(&sketch, samples[i]);
+    }
+    qsort(sorted, SAMPLES, sizeof(double), compare_doubles);
+
+    CHECK(sketch.count == SAMPLES, "count");
+    for (int i = 0; i < QUANTILE_COUNT; i++) {
+        double exact = sorted[(int)(quantiles[i] * (SAMPLES - 1))];
+        double estimate = quantile_sketch_query(&sketch, quantiles[i]);
+        CHECK(within_accuracy(estimate, exact), "q%g: %f vs %f", quantiles[i], estimate, exact);
+    }
+    CHECK(isnan(quantile_sketch_query(&sketch, 1.5)), "quantile out of range");
+
+    quantile_sketch_add(&sketch, NAN);
+    CHECK(sketch.count == SAMPLES, "NaN ignored");
+
+    quantile_sketch_clear(&other);
+    CHECK(isnan(quantile_sketch_query(&other, 0.5)), "empty sketch");
+    quantile_sketch_add(&other, 1e9);
+    CHECK(quantile_sketch_query(&other, 1.0) > 30000.0, "huge sample lands in the last bucket");
+}
+
+static void test_encoding_and_merge() {
+    // Two halves merged answer like one sketch of everything
+    quantile_sketch_clear(&sketch);
+    quantile_sketch_clear(&other);
+    for (int i = 0; i < SAMPLES; i++) {
+        quantile_sketch_add(i % 2 ? &sketch : &other, samples[i]);
+    }
+    int32_t length = quantile_sketch_encode(&sketch, encoded, sizeof(encoded));
+    int32_t other_length = quantile_sketch_encode(&other, encoded_other, sizeof(encoded_other));
+    CHECK(length > 0 && length < 1024, "encoded in %d bytes", length);
+
+    int32_t merged_length = mergeQuantileSketches(encoded, length, encoded_other, other_length, merged,
+                                                  sizeof(merged));
+    double out[QUANTILE_COUNT];
+    CHECK(sketchQuantiles(merged, merged_length, quantiles, QUANTILE_COUNT, out) == SAMPLES, "merged count");
+    for (int i = 0; i < QUANTILE_COUNT; i++) {
+        double exact = sorted[(int)(quantiles[i] * (SAMPLES - 1))];
+        CHECK(within_accuracy(out[i], exact), "merged q%g: %f vs %f", quantiles[i], out[i], exact);
+    }
+
+    struct quantile_sketch decoded;
+    CHECK(quantile_sketch_decode(&decoded, encoded, length) == 0 && decoded.count == sketch.count &&
+              memcmp(decoded.buckets, sketch.buckets, sizeof(sketch.buckets)) == 0,
+          "round trip");
+    CHECK(quantile_sketch_decode(&decoded, encoded, length - 1) == -1, "truncated");
+    encoded[9] ^= 0x40;
+    CHECK(quantile_sketch_decode(&decoded, encoded, length) == -1, "other accuracy");
+    CHECK(quantile_sketch_encode(&sketch, merged, 30) == -1, "small buffer");
+    CHECK(sketchQuantiles(encoded, length, quantiles, QUANTILE_COUNT, out) == -1, "rejected by query");
+}
+
+static void test_sliding_window() {
+    static struct quantile_window window;
+    struct quantile_sketch read;
+    uint64_t t = 1000 * NS_PER_SECOND;
+
+    // Five busy minutes, then ten quiet ones: the 5 min window forgets the
+    // busy part, the hour remembers it
+    for (int i = 0; i < 300; i++, t += NS_PER_SECOND) quantile_window_push(&window, QUANTILE_WINDOW_5MIN, t, 90.0);
+    for (int i = 0; i < 600; i++, t += NS_PER_SECOND) quantile_window_push(&window, QUANTILE_WINDOW_5MIN, t, 10.0);
+    CHECK(quantile_window_read(&window, &read) == 0, "read window");
+    CHECK(read.count >= 275 && read.count <= 300, "5 min window holds %llu samples",
+          (unsigned long long)read.count);
+    CHECK(within_accuracy(quantile_sketch_query(&read, 1.0), 10.0), "busy minutes expired");
+
+    // A gap longer than the window empties it
+    t += 3600 * NS_PER_SECOND;
+    quantile_window_push(&window, QUANTILE_WINDOW_5MIN, t, 50.0);
+    quantile_window_read(&window, &read);
+    CHECK(read.count == 1, "gap empties the window (%llu)", (unsigned long long)read.count);
+
+    // Samples older than every slice are dropped
+    quantile_window_push(&window, QUANTILE_WINDOW_5MIN, t - 3600 * NS_PER_SECOND, 50.0);
+    quantile_window_read(&window, &read);
+    CHECK(read.count == 1, "stale sample dropped");
+}
+
+static void test_history_windows() {
+    double out[3];
+    const double p[] = {0.5, 0.95, 0.99};
+
+    clearHistory();
+    CHECK(getHistoryQuantiles(HISTORY_CPU, QUANTILE_WINDOW_1H, p, 3, out) == 0 && isnan(out[0]), "empty");
+
+    uint64_t t = 5000 * NS_PER_SECOND;
+    for (int i = 0; i < 1200; i++, t += NS_PER_SECOND) {
+        history_push(HISTORY_CPU, t, i < 600 ? 95.0 : 5.0 + (i % 10));
+    }
+    int64_t five_minutes = getHistoryQuantiles(HISTORY_CPU, QUANTILE_WINDOW_5MIN, p, 3, out);
+    CHECK(five_minutes >= 275 && five_minutes <= 300 && out[2] < 15.0, "5 min p99 %f over %lld", out[2],
+          (long long)five_minutes);
+    CHECK(getHistoryQuantiles(HISTORY_CPU, QUANTILE_WINDOW_1H, p, 3, out) == 1200 && within_accuracy(out[2], 95.0),
+          "1 h p99 %f", out[2]);
+
+    int32_t length = getHistorySketch(HISTORY_CPU, QUANTILE_WINDOW_24H, encoded, sizeof(encoded));
+    double from_sketch[3];
+    CHECK(sketchQuantiles(encoded, length, p, 3, from_sketch) == 1200 && from_sketch[1] == out[1],
+          "exported sketch");
+
+    CHECK(getHistoryQuantiles(HISTORY_CPU, QUANTILE_WINDOW_COUNT, p, 3, out) == -1, "unknown window");
+    CHECK(getHistoryQuantiles(HISTORY_METRIC_COUNT, QUANTILE_WINDOW_1H, p, 3, out) == -1, "unknown metric");
+    clearHistory();
+}
+
+int main() {
+    test_accuracy();
+    test_encoding_and_merge();
+    test_sliding_window();
+    test_history_windows();
+
+    if (failures) {
+        printf("FAILED (%d)\n", failures);
+        return 1;
+    }
+    printf("OK\n");
+    return 0;
+}
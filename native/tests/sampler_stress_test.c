@@ -0,0 +1,200 @@
+// Stress test for the sampler's seqlock slot: one writer publishes as fast as
+// it can while several readers verify that every snapshot they copy out is
+// internally consistent (no torn reads).
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "../common/sampler.h"
+#include "../common/seqlock.h"
+#include "check.h"
+
+#define READER_COUNT 4
+#define WRITE_COUNT 100000
+
+static _Atomic uint32_t test_sequence = 0;
+static _Atomic uint64_t test_words[SEQLOCK_WORDS(struct system_snapshot)];
+static atomic_int writer_done = 0;
+
+struct reader_result {
+    unsigned long reads;
+    unsigned long torn;
+    unsigned long regressions;
+};
+
+// Every field carries the same generation number, so any mix of two
+// generations is detectable
+static void fill_generation(struct system_snapshot* snapshot, uint64_t generation) {
+    snapshot->version = (uint32_t)generation;
+    snapshot->size = (uint32_t)(generation >> 32);
+    snapshot->timestamp_ns = generation;
+    snapshot->cpu_usage = (double)generation;
+    snapshot->memory_used = (int64_t)generation;
+    snapshot->memory_total = (int64_t)generation;
+    snapshot->disk_usage = (double)generation;
+    snapshot->disk_used = (double)generation;
+    snapshot->disk_total = (double)generation;
+    snapshot->temperature = (double)generation;
+    snapshot->core_count = (int32_t)generation;
+    for (int i = 0; i < SYSTEM_SNAPSHOT_MAX_CORES * CORE_USAGE_FIELDS; i++) {
+        snapshot->per_core[i] = (double)generation;
+    }
+}
+
+static int is_consistent(const struct system_snapshot* snapshot) {
+    uint64_t generation = snapshot->timestamp_ns;
+    double value = (double)generation;
+    return snapshot->version == (uint32_t)generation &&
+           snapshot->size == (uint32_t)(generation >> 32) &&
+           snapshot->cpu_usage == value &&
+           snapshot->memory_used == (int64_t)generation &&
+           snapshot->memory_total == (int64_t)generation &&
+           snapshot->disk_usage == value &&
+           snapshot->disk_used == value &&
+           snapshot->disk_total == value &&
+           snapshot->temperature == value &&
+           snapshot->core_count == (int32_t)generation &&
+           snapshot->per_core[0] == value &&
+           snapshot->per_core[SYSTEM_SNAPSHOT_MAX_CORES * CORE_USAGE_FIELDS - 1] == value;
+}
+
+static void* writer_main(void* arg) {
+    struct system_snapshot snapshot;
+    (void)arg;
+
+    for (uint64_t generation = 1; generation <= WRITE_COUNT; generation++) {
+        fill_generation(&snapshot, generation);
+        seqlock_write(&test_sequence, test_words, &snapshot, sizeof(snapshot));
+    }
+    atomic_store(&writer_done, 1);
+    return NULL;
+}
+
+static void* reader_main(void* arg) {
+    struct reader_result* result = (struct reader_result*)arg;
+    struct system_snapshot snapshot;
+    uint64_t last_generation = 0;
+
+    while (!atomic_load(&writer_done)) {
+        if (seqlock_read(&test_sequence, test_words, &snapshot, sizeof(snapshot)) != 0) {
+            continue;
+        }
+        result->reads++;
+        if (!is_consistent(&snapshot)) {
+            result->torn++;
+        }
+        if (snapshot.timestamp_ns < last_generation) {
+            result->regressions++;
+        }
+        last_generation = snapshot.timestamp_ns;
+    }
+    return NULL;
+}
+
+static void test_seqlock_no_torn_reads() {
+    pthread_t writer;
+    pthread_t readers[READER_COUNT];
+    struct reader_result results[READER_COUNT];
+    unsigned long reads = 0, torn = 0, regressions = 0;
+
+    memset(results, 0, sizeof(results));
+    for (int i = 0; i < READER_COUNT; i++) {
+        pthread_create(&readers[i], NULL, reader_main, &results[i]);
+    }
+    pthread_create(&writer, NULL, writer_main, NULL);
+
+    pthread_join(writer, NULL);
+    for (int i = 0; i < READER_COUNT; i++) {
+        pthread_join(readers[i], NULL);
+        reads += results[i].reads;
+        torn += results[i].torn;
+        regressions += results[i].regressions;
+    }
+
+    printf("seqlock: %d writes, %lu reads, %lu torn, %lu regressions\n",
+           WRITE_COUNT, reads, torn, regressions);
+    CHECK(torn == 0, "seqlock: %lu torn reads", torn);
+    CHECK(regressions == 0, "seqlock: %lu regressions", regressions);
+}
+
+static void* sampler_reader_main(void* arg) {
+    struct reader_result* result = (struct reader_result*)arg;
+    struct system_snapshot snapshot;
+    uint64_t last_timestamp = 0;
+    struct timespec start, now;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    do {
+        memset(&snapshot, 0, sizeof(snapshot));
+        snapshot.version = SYSTEM_SNAPSHOT_VERSION;
+        snapshot.size = sizeof(snapshot);
+        if (readLatestSnapshot(&snapshot) == 0) {
+            result->reads++;
+            if (snapshot.version != SYSTEM_SNAPSHOT_VERSION || snapshot.size != sizeof(snapshot) ||
+                snapshot.timestamp_ns == 0) {
+                result->torn++;
+            }
+            if (snapshot.timestamp_ns < last_timestamp) {
+                result->regressions++;
+            }
+            last_timestamp = snapshot.timestamp_ns;
+        }
+        clock_gettime(CLOCK_MONOTONIC, &now);
+    } while ((now.tv_sec - start.tv_sec) * 1000 + (now.tv_nsec - start.tv_nsec) / 1000000 < 300);
+    return NULL;
+}
+
+static void test_sampler_thread() {
+    pthread_t readers[READER_COUNT];
+    struct reader_result results[READER_COUNT];
+    unsigned long reads = 0, torn = 0, regressions = 0;
+    struct system_snapshot snapshot;
+
+    // Nothing published before the first start
+    snapshot.version = SYSTEM_SNAPSHOT_VERSION;
+    snapshot.size = sizeof(snapshot);
+    CHECK(readLatestSnapshot(&snapshot) != 0, "sampler: snapshot available before start");
+
+    if (startSampler(1) != 0) {
+        CHECK(0, "sampler: failed to start");
+        return;
+    }
+
+    memset(results, 0, sizeof(results));
+    for (int i = 0; i < READER_COUNT; i++) {
+        pthread_create(&readers[i], NULL, sampler_reader_main, &results[i]);
+    }
+    setSamplerInterval(2);
+    for (int i = 0; i < READER_COUNT; i++) {
+        pthread_join(readers[i], NULL);
+        reads += results[i].reads;
+        torn += results[i].torn;
+        regressions += results[i].regressions;
+    }
+
+    stopSampler();
+    stopSampler();
+
+    // Restart after stop and make sure sampling resumes
+    CHECK(startSampler(1) == 0, "sampler: failed to restart");
+    stopSampler();
+
+    printf("sampler: %lu reads, %lu invalid, %lu regressions\n", reads, torn, regressions);
+    CHECK(reads > 0, "sampler: no reads");
+    CHECK(torn == 0 && regressions == 0, "sampler: %lu invalid, %lu regressions", torn, regressions);
+}
+
+int main() {
+    test_seqlock_no_torn_reads();
+    test_sampler_thread();
+
+    if (failures) {
+        printf("FAILED (%d)\n", failures);
+        return 1;
+    }
+    printf("OK\n");
+    return 0;
+}
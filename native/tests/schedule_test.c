@@ -0,0 +1,206 @@
+// Checks the adaptive schedule's backoff, tightening, visibility and
+// batching on an explicit clock, the static value cache, and that the
+// adaptive sampler keeps the raw history on its interval grid
+
+#include <math.h>
+#include <stdio.h>
+#include <time.h>
+
+#include "cpu_monitor.h"
+#include "check.h"
+
+#define MS 1000000ull
+
+static void sleep_ms(int ms) {
+    struct timespec delay = {ms / 1000, (long)(ms % 1000) * 1000000L};
+    nanosleep(&delay, NULL);
+}
+
+static void test_backoff_and_tighten() {
+    uint64_t now = 1000 * MS;
+    struct schedule_policy policy;
+
+    resetSchedule();
+    getSchedulePolicy(SCHEDULE_CPU, &policy);
+    CHECK(getScheduleInterval(SCHEDULE_CPU) == policy.interval_ms, "starts at the normal interval");
+
+    // Everything is due at first, then one interval later
+    CHECK(schedule_due_at(SCHEDULE_BIT(SCHEDULE_CPU), now) == SCHEDULE_BIT(SCHEDULE_CPU), "due at first");
+    CHECK(schedule_due_at(SCHEDULE_BIT(SCHEDULE_CPU), now + MS) == 0, "not due again at once");
+    CHECK(schedule_next_ns(SCHEDULE_BIT(SCHEDULE_CPU), now) == (int64_t)(now + policy.interval_ms * MS),
+          "next due one interval on");
+
+    // A value that stays put backs off after SCHEDULE_STABLE_RUN reports,
+    // doubling up to the maximum
+    schedule_report_at(SCHEDULE_CPU, 20.0, now);
+    for (int i = 0; i < SCHEDULE_STABLE_RUN; i++) schedule_report_at(SCHEDULE_CPU, 20.0, now);
+    CHECK(getScheduleInterval(SCHEDULE_CPU) == policy.interval_ms * 2, "backed off to %d",
+          getScheduleInterval(SCHEDULE_CPU));
+    for (int i = 0; i < 20; i++) schedule_report_at(SCHEDULE_CPU, 20.0, now);
+    CHECK(getScheduleInterval(SCHEDULE_CPU) == policy.max_interval_ms, "capped at the maximum");
+
+    // A jump halves it and brings the next due time in
+    now += policy.interval_ms * MS;
+    CHECK(schedule_due_at(SCHEDULE_BIT(SCHEDULE_CPU), now) == SCHEDULE_BIT(SCHEDULE_CPU), "due again");
+    schedule_report_at(SCHEDULE_CPU, 20.0 + policy.active_change, now);
+    CHECK(getScheduleInterval(SCHEDULE_CPU) == policy.max_interval_ms / 2, "halved to %d",
+          getScheduleInterval(SCHEDULE_CPU));
+    CHECK(schedule_next_ns(SCHEDULE_BIT(SCHEDULE_CPU), now) == (int64_t)(now + policy.max_interval_ms / 2 * MS),
+          "next due pulled in");
+    for (int i = 0; i < 20; i++) schedule_report_at(SCHEDULE_CPU, (i % 2) * 100.0, now);
+    CHECK(getScheduleInterval(SCHEDULE_CPU) == policy.min_interval_ms, "floored at the minimum");
+
+    // Ordinary movement drifts back to normal
+    for (int i = 0; i < 10; i++) schedule_report_at(SCHEDULE_CPU, 50.0 + (i % 2) * (policy.stable_change * 2), now);
+    CHECK(getScheduleInterval(SCHEDULE_CPU) == policy.interval_ms, "back to normal");
+
+    // NaN is ignored rather than counted as a change
+    schedule_report_at(SCHEDULE_CPU, NAN, now);
+    CHECK(getScheduleInterval(SCHEDULE_CPU) == policy.interval_ms, "NaN ignored");
+}
+
+static void test_visibility() {
+    uint64_t now = 1000 * MS;
+    struct schedule_policy memory, processes;
+
+    resetSchedule();
+    getSchedulePolicy(SCHEDULE_MEMORY, &memory);
+    getSchedulePolicy(SCHEDULE_PROCESSES, &processes);
+    CHECK(processes.hidden_interval_ms == 0, "UI collectors pause while hidden");
+
+    uint32_t mask = SCHEDULE_BIT(SCHEDULE_MEMORY) | SCHEDULE_BIT(SCHEDULE_PROCESSES);
+    CHECK(schedule_due_at(mask, now) == mask, "both due");
+
+    setScheduleVisible(0);
+    CHECK(getScheduleInterval(SCHEDULE_MEMORY) == memory.hidden_interval_ms, "hidden interval");
+    CHECK(getScheduleInterval(SCHEDULE_PROCESSES) == 0, "paused");
+    CHECK(schedule_next_ns(SCHEDULE_BIT(SCHEDULE_PROCESSES), now) == -1, "nothing due while paused");
+    CHECK(schedule_due_at(mask, now + 3600000 * MS) == SCHEDULE_BIT(SCHEDULE_MEMORY), "paused never due");
+
+    // Showing the dashboard makes everything due at once
+    schedule_due_at(mask, now + 3600000 * MS);
+    setScheduleVisible(1);
+    CHECK(schedule_due_at(mask, now + 3600001 * MS) == mask, "due on becoming visible");
+    CHECK(getScheduleInterval(SCHEDULE_PROCESSES) == processes.interval_ms, "normal interval again");
+}
+
+static void test_batching() {
+    uint64_t now = 1000 * MS;
+    struct schedule_policy policy = {1000, 100, 10000, 5000, 0.1, 1.0};
+
+    resetSchedule();
+    setSchedulePolicy(SCHEDULE_CPU, &policy);
+    policy.interval_ms = policy.max_interval_ms = 1200;
+    setSchedulePolicy(SCHEDULE_MEMORY, &policy);
+    uint32_t mask = SCHEDULE_BIT(SCHEDULE_CPU) | SCHEDULE_BIT(SCHEDULE_MEMORY);
+
+    CHECK(schedule_due_at(mask, now) == mask, "both due at first");
+    // CPU comes due at +1000 and memory, 200 ms later, is within its slack
+    // of a quarter interval, so one wakeup takes both
+    CHECK(schedule_next_ns(mask, now) == (int64_t)(now + 1000 * MS), "wake for CPU");
+    CHECK(schedule_due_at(mask, now + 1000 * MS) == mask, "memory taken early");
+
+    // Further away than the slack it waits for its own wakeup
+    policy.interval_ms = policy.max_interval_ms = 2000;
+    setSchedulePolicy(SCHEDULE_MEMORY, &policy);
+    schedule_due_at(mask, now + 3000 * MS);
+    CHECK(schedule_due_at(mask, now + 4000 * MS) == SCHEDULE_BIT(SCHEDULE_CPU), "memory not taken early");
+}
+
+static void test_policy_validation() {
+    struct schedule_policy policy;
+
+    resetSchedule();
+    getSchedulePolicy(SCHEDULE_DISK, &policy);
+    struct schedule_policy bad = policy;
+    bad.min_interval_ms = 0;
+    CHECK(setSchedulePolicy(SCHEDULE_DISK, &bad) == -1, "zero minimum");
+    bad = policy;
+    bad.interval_ms = bad.max_interval_ms + 1;
+    CHECK(setSchedulePolicy(SCHEDULE_DISK, &bad) == -1, "interval above maximum");
+    bad = policy;
+    bad.active_change = bad.stable_change;
+    CHECK(setSchedulePolicy(SCHEDULE_DISK, &bad) == -1, "active not above stable");
+    bad = policy;
+    bad.stable_change = NAN;
+    CHECK(setSchedulePolicy(SCHEDULE_DISK, &bad) == -1, "NaN threshold");
+    CHECK(setSchedulePolicy(SCHEDULE_COLLECTOR_COUNT, &policy) == -1, "unknown collector");
+    CHECK(setSchedulePolicy(SCHEDULE_DISK, NULL) == -1, "NULL policy");
+    CHECK(getScheduleInterval(-1) == -1, "unknown interval");
+    CHECK(setSchedulePolicy(SCHEDULE_DISK, &policy) == 0, "valid policy");
+}
+
+static void test_static_cache() {
+    double value;
+
+    resetSchedule();
+    CHECK(!schedule_static_get(SCHEDULE_STATIC_CORE_COUNT, &value), "empty");
+    schedule_static_put(SCHEDULE_STATIC_CORE_COUNT, 12);
+    CHECK(schedule_static_get(SCHEDULE_STATIC_CORE_COUNT, &value) && value == 12, "cached");
+    CHECK(getCpuCoreCount() == 12, "getCpuCoreCount() serves the cache");
+
+    invalidateStaticValues();
+    CHECK(!schedule_static_get(SCHEDULE_STATIC_CORE_COUNT, &value), "invalidated");
+    int cores = getCpuCoreCount();
+    CHECK(cores >= 1 && schedule_static_get(SCHEDULE_STATIC_CORE_COUNT, &value) && value == cores,
+          "read again and cached");
+
+    int total = getMemoryTotal();
+    CHECK(total > 0 && schedule_static_get(SCHEDULE_STATIC_MEMORY_TOTAL, &value) && value == total,
+          "memory total cached");
+
+    CHECK(setStaticValueTtl(SCHEDULE_STATIC_MEMORY_TOTAL, 0) == 0, "TTL 0");
+    CHECK(!schedule_static_get(SCHEDULE_STATIC_MEMORY_TOTAL, &value), "TTL 0 disables the cache");
+    CHECK(setStaticValueTtl(SCHEDULE_STATIC_COUNT, 10) == -1 && setStaticValueTtl(0, -1) == -1, "bad TTL");
+}
+
+static void test_adaptive_sampler() {
+    int32_t length = 0;
+    struct system_snapshot latest = {.version = SYSTEM_SNAPSHOT_VERSION, .size = sizeof(latest)};
+
+    // CPU on the 20 ms grid, disk far slower than it
+    resetSchedule();
+    struct schedule_policy fast = {20, 20, 20, 20, 0.0, 1000.0};
+    struct schedule_policy slow = {200, 200, 200, 200, 0.0, 1000.0};
+    setSchedulePolicy(SCHEDULE_CPU, &fast);
+    setSchedulePolicy(SCHEDULE_MEMORY, &fast);
+    setSchedulePolicy(SCHEDULE_DISK, &slow);
+    setSchedulePolicy(SCHEDULE_TEMPERATURE, &slow);
+    clearHistory();
+
+    setSamplerAdaptive(1);
+    CHECK(startSampler(20) == 0, "start");
+    sleep_ms(1000);
+    stopSampler();
+    setSamplerAdaptive(0);
+
+    CHECK(readLatestSnapshot(&latest) == 0 && latest.disk_total > 0, "published a full snapshot");
+    getHistoryView(HISTORY_CPU, HISTORY_TIER_RAW, HISTORY_FIELD_AVG, &length);
+    int32_t cpu = length;
+    getHistoryView(HISTORY_DISK, HISTORY_TIER_RAW, HISTORY_FIELD_AVG, &length);
+    int32_t disk = length;
+    printf("adaptive: %d CPU points, %d disk points over 1 s\n", cpu, disk);
+    // Disk is sampled a tenth as often but held on the same grid; its
+    // last step may still be open
+    CHECK(cpu >= 30 && cpu <= 52, "CPU points %d", cpu);
+    CHECK(disk >= cpu - 12 && disk <= cpu, "disk points %d against %d", disk, cpu);
+
+    clearHistory();
+    resetSchedule();
+}
+
+int main() {
+    test_backoff_and_tighten();
+    test_visibility();
+    test_batching();
+    test_policy_validation();
+    test_static_cache();
+    test_adaptive_sampler();
+
+    if (failures) {
+        printf("FAILED (%d)\n", failures);
+        return 1;
+    }
+    printf("OK\n");
+    return 0;
+}
@@ -0,0 +1,222 @@
+// Checks the sensor collector against a fake /sys/class/hwmon and
+// /sys/class/thermal tree
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#include "cpu_monitor.h"
+#include "check.h"
+
+static char root[] = "/tmp/sensors_test.XXXXXX";
+static char hwmon[300];
+static char thermal[300];
+
+static void make_dir(const char* name) {
+    char path[512];
+    snprintf(path, sizeof(path), "%s/%s", root, name);
+    mkdir(path, 0755);
+}
+
+static void write_file(const char* name, const char* text) {
+    char path[512];
+    snprintf(path, sizeof(path), "%s/%s", root, name);
+    FILE* file = fopen(path, "w");
+    fputs(text, file);
+    fclose(file);
+}
+
+static int near(double value, double expected) {
+    return value > expected - 1e-9 && value < expected + 1e-9;
+}
+
+static void build_tree() {
+    make_dir("hwmon");
+    make_dir("thermal");
+
+    make_dir("hwmon/hwmon0");
+    write_file("hwmon/hwmon0/name", "coretemp\n");
+    write_file("hwmon/hwmon0/temp1_input", "52000\n");
+    write_file("hwmon/hwmon0/temp1_label", "Package id 0\n");
+    write_file("hwmon/hwmon0/temp1_crit", "100000\n");
+    write_file("hwmon/hwmon0/temp2_input", "48000\n");
+    write_file("hwmon/hwmon0/temp2_label", "Core 0\n");
+    write_file("hwmon/hwmon0/temp3_input", "50000\n");
+    write_file("hwmon/hwmon0/temp3_label", "Core 1\n");
+
+    make_dir("hwmon/hwmon1");
+    write_file("hwmon/hwmon1/name", "nvme\n");
+    write_file("hwmon/hwmon1/temp1_input", "38850\n");
+    write_file("hwmon/hwmon1/temp1_label", "Composite\n");
+
+    // No labels: the input stem is used instead
+    make_dir("hwmon/hwmon2");
+    write_file("hwmon/hwmon2/name", "thinkpad\n");
+    write_file("hwmon/hwmon2/fan1_input", "2100\n");
+    write_file("hwmon/hwmon2/temp1_input", "-5000\n");
+
+    make_dir("hwmon/hwmon3");
+    write_file("hwmon/hwmon3/name", "acpitz\n");
+    write_file("hwmon/hwmon3/temp1_input", "27800\n");
+
+    // Same sensor as hwmon3
+    make_dir("thermal/thermal_zone0");
+    write_file("thermal/thermal_zone0/type", "acpitz\n");
+    write_file("thermal/thermal_zone0/temp", "27800\n");
+
+    make_dir("thermal/thermal_zone1");
+    write_file("thermal/thermal_zone1/type", "x86_pkg_temp\n");
+    write_file("thermal/thermal_zone1/temp", "53000\n");
+    write_file("thermal/thermal_zone1/trip_point_0_type", "passive\n");
+    write_file("thermal/thermal_zone1/trip_point_0_temp", "95000\n");
+    write_file("thermal/thermal_zone1/trip_point_1_type", "critical\n");
+    write_file("thermal/thermal_zone1/trip_point_1_temp", "105000\n");
+
+    // Not a zone
+    make_dir("thermal/cooling_device0");
+    write_file("thermal/cooling_device0/type", "Processor\n");
+}
+
+static const struct sensor_reading* find(const struct sensor_reading* rows, int count,
+                                         const char* chip, const char* label) {
+    for (int i = 0; i < count; i++) {
+        if (strcmp(rows[i].chip, chip) == 0 && strcmp(rows[i].label, label) == 0) return &rows[i];
+    }
+    return NULL;
+}
+
+static void test_discovery() {
+    struct sensor_reading rows[16];
+    int count = getSensors(rows, 16);
+    CHECK(count == 8, "sensor count %d", count);
+    if (count != 8) return;
+
+    // Ordered by kind, then chip, then index
+    CHECK(rows[0].kind == SENSOR_CPU_PACKAGE && strcmp(rows[0].chip, "coretemp") == 0, "row 0 %s", rows[0].label);
+    CHECK(rows[1].kind == SENSOR_CPU_PACKAGE && strcmp(rows[1].chip, "x86_pkg_temp") == 0, "row 1 %s", rows[1].chip);
+    CHECK(rows[2].kind == SENSOR_CPU_CORE && rows[2].index == 0, "row 2 %s", rows[2].label);
+    CHECK(rows[3].kind == SENSOR_CPU_CORE && rows[3].index == 1, "row 3 %s", rows[3].label);
+    CHECK(rows[4].kind == SENSOR_NVME, "row 4 %s", rows[4].chip);
+    CHECK(rows[5].kind == SENSOR_FAN, "row 5 %s", rows[5].chip);
+    CHECK(rows[6].kind == SENSOR_OTHER && strcmp(rows[6].chip, "acpitz") == 0, "row 6 %s", rows[6].chip);
+    CHECK(rows[7].kind == SENSOR_OTHER && strcmp(rows[7].chip, "thinkpad") == 0, "row 7 %s", rows[7].chip);
+
+    const struct sensor_reading* package = find(rows, count, "coretemp", "Package id 0");
+    CHECK(package != NULL && near(package->value, 52.0) && near(package->critical, 100.0), "coretemp package");
+    const struct sensor_reading* nvme = find(rows, count, "nvme", "Composite");
+    CHECK(nvme != NULL && near(nvme->value, 38.85) && nvme->critical == 0.0, "nvme composite");
+    const struct sensor_reading* fan = find(rows, count, "thinkpad", "fan1");
+    CHECK(fan != NULL && near(fan->value, 2100.0) && fan->index == 1, "fan rpm");
+    const struct sensor_reading* cold = find(rows, count, "thinkpad", "temp1");
+    CHECK(cold != NULL && near(cold->value, -5.0), "negative temperature");
+    const struct sensor_reading* zone = find(rows, count, "x86_pkg_temp", "x86_pkg_temp");
+    CHECK(zone != NULL && near(zone->value, 53.0) && near(zone->critical, 105.0), "thermal zone critical trip");
+
+    CHECK(near(sensors_cpu_temperature(), 53.0), "cpu temperature %f", sensors_cpu_temperature());
+    CHECK(near(getTemperature(), 53.0), "getTemperature %f", getTemperature());
+}
+
+static void test_updates_and_rescan() {
+    struct sensor_reading rows[16];
+
+    // Descriptors stay open; values are re-read in place
+    write_file("hwmon/hwmon0/temp1_input", "71500\n");
+    CHECK(near(sensors_cpu_temperature(), 71.5), "updated package %f", sensors_cpu_temperature());
+
+    // A new chip is invisible until a rescan
+    make_dir("hwmon/hwmon4");
+    write_file("hwmon/hwmon4/name", "amdgpu\n");
+    write_file("hwmon/hwmon4/temp1_input", "61000\n");
+    write_file("hwmon/hwmon4/temp1_label", "edge\n");
+    CHECK(getSensors(rows, 16) == 8, "table is cached");
+    CHECK(rescanSensors() == 9, "rescan finds the GPU");
+    int count = getSensors(rows, 16);
+    const struct sensor_reading* gpu = find(rows, count, "amdgpu", "edge");
+    CHECK(gpu != NULL && gpu->kind == SENSOR_GPU && near(gpu->value, 61.0), "gpu sensor");
+
+    CHECK(getSensors(rows, 3) == 3, "capacity limits rows");
+    CHECK(getSensors(rows, 0) == 0, "zero capacity");
+}
+
+static void test_fallbacks() {
+    struct sensor_reading rows[4];
+
+    // Only ACPI and other board sensors: the ACPI zone stands in for the CPU
+    char path[512];
+    snprintf(path, sizeof(path), "%s/empty", root);
+    make_dir("empty");
+    make_dir("board");
+    make_dir("board/hwmon0");
+    write_file("board/hwmon0/name", "acpitz\n");
+    write_file("board/hwmon0/temp1_input", "40000\n");
+    make_dir("board/hwmon1");
+    write_file("board/hwmon1/name", "BAT0\n");
+    write_file("board/hwmon1/temp1_input", "30000\n");
+    char board[512];
+    snprintf(board, sizeof(board), "%s/board", root);
+    sensors_set_sources(board, path);
+    CHECK(near(sensors_cpu_temperature(), 40.0), "ACPI fallback %f", sensors_cpu_temperature());
+
+    // Chipset, wifi and battery sensors never stand in for the CPU
+    make_dir("noncpu");
+    make_dir("noncpu/hwmon0");
+    write_file("noncpu/hwmon0/name", "iwlwifi_1\n");
+    write_file("noncpu/hwmon0/temp1_input", "45000\n");
+    make_dir("noncpu/hwmon1");
+    write_file("noncpu/hwmon1/name", "pch_cannonlake\n");
+    write_file("noncpu/hwmon1/temp1_input", "50000\n");
+    char noncpu[512];
+    snprintf(noncpu, sizeof(noncpu), "%s/noncpu", root);
+    sensors_set_sources(noncpu, path);
+    CHECK(getSensors(rows, 4) == 2, "two board sensors");
+    CHECK(sensors_cpu_temperature() == -1.0, "no cpu proxy %f", sensors_cpu_temperature());
+
+    sensors_set_sources(path, path);
+    CHECK(getSensors(rows, 4) == 0, "no sensors");
+    CHECK(sensors_cpu_temperature() == -1.0, "no cpu temperature");
+
+    CHECK(getSensors(NULL, 4) == -1, "NULL rows");
+    CHECK(getSensors(rows, -1) == -1, "negative capacity");
+}
+
+static void test_live_system() {
+    struct sensor_reading rows[SENSOR_MAX_COUNT];
+
+    sensors_set_sources(NULL, NULL);
+    int count = getSensors(rows, SENSOR_MAX_COUNT);
+    CHECK(count >= 0, "live sensors %d", count);
+    for (int i = 0; i < count; i++) {
+        CHECK(rows[i].kind >= SENSOR_CPU_PACKAGE && rows[i].kind <= SENSOR_OTHER, "live kind %d", rows[i].kind);
+        CHECK(rows[i].chip[0] != '\0', "live chip name");
+    }
+    if (count == 0) printf("SKIP: no hwmon or thermal sensors\n");
+}
+
+int main() {
+    if (mkdtemp(root) == NULL) {
+        printf("FAIL: cannot create %s\n", root);
+        return 1;
+    }
+    build_tree();
+    snprintf(hwmon, sizeof(hwmon), "%s/hwmon", root);
+    snprintf(thermal, sizeof(thermal), "%s/thermal", root);
+    sensors_set_sources(hwmon, thermal);
+
+    test_discovery();
+    test_updates_and_rescan();
+    test_fallbacks();
+    test_live_system();
+    sensors_cleanup();
+
+    char command[300];
+    snprintf(command, sizeof(command), "rm -rf %s", root);
+    system(command);
+
+    if (failures) {
+        printf("FAILED (%d)\n", failures);
+        return 1;
+    }
+    printf("OK\n");
+    return 0;
+}
@@ -0,0 +1,189 @@
+// Checks the shared segment between a collector and a viewer process: a
+// forked child publishes, the parent attaches read-only
+
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "cpu_monitor.h"
+#include "check.h"
+
+#define INTERVAL_MS 20
+
+static char name[64];
+
+static void sleep_ms(long ms) {
+    struct timespec delay = {ms / 1000, (ms % 1000) * 1000000L};
+    nanosleep(&delay, NULL);
+}
+
+static void prepare(struct system_snapshot* snapshot) {
+    memset(snapshot, 0, sizeof(*snapshot));
+    snapshot->version = SYSTEM_SNAPSHOT_VERSION;
+    snapshot->size = sizeof(*snapshot);
+}
+
+// Collector: publish every INTERVAL_MS / 2 until told 'q', then stay mapped
+// but silent until told 'x'. With `crash`, exit after one snapshot without
+// removing the segment.
+static void run_collector(int commands, int ready, int crash) {
+    static struct system_snapshot sample;
+
+    if (shared_segment_create(name, INTERVAL_MS) != 0) _exit(1);
+
+    prepare(&sample);
+    sample.cpu_usage = 42.5;
+    sample.memory_used = 1000;
+    sample.memory_total = 4000;
+    sample.temperature = -1.0;
+    sample.core_count = 2;
+    sample.per_core[0] = 60.0;
+    sample.per_core[CORE_USAGE_FIELDS] = 25.0;
+    for (int i = 1; i <= 3; i++) {
+        history_push(HISTORY_CPU, (uint64_t)i * 1000000000ull, i * 10.0);
+    }
+    sample.timestamp_ns = latency_now_ns();
+    shared_segment_publish(&sample);
+    if (crash) _exit(0);
+
+    if (write(ready, "r", 1) != 1) _exit(1);
+
+    int publishing = 1;
+    for (;;) {
+        struct pollfd pending = {commands, POLLIN, 0};
+        if (poll(&pending, 1, INTERVAL_MS / 2) > 0) {
+            char command = 0;
+            if (read(commands, &command, 1) != 1 || command == 'x') break;
+            if (command == 'q') publishing = 0;
+        }
+        if (publishing) {
+            sample.timestamp_ns = latency_now_ns();
+            shared_segment_publish(&sample);
+        }
+    }
+    shared_segment_destroy();
+    _exit(0);
+}
+
+static void test_viewer() {
+    struct system_snapshot snapshot;
+    int commands[2], ready[2];
+    int32_t length = 0;
+
+    CHECK(attachSharedSegment(name) == -1, "attach without a collector");
+    prepare(&snapshot);
+    CHECK(readSharedSnapshot(&snapshot) == -1, "read while detached");
+
+    if (pipe(commands) != 0 || pipe(ready) != 0) {
+        CHECK(0, "pipe");
+        return;
+    }
+    pid_t child = fork();
+    if (child == 0) {
+        close(commands[1]);
+        close(ready[0]);
+        run_collector(commands[0], ready[1], 0);
+    }
+    close(commands[0]);
+    close(ready[1]);
+
+    char signal_byte;
+    CHECK(read(ready[0], &signal_byte, 1) == 1, "collector ready");
+
+    CHECK(attachSharedSegment(name) == 0, "attach to a live collector");
+    prepare(&snapshot);
+    CHECK(readSharedSnapshot(&snapshot) == 0, "read snapshot");
+    CHECK(snapshot.cpu_usage == 42.5 && snapshot.memory_used == 1000 && snapshot.memory_total == 4000,
+          "snapshot values %f %lld", snapshot.cpu_usage, (long long)snapshot.memory_used);
+    CHECK(snapshot.core_count == 2 && snapshot.per_core[0] == 60.0 && snapshot.per_core[CORE_USAGE_FIELDS] == 25.0,
+          "per-core values");
+    CHECK(snapshot.version == SYSTEM_SNAPSHOT_VERSION, "snapshot version");
+
+    // History is read straight from the collector's rings
+    const double* view = getHistoryView(HISTORY_CPU, HISTORY_TIER_RAW, HISTORY_FIELD_AVG, &length);
+    CHECK(view != NULL && length == 3 && view[0] == 10.0 && view[2] == 30.0, "shared history (%d points)", length);
+
+    // The mapping is read-only: local writes are dropped, not faults
+    history_push(HISTORY_CPU, 5000000000ull, 99.0);
+    clearHistory();
+    CHECK(getHistoryLength(HISTORY_CPU, HISTORY_TIER_RAW) == 3, "viewer cannot write history");
+
+    CHECK(shared_segment_create(name, INTERVAL_MS) == -1, "second collector refused");
+
+    // A collector that stops publishing goes stale
+    CHECK(write(commands[1], "q", 1) == 1, "command q");
+    sleep_ms(INTERVAL_MS * SHARED_SEGMENT_STALE_INTERVALS + 80);
+    prepare(&snapshot);
+    CHECK(readSharedSnapshot(&snapshot) == -1, "stale collector");
+    CHECK(attachSharedSegment(name) == -1, "attach to a stale collector");
+
+    CHECK(write(commands[1], "x", 1) == 1, "command x");
+    int status = 0;
+    waitpid(child, &status, 0);
+    CHECK(WIFEXITED(status) && WEXITSTATUS(status) == 0, "collector exit status");
+
+    detachSharedSegment();
+    CHECK(getHistoryLength(HISTORY_CPU, HISTORY_TIER_RAW) == 0, "local history after detach");
+    close(commands[1]);
+    close(ready[0]);
+}
+
+static void test_crashed_collector() {
+    pid_t child = fork();
+    if (child == 0) run_collector(-1, -1, 1);
+    int status = 0;
+    waitpid(child, &status, 0);
+
+    // The segment outlives the collector, but only until it goes stale
+    CHECK(shared_segment_create(name, INTERVAL_MS) == -1, "fresh segment of a dead collector");
+    sleep_ms(INTERVAL_MS * SHARED_SEGMENT_STALE_INTERVALS + 80);
+    CHECK(shared_segment_create(name, INTERVAL_MS) == 0, "replace a stale segment");
+    shared_segment_destroy();
+    CHECK(attachSharedSegment(name) == -1, "segment removed");
+}
+
+static void test_other_layout() {
+    int fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0600);
+    CHECK(fd >= 0, "create foreign segment");
+    if (fd < 0) return;
+
+    size_t size = 1 << 20;
+    struct shared_segment_header* header = MAP_FAILED;
+    if (ftruncate(fd, (off_t)size) == 0) {
+        header = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    close(fd);
+    CHECK(header != MAP_FAILED, "map foreign segment");
+    if (header != MAP_FAILED) {
+        header->version = SHARED_SEGMENT_VERSION + 1;
+        header->interval_ms = 1000;
+        atomic_store(&header->published_ns, latency_now_ns());
+        atomic_store(&header->magic, SHARED_SEGMENT_MAGIC);
+        CHECK(attachSharedSegment(name) == -1, "attach to another layout version");
+        munmap(header, size);
+    }
+    shm_unlink(name);
+}
+
+int main() {
+    snprintf(name, sizeof(name), "/cpu_monitor_test_%d", (int)getpid());
+    shm_unlink(name);
+
+    test_viewer();
+    test_crashed_collector();
+    test_other_layout();
+
+    if (failures) {
+        printf("FAILED (%d)\n", failures);
+        return 1;
+    }
+    printf("OK\n");
+    return 0;
+}
@@ -0,0 +1,163 @@
+// Checks the window statistics kernels against naive recomputation, and
+// the per-sample statistics the history caches against the kernels
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "cpu_monitor.h"
+#include "check.h"
+
+#define NS_PER_SECOND 1000000000ull
+#define MAX_LENGTH 5000
+
+static double values[MAX_LENGTH], out[MAX_LENGTH], expected[MAX_LENGTH];
+static uint32_t random_state = 7;
+
+static double next_random() {
+    random_state = random_state * 1103515245u + 12345u;
+    return (double)(random_state >> 8) / (double)(1u << 24);
+}
+
+static void fill_random(int length) {
+    for (int i = 0; i < length; i++) {
+        values[i] = 50.0 + 30.0 * sin(i / 40.0) + 20.0 * next_random();
+    }
+}
+
+// Straight from the definitions, O(n * window)
+static void reference(int stat, const double* series, int length, int window, double* result) {
+    double ewma = series[0];
+    double alpha = 2.0 / (window + 1.0);
+
+    for (int i = 0; i < length; i++) {
+        int start = i - window + 1 > 0 ? i - window + 1 : 0;
+        double sum = 0, low = series[start], high = series[start];
+        for (int j = start; j <= i; j++) {
+            sum += series[j];
+            if (series[j] < low) low = series[j];
+            if (series[j] > high) high = series[j];
+        }
+        double mean = sum / (i - start + 1);
+        double squares = 0;
+        for (int j = start; j <= i; j++) squares += (series[j] - mean) * (series[j] - mean);
+        ewma += alpha * (series[i] - ewma);
+
+        switch (stat) {
+            case WINDOW_STAT_MEAN: result[i] = mean; break;
+            case WINDOW_STAT_EWMA: result[i] = ewma; break;
+            case WINDOW_STAT_MIN: result[i] = low; break;
+            case WINDOW_STAT_MAX: result[i] = high; break;
+            case WINDOW_STAT_STDDEV: result[i] = sqrt(squares / (i - start + 1)); break;
+        }
+    }
+}
+
+static int close_to(const double* a, const double* b, int length) {
+    for (int i = 0; i < length; i++) {
+        if (fabs(a[i] - b[i]) > 1e-7) return 0;
+    }
+    return 1;
+}
+
+static void test_kernels_match_reference() {
+    static const int lengths[] = {1, 2, 7, 900, MAX_LENGTH};
+    static const int windows[] = {1, 2, 3, 30, 900};
+
+    for (size_t l = 0; l < sizeof(lengths) / sizeof(lengths[0]); l++) {
+        fill_random(lengths[l]);
+        for (size_t w = 0; w < sizeof(windows) / sizeof(windows[0]); w++) {
+            for (int stat = 0; stat < WINDOW_STAT_COUNT; stat++) {
+                int result = computeWindowStat(stat, values, lengths[l], windows[w], out);
+                reference(stat, values, lengths[l], windows[w], expected);
+                CHECK(result == 0 && close_to(out, expected, lengths[l]), "stat %d, %d points, window %d", stat,
+                      lengths[l], windows[w]);
+            }
+        }
+    }
+}
+
+static void test_in_place() {
+    fill_random(1000);
+    reference(WINDOW_STAT_MEAN, values, 1000, 5, expected);
+    CHECK(computeWindowStat(WINDOW_STAT_MEAN, values, 1000, 5, values) == 0 && close_to(values, expected, 1000),
+          "mean in place");
+
+    fill_random(1000);
+    reference(WINDOW_STAT_EWMA, values, 1000, 5, expected);
+    CHECK(computeWindowStat(WINDOW_STAT_EWMA, values, 1000, 5, values) == 0 && close_to(values, expected, 1000),
+          "EWMA in place");
+}
+
+static void test_history_cache() {
+    const int total = HISTORY_RAW_CAPACITY * 4 + 11;
+    static double pushed[HISTORY_RAW_CAPACITY * 4 + 11];
+
+    clearHistory();
+    CHECK(getHistoryStatWindow() == HISTORY_STAT_WINDOW, "default window");
+    for (int i = 0; i < total; i++) {
+        pushed[i] = 50.0 + 30.0 * sin(i / 40.0) + 20.0 * next_random();
+        history_push(HISTORY_MEMORY, (uint64_t)i * NS_PER_SECOND, pushed[i]);
+    }
+
+    // The cache follows the whole stream, including samples that have left
+    // the ring; compare the visible tail with the kernels over everything
+    for (int stat = 0; stat < WINDOW_STAT_COUNT; stat++) {
+        int32_t length = 0;
+        const double* view = getHistoryStatView(HISTORY_MEMORY, stat, &length);
+        computeWindowStat(stat, pushed, total, HISTORY_STAT_WINDOW, out);
+        CHECK(view != NULL && length == HISTORY_RAW_CAPACITY &&
+                  close_to(view, out + total - length, length),
+              "cached stat %d", stat);
+    }
+
+    // A new window is recomputed over what the ring holds
+    CHECK(setHistoryStatWindow(60) == 0 && getHistoryStatWindow() == 60, "set window");
+    int32_t raw_length = 0;
+    const double* raw = getHistoryView(HISTORY_MEMORY, HISTORY_TIER_RAW, HISTORY_FIELD_AVG, &raw_length);
+    for (int stat = 0; stat < WINDOW_STAT_COUNT; stat++) {
+        int32_t length = 0;
+        const double* view = getHistoryStatView(HISTORY_MEMORY, stat, &length);
+        reference(stat, raw, raw_length, 60, expected);
+        CHECK(length == raw_length && close_to(view, expected, length), "recomputed stat %d", stat);
+    }
+
+    // ...and keeps up with new samples from there
+    for (int i = 0; i < 100; i++) {
+        history_push(HISTORY_MEMORY, (uint64_t)(total + i) * NS_PER_SECOND, 10.0 * (i % 7));
+    }
+    int32_t length = 0;
+    const double* max = getHistoryStatView(HISTORY_MEMORY, WINDOW_STAT_MAX, &length);
+    const double* mean = getHistoryStatView(HISTORY_MEMORY, WINDOW_STAT_MEAN, &length);
+    raw = getHistoryView(HISTORY_MEMORY, HISTORY_TIER_RAW, HISTORY_FIELD_AVG, &raw_length);
+    reference(WINDOW_STAT_MEAN, raw + raw_length - 60, 60, 60, expected);
+    CHECK(max[length - 1] == 60.0, "rolling max after new samples (%f)", max[length - 1]);
+    CHECK(fabs(mean[length - 1] - expected[59]) < 1e-9, "rolling mean after new samples");
+
+    CHECK(setHistoryStatWindow(0) == -1 && setHistoryStatWindow(HISTORY_RAW_CAPACITY + 1) == -1, "bad window");
+    setHistoryStatWindow(HISTORY_STAT_WINDOW);
+}
+
+static void test_invalid_arguments() {
+    int32_t length = 0;
+    CHECK(computeWindowStat(WINDOW_STAT_COUNT, values, 10, 3, out) == -1, "unknown stat");
+    CHECK(computeWindowStat(WINDOW_STAT_MEAN, values, 10, 0, out) == -1, "zero window");
+    CHECK(computeWindowStat(WINDOW_STAT_MEAN, NULL, 10, 3, out) == -1, "missing input");
+    CHECK(computeWindowStat(WINDOW_STAT_MAX, values, 0, 3, out) == 0, "empty series");
+    CHECK(getHistoryStatView(HISTORY_CPU, WINDOW_STAT_COUNT, &length) == NULL, "unknown history stat");
+    CHECK(getHistoryStatView(HISTORY_METRIC_COUNT, WINDOW_STAT_MEAN, &length) == NULL, "unknown metric");
+}
+
+int main() {
+    test_kernels_match_reference();
+    test_in_place();
+    test_history_cache();
+    test_invalid_arguments();
+
+    if (failures) {
+        printf("FAILED (%d)\n", failures);
+        return 1;
+    }
+    printf("OK\n");
+    return 0;
+}
@@ -1,72 +1,77 @@
 #include <windows.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <pdh.h>
 #include <pdhmsg.h>
 
+#include "cpu_monitor.h"
+
 #pragma comment(lib, "pdh.lib")
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
-// PDH query handle for CPU usage monitoring
-static PDH_HQUERY cpuQuery = NULL;
-static PDH_HCOUNTER cpuTotal = NULL;
-static ULARGE_INTEGER lastCPU, lastSysCPU, lastUserCPU;
-static int numProcessors = 0;
-static HANDLE self;
-
-// Initialize CPU performance monitoring
-static void init_cpu_monitoring() {
-    // Initialize PDH query for CPU usage
-    PdhOpenQuery(NULL, 0, &cpuQuery);
-    PdhAddEnglishCounter(cpuQuery, "\\Processor(_Total)\\% Processor Time", 0, &cpuTotal);
-    PdhCollectQueryData(cpuQuery);
-
-    // Get system information including processor count
-    SYSTEM_INFO sysInfo;
-    GetSystemInfo(&sysInfo);
-    numProcessors = sysInfo.dwNumberOfProcessors;
-
-    // Get handle to current process
-    self = GetCurrentProcess();
-
-    // Get CPU times for current process and system
-    FILETIME createTime, exitTime, kernelTime, userTime;
-    GetProcessTimes(self, &createTime, &exitTime, &kernelTime, &userTime);
+// Everything a sample mutates. A PDH query keeps the raw counter values of
+// its last collection, so each context needs a query of its own.
+struct monitor_ctx {
+    PDH_HQUERY cpuQuery;
+    PDH_HCOUNTER cpuTotal;
+};
 
-    lastCPU.LowPart = kernelTime.dwLowDateTime;
-    lastCPU.HighPart = kernelTime.dwHighDateTime;
+// Context behind the process-wide functions (getCpuUsage() and friends)
+static struct monitor_ctx default_ctx = {NULL, NULL};
 
-    FILETIME sysKernel, sysUser;
-    GetSystemTimes(&sysKernel, &sysUser, NULL);
+// Result of the last getCpuUsage(), for the temperature estimate; collecting
+// again there would reset the interval the next caller measures
+static double last_cpu_usage = 0.0;
 
-    lastSysCPU.LowPart = sysKernel.dwLowDateTime;
-    lastSysCPU.HighPart = sysKernel.dwHighDateTime;
+// Open a context's PDH query and take the baseline collection
+static int open_cpu_query(struct monitor_ctx* ctx) {
+    if (PdhOpenQuery(NULL, 0, &ctx->cpuQuery) != ERROR_SUCCESS) {
+        ctx->cpuQuery = NULL;
+        return -1;
+    }
+    if (PdhAddEnglishCounter(ctx->cpuQuery, "\\Processor(_Total)\\% Processor Time", 0, &ctx->cpuTotal) != ERROR_SUCCESS) {
+        PdhCloseQuery(ctx->cpuQuery);
+        ctx->cpuQuery = NULL;
+        return -1;
+    }
+    PdhCollectQueryData(ctx->cpuQuery);
+    return 0;
+}
 
-    lastUserCPU.LowPart = sysUser.dwLowDateTime;
-    lastUserCPU.HighPart = sysUser.dwHighDateTime;
+// Collect the context's query and format usage since its last collection
+static double cpu_usage_since_previous(struct monitor_ctx* ctx) {
+    PDH_FMT_COUNTERVALUE counterVal;
+    
+    // Collect new data point
+    PdhCollectQueryData(ctx->cpuQuery);
+    if (PdhGetFormattedCounterValue(ctx->cpuTotal, PDH_FMT_DOUBLE, NULL, &counterVal) != ERROR_SUCCESS) {
+        return -1.0;
+    }
+    
+    // Return CPU percentage
+    return counterVal.doubleValue;
 }
 
 // Get CPU usage percentage (0-100)
 double getCpuUsage() {
     // Initialize CPU monitoring if not already done
-    if (cpuQuery == NULL) {
-        init_cpu_monitoring();
+    if (default_ctx.cpuQuery == NULL) {
+        if (open_cpu_query(&default_ctx) != 0) {
+            fprintf(stderr, "Error opening CPU performance query\n");
+            return -1.0;
+        }
         // First call needs to establish baseline
         Sleep(100); // Wait a bit to get first measurement
         return 0.0;
     }
 
-    PDH_FMT_COUNTERVALUE counterVal;
-    
-    // Collect new data point
-    PdhCollectQueryData(cpuQuery);
-    PdhGetFormattedCounterValue(cpuTotal, PDH_FMT_DOUBLE, NULL, &counterVal);
-    
-    // Return CPU percentage
-    return counterVal.doubleValue;
+    double cpu_usage = cpu_usage_since_previous(&default_ctx);
+    if (cpu_usage >= 0) last_cpu_usage = cpu_usage;
+    return cpu_usage;
 }
 
 // Get used memory in MB
@@ -150,22 +155,149 @@ double getDiskTotal() {
     return (double)totalNumberOfBytes.QuadPart / (1024.0 * 1024.0);
 }
 
-// Get CPU temperature in Celsius
-double getTemperature() {
+// Get capacity of every fixed and network drive
+int getMountUsage(struct mount_usage* out, int capacity) {
+    char drives[256];
+
+    if (out == NULL || capacity < 0) return -1;
+
+    DWORD length = GetLogicalDriveStringsA(sizeof(drives) - 1, drives);
+    if (length == 0 || length >= sizeof(drives)) {
+        fprintf(stderr, "Error listing drives\n");
+        return -1;
+    }
+
+    int written = 0;
+    for (char* drive = drives; *drive != '\0' && written < capacity; drive += strlen(drive) + 1) {
+        UINT type = GetDriveTypeA(drive);
+        if (type != DRIVE_FIXED && type != DRIVE_REMOTE) continue;
+
+        ULARGE_INTEGER available, total, free;
+        if (!GetDiskFreeSpaceExA(drive, &available, &total, &free) || total.QuadPart == 0) continue;
+
+        struct mount_usage* row = &out[written++];
+        memset(row, 0, sizeof(*row));
+        row->total_mb = (double)total.QuadPart / (1024.0 * 1024.0);
+        row->used_mb = (double)(total.QuadPart - free.QuadPart) / (1024.0 * 1024.0);
+        row->available_mb = (double)available.QuadPart / (1024.0 * 1024.0);
+        row->usage_percent = row->used_mb + row->available_mb > 0
+            ? row->used_mb / (row->used_mb + row->available_mb) * 100.0 : 0.0;
+
+        strncpy(row->mount_point, drive, MOUNT_PATH_LEN - 1);
+        GetVolumeInformationA(drive, NULL, 0, NULL, NULL, NULL, row->fs_type, MOUNT_FSTYPE_LEN);
+
+        // "C:" maps to a device such as \Device\HarddiskVolume3
+        char letter[3] = {drive[0], ':', '\0'};
+        if (!QueryDosDeviceA(letter, row->device, MOUNT_DEVICE_LEN)) {
+            row->device[0] = '\0';
+        }
+    }
+    return written;
+}
+
+// Estimate CPU temperature from an already sampled CPU usage
+static double estimate_temperature(double cpuUsage) {
     // Windows doesn't have a standard way to get CPU temperature through WMI
     // This would require additional libraries like OpenHardwareMonitor
     // For now, we'll return an estimated value based on CPU usage
-    double cpuUsage = getCpuUsage();
-    double estimatedTemp = 35.0 + (cpuUsage / 5.0);
-    
-    return estimatedTemp;
+    return 35.0 + (cpuUsage / 5.0);
+}
+
+// Get CPU temperature in Celsius
+double getTemperature() {
+    return estimate_temperature(last_cpu_usage);
+}
+
+// Fill every per-tick metric from one sample: one PDH collection, one
+// memory status query and one disk space query
+static int sample_context(struct monitor_ctx* ctx, struct system_snapshot* snapshot) {
+    struct system_snapshot sample;
+    LARGE_INTEGER counter, frequency;
+    MEMORYSTATUSEX memInfo;
+    ULARGE_INTEGER freeBytesAvailable, totalNumberOfBytes, totalNumberOfFreeBytes;
+
+    if (snapshot == NULL || snapshot->size < SYSTEM_SNAPSHOT_MIN_SIZE) {
+        return -1;
+    }
+
+    memset(&sample, 0, sizeof(sample));
+    QueryPerformanceCounter(&counter);
+    QueryPerformanceFrequency(&frequency);
+    sample.timestamp_ns = (uint64_t)(counter.QuadPart / frequency.QuadPart) * 1000000000ull +
+                          (uint64_t)(counter.QuadPart % frequency.QuadPart) * 1000000000ull / (uint64_t)frequency.QuadPart;
+
+    sample.cpu_usage = cpu_usage_since_previous(ctx);
+
+    memInfo.dwLength = sizeof(MEMORYSTATUSEX);
+    if (GlobalMemoryStatusEx(&memInfo)) {
+        sample.memory_used = (int64_t)((memInfo.ullTotalPhys - memInfo.ullAvailPhys) / (1024 * 1024));
+        sample.memory_total = (int64_t)(memInfo.ullTotalPhys / (1024 * 1024));
+    } else {
+        sample.memory_used = -1;
+        sample.memory_total = -1;
+    }
+
+    if (GetDiskFreeSpaceEx("C:\\", &freeBytesAvailable, &totalNumberOfBytes, &totalNumberOfFreeBytes)) {
+        ULONGLONG usedBytes = totalNumberOfBytes.QuadPart - totalNumberOfFreeBytes.QuadPart;
+        sample.disk_total = (double)totalNumberOfBytes.QuadPart / (1024.0 * 1024.0);
+        sample.disk_used = (double)usedBytes / (1024.0 * 1024.0);
+        sample.disk_usage = totalNumberOfBytes.QuadPart > 0
+            ? (double)usedBytes / (double)totalNumberOfBytes.QuadPart * 100.0
+            : 0.0;
+    } else {
+        sample.disk_total = -1.0;
+        sample.disk_used = -1.0;
+        sample.disk_usage = -1.0;
+    }
+
+    // Reuse this tick's CPU sample instead of taking a second one
+    sample.temperature = estimate_temperature(sample.cpu_usage);
+
+    return system_snapshot_copy_out(snapshot, &sample);
+}
+
+int getSystemSnapshot(struct system_snapshot* snapshot) {
+    if (default_ctx.cpuQuery == NULL && open_cpu_query(&default_ctx) != 0) {
+        fprintf(stderr, "Error opening CPU performance query\n");
+    }
+    int result = sample_context(&default_ctx, snapshot);
+    if (result == 0 && snapshot->cpu_usage >= 0) last_cpu_usage = snapshot->cpu_usage;
+    return result;
+}
+
+struct monitor_ctx* monitor_create() {
+    struct monitor_ctx* ctx = calloc(1, sizeof(*ctx));
+    if (ctx == NULL) {
+        fprintf(stderr, "Error allocating monitor context\n");
+        return NULL;
+    }
+
+    // PDH has no since-boot counter; the first sample covers the time since
+    // this baseline collection instead
+    if (open_cpu_query(ctx) != 0) {
+        fprintf(stderr, "Error opening CPU performance query\n");
+        free(ctx);
+        return NULL;
+    }
+    return ctx;
+}
+
+int monitor_sample(struct monitor_ctx* ctx, struct system_snapshot* snapshot) {
+    if (ctx == NULL) return -1;
+    return sample_context(ctx, snapshot);
+}
+
+void monitor_destroy(struct monitor_ctx* ctx) {
+    if (ctx == NULL) return;
+    if (ctx->cpuQuery != NULL) PdhCloseQuery(ctx->cpuQuery);
+    free(ctx);
 }
 
 // Cleanup resources
 void cleanup_cpu_monitoring() {
-    if (cpuQuery != NULL) {
-        PdhCloseQuery(cpuQuery);
-        cpuQuery = NULL;
+    if (default_ctx.cpuQuery != NULL) {
+        PdhCloseQuery(default_ctx.cpuQuery);
+        default_ctx.cpuQuery = NULL;
     }
 }
 
@@ -1,6 +1,10 @@
 #ifndef CPU_MONITOR_H
 #define CPU_MONITOR_H
 
+#include "../common/monitor_ctx.h"
+#include "../common/mount_usage.h"
+#include "../common/system_snapshot.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif